@@ -0,0 +1,79 @@
+#include "BenchRunner.h"
+#include "../src/hal/Hal.h"
+
+namespace bench {
+
+namespace {
+
+constexpr uint8_t  MAX_SAMPLES        = 15;
+constexpr uint32_t MAX_ITERATIONS     = 100000000;
+constexpr uint32_t ALLOC_ITERATIONS   = 1000;   // allocation counts are per-op stable
+
+volatile uint32_t sink;
+
+uint32_t timeMicros(const Benchmark& b, uint32_t iterations) {
+    uint32_t start = hal::micros();
+    b.run(iterations);
+    return hal::micros() - start;
+}
+
+} // namespace
+
+void consume(uint32_t v) {
+    sink = sink + v;
+}
+
+BenchResult run(const Benchmark& b, const BenchConfig& cfg) {
+    BenchResult r = {};
+    r.name = b.name;
+
+    // ── Warm up + calibrate ──────────────────────────────────────────
+    const uint32_t targetUs = cfg.sampleMs * 1000;
+    uint32_t n  = 1;
+    uint32_t us = timeMicros(b, n);
+    while (us < targetUs && n < MAX_ITERATIONS) {
+        uint32_t grow = us > 0 ? targetUs / us + 1 : 10;
+        n = (uint32_t)min<uint64_t>((uint64_t)n * constrain(grow, 2u, 10u), MAX_ITERATIONS);
+        us = timeMicros(b, n);
+    }
+    r.iterations = n;
+
+    // ── Timed samples (median) ───────────────────────────────────────
+    uint8_t samples = constrain(cfg.samples, (uint8_t)1, MAX_SAMPLES);
+    double  nsPerOp[MAX_SAMPLES];
+    for (uint8_t i = 0; i < samples; ++i) {
+        nsPerOp[i] = timeMicros(b, n) * 1000.0 / n;
+    }
+    for (uint8_t i = 1; i < samples; ++i) {          // insertion sort, ≤15 items
+        double v = nsPerOp[i];
+        int    j = i - 1;
+        while (j >= 0 && nsPerOp[j] > v) { nsPerOp[j + 1] = nsPerOp[j]; --j; }
+        nsPerOp[j + 1] = v;
+    }
+    r.nsPerOp = nsPerOp[samples / 2];
+
+    // ── Heap traffic ─────────────────────────────────────────────────
+    uint32_t an = min(n, ALLOC_ITERATIONS);
+    allocCountingBegin();
+    b.run(an);
+    AllocStats a = allocCountingEnd();
+    r.allocsPerOp = (double)a.count / an;
+    r.bytesPerOp  = (double)a.bytes / an;
+
+    r.messageBytes = b.messageBytes ? b.messageBytes() : 0;
+    return r;
+}
+
+int formatResult(const BenchResult& r, const char* platform, char* buf, size_t cap) {
+    int n = snprintf(buf, cap,
+                     "{\"bench\":\"%s\",\"platform\":\"%s\",\"iterations\":%u,"
+                     "\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f,\"bytes_per_op\":%.1f",
+                     r.name, platform, (unsigned)r.iterations,
+                     r.nsPerOp, r.allocsPerOp, r.bytesPerOp);
+    if (n < 0 || (size_t)n >= cap) return n;
+    if (r.messageBytes) n += snprintf(buf + n, cap - n, ",\"msg_bytes\":%u", (unsigned)r.messageBytes);
+    if ((size_t)n < cap) n += snprintf(buf + n, cap - n, "}");
+    return n;
+}
+
+} // namespace bench
@@ -0,0 +1,73 @@
+#ifndef BENCH_RUNNER_H
+#define BENCH_RUNNER_H
+
+#include <Arduino.h>
+
+/**
+ * Tiny microbenchmark harness shared by the host runner
+ * (bench/native/main.cpp) and the on-target runner (bench/esp32/main.cpp).
+ *
+ * A case's run() executes its body `iterations` times.  The runner
+ * grows the count until one sample lasts cfg.sampleMs, takes the median
+ * of cfg.samples timed samples, then repeats a shorter run with the
+ * allocation counter on (so hook overhead never pollutes the timing).
+ *
+ * Each result is one JSON object per line, starting with {"bench": so
+ * it can be grepped out of a serial log full of firmware output.
+ * Cases that produce or consume a wire message also report its size
+ * ("msg_bytes"), so JSON and MessagePack rows compare on both axes.
+ */
+
+struct Benchmark {
+    const char* name;
+    void (*run)(uint32_t iterations);
+    uint32_t (*messageBytes)() = nullptr;   // optional: size of the message one op handles
+};
+
+struct BenchConfig {
+    uint32_t sampleMs;
+    uint8_t  samples;
+};
+
+struct BenchResult {
+    const char* name;
+    uint32_t    iterations;    // per timed sample
+    double      nsPerOp;       // median of the samples
+    double      allocsPerOp;   // malloc/calloc/realloc calls
+    double      bytesPerOp;    // bytes requested by those calls
+    uint32_t    messageBytes;  // 0 = not a message case
+};
+
+namespace bench {
+
+// ── Cases (bench/Benchmarks.cpp) ─────────────────────────────────────
+extern const Benchmark CASES[];
+extern const size_t    CASE_COUNT;
+
+/** Writes known values into NVS; host only — never clobber a real device. */
+void seedConfig();
+
+/** Puts DeviceStats into a representative "connected to REMOTE" state. */
+void seedStats();
+
+// ── Runner ───────────────────────────────────────────────────────────
+BenchResult run(const Benchmark& b, const BenchConfig& cfg);
+
+/** Formats one result line (no trailing newline); returns its length. */
+int formatResult(const BenchResult& r, const char* platform, char* buf, size_t cap);
+
+/** Feeds a value into a volatile sink so the optimiser keeps the work. */
+void consume(uint32_t v);
+
+// ── Allocation counting (bench/<platform>/AllocHooks.cpp) ────────────
+struct AllocStats {
+    uint32_t count;
+    uint32_t bytes;
+};
+
+void       allocCountingBegin();
+AllocStats allocCountingEnd();
+
+} // namespace bench
+
+#endif // BENCH_RUNNER_H
@@ -0,0 +1,283 @@
+#include "BenchRunner.h"
+#include "../src/DeviceContext.h"
+#include "../src/ConfigManager.h"
+#include "../src/commands/CommandProcessor.h"
+#include "../src/commands/RateLimiter.h"
+#include "../src/wifi/WiFiManager.h"
+#include "../src/telemetry/TelemetryScheduler.h"
+#include "../src/protocol/WireProtocol.h"
+#include "../src/power/BatteryMonitor.h"
+#include <ArduinoJson.h>
+
+/**
+ * The firmware's hot paths.  Case names are the keys in
+ * bench/baseline.json — rename one and its history is lost.
+ */
+namespace {
+
+const char STATUS_CMD[]    = "{\"requestType\":\"STATUS\"}";
+const char INTENSITY_CMD[] = "{\"requestType\":\"INTENSITY\",\"intensity\":42}";
+const char RATE_CMD[]      = "{\"requestType\":\"TELEMETRY_RATE\",\"transport\":\"REMOTE\","
+                             "\"minIntervalMs\":250,\"heartbeatMs\":30000}";
+const char CREDS_CMD[]     = "{\"requestType\":\"WIFI_CREDENTIALS\",\"ssid\":\"OpenVibe-Lab\","
+                             "\"password\":\"correct horse battery staple\"}";
+const char BATCH_CMD[]     = "{\"requestType\":\"BATCH\",\"id\":1,\"commands\":["
+                             "{\"requestType\":\"INTENSITY\",\"intensity\":42},"
+                             "{\"requestType\":\"STATUS\"}]}";
+const char REMOTE_URL[]    = "ws://relay.openvibe.example:8080/devices";
+
+// MessagePack twins of the commands above (WireProtocol.h keys)
+const uint8_t INTENSITY_MP[] = { 0x82, wire::KEY_TYPE, REQ_INTENSITY, wire::KEY_INTENSITY, 42 };
+const uint8_t RATE_MP[]      = { 0x84, wire::KEY_TYPE, REQ_TELEMETRY_RATE, wire::KEY_TRANSPORT, TRANSPORT_REMOTE,
+                                 wire::KEY_MIN_INTERVAL, 0xCC, 250, wire::KEY_HEARTBEAT, 0xCD, 0x75, 0x30 };
+
+// ── Status serialisation ─────────────────────────────────────────────
+
+void benchStatusJson(uint32_t n) {
+    DeviceContext& ctx = DeviceContext::getInstance();
+    for (uint32_t i = 0; i < n; ++i) {
+        bench::consume(ctx.buildStatusJson().length());
+    }
+}
+
+void benchStatusMsgPack(uint32_t n) {
+    DeviceContext&     ctx = DeviceContext::getInstance();
+    wire::StatusBuffer out;
+    for (uint32_t i = 0; i < n; ++i) {
+        ctx.buildStatusMsgPack(out);
+        bench::consume(out.size());
+    }
+}
+
+uint32_t statusJsonBytes() { return DeviceContext::getInstance().buildStatusJson().length(); }
+
+uint32_t statusMsgPackBytes() {
+    wire::StatusBuffer out;
+    DeviceContext::getInstance().buildStatusMsgPack(out);
+    return out.size();
+}
+
+// ── Inbound command parse (the BLE onWrite / WS text frame path) ─────
+
+void parse(const char* json, size_t len, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        JsonDocument doc;
+        deserializeJson(doc, json, len);
+        const char* req = doc["requestType"];
+        bench::consume(req ? (uint32_t)req[0] : 0u);
+    }
+}
+
+void benchParseIntensity(uint32_t n) { parse(INTENSITY_CMD, sizeof(INTENSITY_CMD) - 1, n); }
+void benchParseRate(uint32_t n)      { parse(RATE_CMD,      sizeof(RATE_CMD) - 1,      n); }
+void benchParseCreds(uint32_t n)     { parse(CREDS_CMD,     sizeof(CREDS_CMD) - 1,     n); }
+
+// Straight into the typed Command, as CommandProcessor::handleMsgPack does.
+void parseMsgPack(const uint8_t* data, size_t len, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        MsgPackReader r(data, len);
+        Command       cmd;
+        uint32_t      entries = 0;
+        int64_t       key, type;
+        r.map(entries);
+        while (entries--) {
+            if (!r.sint(key)) break;
+            if (key == wire::KEY_TYPE && r.sint(type)) cmd.type = (RequestType)type;
+            else wire::decodeField(r, (uint32_t)key, cmd);
+        }
+        bench::consume(cmd.type + cmd.intensity);
+    }
+}
+
+void benchParseIntensityMsgPack(uint32_t n) { parseMsgPack(INTENSITY_MP, sizeof(INTENSITY_MP), n); }
+void benchParseRateMsgPack(uint32_t n)      { parseMsgPack(RATE_MP,      sizeof(RATE_MP),      n); }
+
+uint32_t intensityJsonBytes()    { return sizeof(INTENSITY_CMD) - 1; }
+uint32_t rateJsonBytes()         { return sizeof(RATE_CMD) - 1; }
+uint32_t intensityMsgPackBytes() { return sizeof(INTENSITY_MP); }
+uint32_t rateMsgPackBytes()      { return sizeof(RATE_MP); }
+
+// ── Full dispatch (parse + execute; no NVS writes) ───────────────────
+
+void benchDispatchStatus(uint32_t n) {
+    CommandProcessor& cp = CommandProcessor::getInstance();
+    for (uint32_t i = 0; i < n; ++i) {
+        bench::consume(cp.handleJson(STATUS_CMD, sizeof(STATUS_CMD) - 1, SOURCE_BLE));
+    }
+}
+
+// The "[WS] Intensity" line is LOG_D, compiled out at the default level.
+void benchDispatchIntensity(uint32_t n) {
+    CommandProcessor& cp = CommandProcessor::getInstance();
+    for (uint32_t i = 0; i < n; ++i) {
+        bench::consume(cp.handleJson(INTENSITY_CMD, sizeof(INTENSITY_CMD) - 1, SOURCE_WS_LOCAL));
+    }
+}
+
+void benchDispatchIntensityMsgPack(uint32_t n) {
+    CommandProcessor& cp = CommandProcessor::getInstance();
+    for (uint32_t i = 0; i < n; ++i) {
+        bench::consume(cp.handleMsgPack(INTENSITY_MP, sizeof(INTENSITY_MP), SOURCE_WS_LOCAL));
+    }
+}
+
+// One BATCH frame doing what dispatch_intensity + dispatch_status do
+// in two, including the aggregated reply.
+void benchDispatchBatch(uint32_t n) {
+    CommandProcessor& cp = CommandProcessor::getInstance();
+    for (uint32_t i = 0; i < n; ++i) {
+        String reply;
+        bench::consume(cp.handleJson(BATCH_CMD, sizeof(BATCH_CMD) - 1, SOURCE_WS_LOCAL, &reply));
+    }
+}
+
+// ── Rate limiting (in front of the dispatch above) ───────────────────
+
+// The clock moves one token per frame, so every frame gets through.
+void benchAdmitIntensity(uint32_t n) {
+    RateLimiter& rl = RateLimiter::getInstance();
+    for (uint32_t i = 0; i < n; ++i) {
+        bench::consume(rl.admitJson(SOURCE_WS_LOCAL, 0, INTENSITY_CMD, sizeof(INTENSITY_CMD) - 1,
+                                    i * OPENVIBE_RATE_CONTROL_MS));
+    }
+}
+
+// The clock stands still: past the burst, what a flood costs per frame.
+void benchDropIntensity(uint32_t n) {
+    RateLimiter& rl = RateLimiter::getInstance();
+    for (uint32_t i = 0; i < n; ++i) {
+        bench::consume(rl.admitJson(SOURCE_WS_REMOTE, 0, INTENSITY_CMD, sizeof(INTENSITY_CMD) - 1, 0));
+    }
+}
+
+// ── REMOTE URL parsing (connectToRemote) ─────────────────────────────
+
+void benchRemoteUrl(uint32_t n) {
+    const String   url(REMOTE_URL);
+    const String   id("a286f24");
+    RemoteEndpoint ep;
+    for (uint32_t i = 0; i < n; ++i) {
+        WiFiManager::parseRemoteUrl(url, id, ep);
+        bench::consume(ep.port + ep.path.length());
+    }
+}
+
+// ── ConfigManager accessors (one NVS open/close each) ────────────────
+
+void benchConfigSsid(uint32_t n) {
+    ConfigManager& cfg = ConfigManager::getInstance();
+    for (uint32_t i = 0; i < n; ++i) bench::consume(cfg.getWiFiSSID().length());
+}
+
+void benchConfigTransport(uint32_t n) {
+    ConfigManager& cfg = ConfigManager::getInstance();
+    for (uint32_t i = 0; i < n; ++i) bench::consume((uint32_t)cfg.getLastTransport());
+}
+
+void benchConfigTelemetryRate(uint32_t n) {
+    ConfigManager& cfg = ConfigManager::getInstance();
+    uint32_t minMs = 0, hbMs = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        cfg.getTelemetryRate(TRANSPORT_REMOTE, minMs, hbMs);
+        bench::consume(minMs + hbMs);
+    }
+}
+
+// ── Battery sampling (timer task, every 100 ms) ──────────────────────
+
+// A pin hovering around 1.85 V, so the filter and LUT do real work.
+class NoisyAdc : public AdcSource {
+public:
+    bool     begin() override { return true; }
+    uint32_t readMilliVolts() override {
+        lcg = lcg * 1103515245u + 12345u;
+        return 1830 + (lcg >> 16) % 41;
+    }
+
+private:
+    uint32_t lcg = 1;
+};
+
+// One sample(): 16 conversions, the IIR step and the percent lookup.
+void benchBatterySample(uint32_t n) {
+    static BatteryMonitor mon;
+    static bool           started = false;
+    if (!started) {
+        BatteryMonitor::Config cfg;
+        cfg.adcPin    = 35;
+        cfg.chargePin = -1;
+        mon.begin(new NoisyAdc(), cfg);
+        started = true;
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        mon.sample();
+        bench::consume(mon.getMilliVolts());
+    }
+}
+
+// ── Telemetry scheduling (runs every loop tick) ──────────────────────
+
+void benchTelemetryTick(uint32_t n) {
+    static TelemetryScheduler sched;
+    static uint32_t           now = 0;
+    const uint8_t all = TelemetryScheduler::channelBit(TRANSPORT_BLE) |
+                        TelemetryScheduler::channelBit(TRANSPORT_WIFI) |
+                        TelemetryScheduler::channelBit(TRANSPORT_REMOTE);
+    DeviceStats& stats = DeviceContext::getInstance().getStats();
+    for (uint32_t i = 0; i < n; ++i) {
+        now += 1;
+        if (!sched.anyWindowOpen(all, now)) continue;
+        uint8_t due = sched.due(stats, all, now);
+        if (due) sched.markSent(due, stats, now);
+        bench::consume(due);
+    }
+}
+
+} // namespace
+
+namespace bench {
+
+const Benchmark CASES[] = {
+    { "status_json",             benchStatusJson,                statusJsonBytes },
+    { "status_msgpack",          benchStatusMsgPack,             statusMsgPackBytes },
+    { "parse_intensity",         benchParseIntensity,            intensityJsonBytes },
+    { "parse_intensity_msgpack", benchParseIntensityMsgPack,     intensityMsgPackBytes },
+    { "parse_telemetry_rate",    benchParseRate,                 rateJsonBytes },
+    { "parse_tlm_rate_msgpack",  benchParseRateMsgPack,          rateMsgPackBytes },
+    { "parse_wifi_credentials",  benchParseCreds },
+    { "dispatch_status",         benchDispatchStatus },
+    { "dispatch_intensity",      benchDispatchIntensity },
+    { "dispatch_intensity_mp",   benchDispatchIntensityMsgPack },
+    { "dispatch_batch",          benchDispatchBatch },
+    { "admit_intensity",         benchAdmitIntensity },
+    { "drop_intensity",          benchDropIntensity },
+    { "remote_url_parse",        benchRemoteUrl },
+    { "config_get_ssid",         benchConfigSsid },
+    { "config_get_transport",    benchConfigTransport },
+    { "config_get_tlm_rate",     benchConfigTelemetryRate },
+    { "telemetry_tick",          benchTelemetryTick },
+    { "battery_sample",          benchBatterySample },
+};
+const size_t CASE_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+void seedConfig() {
+    ConfigManager& cfg = ConfigManager::getInstance();
+    cfg.setWiFiCredentials("OpenVibe-Lab", "correct horse battery staple");
+    cfg.setRemoteServer(REMOTE_URL);
+    cfg.setLastTransport(TRANSPORT_REMOTE);
+    cfg.setTelemetryRate(TRANSPORT_REMOTE, 250, 30000);
+}
+
+void seedStats() {
+    DeviceStats& s = DeviceContext::getInstance().getStats();
+    s.levels[0]            = 42;
+    s.battery              = 87;
+    s.isWifiConnected      = true;
+    s.isBluetoothConnected = false;
+    s.ipAddress            = "192.168.1.57";
+    s.macAddress           = "24:6F:28:0A:B1:E5";
+    s.transport            = TRANSPORT_REMOTE;
+    s.serverAddress        = REMOTE_URL;
+}
+
+} // namespace bench
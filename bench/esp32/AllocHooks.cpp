@@ -0,0 +1,71 @@
+#include <stddef.h>
+#include <stdint.h>
+#include "../BenchRunner.h"
+
+/**
+ * On-target allocation counter.  The esp32dev_bench env links with
+ * -Wl,--wrap=malloc/calloc/realloc/free, so every call site in the
+ * image (Arduino String, ArduinoJson, libstdc++ operator new) lands in
+ * the __wrap_* functions below.  Allocations made directly through
+ * heap_caps_* by IDF drivers are not seen, which is fine: nothing
+ * benchmarked calls them.
+ */
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void  __real_free(void* ptr);
+}
+
+namespace {
+
+volatile bool     counting   = false;
+volatile uint32_t allocCount = 0;
+volatile uint32_t allocBytes = 0;
+
+inline void note(size_t size) {
+    if (!counting) return;
+    allocCount = allocCount + 1;
+    allocBytes = allocBytes + (uint32_t)size;
+}
+
+} // namespace
+
+extern "C" {
+
+void* __wrap_malloc(size_t size) {
+    note(size);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    note(count * size);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    note(size);
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    __real_free(ptr);
+}
+
+} // extern "C"
+
+namespace bench {
+
+void allocCountingBegin() {
+    allocCount = 0;
+    allocBytes = 0;
+    counting   = true;
+}
+
+AllocStats allocCountingEnd() {
+    counting = false;
+    AllocStats s = { allocCount, allocBytes };
+    return s;
+}
+
+} // namespace bench
@@ -0,0 +1,40 @@
+#include <Arduino.h>
+#include "../BenchRunner.h"
+
+/**
+ * On-target benchmark runner (env:esp32dev_bench).
+ *
+ * Runs every case once at boot and prints one {"bench":...} line per
+ * result over serial.  Capture the monitor output to a file and feed
+ * it to the host runner's --compare to check it against the "esp32"
+ * section of bench/baseline.json.
+ *
+ * NVS is only read, never seeded, so the config cases measure
+ * whatever the board has stored (missing keys are the fast path).
+ */
+
+#ifndef OPENVIBE_BENCH_BAUD
+#define OPENVIBE_BENCH_BAUD 115200
+#endif
+
+static const BenchConfig CONFIG = { 50, 5 };
+
+void setup() {
+    Serial.begin(OPENVIBE_BENCH_BAUD);
+    delay(1000);   // let the monitor attach
+    Serial.println("[Bench] Starting");
+
+    bench::seedStats();
+    char line[256];
+    for (size_t i = 0; i < bench::CASE_COUNT; ++i) {
+        BenchResult r = bench::run(bench::CASES[i], CONFIG);
+        bench::formatResult(r, "esp32", line, sizeof(line));
+        Serial.println(line);
+    }
+
+    Serial.printf("[Bench] Done (free heap %u B)\n", (unsigned)ESP.getFreeHeap());
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,69 @@
+#include <stddef.h>
+#include <stdint.h>
+#include "../BenchRunner.h"
+
+/**
+ * Host allocation counter: replaces the C allocator entry points and
+ * forwards to glibc's internal ones.  Everything — operator new,
+ * std::string behind the String shim, ArduinoJson's pool — ends up
+ * here.  Counting is off outside allocCountingBegin/End.
+ */
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void  __libc_free(void* ptr);
+}
+
+namespace {
+
+volatile bool counting = false;
+uint32_t      allocCount = 0;
+uint32_t      allocBytes = 0;
+
+inline void note(size_t size) {
+    if (!counting) return;
+    __atomic_fetch_add(&allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocBytes, (uint32_t)size, __ATOMIC_RELAXED);
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    note(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    note(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    note(size);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+
+} // extern "C"
+
+namespace bench {
+
+void allocCountingBegin() {
+    allocCount = 0;
+    allocBytes = 0;
+    counting   = true;
+}
+
+AllocStats allocCountingEnd() {
+    counting = false;
+    AllocStats s = { allocCount, allocBytes };
+    return s;
+}
+
+} // namespace bench
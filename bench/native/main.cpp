@@ -0,0 +1,255 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../BenchRunner.h"
+#include "../../src/hal/native/NativeSim.h"
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * Host benchmark runner.
+ *
+ *   .pio/build/native_bench/program [--filter SUBSTR] [--samples N] [--sample-ms N]
+ *                                   [--baseline FILE] [--tolerance X] [--update-baseline]
+ *                                   [--compare CAPTURE]
+ *
+ * Result lines go to stdout; firmware log output produced while the
+ * cases run is discarded.  With --baseline the results are checked
+ * against the file's section for their platform and the exit status
+ * is 1 on a regression; a platform with no recorded results is an
+ * error (exit 2), so a missing baseline never passes.  --compare skips running and instead reads
+ * {"bench":...} lines from CAPTURE (e.g. a serial log from the
+ * esp32dev_bench env), so on-target runs use the same check.
+ */
+
+namespace {
+
+constexpr const char* PLATFORM          = "native";
+constexpr double      DEFAULT_TOLERANCE = 0.25;   // ns/op may grow 25 % before failing
+constexpr double      ALLOC_SLACK       = 0.5;    // allocs/op are integral when stable
+constexpr double      BYTES_SLACK       = 0.10;   // bytes/op may grow 10 % + 16 B
+
+struct Row {
+    std::string name;
+    std::string platform;
+    std::string line;
+    BenchResult result;
+};
+
+struct Options {
+    const char* filter         = nullptr;
+    const char* baseline       = nullptr;
+    const char* compare        = nullptr;
+    double      tolerance      = -1;
+    bool        updateBaseline = false;
+    BenchConfig cfg            = { 100, 5 };
+};
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [--filter SUBSTR] [--samples N] [--sample-ms N]\n"
+            "          [--baseline FILE] [--tolerance X] [--update-baseline] [--compare CAPTURE]\n",
+            prog);
+}
+
+bool readFile(const char* path, std::string& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+// ── Sources of rows ──────────────────────────────────────────────────
+
+void runCases(const Options& opt, std::vector<Row>& rows) {
+    // Firmware code logs through Serial (stdout); keep results clean.
+    fflush(stdout);
+    int   resultsFd = dup(STDOUT_FILENO);
+    FILE* results   = fdopen(resultsFd, "w");
+    if (!freopen("/dev/null", "w", stdout)) results = stderr;
+
+    for (size_t i = 0; i < bench::CASE_COUNT; ++i) {
+        const Benchmark& b = bench::CASES[i];
+        if (opt.filter && !strstr(b.name, opt.filter)) continue;
+
+        Row  row;
+        char line[256];
+        row.result   = bench::run(b, opt.cfg);
+        bench::formatResult(row.result, PLATFORM, line, sizeof(line));
+        row.name     = b.name;
+        row.platform = PLATFORM;
+        row.line     = line;
+        fprintf(results, "%s\n", line);
+        fflush(results);
+        rows.push_back(row);
+    }
+}
+
+bool readCapture(const char* path, std::vector<Row>& rows) {
+    std::string text;
+    if (!readFile(path, text)) return false;
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string::npos) eol = text.size();
+        std::string line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        size_t start = line.find("{\"bench\":");
+        if (start == std::string::npos) continue;
+        line.erase(0, start);
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+
+        JsonDocument doc;
+        if (deserializeJson(doc, line.c_str(), line.size())) continue;
+        Row row;
+        row.name                = doc["bench"] | "";
+        row.platform            = doc["platform"] | "unknown";
+        row.line                = line;
+        row.result.iterations   = doc["iterations"] | 0u;
+        row.result.nsPerOp      = doc["ns_per_op"] | 0.0;
+        row.result.allocsPerOp  = doc["allocs_per_op"] | 0.0;
+        row.result.bytesPerOp   = doc["bytes_per_op"] | 0.0;
+        row.result.messageBytes = doc["msg_bytes"] | 0u;
+        rows.push_back(row);
+    }
+    return true;
+}
+
+// ── Baseline ─────────────────────────────────────────────────────────
+
+int compareBaseline(const std::vector<Row>& rows, JsonDocument& baseline, double tolerance) {
+    int failures = 0;
+    fprintf(stderr, "%-26s %12s %12s %8s  %s\n", "bench", "ns/op", "baseline", "allocs", "verdict");
+
+    for (const Row& row : rows) {
+        JsonVariant ref = baseline[row.platform.c_str()][row.name.c_str()];
+        const BenchResult& r = row.result;
+
+        if (ref.isNull()) {
+            fprintf(stderr, "%-26s %12.1f %12s %8.2f  new\n", row.name.c_str(), r.nsPerOp, "-", r.allocsPerOp);
+            continue;
+        }
+
+        double refNs     = ref["ns_per_op"]     | 0.0;
+        double refAllocs = ref["allocs_per_op"] | 0.0;
+        double refBytes  = ref["bytes_per_op"]  | 0.0;
+
+        const char* verdict = "ok";
+        if (r.allocsPerOp > refAllocs + ALLOC_SLACK) {
+            verdict = "REGRESSION (allocs)";
+        } else if (r.bytesPerOp > refBytes * (1 + BYTES_SLACK) + 16) {
+            verdict = "REGRESSION (bytes)";
+        } else if (refNs > 0 && r.nsPerOp > refNs * (1 + tolerance)) {
+            verdict = "REGRESSION (time)";
+        } else if (refNs > 0 && r.nsPerOp < refNs * (1 - tolerance)) {
+            verdict = "faster";
+        }
+        if (strncmp(verdict, "REGRESSION", 10) == 0) ++failures;
+
+        fprintf(stderr, "%-26s %12.1f %12.1f %8.2f  %s\n",
+                row.name.c_str(), r.nsPerOp, refNs, r.allocsPerOp, verdict);
+    }
+    return failures;
+}
+
+// Every platform in `rows` needs recorded results to compare against.
+bool hasBaseline(const std::vector<Row>& rows, JsonDocument& baseline, const char* path) {
+    for (const Row& row : rows) {
+        JsonObject section = baseline[row.platform.c_str()];
+        if (section.isNull() || section.size() == 0) {
+            fprintf(stderr, "%s has no %s results; record them with --update-baseline\n",
+                    path, row.platform.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeBaseline(const char* path, const std::vector<Row>& rows, JsonDocument& baseline) {
+    if (baseline["tolerance"].isNull()) baseline["tolerance"] = DEFAULT_TOLERANCE;
+    for (const Row& row : rows) {
+        JsonObject entry = baseline[row.platform.c_str()][row.name.c_str()].to<JsonObject>();
+        entry["ns_per_op"]     = row.result.nsPerOp;
+        entry["allocs_per_op"] = row.result.allocsPerOp;
+        entry["bytes_per_op"]  = row.result.bytesPerOp;
+        if (row.result.messageBytes) entry["msg_bytes"] = row.result.messageBytes;
+    }
+
+    String out;
+    serializeJsonPretty(baseline, out);
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fwrite(out.c_str(), 1, out.length(), f);
+    fputc('\n', f);
+    fclose(f);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const char* a    = argv[i];
+        const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if      (!strcmp(a, "--filter")    && next) { opt.filter = next; ++i; }
+        else if (!strcmp(a, "--samples")   && next) { opt.cfg.samples = (uint8_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--sample-ms") && next) { opt.cfg.sampleMs = (uint32_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--baseline")  && next) { opt.baseline = next; ++i; }
+        else if (!strcmp(a, "--tolerance") && next) { opt.tolerance = atof(next); ++i; }
+        else if (!strcmp(a, "--compare")   && next) { opt.compare = next; ++i; }
+        else if (!strcmp(a, "--update-baseline"))   { opt.updateBaseline = true; }
+        else if (!strcmp(a, "--help"))              { usage(argv[0]); return 0; }
+        else { usage(argv[0]); return 2; }
+    }
+    if (opt.updateBaseline && !opt.baseline) {
+        fprintf(stderr, "--update-baseline needs --baseline FILE\n");
+        return 2;
+    }
+
+    std::vector<Row> rows;
+    if (opt.compare) {
+        if (!readCapture(opt.compare, rows)) {
+            fprintf(stderr, "cannot read %s\n", opt.compare);
+            return 2;
+        }
+    } else {
+        // Private NVS so config cases never touch a developer's .nvs/.
+        char dir[] = "/tmp/openvibe-bench-XXXXXX";
+        if (mkdtemp(dir)) native::simOptions().nvsDir = dir;
+        bench::seedConfig();
+        bench::seedStats();
+        runCases(opt, rows);
+    }
+
+    if (!opt.baseline) return 0;
+
+    JsonDocument baseline;
+    std::string  text;
+    if (readFile(opt.baseline, text) && deserializeJson(baseline, text.c_str(), text.size())) {
+        fprintf(stderr, "%s is not valid JSON\n", opt.baseline);
+        return 2;
+    }
+
+    if (opt.updateBaseline) {
+        if (!writeBaseline(opt.baseline, rows, baseline)) {
+            fprintf(stderr, "cannot write %s\n", opt.baseline);
+            return 2;
+        }
+        fprintf(stderr, "updated %s (%u results)\n", opt.baseline, (unsigned)rows.size());
+        return 0;
+    }
+
+    if (!hasBaseline(rows, baseline, opt.baseline)) return 2;
+
+    double tolerance = opt.tolerance >= 0 ? opt.tolerance : (baseline["tolerance"] | DEFAULT_TOLERANCE);
+    int    failures  = compareBaseline(rows, baseline, tolerance);
+    if (failures) fprintf(stderr, "%d regression(s) against %s\n", failures, opt.baseline);
+    return failures ? 1 : 0;
+}
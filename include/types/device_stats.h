@@ -6,15 +6,20 @@
 enum TransportMode {
     TRANSPORT_BLE = 0,
     TRANSPORT_WIFI = 1,
-    TRANSPORT_REMOTE = 2
+    TRANSPORT_REMOTE = 2,
+    TRANSPORT_AUTO = 3     // every built link at once (src/session/SessionManager.h)
 };
 
+// Motor outputs a build can drive (see src/motor/MotorBank.h).
+constexpr uint8_t MAX_MOTOR_CHANNELS = 8;
+
 /**
  * Holds the runtime state of the device.
  * Owned exclusively by DeviceContext — never accessed via extern.
  */
 struct DeviceStats {
-    int intensity = 0;
+    uint8_t levels[MAX_MOTOR_CHANNELS] = {};   // per channel, 0–100
+    uint8_t channelCount = 1;
     int battery = 100;
     bool isCharging = false;
     bool isBluetoothConnected = false;
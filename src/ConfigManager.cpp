@@ -1,4 +1,5 @@
 #include "ConfigManager.h"
+#include "hal/Nvs.h"
 
 ConfigManager& ConfigManager::getInstance() {
     static ConfigManager instance;
@@ -8,27 +9,19 @@ ConfigManager& ConfigManager::getInstance() {
 // ── WiFi ──────────────────────────────────────────────────────────────
 
 void ConfigManager::setWiFiCredentials(const String& ssid, const String& password) {
-    Preferences p;
-    p.begin(NS, false);
+    hal::Nvs p(NS, false);
     p.putString("wifi_ssid", ssid);
     p.putString("wifi_pass", password);
-    p.end();
 }
 
 String ConfigManager::getWiFiSSID() {
-    Preferences p;
-    p.begin(NS, true);
-    String v = p.getString("wifi_ssid", "");
-    p.end();
-    return v;
+    hal::Nvs p(NS, true);
+    return p.getString("wifi_ssid", "");
 }
 
 String ConfigManager::getWiFiPassword() {
-    Preferences p;
-    p.begin(NS, true);
-    String v = p.getString("wifi_pass", "");
-    p.end();
-    return v;
+    hal::Nvs p(NS, true);
+    return p.getString("wifi_pass", "");
 }
 
 bool ConfigManager::hasWiFiCredentials() {
@@ -36,60 +29,130 @@ bool ConfigManager::hasWiFiCredentials() {
 }
 
 void ConfigManager::clearWiFiCredentials() {
-    Preferences p;
-    p.begin(NS, false);
+    hal::Nvs p(NS, false);
     p.remove("wifi_ssid");
     p.remove("wifi_pass");
-    p.end();
 }
 
 // ── Device ────────────────────────────────────────────────────────────
 
 void ConfigManager::setDeviceName(const String& name) {
-    Preferences p;
-    p.begin(NS, false);
+    hal::Nvs p(NS, false);
     p.putString("dev_name", name);
-    p.end();
 }
 
 String ConfigManager::getDeviceName() {
-    Preferences p;
-    p.begin(NS, true);
-    String v = p.getString("dev_name", "OpenVibe");
-    p.end();
-    return v;
+    hal::Nvs p(NS, true);
+    return p.getString("dev_name", "OpenVibe");
 }
 
 // ── Transport ─────────────────────────────────────────────────────────
 
 void ConfigManager::setLastTransport(int transport) {
-    Preferences p;
-    p.begin(NS, false);
+    hal::Nvs p(NS, false);
     p.putInt("transport", transport);
-    p.end();
 }
 
 int ConfigManager::getLastTransport() {
-    Preferences p;
-    p.begin(NS, true);
-    int v = p.getInt("transport", 0);
-    p.end();
-    return v;
+    hal::Nvs p(NS, true);
+    return p.getInt("transport", 0);
 }
 
 // ── Remote server ─────────────────────────────────────────────────────
 
 void ConfigManager::setRemoteServer(const String& url) {
-    Preferences p;
-    p.begin(NS, false);
+    hal::Nvs p(NS, false);
     p.putString("remote_url", url);
-    p.end();
 }
 
 String ConfigManager::getRemoteServer() {
-    Preferences p;
-    p.begin(NS, true);
-    String v = p.getString("remote_url", "");
-    p.end();
-    return v;
+    hal::Nvs p(NS, true);
+    return p.getString("remote_url", "");
+}
+
+// ── Telemetry ─────────────────────────────────────────────────────────
+
+void ConfigManager::setTelemetryRate(int transport, uint32_t minIntervalMs, uint32_t heartbeatMs) {
+    char minKey[12], hbKey[12];
+    snprintf(minKey, sizeof(minKey), "tlm_min_%d", transport);
+    snprintf(hbKey,  sizeof(hbKey),  "tlm_hb_%d",  transport);
+
+    hal::Nvs p(NS, false);
+    p.putUInt(minKey, minIntervalMs);
+    p.putUInt(hbKey,  heartbeatMs);
+}
+
+bool ConfigManager::getTelemetryRate(int transport, uint32_t& minIntervalMs, uint32_t& heartbeatMs) {
+    char minKey[12], hbKey[12];
+    snprintf(minKey, sizeof(minKey), "tlm_min_%d", transport);
+    snprintf(hbKey,  sizeof(hbKey),  "tlm_hb_%d",  transport);
+
+    hal::Nvs p(NS, true);
+    bool found = p.isKey(minKey);
+    if (found) {
+        minIntervalMs = p.getUInt(minKey, minIntervalMs);
+        heartbeatMs   = p.getUInt(hbKey,  heartbeatMs);
+    }
+    return found;
+}
+
+// ── Power ─────────────────────────────────────────────────────────────
+
+void ConfigManager::setPowerProfile(int profile) {
+    hal::Nvs p(NS, false);
+    p.putInt("power", profile);
+}
+
+int ConfigManager::getPowerProfile() {
+    hal::Nvs p(NS, true);
+    return p.getInt("power", 1);
+}
+
+// ── OTA ───────────────────────────────────────────────────────────────
+
+void ConfigManager::setOtaProgress(uint32_t size, const uint8_t sha256[32], uint32_t offset) {
+    hal::Nvs p(NS, false);
+    p.putUInt("ota_size", size);
+    p.putBytes("ota_sha", sha256, 32);
+    p.putUInt("ota_off", offset);
+}
+
+bool ConfigManager::getOtaProgress(uint32_t& size, uint8_t sha256[32], uint32_t& offset) {
+    hal::Nvs p(NS, true);
+    if (!p.isKey("ota_size") || p.getBytes("ota_sha", sha256, 32) != 32) return false;
+    size   = p.getUInt("ota_size", 0);
+    offset = p.getUInt("ota_off", 0);
+    return true;
+}
+
+void ConfigManager::clearOtaProgress() {
+    hal::Nvs p(NS, false);
+    p.remove("ota_size");
+    p.remove("ota_sha");
+    p.remove("ota_off");
+}
+
+void ConfigManager::setOtaTrial(int boots) {
+    hal::Nvs p(NS, false);
+    p.putInt("ota_trial", boots);
+}
+
+int ConfigManager::getOtaTrial() {
+    hal::Nvs p(NS, true);
+    return p.getInt("ota_trial", -1);
+}
+
+void ConfigManager::clearOtaTrial() {
+    hal::Nvs p(NS, false);
+    p.remove("ota_trial");
+}
+
+void ConfigManager::setOtaKey(const uint8_t key[32]) {
+    hal::Nvs p(NS, false);
+    p.putBytes("ota_key", key, 32);
+}
+
+bool ConfigManager::getOtaKey(uint8_t key[32]) {
+    hal::Nvs p(NS, true);
+    return p.getBytes("ota_key", key, 32) == 32;
 }
@@ -2,12 +2,12 @@
 #define CONFIG_MANAGER_H
 
 #include <Arduino.h>
-#include <Preferences.h>
 
 /**
  * Singleton that centralises all NVS (non-volatile storage) access.
  * Replaces the old WiFiCredentials helper and any other scattered
- * Preferences usage so every key lives under one namespace.
+ * Preferences usage so every key lives under one namespace.  Storage
+ * goes through hal::Nvs so the host build can run it too.
  */
 class ConfigManager {
 public:
@@ -32,6 +32,27 @@ public:
     void   setRemoteServer(const String& url);
     String getRemoteServer();
 
+    // Telemetry (per-transport status rate; false if never configured)
+    void setTelemetryRate(int transport, uint32_t minIntervalMs, uint32_t heartbeatMs);
+    bool getTelemetryRate(int transport, uint32_t& minIntervalMs, uint32_t& heartbeatMs);
+
+    // Power profile (PowerProfile; balanced if never set)
+    void setPowerProfile(int profile);
+    int  getPowerProfile();
+
+    // OTA: checkpoint of an interrupted transfer (false if none) and the
+    // boot-trial counter of a freshly activated image (-1 if none).
+    void setOtaProgress(uint32_t size, const uint8_t sha256[32], uint32_t offset);
+    bool getOtaProgress(uint32_t& size, uint8_t sha256[32], uint32_t& offset);
+    void clearOtaProgress();
+    void setOtaTrial(int boots);
+    int  getOtaTrial();
+    void clearOtaTrial();
+
+    // OTA key: HMAC-SHA256 key images are signed with (false if none)
+    void setOtaKey(const uint8_t key[32]);
+    bool getOtaKey(uint8_t key[32]);
+
 private:
     ConfigManager() = default;
     ConfigManager(const ConfigManager&)            = delete;
@@ -1,7 +1,16 @@
 #include "DeviceContext.h"
 #include "ConfigManager.h"
+#include "Features.h"
 #include "wifi/WiFiManager.h"
 #include "ble/BLEManager.h"
+#include "power/BatteryMonitor.h"
+#include "trace/TraceRecorder.h"
+#include "ota/OtaManager.h"
+#include "log/Logger.h"
+#include "commands/CommandProcessor.h"
+#include "session/SessionManager.h"
+#include "protocol/WireProtocol.h"
+#include "hal/Hal.h"
 #include <ArduinoJson.h>
 #include <base64.h>
 
@@ -15,61 +24,207 @@ DeviceContext& DeviceContext::getInstance() {
 DeviceContext::DeviceContext()
     : wifiMgr(nullptr)
     , bleMgr(nullptr)
-    , statusBroadcastRequested(false) {}
+    , battery(nullptr)
+#if OPENVIBE_WITH_REMOTE
+    , remoteEnabled(false)
+#endif
+    , lastLed(false)
+    , busyFrames(0) {}
 
 // ── Lifecycle ────────────────────────────────────────────────────────
 
 void DeviceContext::setup() {
     Serial.begin(115200);
-    pinMode(LED_PIN, OUTPUT);
-    digitalWrite(LED_PIN, LOW);
+    Logger::getInstance().begin();
+    hal::wakeOnSerialInput();
+    hal::gpioOutput(LED_PIN);
+    hal::gpioWrite(LED_PIN, false);
 
     ConfigManager& cfg = ConfigManager::getInstance();
 
+    // ── Firmware trial (may roll back and restart right here) ────────
+    OtaManager::getInstance().bootCheck();
+
+    // ── Motors (channel count from the board's pin list) ─────────────
+    uint8_t channels   = motors.begin(MotorBank::Config());
+    stats.channelCount = channels ? channels : 1;   // level still reported
+
+#if OPENVIBE_WITH_REMOTE
+    events.begin();
+#endif
+
+    // ── Battery (sampled from a timer task, off the loop) ────────────
+    BatteryMonitor::Config batCfg;
+    battery = new BatteryMonitor();
+    battery->begin(batCfg.adcPin >= 0 ? hal::createAdcSource(batCfg.adcPin) : nullptr, batCfg);
+    battery->startSampling();
+
+    // Each subsystem's share of the boot, for the variant report.
+    uint32_t bleMs  = 0;
+    uint32_t wifiMs = 0;
+    uint32_t t0;
+
+#if OPENVIBE_WITH_WIFI
+    t0 = hal::millis();
+    hal::wifiInit();
+    wifiMs += hal::millis() - t0;
+#endif
+
     // ── BLE ──────────────────────────────────────────────────────────
-    WiFi.mode(WIFI_STA);
-    String deviceId = base64::encode(WiFi.macAddress());
+#if OPENVIBE_WITH_BLE
+    t0 = hal::millis();
+    String deviceId = base64::encode(hal::macAddress());
     String fullName = cfg.getDeviceName() + "-" + deviceId.substring(0, 8);
 
     bleMgr = new BLEManager();
     bleMgr->begin(fullName);
+    bleMs = hal::millis() - t0;
+#endif
 
     // ── WiFi ─────────────────────────────────────────────────────────
+#if OPENVIBE_WITH_WIFI
+    t0 = hal::millis();
     wifiMgr = new WiFiManager();
-    wifiMgr->scanNetworks();
     wifiMgr->begin();
+    wifiMs += hal::millis() - t0;
+#endif
 
     // ── Restore transport ────────────────────────────────────────────
     int savedTransport = cfg.getLastTransport();
-    if (savedTransport >= TRANSPORT_BLE && savedTransport <= TRANSPORT_REMOTE) {
+    if (savedTransport >= TRANSPORT_BLE && savedTransport <= TRANSPORT_AUTO) {
         stats.transport = static_cast<TransportMode>(savedTransport);
     }
+    // Saved (or default) transport not in this build: the first that is.
+    if (!transportBuilt(stats.transport)) {
+        for (int t = TRANSPORT_BLE; t <= TRANSPORT_REMOTE; ++t) {
+            if (!transportBuilt(static_cast<TransportMode>(t))) continue;
+            stats.transport = static_cast<TransportMode>(t);
+            break;
+        }
+    }
+#if OPENVIBE_WITH_REMOTE
+    remoteEnabled = WiFiManager::wantsRemote(stats.transport);
+#endif
+
+    // ── Power profile (needs the Wi-Fi driver up for modem sleep) ────
+    power.begin(static_cast<PowerProfile>(cfg.getPowerProfile()));
+
+    // ── Telemetry rates (defaults unless overridden in NVS) ──────────
+    for (int ch = TRANSPORT_BLE; ch <= TRANSPORT_REMOTE; ++ch) {
+        TelemetryRate rate = telemetry.getRate(static_cast<TransportMode>(ch));
+        if (cfg.getTelemetryRate(ch, rate.minIntervalMs, rate.heartbeatMs)) {
+            telemetry.setRate(static_cast<TransportMode>(ch), rate);
+        }
+    }
 
     // ── Pre-cache slow stats ─────────────────────────────────────────
-    stats.macAddress = WiFi.macAddress();
+    stats.macAddress = hal::macAddress();
     stats.version    = "1.0.0";
+
+    TraceRecorder::getInstance().recordBoot(stats.transport, stats.version);
+
+    // Since the application started (ROM and bootloader not included).
+    LOG_I(SYS, "[Boot] Ready in %u ms (BLE %u ms, Wi-Fi %u ms)\n",
+               (unsigned)hal::millis(), (unsigned)bleMs, (unsigned)wifiMs);
 }
 
 void DeviceContext::loop() {
-    // ── Motor PWM ────────────────────────────────────────────────────
-    analogWrite(MOTOR_PWM_PIN, map(stats.intensity, 0, 100, 0, 255));
+    service();
+
+    // A pass that handled input goes round again at once: more frames
+    // may already sit in a library's buffer, where no wake-up sees them.
+    uint32_t frames = CommandProcessor::getInstance().frameCount()
+                    + OtaManager::getInstance().chunkCount();
+    bool     busy   = frames != busyFrames;
+    busyFrames      = frames;
+
+#if OPENVIBE_WITH_WIFI
+    bool sockets = wifiMgr && wifiMgr->hasOpenSockets();
+#else
+    bool sockets = false;
+#endif
+    power.idle(busy ? 0 : msUntilNextWork(), sockets);
+}
+
+void DeviceContext::service() {
+    // ── Subsystem ticks ──────────────────────────────────────────────
+#if OPENVIBE_WITH_WIFI
+    if (wifiMgr) wifiMgr->loop();
+#endif
+#if OPENVIBE_WITH_BLE
+    if (bleMgr)  bleMgr->loop();
+#endif
+    console.loop();
+    TraceRecorder::getInstance().loop();
+    OtaManager::getInstance().loop();
+
+    // ── Motor PWM (patterns; only changed channels are written) ──────
+    motors.update(stats.levels, hal::millis());
 
     // ── LED tracks BLE connection ────────────────────────────────────
-    static bool lastLed = false;
     if (stats.isBluetoothConnected != lastLed) {
         lastLed = stats.isBluetoothConnected;
-        digitalWrite(LED_PIN, lastLed ? HIGH : LOW);
+        hal::gpioWrite(LED_PIN, lastLed);
     }
 
-    // ── Subsystem ticks ──────────────────────────────────────────────
-    if (wifiMgr) wifiMgr->loop();
+    // ── Link health and route (TRANSPORT_AUTO) ───────────────────────
+    serviceSession();
+
+    // ── Rate-limited status broadcast ────────────────────────────────
+    serviceTelemetry();
+
+    // ── Remote away: record changes; back: replay them ───────────────
+    serviceEvents();
+
+    // ── One history sample per second ────────────────────────────────
+    serviceHistory();
+}
 
-    // ── Pending status broadcast ─────────────────────────────────────
-    if (statusBroadcastRequested) {
-        statusBroadcastRequested = false;
-        broadcastStats();
+// Earliest deadline of any timed job; everything else wakes the loop.
+uint32_t DeviceContext::msUntilNextWork() {
+    uint32_t now  = hal::millis();
+    uint32_t wait = TraceRecorder::getInstance().msUntilNextWork(now);
+
+    uint32_t o = OtaManager::getInstance().msUntilNextWork(now);
+    if (o < wait) wait = o;
+
+    uint32_t m = motors.msUntilNextWork(stats.levels, now);
+    if (m < wait) wait = m;
+
+#if OPENVIBE_WITH_WIFI
+    if (wifiMgr) {
+        uint32_t w = wifiMgr->msUntilNextWork(now);
+        if (w < wait) wait = w;
+    }
+#endif
+
+#if OPENVIBE_WITH_BLE
+    if (bleMgr) {
+        uint32_t b = bleMgr->msUntilNextWork(now);
+        if (b < wait) wait = b;
+    }
+#endif
+
+#if OPENVIBE_WITH_REMOTE
+    if (wifiMgr && wifiMgr->isRemoteConnected()) {
+        uint32_t e = events.msUntilBatch(now);
+        if (e < wait) wait = e;
+    }
+#endif
+
+    uint32_t s = SessionManager::getInstance().msUntilNextWork(now);
+    if (s < wait) wait = s;
+
+    uint32_t h = history.msUntilSample(now);
+    if (h < wait) wait = h;
+
+    uint8_t available = availableTelemetryChannels();
+    if (available) {
+        refreshDeviceStats();
+        uint32_t t = telemetry.msUntilDue(stats, available, now);
+        if (t < wait) wait = t;
     }
-    // delay(10) removed for higher responsiveness
+    return wait;
 }
 
 // ── State ────────────────────────────────────────────────────────────
@@ -83,13 +238,33 @@ void DeviceContext::setTransport(TransportMode mode) {
 
     TransportMode old = stats.transport;
     stats.transport = mode;
+    TraceRecorder::getInstance().recordState(TRACE_TRANSPORT, old, mode);
 
+#if OPENVIBE_WITH_WIFI
     if (wifiMgr) wifiMgr->handleTransportChange(old, mode);
+#endif
+#if OPENVIBE_WITH_REMOTE
+    remoteEnabled = WiFiManager::wantsRemote(mode);
+#endif
 
     // Persist
     ConfigManager::getInstance().setLastTransport(static_cast<int>(mode));
 }
 
+// ── Motors ───────────────────────────────────────────────────────────
+
+bool DeviceContext::setIntensity(int channel, int level) {
+    if (channel < -1 || channel >= stats.channelCount) return false;
+
+    uint8_t v     = (uint8_t)constrain(level, 0, 100);
+    uint8_t first = channel < 0 ? 0 : channel;
+    uint8_t last  = channel < 0 ? stats.channelCount : channel + 1;
+    for (uint8_t i = first; i < last; ++i) stats.levels[i] = v;
+    return true;
+}
+
+MotorBank& DeviceContext::getMotors() { return motors; }
+
 // ── Subsystem access ─────────────────────────────────────────────────
 
 WiFiManager* DeviceContext::getWiFiManager() { return wifiMgr; }
@@ -97,47 +272,63 @@ BLEManager*  DeviceContext::getBLEManager()  { return bleMgr;  }
 
 // ── Lifecycle events ─────────────────────────────────────────────────
 
+#if OPENVIBE_WITH_WIFI
 void DeviceContext::onWiFiConnected() {
     stats.isWifiConnected = true;
-    stats.ipAddress       = WiFi.localIP().toString();
-    Serial.print("WiFi connected – IP: ");
-    Serial.println(stats.ipAddress);
+    stats.ipAddress       = hal::wifiLocalIP();
+    LOG_I(SYS, "WiFi connected – IP: %s\n", stats.ipAddress.c_str());
 }
 
 void DeviceContext::onWiFiDisconnected() {
     stats.isWifiConnected = false;
     stats.ipAddress       = "";
-    Serial.println("WiFi disconnected");
+    LOG_I(SYS, "WiFi disconnected\n");
 }
+#endif
 
 void DeviceContext::onBLEConnected() {
     stats.isBluetoothConnected = true;
-    Serial.println("BLE client connected");
+    LOG_I(SYS, "BLE client connected\n");
 }
 
 void DeviceContext::onBLEDisconnected() {
     stats.isBluetoothConnected = false;
-    Serial.println("BLE client disconnected");
+    LOG_I(SYS, "BLE client disconnected\n");
 }
 
 // ── Stats ────────────────────────────────────────────────────────────
 
 void DeviceContext::requestStatusBroadcast() {
-    statusBroadcastRequested = true;
+    telemetry.requestImmediate();
+}
+
+void DeviceContext::setTelemetryRate(TransportMode channel, const TelemetryRate& rate) {
+    telemetry.setRate(channel, rate);
+    ConfigManager::getInstance().setTelemetryRate(
+        static_cast<int>(channel), rate.minIntervalMs, rate.heartbeatMs);
+}
+
+const TelemetryRate& DeviceContext::getTelemetryRate(TransportMode channel) const {
+    return telemetry.getRate(channel);
 }
 
 void DeviceContext::refreshDeviceStats() {
-    stats.isWifiConnected = (WiFi.status() == WL_CONNECTED);
-    stats.ipAddress       = stats.isWifiConnected ? WiFi.localIP().toString() : String("");
+#if OPENVIBE_WITH_WIFI
+    bool connected = hal::wifiIsConnected();
+    if (connected != stats.isWifiConnected || (connected && stats.ipAddress.isEmpty())) {
+        stats.isWifiConnected = connected;
+        stats.ipAddress       = connected ? hal::wifiLocalIP() : String("");
+    }
+#endif
     // macAddress is cached in setup()
 
-    stats.battery    = 100;
-    stats.isCharging = false;
+    if (battery && battery->hasSensor()) stats.battery = battery->getPercent();
+    stats.isCharging = battery && battery->isCharging();
 }
 
 String DeviceContext::buildStatusJson() const {
     JsonDocument doc;
-    doc["intensity"]             = stats.intensity;
+    doc["intensity"]             = stats.levels[0];
     doc["battery"]               = stats.battery;
     doc["isCharging"]            = stats.isCharging;
     doc["isBluetoothConnected"]  = stats.isBluetoothConnected;
@@ -145,33 +336,230 @@ String DeviceContext::buildStatusJson() const {
     doc["ipAddress"]             = stats.ipAddress;
     doc["macAddress"]            = stats.macAddress;
     doc["version"]               = stats.version;
-    doc["deviceId"]              = String((uint32_t)ESP.getEfuseMac(), HEX);
+    doc["deviceId"]              = hal::deviceId();
 
-    switch (stats.transport) {
-        case TRANSPORT_WIFI:   doc["transport"] = "WIFI";   break;
-        case TRANSPORT_REMOTE: doc["transport"] = "REMOTE"; break;
-        default:               doc["transport"] = "BLE";    break;
+    doc["transport"]             = CommandProcessor::transportName(stats.transport);
+
+    SessionManager& session = SessionManager::getInstance();
+    if (stats.transport == TRANSPORT_AUTO && session.hasRoute()) {
+        doc["route"] = CommandProcessor::transportName(session.route());
+    }
+
+    if (stats.channelCount > 1) {
+        JsonArray levels = doc["channels"].to<JsonArray>();
+        for (uint8_t i = 0; i < stats.channelCount; ++i) levels.add(stats.levels[i]);
     }
 
-    if (stats.transport == TRANSPORT_REMOTE && !stats.serverAddress.isEmpty()) {
+    if ((stats.transport == TRANSPORT_REMOTE || stats.transport == TRANSPORT_AUTO) &&
+        !stats.serverAddress.isEmpty()) {
         doc["serverAddress"] = stats.serverAddress;
     }
 
     String out;
     serializeJson(doc, out);
-    Serial.println(out);
     return out;
 }
 
-void DeviceContext::broadcastStats() {
+void DeviceContext::buildStatusMsgPack(MsgPackWriter& out) const {
+    out.reset();
+    SessionManager& session = SessionManager::getInstance();
+    bool routed = stats.transport == TRANSPORT_AUTO && session.hasRoute();
+    wire::encodeStatus(out, stats, hal::deviceId(), routed ? (int)session.route() : -1);
+}
+
+// In AUTO status only goes out on the route (none while there is no
+// healthy link); when the route moves, the scheduler sees a channel
+// come up and pushes to it at once.
+uint8_t DeviceContext::availableTelemetryChannels() const {
+    uint8_t links = connectedLinks();
+    if (stats.transport != TRANSPORT_AUTO) return links;
+
+    SessionManager& session = SessionManager::getInstance();
+    return session.hasRoute() ? links & TelemetryScheduler::channelBit(session.route()) : 0;
+}
+
+uint8_t DeviceContext::connectedLinks() const {
+    uint8_t mask = 0;
+    if (bleMgr && stats.isBluetoothConnected) {
+        mask |= TelemetryScheduler::channelBit(TRANSPORT_BLE);
+    }
+#if OPENVIBE_WITH_WIFI
+    if (wifiMgr && wifiMgr->hasLocalClients()) {
+        mask |= TelemetryScheduler::channelBit(TRANSPORT_WIFI);
+    }
+    if (wifiMgr && wifiMgr->isRemoteConnected()) {
+        mask |= TelemetryScheduler::channelBit(TRANSPORT_REMOTE);
+    }
+#endif
+    return mask;
+}
+
+void DeviceContext::serviceTelemetry() {
+    uint8_t  available = availableTelemetryChannels();
+    uint32_t now       = hal::millis();
+
+    // Nothing can go out yet — skip the stats refresh entirely.
+    if (!telemetry.anyWindowOpen(available, now)) return;
+
     refreshDeviceStats();
+    uint8_t due = telemetry.due(stats, available, now);
+    if (!due) return;
+
+    // Serialise once, fan out to every due channel.  The MessagePack
+    // form is only built when a WebSocket peer asked for it.
     String json = buildStatusJson();
+    LOG_D(TLM, "%s\n", json.c_str());
 
-    if (stats.isBluetoothConnected && bleMgr) {
+#if OPENVIBE_WITH_BLE
+    if (due & TelemetryScheduler::channelBit(TRANSPORT_BLE)) {
         bleMgr->updateStats(json);
     }
+#endif
+
+#if OPENVIBE_WITH_WIFI
+    uint8_t            wsDue  = due & (TelemetryScheduler::channelBit(TRANSPORT_WIFI) |
+                                       TelemetryScheduler::channelBit(TRANSPORT_REMOTE));
+    wire::StatusBuffer binary;
+    bool               hasBin = wsDue && wifiMgr->wantsBinaryStatus();
+    if (hasBin) buildStatusMsgPack(binary);
+
+    if (due & TelemetryScheduler::channelBit(TRANSPORT_WIFI)) {
+        wifiMgr->sendStatsLocal(json, hasBin ? &binary : nullptr);
+    }
+    if (due & TelemetryScheduler::channelBit(TRANSPORT_REMOTE)) {
+        wifiMgr->sendStatsRemote(json, hasBin ? &binary : nullptr);
+    }
+#endif
+
+    telemetry.markSent(due, stats, now);
+
+    SessionManager& session = SessionManager::getInstance();
+    for (uint8_t i = 0; i < SessionManager::LINK_COUNT; ++i) {
+        if (due & (1u << i)) session.delivered((TransportMode)i, now);
+    }
+}
 
-    if (stats.transport != TRANSPORT_BLE && wifiMgr) {
-        wifiMgr->sendStats(json);
+// ── Session ──────────────────────────────────────────────────────────
+
+// Feeds the connected links to SessionManager and, in AUTO, sends the
+// probes it asks for: {"type":"probe","seq":n}, or MSG_PROBE to
+// MessagePack peers.
+void DeviceContext::serviceSession() {
+    SessionManager& session = SessionManager::getInstance();
+    uint32_t        now     = hal::millis();
+
+    session.update(connectedLinks(), stats.transport == TRANSPORT_AUTO, now);
+
+    uint8_t due = session.probesDue(now);
+    for (uint8_t i = 0; due && i < SessionManager::LINK_COUNT; ++i) {
+        if (!(due & (1u << i))) continue;
+        TransportMode link = (TransportMode)i;
+        uint32_t      seq  = session.takeProbe(link, now);
+
+        JsonDocument doc;
+        doc["type"] = "probe";
+        doc["seq"]  = seq;
+        String json;
+        serializeJson(doc, json);
+
+#if OPENVIBE_WITH_BLE
+        if (link == TRANSPORT_BLE) bleMgr->sendProbe(json);
+#endif
+#if OPENVIBE_WITH_WIFI
+        if (link == TRANSPORT_BLE) continue;
+        wire::StatusBuffer binary;
+        bool               hasBin = wifiMgr->wantsBinaryStatus();
+        if (hasBin) wire::encodeProbe(binary, seq);
+        if (link == TRANSPORT_WIFI)   wifiMgr->sendStatsLocal(json, hasBin ? &binary : nullptr);
+        if (link == TRANSPORT_REMOTE) wifiMgr->sendStatsRemote(json, hasBin ? &binary : nullptr);
+#endif
     }
 }
+
+// ── Buffered events ──────────────────────────────────────────────────
+
+// While the remote client is enabled (REMOTE, or AUTO with a URL) but
+// has no server, every pass diffs the stats into the buffer (battery
+// and link changes wake the loop, commands do too).
+// Once it is connected, one batch per EventBuffer::FLUSH_MS goes out
+// after the pass's status push.
+void DeviceContext::serviceEvents() {
+#if OPENVIBE_WITH_REMOTE
+    if (!wifiMgr) return;
+    uint32_t now = hal::millis();
+
+    if (!wifiMgr->isRemoteConnected()) {
+        if (!remoteEnabled) {
+            events.stopTracking();
+            return;
+        }
+        refreshDeviceStats();
+        events.track(stats, now);
+        return;
+    }
+
+    events.stopTracking();
+    if (events.msUntilBatch(now)) return;
+
+    BufferedEvent batch[EventBuffer::BATCH];
+    size_t        n       = events.peek(batch, EventBuffer::BATCH);
+    uint32_t      dropped = events.counters().dropped;
+    if (!n) return;
+
+    bool   sent;
+    size_t bytes;
+    if (wifiMgr->remoteWantsBinary()) {
+        wire::EventsBuffer binary;
+        wire::encodeEvents(binary, batch, n, now, dropped);
+        sent  = wifiMgr->sendEventsRemote(String(), &binary);
+        bytes = binary.size();
+    } else {
+        String json = EventBuffer::encodeJson(batch, n, now, dropped);
+        sent  = wifiMgr->sendEventsRemote(json, nullptr);
+        bytes = json.length();
+    }
+    // A batch that did not go out is retried FLUSH_MS later.
+    events.consume(sent ? n : 0, sent ? bytes : 0, now);
+#endif
+}
+
+#if OPENVIBE_WITH_REMOTE
+const EventBuffer& DeviceContext::getEvents() const { return events; }
+#endif
+
+// ── History ──────────────────────────────────────────────────────────
+
+// Links here are the radios that are up (BLE central, station
+// associated, remote server), not who receives status.
+void DeviceContext::serviceHistory() {
+    uint32_t now = hal::millis();
+    if (history.msUntilSample(now)) return;
+
+    refreshDeviceStats();
+    HistoryStore::Sample s;
+    s.level   = stats.levels[0];
+    s.battery = (uint8_t)constrain(stats.battery, 0, 100);
+    s.rssi    = 0;
+    s.links   = stats.isBluetoothConnected ? TelemetryScheduler::channelBit(TRANSPORT_BLE) : 0;
+#if OPENVIBE_WITH_WIFI
+    if (stats.isWifiConnected) {
+        s.rssi   = hal::wifiRssi();
+        s.links |= TelemetryScheduler::channelBit(TRANSPORT_WIFI);
+    }
+    if (wifiMgr && wifiMgr->isRemoteConnected()) {
+        s.links |= TelemetryScheduler::channelBit(TRANSPORT_REMOTE);
+    }
+#endif
+    history.record(s, now);
+}
+
+const HistoryStore& DeviceContext::getHistory() const { return history; }
+
+// ── Power ────────────────────────────────────────────────────────────
+
+void DeviceContext::setPowerProfile(PowerProfile profile) {
+    if (!power.setProfile(profile)) return;
+    ConfigManager::getInstance().setPowerProfile(static_cast<int>(profile));
+}
+
+const PowerManager& DeviceContext::getPower() const { return power; }
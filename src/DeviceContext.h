@@ -2,18 +2,34 @@
 #define DEVICE_CONTEXT_H
 
 #include <Arduino.h>
-#include <WiFi.h>
 #include "../include/types/device_stats.h"
+#include "telemetry/TelemetryScheduler.h"
+#include "power/PowerManager.h"
+#include "commands/SerialConsole.h"
+#include "motor/MotorBank.h"
+#include "telemetry/HistoryStore.h"
+#include "Features.h"
+#if OPENVIBE_WITH_REMOTE
+#include "telemetry/EventBuffer.h"
+#endif
 
 // Forward-declare subsystems — headers included only in .cpp
 class WiFiManager;
 class BLEManager;
+class BatteryMonitor;
+class MsgPackWriter;
 
 /**
  * Central owner of all runtime state and subsystem pointers.
  *
  * Subsystems (WiFiManager, BLEManager) read/write DeviceStats through
- * this singleton rather than through scattered globals.
+ * this singleton rather than through scattered globals.  Either may be
+ * compiled out (Features.h); its pointer then stays null.
+ *
+ * loop() is service() — one pass over every subsystem — followed by an
+ * idle wait until the earliest timed job or a hal::wake() (see
+ * PowerManager).  Harnesses that pace the loop themselves call
+ * service() directly.
  */
 class DeviceContext {
 public:
@@ -21,12 +37,19 @@ public:
 
     void setup();
     void loop();
+    void service();
 
     // ── State ────────────────────────────────────────────────────────
     DeviceStats&  getStats();
     TransportMode getTransport() const;
     void          setTransport(TransportMode mode);
 
+    // ── Motors ───────────────────────────────────────────────────────
+    // Level clamped to 0–100; `channel` -1 = every channel.  False if
+    // the channel does not exist.
+    bool       setIntensity(int channel, int level);
+    MotorBank& getMotors();
+
     // ── Subsystem access ─────────────────────────────────────────────
     WiFiManager* getWiFiManager();
     BLEManager*  getBLEManager();
@@ -40,6 +63,23 @@ public:
     // ── Stats broadcast ──────────────────────────────────────────────
     void requestStatusBroadcast();
     String buildStatusJson() const;
+    void   buildStatusMsgPack(MsgPackWriter& out) const;   // binary-protocol peers
+
+    // ── Telemetry rate (persisted) ───────────────────────────────────
+    void                 setTelemetryRate(TransportMode channel, const TelemetryRate& rate);
+    const TelemetryRate& getTelemetryRate(TransportMode channel) const;
+
+    // ── Power profile (persisted) ────────────────────────────────────
+    void                setPowerProfile(PowerProfile profile);
+    const PowerManager& getPower() const;
+
+    // ── Recorded history (HISTORY, GET /history) ─────────────────────
+    const HistoryStore& getHistory() const;
+
+#if OPENVIBE_WITH_REMOTE
+    // ── Events buffered while the remote is away ─────────────────────
+    const EventBuffer& getEvents() const;
+#endif
 
 private:
     DeviceContext();
@@ -47,18 +87,34 @@ private:
     DeviceContext& operator=(const DeviceContext&) = delete;
 
     DeviceStats  stats;
-    WiFiManager* wifiMgr;
-    BLEManager*  bleMgr;
+    WiFiManager*    wifiMgr;
+    BLEManager*     bleMgr;
+    BatteryMonitor* battery;
+
+    TelemetryScheduler telemetry;
+    PowerManager       power;
+    SerialConsole      console;
+    MotorBank          motors;
+    HistoryStore       history;
+#if OPENVIBE_WITH_REMOTE
+    EventBuffer        events;
+    bool               remoteEnabled;   // WiFiManager::wantsRemote(), kept per transport change
+#endif
 
-    bool statusBroadcastRequested;
+    bool     lastLed;
+    uint32_t busyFrames; // frames + OTA chunks handled, after the last pass
 
     // ── Helpers ──────────────────────────────────────────────────────
-    void refreshDeviceStats();
-    void broadcastStats();
+    void     refreshDeviceStats();
+    uint8_t  availableTelemetryChannels() const;
+    uint8_t  connectedLinks() const;
+    void     serviceSession();
+    void     serviceTelemetry();
+    void     serviceEvents();
+    void     serviceHistory();
+    uint32_t msUntilNextWork();
 
-    // Motor
-    static constexpr int MOTOR_PWM_PIN = 4;
-    static constexpr int LED_PIN       = 2;
+    static constexpr int LED_PIN = 2;
 };
 
 #endif // DEVICE_CONTEXT_H
@@ -0,0 +1,58 @@
+#ifndef FEATURES_H
+#define FEATURES_H
+
+#include "../include/types/device_stats.h"
+
+// ── Subsystems ───────────────────────────────────────────────────────
+// Each is 1 (built, the default) or 0 (compiled out: its code, its
+// objects and — with the variant envs' lib_ignore — its library are
+// gone from the image).  Set them per build environment, e.g.
+//   build_flags = -DOPENVIBE_WITH_WS=0 -DOPENVIBE_WITH_REST=0 -DOPENVIBE_WITH_REMOTE=0
+#ifndef OPENVIBE_WITH_BLE         // BLE service (TRANSPORT_BLE)
+#define OPENVIBE_WITH_BLE    1
+#endif
+#ifndef OPENVIBE_WITH_WS          // local WebSocket server (TRANSPORT_WIFI)
+#define OPENVIBE_WITH_WS     1
+#endif
+#ifndef OPENVIBE_WITH_REST        // HTTP API, including POST /ota
+#define OPENVIBE_WITH_REST   1
+#endif
+#ifndef OPENVIBE_WITH_REMOTE      // WebSocket client (TRANSPORT_REMOTE)
+#define OPENVIBE_WITH_REMOTE 1
+#endif
+
+// The Wi-Fi station (WiFiManager, hal::wifi*) exists for any of the three.
+#define OPENVIBE_WITH_WIFI (OPENVIBE_WITH_WS || OPENVIBE_WITH_REST || OPENVIBE_WITH_REMOTE)
+
+#if !OPENVIBE_WITH_BLE && !OPENVIBE_WITH_WIFI
+#error "OpenVibe needs BLE or at least one Wi-Fi subsystem"
+#endif
+
+// DNS-SD advertisement of the local servers (on with Wi-Fi by default).
+#ifndef OPENVIBE_WITH_MDNS
+#define OPENVIBE_WITH_MDNS OPENVIBE_WITH_WIFI
+#endif
+#if OPENVIBE_WITH_MDNS && !OPENVIBE_WITH_WIFI
+#error "OPENVIBE_WITH_MDNS needs a Wi-Fi subsystem"
+#endif
+
+// Control page served by the HTTP API (on with it by default).
+#ifndef OPENVIBE_WITH_WEBUI
+#define OPENVIBE_WITH_WEBUI OPENVIBE_WITH_REST
+#endif
+#if OPENVIBE_WITH_WEBUI && !OPENVIBE_WITH_REST
+#error "OPENVIBE_WITH_WEBUI needs OPENVIBE_WITH_REST"
+#endif
+
+/** Whether `mode` can be selected in this build. */
+inline bool transportBuilt(TransportMode mode) {
+    switch (mode) {
+        case TRANSPORT_BLE:    return OPENVIBE_WITH_BLE;
+        case TRANSPORT_WIFI:   return OPENVIBE_WITH_WS;
+        case TRANSPORT_REMOTE: return OPENVIBE_WITH_REMOTE;
+        case TRANSPORT_AUTO:   return OPENVIBE_WITH_BLE + OPENVIBE_WITH_WS + OPENVIBE_WITH_REMOTE >= 2;
+    }
+    return false;
+}
+
+#endif // FEATURES_H
@@ -1,18 +1,41 @@
+#include "../Features.h"
+#if OPENVIBE_WITH_BLE
+
 #include "BLECallbacks.h"
 #include "../DeviceContext.h"
-#include "../ConfigManager.h"
-#include "../wifi/WiFiManager.h"
-#include <ArduinoJson.h>
+#include "BLEManager.h"
+#include "../log/Logger.h"
 
 // ── Server connect / disconnect ──────────────────────────────────────
 
-void BLEServerHandler::onConnect(BLEServer* server) {
+void BLEServerHandler::onConnect(BLEServer* server, esp_ble_gatts_cb_param_t* param) {
     DeviceContext::getInstance().onBLEConnected();
+    BLEManager* ble = DeviceContext::getInstance().getBLEManager();
+    if (ble) {
+        const esp_gatt_conn_params_t& p = param->connect.conn_params;
+        ble->centralConnected(param->connect.remote_bda, p.interval, p.latency, p.timeout);
+    }
+    hal::wake();   // LED + first status
 }
 
 void BLEServerHandler::onDisconnect(BLEServer* server) {
+    BLEManager* ble = DeviceContext::getInstance().getBLEManager();
+    if (ble) ble->centralDisconnected();
     DeviceContext::getInstance().onBLEDisconnected();
     BLEDevice::startAdvertising();   // resume advertising
+    hal::wake();
+}
+
+// What the central settled on, after our request or on its own.
+void BLEServerHandler::onGapEvent(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param) {
+    if (event != ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT) return;
+    const auto& u = param->update_conn_params;
+    if (u.status != ESP_BT_STATUS_SUCCESS) {
+        LOG_W(BLE, "[BLE] Connection parameter update failed (%d)\n", (int)u.status);
+        return;
+    }
+    BLEManager* ble = DeviceContext::getInstance().getBLEManager();
+    if (ble) ble->connParamsUpdated(u.conn_int, u.latency, u.timeout);
 }
 
 // ── Write handler for the WiFi / command characteristic ──────────────
@@ -21,60 +44,9 @@ void WiFiConfigCharacteristicHandler::onWrite(BLECharacteristic* characteristic)
     std::string raw = characteristic->getValue();
     if (raw.empty()) return;
 
-    Serial.printf("[BLE] Received: %s\n", raw.c_str());
-
-    JsonDocument doc;
-    if (deserializeJson(doc, raw.c_str())) {
-        Serial.println("[BLE] JSON parse failed");
-        return;
-    }
-
-    DeviceContext& ctx = DeviceContext::getInstance();
-    ConfigManager& cfg = ConfigManager::getInstance();
-
-    const char* req = doc["requestType"];
-    if (!req) return;
-
-    // ── STATUS ───────────────────────────────────────────────────────
-    if (strcmp(req, "STATUS") == 0) {
-        ctx.requestStatusBroadcast();
-    }
-    // ── INTENSITY ────────────────────────────────────────────────────
-    else if (strcmp(req, "INTENSITY") == 0) {
-        int val = doc["intensity"].as<int>();
-        ctx.getStats().intensity = constrain(val, 0, 100);
-        Serial.printf("[BLE] Intensity → %d\n", ctx.getStats().intensity);
-    }
-    // ── WIFI_CREDENTIALS (non-blocking!) ─────────────────────────────
-    else if (strcmp(req, "WIFI_CREDENTIALS") == 0) {
-        const char* ssid = doc["ssid"];
-        const char* pass = doc["password"];
-        if (!ssid) return;
-
-        Serial.printf("[BLE] Saving WiFi creds for \"%s\"\n", ssid);
-        cfg.setWiFiCredentials(ssid, pass ? pass : "");
-
-        WiFiManager* wifi = ctx.getWiFiManager();
-        if (wifi) wifi->connect();   // returns immediately
-    }
-    // ── SWITCH_TRANSPORT ─────────────────────────────────────────────
-    else if (strcmp(req, "SWITCH_TRANSPORT") == 0) {
-        const char* t = doc["transport"];
-        if (!t) return;
-
-        TransportMode mode = ctx.getTransport();
-        if      (strcmp(t, "BLE")    == 0) mode = TRANSPORT_BLE;
-        else if (strcmp(t, "WIFI")   == 0) mode = TRANSPORT_WIFI;
-        else if (strcmp(t, "REMOTE") == 0) {
-            mode = TRANSPORT_REMOTE;
-            const char* addr = doc["serverAddress"];
-            if (addr) {
-                cfg.setRemoteServer(addr);
-                ctx.getStats().serverAddress = String(addr);
-            }
-        }
-
-        ctx.setTransport(mode);
-        Serial.printf("[BLE] Transport → %s\n", t);
-    }
+    LOG_D(BLE, "[BLE] Received: %s\n", raw.c_str());
+    BLEManager* ble = DeviceContext::getInstance().getBLEManager();
+    if (ble) ble->queueWrite((const uint8_t*)raw.data(), raw.size());
 }
+
+#endif // OPENVIBE_WITH_BLE
@@ -12,7 +12,12 @@
  * DeviceContext so that no global variables are required.
  */
 class BLEServerHandler : public BLEServerCallbacks {
-    void onConnect(BLEServer* server) override;
+public:
+    // Connection parameter updates (BLEDevice::setCustomGapHandler).
+    static void onGapEvent(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param);
+
+private:
+    void onConnect(BLEServer* server, esp_ble_gatts_cb_param_t* param) override;
     void onDisconnect(BLEServer* server) override;
 };
 
@@ -1,12 +1,30 @@
+#include "../Features.h"
+#if OPENVIBE_WITH_BLE
+
 #include "BLEManager.h"
 #include "BLECallbacks.h"
 #include "../DeviceContext.h"
+#include "../commands/CommandProcessor.h"
+#include "../commands/RateLimiter.h"
+#include "../hal/Hal.h"
+#include "../log/Logger.h"
+#include <BLEDevice.h>
+#include <BLEUtils.h>
+#include <BLEServer.h>
 
 BLEManager::BLEManager()
     : pServer(nullptr)
     , pService(nullptr)
     , pWiFiChar(nullptr)
-    , pStatsChar(nullptr) {}
+    , pStatsChar(nullptr)
+    , pendingHead(0)
+    , pendingCount(0)
+    , session(0)
+    , peer{}
+    , peerUp(false)
+    , peerEpoch(0)
+    , seenEpoch(0)
+    , grantPending(false) {}
 
 void BLEManager::begin(const String& deviceName) {
     BLEDevice::init(deviceName.c_str());
@@ -18,9 +36,9 @@ void BLEManager::begin(const String& deviceName) {
     // ── Service ──────────────────────────────────────────────────────
     pService = pServer->createService(SERVICE_UUID);
 
-    // ── WiFi-config characteristic (write-only by client) ────────────
+    // ── WiFi-config / command characteristic (write; read = last reply)
     pWiFiChar = pService->createCharacteristic(
-        WIFI_CHAR_UUID, BLECharacteristic::PROPERTY_WRITE);
+        WIFI_CHAR_UUID, BLECharacteristic::PROPERTY_WRITE | BLECharacteristic::PROPERTY_READ);
     pWiFiChar->setCallbacks(new WiFiConfigCharacteristicHandler());
 
     // ── Stats characteristic (notify + read) ─────────────────────────
@@ -37,10 +55,113 @@ void BLEManager::begin(const String& deviceName) {
     BLEAdvertising* adv = BLEDevice::getAdvertising();
     adv->addServiceUUID(SERVICE_UUID);
     adv->setScanResponse(true);
-    adv->setMinPreferred(0x06);
+    // What the link starts on; BLELinkPolicy takes over once connected.
+    adv->setMinPreferred(BLELinkPolicy::PARAMS[BLE_LINK_ACTIVE].minInterval);
+    adv->setMaxPreferred(BLELinkPolicy::PARAMS[BLE_LINK_ACTIVE].maxInterval);
+    BLEDevice::setCustomGapHandler(BLEServerHandler::onGapEvent);
     BLEDevice::startAdvertising();
 
-    Serial.println("[BLE] Advertising as \"" + deviceName + "\"");
+    LOG_I(BLE, "[BLE] Advertising as \"%s\"\n", deviceName.c_str());
+}
+
+void BLEManager::loop() {
+    uint32_t    now = hal::millis();
+    std::string frame;
+    serviceLink(now);
+    while (takeWrite(frame)) {
+        String   ack;
+        uint32_t at = hal::millis();   // one clock for the limiter and the link
+        if (RateLimiter::getInstance().admitJson(SOURCE_BLE, 0, frame.data(), frame.size(), at)) {
+            link.command(at);
+            CommandProcessor::getInstance().handleJson(frame.data(), frame.size(), SOURCE_BLE, &ack,
+                                                       nullptr, &session);
+        }
+        // Always overwrite: the written value may hold a Wi-Fi password.
+        if (pWiFiChar) pWiFiChar->setValue(ack.c_str());
+    }
+}
+
+// ── Connection parameters ────────────────────────────────────────────
+
+void BLEManager::serviceLink(uint32_t now) {
+    bool                   up, reconnected, granted;
+    BLELinkPolicy::Granted g;
+    {
+        hal::LockGuard lock(linkLock);
+        up           = peerUp;
+        reconnected  = peerEpoch != seenEpoch;
+        granted      = grantPending;
+        g            = grant;
+        seenEpoch    = peerEpoch;
+        grantPending = false;
+    }
+
+    if (reconnected || !up) link.disconnected(now);
+    if (reconnected && up) {
+        link.connected(now);
+        session = 0;
+    }
+    if (granted) link.granted(g.interval, g.latency, g.timeout, now);
+
+    BLELinkPolicy::Params p;
+    if (pServer && link.due(now, p)) {
+        LOG_D(BLE, "[BLE] Asking for %s parameters\n", BLELinkPolicy::stateName(link.state()));
+        pServer->updateConnParams(peer, p.minInterval, p.maxInterval, p.latency, p.timeout);
+    }
+}
+
+void BLEManager::centralConnected(const uint8_t addr[6], uint16_t interval, uint16_t latency,
+                                  uint16_t timeout) {
+    {
+        hal::LockGuard lock(linkLock);
+        memcpy(peer, addr, sizeof(peer));
+        peerUp       = true;
+        ++peerEpoch;
+        grant        = { interval, latency, timeout };
+        grantPending = interval != 0;
+    }
+    hal::wake();
+}
+
+void BLEManager::centralDisconnected() {
+    {
+        hal::LockGuard lock(linkLock);
+        peerUp       = false;
+        grantPending = false;
+    }
+    hal::wake();
+}
+
+void BLEManager::connParamsUpdated(uint16_t interval, uint16_t latency, uint16_t timeout) {
+    {
+        hal::LockGuard lock(linkLock);
+        grant        = { interval, latency, timeout };
+        grantPending = true;
+    }
+    hal::wake();
+}
+
+// ── Write queue (Bluedroid task → loop) ──────────────────────────────
+
+void BLEManager::queueWrite(const uint8_t* data, size_t len) {
+    hal::LockGuard g(writeLock);
+    if (pendingCount == WRITE_QUEUE) {
+        LOG_W(BLE, "[BLE] Write queue full — dropped\n");
+        return;
+    }
+    pending[(pendingHead + pendingCount) % WRITE_QUEUE].assign((const char*)data, len);
+    ++pendingCount;
+    hal::wake();
+}
+
+bool BLEManager::takeWrite(std::string& out) {
+    hal::LockGuard g(writeLock);
+    if (pendingCount == 0) return false;
+    out.swap(pending[pendingHead]);
+    pending[pendingHead].clear();
+    pendingHead = (pendingHead + 1) % WRITE_QUEUE;
+    --pendingCount;
+    return true;
 }
 
 void BLEManager::updateStats(const String& jsonStats) {
@@ -49,6 +170,18 @@ void BLEManager::updateStats(const String& jsonStats) {
     pStatsChar->notify();
 }
 
+// Goes out as a stats notification; the characteristic keeps the last
+// status for clients that read it.
+void BLEManager::sendProbe(const String& json) {
+    if (!pStatsChar) return;
+    std::string status = pStatsChar->getValue();
+    pStatsChar->setValue(json.c_str());
+    pStatsChar->notify();
+    pStatsChar->setValue(status);
+}
+
 bool BLEManager::isConnected() const {
     return DeviceContext::getInstance().getStats().isBluetoothConnected;
 }
+
+#endif // OPENVIBE_WITH_BLE
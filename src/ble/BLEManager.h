@@ -2,9 +2,14 @@
 #define BLE_MANAGER_H
 
 #include <Arduino.h>
-#include <BLEDevice.h>
-#include <BLEUtils.h>
-#include <BLEServer.h>
+#include <string>
+#include "../hal/Hal.h"
+#include "../power/BLELinkPolicy.h"
+
+// ESP32 BLE types — only BLEManager.cpp needs the real headers.
+class BLEServer;
+class BLEService;
+class BLECharacteristic;
 
 /**
  * Encapsulates all BLE setup: server, service, characteristics,
@@ -13,20 +18,69 @@
  * Callbacks (BLEServerHandler / WiFiConfigCharacteristicHandler)
  * live in their own translation unit and talk to DeviceContext
  * directly — BLEManager just owns the ESP32 BLE objects.
+ *
+ * Command writes arrive on the Bluedroid task; queueWrite() only
+ * stores them and loop() hands them to CommandProcessor, so a command
+ * (or a whole BATCH) runs on the loop task between telemetry ticks.
+ * The reply to a command with an "id" (and every BATCH reply) becomes
+ * the command characteristic's value, for the client to read back.
+ *
+ * Each command frame also feeds a BLELinkPolicy, and loop() asks the
+ * central for the connection parameters it picks: a short interval
+ * while commands stream, a long one with slave latency once they stop.
+ *
+ * The host build swaps in src/hal/native/BLEManagerSim.cpp, which
+ * implements this same interface over a local TCP line protocol.
  */
 class BLEManager {
 public:
     BLEManager();
     void begin(const String& deviceName);
+    void loop();
     void updateStats(const String& jsonStats);
+    void sendProbe(const String& json);   // notify only; the status value stays
     bool isConnected() const;
 
+    uint32_t             msUntilNextWork(uint32_t now) const { return link.msUntilNextWork(now); }
+    const BLELinkPolicy& linkPolicy() const { return link; }
+
+    // Called from the BLE write callback (any task).
+    void queueWrite(const uint8_t* data, size_t len);
+
+    // Called from the Bluedroid task (BLECallbacks.cpp); loop() applies them.
+    void centralConnected(const uint8_t addr[6], uint16_t interval, uint16_t latency, uint16_t timeout);
+    void centralDisconnected();
+    void connParamsUpdated(uint16_t interval, uint16_t latency, uint16_t timeout);
+
 private:
     BLEServer*         pServer;
     BLEService*        pService;
     BLECharacteristic* pWiFiChar;
     BLECharacteristic* pStatsChar;
 
+    static constexpr uint8_t WRITE_QUEUE = 4;
+
+    hal::Mutex  writeLock;
+    std::string pending[WRITE_QUEUE];
+    uint8_t     pendingHead;
+    uint8_t     pendingCount;
+
+    bool takeWrite(std::string& out);
+
+    BLELinkPolicy link;
+    uint32_t      session;   // the central's seq session (CommandProcessor), 0 on connect
+
+    // Link events from the Bluedroid task, under linkLock
+    hal::Mutex             linkLock;
+    uint8_t                peer[6];
+    bool                   peerUp;
+    uint8_t                peerEpoch;      // +1 per connect
+    uint8_t                seenEpoch;      // ... as applied by loop()
+    bool                   grantPending;
+    BLELinkPolicy::Granted grant;
+
+    void serviceLink(uint32_t now);
+
     static constexpr const char* SERVICE_UUID   = "ec2e0883-782d-433b-9a0c-6d5df5565410";
     static constexpr const char* WIFI_CHAR_UUID = "c2433dd7-137e-4e82-845e-a40f70dc4a8d";
     static constexpr const char* STATS_CHAR_UUID = "c2433dd7-137e-4e82-845e-a40f70dc4a8e";
@@ -0,0 +1,92 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <Arduino.h>
+#include "../../include/types/device_stats.h"
+#include "../telemetry/TelemetryScheduler.h"
+#include "../power/PowerManager.h"
+#include "../motor/MotorBank.h"
+#include "../telemetry/HistoryStore.h"
+
+/**
+ * One decoded inbound command.  The JSON and MessagePack front ends
+ * (CommandProcessor::handleJson / handleMsgPack) both decode into this
+ * struct and CommandProcessor::execute() acts on it, so the two
+ * encodings cannot drift apart.
+ *
+ * Numeric values double as the MessagePack type codes (WireProtocol.h).
+ */
+enum RequestType : uint8_t {
+    REQ_UNKNOWN          = 0,
+    REQ_STATUS           = 1,
+    REQ_INTENSITY        = 2,
+    REQ_WIFI_CREDENTIALS = 3,
+    REQ_SWITCH_TRANSPORT = 4,
+    REQ_TELEMETRY_RATE   = 5,
+    REQ_TRACE            = 6,
+    REQ_BATCH            = 7,
+    REQ_HELLO            = 8,
+    REQ_POWER            = 9,
+    REQ_OTA              = 10,
+    REQ_PATTERN          = 11,
+    REQ_PROBE            = 12,   // reply to a link probe (SessionManager.h)
+    REQ_SCAN             = 13,   // cached Wi-Fi networks (WiFiScanCache.h)
+    REQ_HISTORY          = 14    // recorded stats over a range (HistoryStore.h)
+};
+
+enum TraceAction : uint8_t {
+    TRACE_ACTION_START = 0,
+    TRACE_ACTION_STOP  = 1,
+    TRACE_ACTION_CLEAR = 2,
+    TRACE_ACTION_FLUSH = 3,
+    TRACE_ACTION_DUMP  = 4
+};
+
+enum OtaAction : uint8_t {
+    OTA_ACTION_BEGIN  = 0,
+    OTA_ACTION_FINISH = 1,
+    OTA_ACTION_ABORT  = 2,
+    OTA_ACTION_STATUS = 3,
+    OTA_ACTION_KEY    = 4    // serial only: provision the signing key
+};
+
+/** Per-connection encoding, switched by HELLO. */
+enum WireEncoding : uint8_t {
+    WIRE_JSON    = 0,
+    WIRE_MSGPACK = 1
+};
+
+struct Command {
+    RequestType   type      = REQ_UNKNOWN;
+    bool          valid     = true;    // false → CMD_INVALID, nothing executed
+    uint32_t      seq       = 0;       // session sequence number (dedupe), or PROBE echo
+    bool          hasSeq    = false;
+
+    int           intensity = 0;                  // INTENSITY (every channel, or `channel`)
+    int           channel   = -1;                 // INTENSITY / PATTERN, -1 = every channel
+    uint8_t       levels[MAX_MOTOR_CHANNELS] = {};  // INTENSITY per channel, from channel 0
+    uint8_t       levelCount = 0;                 //   0 = use `intensity`
+    MotorPattern  pattern   = PATTERN_CONSTANT;   // PATTERN
+    uint32_t      periodMs  = MotorBank::DEFAULT_PERIOD_MS;
+    String        ssid;                           // WIFI_CREDENTIALS
+    String        password;
+    TransportMode transport = TRANSPORT_BLE;      // SWITCH_TRANSPORT / TELEMETRY_RATE
+    String        serverAddress;                  // SWITCH_TRANSPORT to REMOTE (optional)
+    TelemetryRate rate      = { 0, 0 };           // TELEMETRY_RATE; a field not sent
+    bool          hasMinInterval = false;         //   keeps the channel's current value
+    bool          hasHeartbeat   = false;
+    TraceAction   traceAction = TRACE_ACTION_START;
+    bool          traceFromFlash = false;
+    WireEncoding  encoding  = WIRE_JSON;          // HELLO
+    uint32_t      session   = 0;                  // HELLO: client session to join, 0 = none
+    PowerProfile  powerProfile = POWER_BALANCED;  // POWER
+    OtaAction     otaAction = OTA_ACTION_STATUS;  // OTA
+    uint32_t      otaSize   = 0;                  // OTA begin
+    uint8_t       otaSha256[32] = {};
+    bool          otaHasDigest  = false;
+    uint8_t       otaSig[32]    = {};            // OTA begin: signature; key: the key
+    bool          otaHasSig     = false;
+    HistoryStore::Query history;                  // HISTORY
+};
+
+#endif // COMMAND_H
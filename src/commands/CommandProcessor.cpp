@@ -0,0 +1,798 @@
+#include "CommandProcessor.h"
+#include "../DeviceContext.h"
+#include "../ConfigManager.h"
+#include "../wifi/WiFiManager.h"
+#include "../trace/TraceRecorder.h"
+#include "../ota/OtaManager.h"
+#include "../session/SessionManager.h"
+#include "RateLimiter.h"
+#include "../log/Logger.h"
+#include "../protocol/WireProtocol.h"
+#include "../hal/Hal.h"
+
+CommandProcessor& CommandProcessor::getInstance() {
+    static CommandProcessor instance;
+    return instance;
+}
+
+const char* CommandProcessor::sourceTag(CommandSource src) {
+    switch (src) {
+        case SOURCE_BLE:       return "BLE";
+        case SOURCE_WS_LOCAL:  return "WS";
+        case SOURCE_WS_REMOTE: return "WS-Client";
+        case SOURCE_REST:      return "REST";
+        case SOURCE_SERIAL:    return "Serial";
+        default:               return "?";
+    }
+}
+
+const char* CommandProcessor::resultName(CommandResult result) {
+    switch (result) {
+        case CMD_OK:          return "OK";
+        case CMD_PARSE_ERROR: return "PARSE_ERROR";
+        case CMD_UNKNOWN:     return "UNKNOWN";
+        case CMD_INVALID:     return "INVALID";
+        default:              return "?";
+    }
+}
+
+const char* CommandProcessor::transportName(TransportMode mode) {
+    switch (mode) {
+        case TRANSPORT_WIFI:   return "WIFI";
+        case TRANSPORT_REMOTE: return "REMOTE";
+        case TRANSPORT_AUTO:   return "AUTO";
+        default:               return "BLE";
+    }
+}
+
+bool CommandProcessor::parseTransport(const char* name, TransportMode& out) {
+    if (!name) return false;
+    if      (strcmp(name, "BLE")    == 0) out = TRANSPORT_BLE;
+    else if (strcmp(name, "WIFI")   == 0) out = TRANSPORT_WIFI;
+    else if (strcmp(name, "REMOTE") == 0) out = TRANSPORT_REMOTE;
+    else if (strcmp(name, "AUTO")   == 0) out = TRANSPORT_AUTO;
+    else return false;
+    return true;
+}
+
+bool CommandProcessor::linkOf(CommandSource src, TransportMode& out) {
+    switch (src) {
+        case SOURCE_BLE:       out = TRANSPORT_BLE;    return true;
+        case SOURCE_WS_LOCAL:  out = TRANSPORT_WIFI;   return true;
+        case SOURCE_WS_REMOTE: out = TRANSPORT_REMOTE; return true;
+        default:               return false;   // REST / serial are not session links
+    }
+}
+
+// ── Names ────────────────────────────────────────────────────────────
+
+// Indexed by RequestType / TraceAction / OtaAction.
+static const char* const REQUEST_NAMES[] = {
+    nullptr, "STATUS", "INTENSITY", "WIFI_CREDENTIALS", "SWITCH_TRANSPORT",
+    "TELEMETRY_RATE", "TRACE", "BATCH", "HELLO", "POWER", "OTA", "PATTERN", "PROBE",
+    "SCAN", "HISTORY"
+};
+static const char* const TRACE_ACTIONS[] = { "start", "stop", "clear", "flush", "dump" };
+static const char* const OTA_ACTIONS[]   = { "begin", "finish", "abort", "status", "key" };
+
+RequestType CommandProcessor::requestTypeOf(const char* name, size_t len) {
+    if (!name) return REQ_UNKNOWN;
+    for (uint8_t i = REQ_STATUS; i <= REQ_HISTORY; ++i) {
+        if (strlen(REQUEST_NAMES[i]) == len && memcmp(name, REQUEST_NAMES[i], len) == 0) {
+            return (RequestType)i;
+        }
+    }
+    return REQ_UNKNOWN;
+}
+
+static bool parseTraceAction(const char* name, TraceAction& out) {
+    if (!name) return false;
+    for (uint8_t i = TRACE_ACTION_START; i <= TRACE_ACTION_DUMP; ++i) {
+        if (strcmp(name, TRACE_ACTIONS[i]) == 0) {
+            out = (TraceAction)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseOtaAction(const char* name, OtaAction& out) {
+    if (!name) return false;
+    for (uint8_t i = OTA_ACTION_BEGIN; i <= OTA_ACTION_KEY; ++i) {
+        if (strcmp(name, OTA_ACTIONS[i]) == 0) {
+            out = (OtaAction)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char* encodingName(WireEncoding enc) {
+    return enc == WIRE_MSGPACK ? "msgpack" : "json";
+}
+
+// Null in a build (or boot) without Wi-Fi.
+static WiFiScanCache* scanCache() {
+#if OPENVIBE_WITH_WIFI
+    WiFiManager* wifi = DeviceContext::getInstance().getWiFiManager();
+    return wifi ? &wifi->getScanCache() : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+static const HistoryStore& history() {
+    return DeviceContext::getInstance().getHistory();
+}
+
+// ── Trace redaction ──────────────────────────────────────────────────
+// GET /trace and TRACE dump serve the ring over any link, so a Wi-Fi
+// password or an OTA key is blanked before a frame is recorded.  Only
+// frames that can carry one (and batches, whose items can) are looked at.
+
+static const char* const SECRET_FIELDS[] = { "password", "key" };
+
+static bool maySecret(RequestType type) {
+    return type == REQ_WIFI_CREDENTIALS || type == REQ_OTA || type == REQ_BATCH;
+}
+
+// Secret members of one command become "*"; true if there were any.
+// Looked up read-only, so a frame without secrets is left as it came.
+static bool blankJson(JsonObject cmd) {
+    JsonObjectConst view = cmd;
+    bool            any  = false;
+    for (const char* field : SECRET_FIELDS) {
+        if (view[field].isNull()) continue;
+        cmd[field] = "*";
+        any        = true;
+    }
+    return any;
+}
+
+// The frame again, secrets blanked; empty when it had none.
+static String redactJson(JsonDocument& doc) {
+    bool any = blankJson(doc.as<JsonObject>());
+    if (doc.as<JsonObjectConst>()["commands"].is<JsonArrayConst>()) {
+        for (JsonObject item : doc["commands"].as<JsonArray>()) any |= blankJson(item);
+    }
+    String out;
+    if (any) serializeJson(doc, out);
+    return out;
+}
+
+// Overwrites, in `copy` (the first `kept` bytes of the frame at `base`),
+// the secret strings of the command map at `r` and of its batch items.
+// MessagePack keeps its framing: the bytes become '*', the length stays.
+static void blankMsgPack(MsgPackReader& r, const uint8_t* base, uint8_t* copy, size_t kept) {
+    uint32_t entries, n;
+    if (!r.map(entries)) {
+        r.skip();
+        return;
+    }
+    while (entries-- && r.ok()) {
+        int64_t     key;
+        const char* s;
+        if (!r.sint(key)) {
+            r.skip();
+            r.skip();
+        } else if ((key == wire::KEY_PASSWORD || key == wire::KEY_OTA_SIG) && r.str(s, n)) {
+            for (size_t i = (const uint8_t*)s - base; i < kept && n--; ++i) copy[i] = '*';
+        } else if (key == wire::KEY_COMMANDS && r.array(n)) {
+            while (n-- && r.ok()) blankMsgPack(r, base, copy, kept);
+        } else {
+            r.skip();
+        }
+    }
+}
+
+// ── JSON ─────────────────────────────────────────────────────────────
+
+CommandResult CommandProcessor::handleJson(const char* payload, size_t len, CommandSource src,
+                                           String* ack, WireEncoding* encoding, uint32_t* session) {
+    uint32_t       arrivedUs = hal::micros();
+    TraceRecorder& trace     = TraceRecorder::getInstance();
+    ++frames;
+    noteHeard(src);
+
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, payload, len);
+    if (err) {
+        LOG_W(CMD, "[%s] JSON parse error: %s\n", sourceTag(src), err.c_str());
+        trace.recordCommand(arrivedUs, src, CMD_PARSE_ERROR, payload, len);
+        return CMD_PARSE_ERROR;
+    }
+
+    // The byte scan that admitted the frame may have missed a type
+    // ArduinoJson decodes (an escape): dropped, like any frame over the limit.
+    if (!RateLimiter::getInstance().settleJson(src, doc.as<JsonObjectConst>(), hal::millis())) {
+        return CMD_INVALID;
+    }
+
+    Command       cmd;
+    BatchResults  batch;
+    CommandResult result;
+    fromJson(doc.as<JsonObjectConst>(), cmd);
+    bool duplicate = alreadyRan(cmd, src, session, result);
+    if (duplicate) {
+        LOG_D(CMD, "[%s] seq %u already ran\n", sourceTag(src), (unsigned)cmd.seq);
+    } else {
+        if (cmd.type == REQ_BATCH) {
+            result = executeBatch(doc["commands"], src, encoding, session, batch);
+        } else {
+            result = execute(cmd, src, encoding, session);
+        }
+        remember(cmd, src, session, result);
+    }
+    String redacted = trace.isEnabled() && maySecret(cmd.type) ? redactJson(doc) : String();
+    if (redacted.isEmpty()) trace.recordCommand(arrivedUs, src, result, payload, len);
+    else                    trace.recordCommand(arrivedUs, src, result, redacted.c_str(), redacted.length());
+
+    // A batch, HELLO, OTA, SCAN or HISTORY always answers (one reply
+    // for the whole frame); other commands only when they carry an id.
+    bool isBatch   = cmd.type == REQ_BATCH;
+    bool isHello   = cmd.type == REQ_HELLO;
+    bool isOta     = cmd.type == REQ_OTA;
+    bool isScan    = cmd.type == REQ_SCAN;
+    bool isHistory = cmd.type == REQ_HISTORY;
+    if (ack && (isBatch || isHello || isOta || isScan || isHistory || !doc["id"].isNull())) {
+        JsonDocument reply;
+        if (!doc["id"].isNull()) reply["ack"] = doc["id"];
+        reply["result"] = resultName(result);
+        if (duplicate) reply["duplicate"] = true;
+        if (isBatch && !duplicate) {
+            JsonArray results = reply["results"].to<JsonArray>();
+            for (uint8_t i = 0; i < batch.count; ++i) results.add(resultName(batch.results[i]));
+        }
+        if (isHello) reply["encoding"] = encodingName(encoding ? *encoding : WIRE_JSON);
+        if (isOta) {
+            OtaManager& ota = OtaManager::getInstance();
+            reply["state"]  = OtaManager::stateName(ota.getState());
+            reply["offset"] = ota.getOffset();
+            if (result != CMD_OK && ota.lastError() != OTA_OK) {
+                reply["error"] = OtaManager::statusName(ota.lastError());
+            }
+        }
+        // Over BLE the reply is a characteristic value: cut to fit.
+        size_t maxBytes = src == SOURCE_BLE ? BLE_ACK_MAX : SIZE_MAX;
+#if OPENVIBE_WITH_WIFI
+        WiFiScanCache* scan = isScan && result == CMD_OK ? scanCache() : nullptr;
+        if (scan) scan->toJson(reply.as<JsonObject>(), hal::millis(), maxBytes);
+#endif
+        HistoryStore::Range range;
+        uint32_t            now = hal::millis();
+        if (isHistory && result == CMD_OK && history().resolve(cmd.history, now, range)) {
+            history().toJson(reply.as<JsonObject>(), range, now, maxBytes);
+        }
+        serializeJson(reply, *ack);
+    }
+    return result;
+}
+
+// Keeps the lenient defaults the JSON protocol always had: a missing
+// intensity is 0, password is optional.  A TELEMETRY_RATE field left
+// out keeps the channel's current value.
+// INTENSITY without "channel" or "channels" drives every channel.
+void CommandProcessor::fromJson(JsonObjectConst doc, Command& cmd) {
+    const char* req = doc["requestType"];
+    cmd.type = requestTypeOf(req, req ? strlen(req) : 0);
+
+    JsonVariantConst seq = doc["seq"];
+    if (!seq.isNull()) {
+        cmd.hasSeq = seq.is<uint32_t>() && seq.as<uint32_t>() > 0;
+        cmd.seq    = cmd.hasSeq ? seq.as<uint32_t>() : 0;
+        if (!cmd.hasSeq) cmd.valid = false;
+    }
+
+    switch (cmd.type) {
+        case REQ_INTENSITY: {
+            cmd.intensity = doc["intensity"].as<int>();
+            cmd.channel   = doc["channel"] | -1;
+
+            // Levels past the last channel are dropped here or in execute().
+            JsonArrayConst levels = doc["channels"];
+            if (levels.isNull()) break;
+            if (levels.size() == 0) {
+                cmd.valid = false;
+                break;
+            }
+            for (JsonVariantConst level : levels) {
+                if (cmd.levelCount == MAX_MOTOR_CHANNELS) break;
+                cmd.levels[cmd.levelCount++] = (uint8_t)constrain(level.as<int>(), 0, 100);
+            }
+            break;
+        }
+        case REQ_WIFI_CREDENTIALS: {
+            const char* ssid = doc["ssid"];
+            const char* pass = doc["password"];
+            cmd.valid = ssid != nullptr;
+            if (ssid) cmd.ssid = ssid;
+            if (pass) cmd.password = pass;
+            break;
+        }
+        case REQ_SWITCH_TRANSPORT: {
+            const char* t    = doc["transport"];
+            const char* addr = doc["serverAddress"];
+            cmd.valid = parseTransport(t, cmd.transport);
+            if (addr) cmd.serverAddress = addr;
+            break;
+        }
+        case REQ_TELEMETRY_RATE: {
+            const char* t = doc["transport"];
+            cmd.valid = parseTransport(t, cmd.transport);
+            JsonVariantConst minMs = doc["minIntervalMs"];
+            JsonVariantConst hbMs  = doc["heartbeatMs"];
+            cmd.hasMinInterval = !minMs.isNull();
+            cmd.hasHeartbeat   = !hbMs.isNull();
+            if ((cmd.hasMinInterval && !minMs.is<uint32_t>()) || (cmd.hasHeartbeat && !hbMs.is<uint32_t>())) {
+                cmd.valid = false;
+                break;
+            }
+            cmd.rate.minIntervalMs = minMs.as<uint32_t>();
+            cmd.rate.heartbeatMs   = hbMs.as<uint32_t>();
+            break;
+        }
+        case REQ_TRACE: {
+            const char* action = doc["action"];
+            cmd.valid          = parseTraceAction(action, cmd.traceAction);
+            cmd.traceFromFlash = doc["source"] == "flash";
+            break;
+        }
+        case REQ_HELLO: {
+            const char* enc = doc["encoding"] | "json";
+            if      (strcmp(enc, "json")    == 0) cmd.encoding = WIRE_JSON;
+            else if (strcmp(enc, "msgpack") == 0) cmd.encoding = WIRE_MSGPACK;
+            else cmd.valid = false;
+            JsonVariantConst id = doc["session"];
+            if (id.isNull()) break;
+            cmd.session = id.is<uint32_t>() ? id.as<uint32_t>() : 0;
+            if (!cmd.session || cmd.session > SessionManager::MAX_CLIENT_SESSION) cmd.valid = false;
+            break;
+        }
+        case REQ_POWER:
+            cmd.valid = PowerManager::parseProfile(doc["profile"], cmd.powerProfile);
+            break;
+        case REQ_OTA: {
+            const char* action = doc["action"];
+            cmd.valid        = parseOtaAction(action, cmd.otaAction);
+            cmd.otaSize      = doc["size"] | 0u;
+            cmd.otaHasDigest = OtaManager::parseDigest(doc["sha256"], cmd.otaSha256);
+            cmd.otaHasSig    = OtaManager::parseDigest(cmd.otaAction == OTA_ACTION_KEY ? doc["key"] : doc["sig"],
+                                                       cmd.otaSig);
+            break;
+        }
+        case REQ_PATTERN:
+            cmd.valid    = MotorBank::parsePattern(doc["pattern"], cmd.pattern);
+            cmd.channel  = doc["channel"]  | -1;
+            cmd.periodMs = doc["periodMs"] | MotorBank::DEFAULT_PERIOD_MS;
+            break;
+        case REQ_PROBE:
+            cmd.valid = cmd.valid && cmd.hasSeq;
+            break;
+        case REQ_HISTORY:
+            cmd.history.from = doc["from"] | cmd.history.from;
+            cmd.history.to   = doc["to"]   | cmd.history.to;
+            cmd.history.res  = doc["res"]  | cmd.history.res;
+            break;
+        default: break;
+    }
+}
+
+// ── MessagePack ──────────────────────────────────────────────────────
+
+CommandResult CommandProcessor::handleMsgPack(const uint8_t* data, size_t len, CommandSource src,
+                                              MsgPackWriter* reply, WireEncoding* encoding, uint32_t* session) {
+    uint32_t       arrivedUs = hal::micros();
+    TraceRecorder& trace     = TraceRecorder::getInstance();
+    ++frames;
+    noteHeard(src);
+    if (reply) reply->reset();
+
+    // Walk the whole frame before acting on it, so a truncated batch
+    // is rejected outright instead of half-run.
+    MsgPackReader check(data, len);
+    if (!check.skip() || !check.atEnd()) {
+        LOG_W(CMD, "[%s] MessagePack parse error\n", sourceTag(src));
+        trace.recordCommand(arrivedUs, src, CMD_PARSE_ERROR, (const char*)data, len, true);
+        return CMD_PARSE_ERROR;
+    }
+
+    MsgPackReader r(data, len);
+    MsgPackFrame  frame;
+    CommandResult result = runMsgPack(r, src, encoding, session, &frame);
+    if (trace.isEnabled() && maySecret(frame.type)) {
+        uint8_t       copy[TraceRecorder::MAX_PAYLOAD];
+        size_t        kept = len < sizeof(copy) ? len : sizeof(copy);
+        MsgPackReader walk(data, len);
+        memcpy(copy, data, kept);
+        blankMsgPack(walk, data, copy, kept);
+        // Full length, so a long frame is marked truncated: only `kept` is stored.
+        trace.recordCommand(arrivedUs, src, result, (const char*)copy, len, true);
+    } else {
+        trace.recordCommand(arrivedUs, src, result, (const char*)data, len, true);
+    }
+
+    bool isBatch   = frame.type == REQ_BATCH;
+    bool isHello   = frame.type == REQ_HELLO;
+    bool isOta     = frame.type == REQ_OTA;
+    bool isScan    = frame.type == REQ_SCAN;
+    bool isHistory = frame.type == REQ_HISTORY;
+    OtaManager& ota    = OtaManager::getInstance();
+    bool        otaErr = isOta && result != CMD_OK && ota.lastError() != OTA_OK;
+    bool        dup    = frame.duplicate;
+    bool        hasRes = isBatch && !dup;   // a duplicate batch did not run
+    WiFiScanCache* scan = isScan && result == CMD_OK ? scanCache() : nullptr;
+    uint32_t       now  = hal::millis();
+    HistoryStore::Range range;
+    bool hasHistory = isHistory && result == CMD_OK && history().resolve(frame.history, now, range);
+    if (reply && (isBatch || isHello || isOta || isScan || isHistory || frame.hasId)) {
+        reply->map(2 + frame.hasId + dup + hasRes + isHello + 2 * isOta + otaErr +
+                   (scan ? wire::scanFieldCount(*scan) : 0) +
+                   (hasHistory ? wire::HISTORY_FIELDS : 0));
+        reply->uint(wire::KEY_TYPE);   reply->uint(wire::MSG_ACK);
+        if (frame.hasId) {
+            reply->uint(wire::KEY_ID); reply->uint(frame.id);
+        }
+        reply->uint(wire::KEY_RESULT); reply->uint(result);
+        if (dup) {
+            reply->uint(wire::KEY_DUPLICATE); reply->boolean(true);
+        }
+        if (hasRes) {
+            reply->uint(wire::KEY_RESULTS);
+            reply->array(frame.batch.count);
+            for (uint8_t i = 0; i < frame.batch.count; ++i) reply->uint(frame.batch.results[i]);
+        }
+        if (isHello) {
+            reply->uint(wire::KEY_ENCODING);
+            reply->uint(encoding ? *encoding : WIRE_JSON);
+        }
+        if (isOta) {
+            reply->uint(wire::KEY_OTA_STATE);  reply->uint(ota.getState());
+            reply->uint(wire::KEY_OTA_OFFSET); reply->uint(ota.getOffset());
+            if (otaErr) {
+                reply->uint(wire::KEY_OTA_ERROR); reply->uint(ota.lastError());
+            }
+        }
+        if (scan) wire::encodeScan(*reply, *scan, now);
+        if (hasHistory) wire::encodeHistory(*reply, history(), range, now);
+    }
+    return result;
+}
+
+// Decodes and runs one command map.  `top` is null for batch items:
+// they have no ack of their own and may not be batches themselves.
+// Keys may come in any order: a batch's items are only located while
+// the map is read, and run from a second reader once it is done.
+CommandResult CommandProcessor::runMsgPack(MsgPackReader& r, CommandSource src,
+                                           WireEncoding* encoding, uint32_t* session, MsgPackFrame* top) {
+    uint32_t entries;
+    if (!r.map(entries)) {
+        r.skip();
+        return CMD_UNKNOWN;
+    }
+
+    Command        cmd;
+    uint64_t       seen      = 0;         // bit n: key n present
+    const uint8_t* items     = nullptr;   // batch: the item values, back to back
+    size_t         itemsLen  = 0;
+    uint32_t       itemCount = 0;
+
+    while (entries--) {
+        int64_t key, v;
+        if (!r.sint(key)) {   // non-integer key: not ours
+            r.skip();
+            r.skip();
+            continue;
+        }
+
+        if (key == wire::KEY_TYPE) {
+            if (!r.sint(v)) { r.skip(); v = REQ_UNKNOWN; }
+            cmd.type = (v > REQ_UNKNOWN && v <= REQ_HISTORY) ? (RequestType)v : REQ_UNKNOWN;
+        }
+        else if (key == wire::KEY_ID) {
+            if (!r.sint(v)) r.skip();
+            else if (top && v >= 0 && v <= UINT32_MAX) { top->id = (uint32_t)v; top->hasId = true; }
+        }
+        else if (key == wire::KEY_COMMANDS) {
+            uint32_t n;
+            if (!top || !r.array(n)) { r.skip(); continue; }
+            const uint8_t* first = r.cursor();
+            for (uint32_t i = 0; i < n; ++i) r.skip();
+            items     = (n == 0 || n > MAX_BATCH) ? nullptr : first;
+            itemsLen  = r.cursor() - first;
+            itemCount = n;
+        }
+        else {
+            wire::decodeField(r, (uint32_t)key, cmd);
+            if (key >= 0 && key < 64) seen |= 1ull << key;
+        }
+    }
+
+    if (!wire::hasRequiredFields(cmd.type, seen)) cmd.valid = false;
+    if (!top) return cmd.type == REQ_BATCH ? CMD_INVALID : execute(cmd, src, encoding, session);
+
+    // Top level: runs once per seq
+    top->type    = cmd.type;
+    top->history = cmd.history;
+    CommandResult result;
+    if (cmd.type == REQ_BATCH) {
+        if (!items) return CMD_INVALID;
+        top->duplicate = alreadyRan(cmd, src, session, result);
+        if (top->duplicate) return result;
+
+        CommandResult overall = CMD_OK;   // first failure, if any
+        MsgPackReader list(items, itemsLen);
+        while (itemCount--) {
+            CommandResult res = runMsgPack(list, src, encoding, session, nullptr);
+            top->batch.results[top->batch.count++] = res;
+            if (overall == CMD_OK) overall = res;
+        }
+        finishBatch(src, top->batch, overall);
+        result = overall;
+    } else {
+        top->duplicate = alreadyRan(cmd, src, session, result);
+        if (top->duplicate) return result;
+        result = execute(cmd, src, encoding, session);
+    }
+    remember(cmd, src, session, result);
+    return result;
+}
+
+// ── Batch ────────────────────────────────────────────────────────────
+
+// Runs the commands back to back in this call — i.e. inside one loop()
+// tick, with no telemetry or other transport input in between — and
+// asks for a single status broadcast at the end.  Not transactional:
+// a failing command does not undo the ones before it.
+CommandResult CommandProcessor::executeBatch(JsonVariantConst commands, CommandSource src,
+                                             WireEncoding* encoding, uint32_t* session, BatchResults& out) {
+    JsonArrayConst list = commands.as<JsonArrayConst>();
+    out.count = 0;
+    if (list.isNull() || list.size() == 0 || list.size() > MAX_BATCH) return CMD_INVALID;
+
+    CommandResult overall = CMD_OK;   // first failure, if any
+    for (JsonVariantConst item : list) {
+        Command cmd;
+        fromJson(item.as<JsonObjectConst>(), cmd);
+        // Nested batches, and OTA keys (serial only, on their own), are refused.
+        bool          refused = cmd.type == REQ_BATCH || (cmd.type == REQ_OTA && cmd.otaAction == OTA_ACTION_KEY);
+        CommandResult r       = refused ? CMD_INVALID : execute(cmd, src, encoding, session);
+        out.results[out.count++] = r;
+        if (overall == CMD_OK) overall = r;
+    }
+
+    finishBatch(src, out, overall);
+    return overall;
+}
+
+void CommandProcessor::finishBatch(CommandSource src, const BatchResults& batch, CommandResult overall) {
+    DeviceContext::getInstance().requestStatusBroadcast();
+    LOG_D(CMD, "[%s] Batch of %u → %s\n", sourceTag(src), (unsigned)batch.count, resultName(overall));
+}
+
+// ── Dispatch ─────────────────────────────────────────────────────────
+
+CommandResult CommandProcessor::execute(const Command& cmd, CommandSource src, WireEncoding* encoding,
+                                        uint32_t* session) {
+    DeviceContext& ctx = DeviceContext::getInstance();
+    ConfigManager& cfg = ConfigManager::getInstance();
+    const char*    tag = sourceTag(src);
+
+    if (cmd.type == REQ_UNKNOWN) return CMD_UNKNOWN;
+    if (!cmd.valid)              return CMD_INVALID;
+
+    switch (cmd.type) {
+        // ── STATUS ───────────────────────────────────────────────────
+        case REQ_STATUS:
+            ctx.requestStatusBroadcast();
+            break;
+
+        // ── INTENSITY ────────────────────────────────────────────────
+        case REQ_INTENSITY:
+            if (cmd.levelCount) {
+                uint8_t n = min(cmd.levelCount, ctx.getStats().channelCount);
+                for (uint8_t i = 0; i < n; ++i) ctx.setIntensity(i, cmd.levels[i]);
+                LOG_D(CMD, "[%s] Intensity → %u channel(s)\n", tag, (unsigned)n);
+            } else {
+                if (!ctx.setIntensity(cmd.channel, cmd.intensity)) return CMD_INVALID;
+                LOG_D(CMD, "[%s] Intensity %d → %d\n", tag, cmd.channel, constrain(cmd.intensity, 0, 100));
+            }
+            break;
+
+        // ── WIFI_CREDENTIALS (non-blocking!) ─────────────────────────
+        case REQ_WIFI_CREDENTIALS: {
+#if OPENVIBE_WITH_WIFI
+            LOG_I(CMD, "[%s] Saving WiFi creds for \"%s\"\n", tag, cmd.ssid.c_str());
+            cfg.setWiFiCredentials(cmd.ssid, cmd.password);
+
+            WiFiManager* wifi = ctx.getWiFiManager();
+            if (wifi) wifi->connect();   // returns immediately
+            break;
+#else
+            return CMD_INVALID;   // no Wi-Fi in this build
+#endif
+        }
+
+        // ── SWITCH_TRANSPORT ─────────────────────────────────────────
+        case REQ_SWITCH_TRANSPORT:
+            if (!transportBuilt(cmd.transport)) return CMD_INVALID;
+            if ((cmd.transport == TRANSPORT_REMOTE || cmd.transport == TRANSPORT_AUTO)
+                && !cmd.serverAddress.isEmpty()) {
+                cfg.setRemoteServer(cmd.serverAddress);
+                ctx.getStats().serverAddress = cmd.serverAddress;
+            }
+            ctx.setTransport(cmd.transport);
+            LOG_I(CMD, "[%s] Transport → %s\n", tag, transportName(cmd.transport));
+            break;
+
+        // ── TELEMETRY_RATE ───────────────────────────────────────────
+        case REQ_TELEMETRY_RATE: {
+            if (cmd.transport == TRANSPORT_AUTO) return CMD_INVALID;   // rates are per link
+            TelemetryRate rate = ctx.getTelemetryRate(cmd.transport);
+            if (cmd.hasMinInterval) rate.minIntervalMs = cmd.rate.minIntervalMs;
+            if (cmd.hasHeartbeat)   rate.heartbeatMs   = cmd.rate.heartbeatMs;
+            // A heartbeat of 0 is "never"; any other must not beat the cap.
+            if (rate.minIntervalMs == 0 || (rate.heartbeatMs && rate.heartbeatMs < rate.minIntervalMs)) {
+                return CMD_INVALID;
+            }
+            ctx.setTelemetryRate(cmd.transport, rate);
+            LOG_I(CMD, "[%s] Telemetry %s → %ums / %ums\n", tag, transportName(cmd.transport),
+                       (unsigned)rate.minIntervalMs, (unsigned)rate.heartbeatMs);
+            break;
+        }
+
+        // ── TRACE ────────────────────────────────────────────────────
+        case REQ_TRACE:
+            return handleTrace(cmd);
+
+        // ── HELLO ────────────────────────────────────────────────────
+        // Only a transport that tracks a per-connection encoding can
+        // switch to binary; JSON is always acceptable.  Likewise only
+        // one that tracks a per-connection session can join one.
+        case REQ_HELLO:
+            if (!encoding && cmd.encoding != WIRE_JSON) return CMD_INVALID;
+            if (!session && cmd.session)                return CMD_INVALID;
+            if (encoding) *encoding = cmd.encoding;
+            LOG_I(CMD, "[%s] Encoding → %s\n", tag, encodingName(cmd.encoding));
+            if (cmd.session) {
+                *session = cmd.session;
+                LOG_I(CMD, "[%s] Session → %08x\n", tag, (unsigned)cmd.session);
+            }
+            break;
+
+        // ── POWER ────────────────────────────────────────────────────
+        case REQ_POWER:
+            ctx.setPowerProfile(cmd.powerProfile);
+            LOG_I(CMD, "[%s] Power → %s\n", tag, PowerManager::profileName(cmd.powerProfile));
+            break;
+
+        // ── OTA ──────────────────────────────────────────────────────
+        case REQ_OTA:
+            return handleOta(cmd, src, tag);
+
+        // ── PATTERN ──────────────────────────────────────────────────
+        case REQ_PATTERN:
+            if (!ctx.getMotors().setPattern(cmd.channel, cmd.pattern, cmd.periodMs)) return CMD_INVALID;
+            LOG_D(CMD, "[%s] Pattern %d → %s / %u ms\n", tag, cmd.channel,
+                       MotorBank::patternName(cmd.pattern), (unsigned)cmd.periodMs);
+            break;
+
+        // ── PROBE (echo of a link probe) ─────────────────────────────
+        case REQ_PROBE: {
+            TransportMode link;
+            if (!linkOf(src, link)) return CMD_INVALID;
+            SessionManager::getInstance().probeReply(link, cmd.seq, hal::millis());
+            break;
+        }
+
+        // ── SCAN (the reply carries the cached list) ─────────────────
+        case REQ_SCAN: {
+#if OPENVIBE_WITH_WIFI
+            WiFiScanCache* scan = scanCache();
+            if (!scan) return CMD_INVALID;
+            scan->request(hal::millis());
+            break;
+#else
+            return CMD_INVALID;   // no Wi-Fi in this build
+#endif
+        }
+
+        // ── HISTORY (the reply carries the rows) ─────────────────────
+        case REQ_HISTORY: {
+            HistoryStore::Range range;
+            if (!history().resolve(cmd.history, hal::millis(), range)) return CMD_INVALID;
+            break;
+        }
+
+        default:
+            return CMD_INVALID;   // BATCH never reaches here
+    }
+    return CMD_OK;
+}
+
+// ── Session (dedupe, link liveness) ──────────────────────────────────
+
+// Any frame, even one that does not parse, shows its link is alive.
+void CommandProcessor::noteHeard(CommandSource src) {
+    TransportMode link;
+    if (linkOf(src, link)) SessionManager::getInstance().heard(link, hal::millis());
+}
+
+// The session a seq counts in: the one the connection named in HELLO,
+// else a private one, kept per connection (`session`, which the
+// transport zeroes when a client connects) or, for a source without
+// connections, per source.
+uint32_t CommandProcessor::sessionOf(CommandSource src, uint32_t* session) {
+    uint32_t& id = session ? *session : sourceSessions[src];
+    if (!id) id = SessionManager::getInstance().privateSession();
+    return id;
+}
+
+// A command with a seq that already ran is answered with the result it
+// had, not run again.  PROBE's seq is the probe's, not the session's.
+bool CommandProcessor::alreadyRan(const Command& cmd, CommandSource src, uint32_t* session,
+                                  CommandResult& prior) {
+    if (!cmd.hasSeq || cmd.type == REQ_PROBE) return false;
+    uint8_t r;
+    if (!SessionManager::getInstance().isDuplicate(sessionOf(src, session), cmd.seq, r)) return false;
+    prior = (CommandResult)r;
+    return true;
+}
+
+// After execute(): a HELLO that named a session counts its own seq in it.
+void CommandProcessor::remember(const Command& cmd, CommandSource src, uint32_t* session,
+                                CommandResult result) {
+    if (!cmd.hasSeq || cmd.type == REQ_PROBE) return;
+    SessionManager::getInstance().remember(sessionOf(src, session), cmd.seq, result);
+}
+
+// ── Trace control ────────────────────────────────────────────────────
+
+CommandResult CommandProcessor::handleTrace(const Command& cmd) {
+    TraceRecorder& trace = TraceRecorder::getInstance();
+
+    switch (cmd.traceAction) {
+        case TRACE_ACTION_START: trace.setEnabled(true);  break;
+        case TRACE_ACTION_STOP:  trace.setEnabled(false); break;
+        case TRACE_ACTION_CLEAR: trace.clear();           break;
+        case TRACE_ACTION_FLUSH: if (!trace.flushToFlash()) return CMD_INVALID; break;
+        case TRACE_ACTION_DUMP:  if (!trace.startDump(cmd.traceFromFlash)) return CMD_INVALID; break;
+    }
+
+    LOG_I(TRACE, "[Trace] %s (%u records, %u dropped)\n", TRACE_ACTIONS[cmd.traceAction],
+                 (unsigned)trace.recordCount(), (unsigned)trace.droppedCount());
+    return CMD_OK;
+}
+
+// ── OTA control ──────────────────────────────────────────────────────
+
+// The image itself arrives as WS chunk frames or POST /ota, not here.
+CommandResult CommandProcessor::handleOta(const Command& cmd, CommandSource src, const char* tag) {
+    OtaManager& ota = OtaManager::getInstance();
+    OtaStatus   st  = OTA_OK;
+
+    switch (cmd.otaAction) {
+        case OTA_ACTION_BEGIN: {
+            if (!cmd.otaSize || !cmd.otaHasDigest || !cmd.otaHasSig) return CMD_INVALID;
+            uint32_t resumeAt;
+            st = ota.begin(cmd.otaSize, cmd.otaSha256, cmd.otaSig, resumeAt);
+            break;
+        }
+        case OTA_ACTION_KEY:
+            // Whoever holds the key can flash the device: only someone
+            // at the serial port gets to set it.
+            if (src != SOURCE_SERIAL || !cmd.otaHasSig) {
+                LOG_W(OTA, "[%s] OTA key refused\n", tag);
+                return CMD_INVALID;
+            }
+            OtaManager::setKey(cmd.otaSig);
+            return CMD_OK;
+        case OTA_ACTION_FINISH: st = ota.finish(); break;
+        case OTA_ACTION_ABORT:  ota.abort();       break;
+        case OTA_ACTION_STATUS:                    break;
+    }
+
+    LOG_I(OTA, "[%s] OTA %s → %s (%s, %u / %u)\n", tag, OTA_ACTIONS[cmd.otaAction],
+               OtaManager::statusName(st), OtaManager::stateName(ota.getState()),
+               (unsigned)ota.getOffset(), (unsigned)ota.getSize());
+    return st == OTA_OK ? CMD_OK : CMD_INVALID;
+}
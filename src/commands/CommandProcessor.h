@@ -0,0 +1,179 @@
+#ifndef COMMAND_PROCESSOR_H
+#define COMMAND_PROCESSOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../../include/types/device_stats.h"
+#include "Command.h"
+
+class MsgPackReader;
+class MsgPackWriter;
+
+/** Where an inbound command came from. */
+enum CommandSource : uint8_t {
+    SOURCE_BLE       = 0,
+    SOURCE_WS_LOCAL  = 1,
+    SOURCE_WS_REMOTE = 2,
+    SOURCE_REST      = 3,
+    SOURCE_SERIAL    = 4,
+    SOURCE_COUNT
+};
+
+/** Outcome of handling one inbound frame. */
+enum CommandResult : uint8_t {
+    CMD_OK          = 0,
+    CMD_PARSE_ERROR = 1,   // not valid JSON / MessagePack
+    CMD_UNKNOWN     = 2,   // missing or unknown requestType
+    CMD_INVALID     = 3    // known requestType, bad/missing fields
+};
+
+/**
+ * Single command path shared by every transport.
+ *
+ * BLE writes, local/remote WebSocket text frames (and the simulated
+ * BLE link in the host build) all land here, so the protocol is
+ * defined in exactly one place.
+ *
+ * A command may carry an "id" (number or string).  When it does and
+ * the transport passes `ack`, it is filled with
+ * {"ack":<id>,"result":"OK"} (or the failure name) for the transport
+ * to send back to the originating client only — that is what clients
+ * and tools/loadgen use to measure round-trip latency.
+ *
+ * {"requestType":"BATCH","commands":[...]} runs up to MAX_BATCH
+ * commands in order within the same call (one loop tick), triggers one
+ * status broadcast at the end and answers once with
+ * {"ack":<id>,"result":<first failure or OK>,"results":[...]}.
+ *
+ * Frames are JSON text or, on WebSocket binary frames, MessagePack
+ * (WireProtocol.h).  Both decode into a Command and share execute().
+ * {"requestType":"HELLO","encoding":"msgpack"|"json"} switches what
+ * the device sends that connection (acks, status); it needs `encoding`
+ * — the connection's setting — from the transport, so only the
+ * WebSocket links accept "msgpack".  HELLO always answers, with the
+ * encoding now in effect.
+ *
+ * {"requestType":"POWER","profile":"performance"|"balanced"|"low"}
+ * selects the power profile (PowerManager.h); it is persisted.
+ *
+ * {"requestType":"OTA","action":"begin","size":N,"sha256":"<hex>"},
+ * then "finish" (or "abort" / "status"), drives a firmware update
+ * (OtaManager.h); the image goes in WS chunk frames or POST /ota.
+ * OTA always answers, with the transfer state, the next offset and,
+ * on failure, the reason.
+ *
+ * INTENSITY sets every motor channel, or one with "channel", or
+ * several from channel 0 with "channels":[...];
+ * {"requestType":"PATTERN","pattern":"pulse","periodMs":400} sets how
+ * a channel (or every channel) is modulated (MotorBank.h).  A channel
+ * the board does not have is INVALID.
+ *
+ * A command may also carry a "seq" (uint32, > 0), numbered across
+ * the client's session rather than per connection: it runs once,
+ * whichever link delivers it first, and a copy is acked with the
+ * first result and "duplicate":true (SessionManager.h).  A client
+ * names its session with {"requestType":"HELLO","session":n} on each
+ * link; until it does, a connection's seqs are its own.  REST and
+ * serial have no connection to name one on and count per source.  In
+ * TRANSPORT_AUTO the device probes idle links with
+ * {"type":"probe","seq":n}, answered by {"requestType":"PROBE","seq":n}.
+ *
+ * {"requestType":"SCAN"} always answers with the cached Wi-Fi
+ * networks, strongest first, as "networks":[[ssid,rssi,channel,auth]]
+ * with "ageMs", "total" and "scanning"; a list older than
+ * OPENVIBE_SCAN_MAX_AGE_MS starts a background refresh (WiFiScanCache.h).
+ * Over BLE the list is cut to fit BLE_ACK_MAX.
+ *
+ * {"requestType":"HISTORY","from":-600,"to":0,"res":10} always
+ * answers with recorded stats (HistoryStore.h): "now" (uptime s),
+ * "res" (seconds per row), "from" (time of the first row) and "rows";
+ * a negative from, and a to of 0 or less, are relative to now (from 0
+ * is boot).  A reply that stops short (MAX_ROWS, or BLE_ACK_MAX over
+ * BLE) carries "next", the "from" to ask with for the rest.  An
+ * inverted range is INVALID.
+ *
+ * SWITCH_TRANSPORT to a transport compiled out of this build, and
+ * WIFI_CREDENTIALS or SCAN in a build without Wi-Fi, are INVALID
+ * (Features.h).
+ *
+ * Every frame, parsed or not, is appended to the TraceRecorder with
+ * its arrival time and result.
+ */
+class CommandProcessor {
+public:
+    static constexpr uint8_t MAX_BATCH = 16;
+
+    static CommandProcessor& getInstance();
+
+    // `encoding` and `session` are the connection's, kept by the
+    // transport (WIRE_JSON and 0 when a client connects); HELLO sets
+    // them.  Null for a transport without per-connection state.
+    CommandResult handleJson(const char* payload, size_t len, CommandSource src,
+                             String* ack = nullptr, WireEncoding* encoding = nullptr,
+                             uint32_t* session = nullptr);
+
+    // `reply` receives the MessagePack ack (MSG_ACK) when one is due;
+    // it is left empty otherwise.
+    CommandResult handleMsgPack(const uint8_t* data, size_t len, CommandSource src,
+                                MsgPackWriter* reply = nullptr, WireEncoding* encoding = nullptr,
+                                uint32_t* session = nullptr);
+
+    // Frames handled so far, any source or result.  The loop compares
+    // it across a pass to tell whether input is still arriving.
+    uint32_t frameCount() const { return frames; }
+
+    static const char* sourceTag(CommandSource src);
+    static const char* resultName(CommandResult result);
+    static const char* transportName(TransportMode mode);
+    static bool        parseTransport(const char* name, TransportMode& out);
+    static RequestType requestTypeOf(const char* name, size_t len);   // REQ_UNKNOWN if none
+    static bool        linkOf(CommandSource src, TransportMode& out);   // session link, if any
+
+private:
+    CommandProcessor() = default;
+
+    uint32_t frames = 0;
+    uint32_t sourceSessions[SOURCE_COUNT] = {};   // seq sessions of REST / serial
+
+    // Longest attribute value a BLE client can read back (ATT limit).
+    static constexpr size_t BLE_ACK_MAX = 512;
+
+    CommandProcessor(const CommandProcessor&)            = delete;
+    CommandProcessor& operator=(const CommandProcessor&) = delete;
+
+    struct BatchResults {
+        CommandResult results[MAX_BATCH];
+        uint8_t       count = 0;
+    };
+
+    // What the top level of a MessagePack frame needs for its ack.
+    struct MsgPackFrame {
+        RequestType  type  = REQ_UNKNOWN;
+        uint32_t     id    = 0;
+        bool         hasId = false;
+        bool         duplicate = false;   // seq already ran; nothing executed
+        BatchResults batch;
+        HistoryStore::Query history;      // HISTORY: the range to answer with
+    };
+
+    // Decoding
+    static void   fromJson(JsonObjectConst doc, Command& cmd);
+    CommandResult runMsgPack(MsgPackReader& r, CommandSource src, WireEncoding* encoding, uint32_t* session,
+                             MsgPackFrame* top);
+
+    // Execution
+    CommandResult execute(const Command& cmd, CommandSource src, WireEncoding* encoding, uint32_t* session);
+    CommandResult executeBatch(JsonVariantConst commands, CommandSource src, WireEncoding* encoding,
+                               uint32_t* session, BatchResults& out);
+    void          finishBatch(CommandSource src, const BatchResults& batch, CommandResult overall);
+    CommandResult handleTrace(const Command& cmd);
+    CommandResult handleOta(const Command& cmd, CommandSource src, const char* tag);
+
+    // Session
+    static void noteHeard(CommandSource src);
+    uint32_t    sessionOf(CommandSource src, uint32_t* session);
+    bool        alreadyRan(const Command& cmd, CommandSource src, uint32_t* session, CommandResult& prior);
+    void        remember(const Command& cmd, CommandSource src, uint32_t* session, CommandResult result);
+};
+
+#endif // COMMAND_PROCESSOR_H
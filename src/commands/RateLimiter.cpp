@@ -0,0 +1,276 @@
+#include "RateLimiter.h"
+#include "../protocol/WireProtocol.h"
+#include "../log/Logger.h"
+
+static const char* const CLASS_NAMES[CLASS_COUNT] = { "control", "query", "config" };
+
+static constexpr RateLimiter::Limit DEFAULT_LIMITS[CLASS_COUNT] = {
+    { OPENVIBE_RATE_CONTROL_MS, OPENVIBE_RATE_CONTROL_BURST },
+    { OPENVIBE_RATE_QUERY_MS,   OPENVIBE_RATE_QUERY_BURST },
+    { OPENVIBE_RATE_CONFIG_MS,  OPENVIBE_RATE_CONFIG_BURST },
+};
+
+RateLimiter& RateLimiter::getInstance() {
+    static RateLimiter inst;
+    return inst;
+}
+
+RateLimiter::RateLimiter() {
+    memset(stats, 0, sizeof(stats));
+    for (uint8_t s = 0; s < SOURCE_COUNT; ++s) {
+        for (uint8_t c = 0; c < CLASS_COUNT; ++c) {
+            limits[s][c] = s == SOURCE_SERIAL ? Limit{ 0, 0 } : DEFAULT_LIMITS[c];
+        }
+        fill(shared[s], (CommandSource)s);
+    }
+    for (uint8_t p = 0; p < WS_PEERS; ++p) fill(peers[p], SOURCE_WS_LOCAL);
+}
+
+const char* RateLimiter::className(CommandClass cls) {
+    return cls < CLASS_COUNT ? CLASS_NAMES[cls] : "?";
+}
+
+// CLASS_COUNT: costs nothing (a BATCH costs its items).
+CommandClass RateLimiter::classOf(RequestType type) {
+    switch (type) {
+        case REQ_STATUS:
+        case REQ_TRACE:
+        case REQ_SCAN:
+        case REQ_HISTORY:          return CLASS_QUERY;
+        case REQ_WIFI_CREDENTIALS:
+        case REQ_SWITCH_TRANSPORT:
+        case REQ_TELEMETRY_RATE:
+        case REQ_POWER:
+        case REQ_OTA:              return CLASS_CONFIG;
+        case REQ_BATCH:
+        case REQ_PROBE:            return CLASS_COUNT;
+        default:                   return CLASS_CONTROL;
+    }
+}
+
+// ── Classification (no parse) ────────────────────────────────────────
+
+namespace {
+
+struct Cost {
+    uint8_t  need[CLASS_COUNT] = {};
+    uint16_t commands          = 0;   // BATCH items and single commands seen
+
+    void add(RequestType type) {
+        if (type == REQ_BATCH) return;
+        ++commands;
+        CommandClass cls = RateLimiter::classOf(type);
+        if (cls < CLASS_COUNT && need[cls] < UINT8_MAX) ++need[cls];
+    }
+    // A frame with no command we could see is charged as one control.
+    void finish() {
+        if (!commands) add(REQ_UNKNOWN);
+    }
+};
+
+const char   TYPE_KEY[] = "\"requestType\"";
+const size_t TYPE_LEN   = sizeof(TYPE_KEY) - 1;
+
+// Every "requestType" value, the BATCH items' included.  A key that is
+// really inside a string value only miscounts, never misparses.
+void classifyJson(const char* data, size_t len, Cost& cost) {
+    const char* p   = data;
+    const char* end = data + len;
+    while ((p = (const char*)memchr(p, '"', end - p))) {
+        if ((size_t)(end - p) < TYPE_LEN || memcmp(p, TYPE_KEY, TYPE_LEN) != 0) {
+            ++p;
+            continue;
+        }
+        p += TYPE_LEN;
+        while (p < end && (*p == ':' || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+        if (p == end || *p != '"') continue;
+
+        const char* name = ++p;
+        p = (const char*)memchr(p, '"', end - p);
+        if (!p) break;
+        cost.add(CommandProcessor::requestTypeOf(name, p - name));
+        ++p;
+    }
+    cost.finish();
+}
+
+RequestType typeOf(int64_t v) {
+    return v > 0 && v <= UINT8_MAX ? (RequestType)v : REQ_UNKNOWN;
+}
+
+// KEY_TYPE of one command map; the rest of it is skipped.
+RequestType mapType(MsgPackReader& r, uint32_t entries) {
+    RequestType type = REQ_UNKNOWN;
+    int64_t     key, v;
+    while (entries-- && r.ok()) {
+        if (!r.sint(key)) { r.skip(); r.skip(); continue; }
+        if (key == wire::KEY_TYPE && r.sint(v)) type = typeOf(v);
+        else                                    r.skip();
+    }
+    return type;
+}
+
+// Top-level keys only, plus KEY_TYPE of each KEY_COMMANDS item.
+void classifyMsgPack(const uint8_t* data, size_t len, Cost& cost) {
+    MsgPackReader r(data, len);
+    uint32_t      entries, n;
+    int64_t       key, v;
+    if (r.map(entries)) {
+        while (entries-- && r.ok()) {
+            if (!r.sint(key)) { r.skip(); r.skip(); continue; }
+            if (key == wire::KEY_TYPE && r.sint(v)) {
+                cost.add(typeOf(v));
+            } else if (key == wire::KEY_COMMANDS && r.array(n)) {
+                while (n-- && r.ok()) {
+                    uint32_t m;
+                    if (r.map(m)) cost.add(mapType(r, m));
+                    else          { r.skip(); cost.add(REQ_UNKNOWN); }
+                }
+            } else {
+                r.skip();
+            }
+        }
+    }
+    cost.finish();
+}
+
+} // namespace
+
+// ── Admission ────────────────────────────────────────────────────────
+
+bool RateLimiter::admitJson(CommandSource src, uint8_t peer, const char* data, size_t len, uint32_t now) {
+    Cost cost;
+    classifyJson(data, len, cost);
+    admitted.open = take(src, peer, cost.need, now);
+    admitted.src  = src;
+    admitted.peer = peer;
+    memcpy(admitted.need, cost.need, sizeof(admitted.need));
+    return admitted.open;
+}
+
+// The same count over the parsed frame, as CommandProcessor reads it.
+bool RateLimiter::settleJson(CommandSource src, JsonObjectConst doc, uint32_t now) {
+    if (!admitted.open || admitted.src != src) return true;
+    admitted.open = false;
+
+    Cost        cost;
+    const char* name = doc["requestType"];
+    RequestType type = CommandProcessor::requestTypeOf(name, name ? strlen(name) : 0);
+    if (type == REQ_BATCH) {
+        for (JsonVariantConst item : doc["commands"].as<JsonArrayConst>()) {
+            name = item["requestType"];
+            cost.add(CommandProcessor::requestTypeOf(name, name ? strlen(name) : 0));
+        }
+    }
+    cost.add(type);
+    cost.finish();
+
+    // Only what the scan missed; a scan that counted too much is not refunded.
+    uint8_t extra[CLASS_COUNT] = {};
+    bool    more = false;
+    for (uint8_t c = 0; c < CLASS_COUNT; ++c) {
+        if (cost.need[c] <= admitted.need[c]) continue;
+        extra[c] = cost.need[c] - admitted.need[c];
+        more     = true;
+    }
+    return !more || take(src, admitted.peer, extra, now);
+}
+
+bool RateLimiter::admitMsgPack(CommandSource src, uint8_t peer, const uint8_t* data, size_t len,
+                               uint32_t now) {
+    Cost cost;
+    classifyMsgPack(data, len, cost);
+    return take(src, peer, cost.need, now);
+}
+
+bool RateLimiter::admit(CommandSource src, uint8_t peer, CommandClass cls, uint32_t now) {
+    uint8_t need[CLASS_COUNT] = {};
+    if (cls < CLASS_COUNT) need[cls] = 1;
+    return take(src, peer, need, now);
+}
+
+RateLimiter::Bucket* RateLimiter::buckets(CommandSource src, uint8_t peer) {
+    if (src >= SOURCE_COUNT) return nullptr;
+    return src == SOURCE_WS_LOCAL ? peers[peer % WS_PEERS] : shared[src];
+}
+
+void RateLimiter::fill(Bucket* row, CommandSource src) {
+    for (uint8_t c = 0; c < CLASS_COUNT; ++c) {
+        row[c].creditMs = limits[src][c].intervalMs * limits[src][c].burst;
+        row[c].lastMs   = 0;
+        row[c].loggedMs = 0;
+        row[c].run      = 0;
+    }
+}
+
+void RateLimiter::peerReset(uint8_t peer) {
+    fill(peers[peer % WS_PEERS], SOURCE_WS_LOCAL);
+}
+
+void RateLimiter::setLimit(CommandSource src, CommandClass cls, const Limit& l) {
+    if (src >= SOURCE_COUNT || cls >= CLASS_COUNT) return;
+    limits[src][cls] = l;
+    uint32_t cap = l.intervalMs * l.burst;
+    if (src == SOURCE_WS_LOCAL) {
+        for (Bucket* row : peers) row[cls].creditMs = cap;
+    } else {
+        shared[src][cls].creditMs = cap;
+    }
+}
+
+// "WS#2", "BLE", … for the log.
+static const char* peerTag(char* buf, size_t size, CommandSource src, uint8_t peer) {
+    if (src != SOURCE_WS_LOCAL) return CommandProcessor::sourceTag(src);
+    snprintf(buf, size, "WS#%u", (unsigned)peer);
+    return buf;
+}
+
+// All or nothing: a frame only spends its tokens when every class it
+// needs has enough.
+bool RateLimiter::take(CommandSource src, uint8_t peer, const uint8_t need[CLASS_COUNT], uint32_t now) {
+    Bucket* row = buckets(src, peer);
+    if (!row) return true;
+
+    uint8_t shortOf = 0;   // bit c: class c lacks tokens
+    for (uint8_t c = 0; c < CLASS_COUNT; ++c) {
+        const Limit& l = limits[src][c];
+        if (!need[c] || !l.intervalMs) continue;
+
+        Bucket&  b       = row[c];
+        uint32_t cap     = l.intervalMs * l.burst;
+        uint32_t elapsed = now - b.lastMs;
+        b.creditMs = elapsed >= cap - b.creditMs ? cap : b.creditMs + elapsed;
+        b.lastMs   = now;
+        if (b.creditMs < need[c] * l.intervalMs) shortOf |= 1u << c;
+    }
+
+    char tag[8];
+    for (uint8_t c = 0; c < CLASS_COUNT; ++c) {
+        if (!need[c]) continue;
+        const Limit& l = limits[src][c];
+        Bucket&      b = row[c];
+
+        if (shortOf) {
+            stats[src][c].dropped += need[c];
+            if (!(shortOf & (1u << c))) continue;
+            if (b.run == 0 && now - b.loggedMs >= LOG_EVERY_MS) {
+                LOG_W(CMD, "[%s] Over the %s limit, dropping\n",
+                           peerTag(tag, sizeof(tag), src, peer), CLASS_NAMES[c]);
+                b.loggedMs = now;
+            }
+            if (b.run < UINT16_MAX) ++b.run;
+            continue;
+        }
+
+        stats[src][c].admitted += need[c];
+        if (l.intervalMs) b.creditMs -= need[c] * l.intervalMs;
+        // A steady flood gets one line a second, not one per admit.
+        if (b.run && now - b.loggedMs >= LOG_EVERY_MS) {
+            LOG_I(CMD, "[%s] %u %s frame(s) dropped\n",
+                       peerTag(tag, sizeof(tag), src, peer), (unsigned)b.run, CLASS_NAMES[c]);
+            b.loggedMs = now;
+            b.run      = 0;
+        }
+    }
+    return !shortOf;
+}
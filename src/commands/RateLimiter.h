@@ -0,0 +1,124 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <Arduino.h>
+#include "CommandProcessor.h"
+
+// One token every *_MS, at most *_BURST saved up, for each source (each
+// local WebSocket client on its own) and class.  *_MS 0 = not limited.
+#ifndef OPENVIBE_RATE_CONTROL_MS
+#define OPENVIBE_RATE_CONTROL_MS    20     // 50 / s
+#endif
+#ifndef OPENVIBE_RATE_CONTROL_BURST
+#define OPENVIBE_RATE_CONTROL_BURST 25
+#endif
+#ifndef OPENVIBE_RATE_QUERY_MS
+#define OPENVIBE_RATE_QUERY_MS      100    // 10 / s
+#endif
+#ifndef OPENVIBE_RATE_QUERY_BURST
+#define OPENVIBE_RATE_QUERY_BURST   10
+#endif
+#ifndef OPENVIBE_RATE_CONFIG_MS
+#define OPENVIBE_RATE_CONFIG_MS     2000   // NVS write and / or reconnect each
+#endif
+#ifndef OPENVIBE_RATE_CONFIG_BURST
+#define OPENVIBE_RATE_CONFIG_BURST  3
+#endif
+
+/** What a command costs the device, for rate limiting. */
+enum CommandClass : uint8_t {
+    CLASS_CONTROL = 0,   // INTENSITY, PATTERN, HELLO, anything unrecognised
+    CLASS_QUERY   = 1,   // STATUS, TRACE, SCAN, HISTORY, REST GETs
+    CLASS_CONFIG  = 2,   // WIFI_CREDENTIALS, SWITCH_TRANSPORT, TELEMETRY_RATE, POWER, OTA
+    CLASS_COUNT
+};
+
+/**
+ * Token buckets in front of the command path, so one client that
+ * floods cannot take the loop from the others.
+ *
+ * Transports ask before handing a frame to CommandProcessor.  The frame
+ * is classified without being parsed — a scan for "requestType" values
+ * in JSON, a walk over the top-level keys in MessagePack — and every
+ * command in it (each BATCH item) takes a token of its class.  A frame
+ * that does not get them all is dropped whole, unanswered and not
+ * traced; REST answers 429.  PROBE echoes cost nothing: they are the
+ * device's own probes coming back.
+ *
+ * The JSON scan reads raw bytes, so a type it cannot see (an escaped
+ * key or name) is charged as one control.  CommandProcessor settles
+ * the frame once it is parsed: what its commands really need beyond
+ * that charge is taken then, or the frame is still dropped.
+ *
+ * Buckets are per source, and per client on the local WebSocket server
+ * (WS_PEERS of them).  Serial is not limited.  Each (source, class)
+ * counts what it let through and what it dropped.
+ */
+class RateLimiter {
+public:
+    static constexpr uint8_t WS_PEERS = 8;
+
+    struct Limit {
+        uint32_t intervalMs;   // per token; 0 = unlimited
+        uint16_t burst;
+    };
+
+    struct Counters {
+        uint32_t admitted;   // commands
+        uint32_t dropped;
+    };
+
+    static RateLimiter& getInstance();
+
+    // False: drop the frame.  `peer` is the WS client number for
+    // SOURCE_WS_LOCAL and ignored otherwise.
+    bool admitJson(CommandSource src, uint8_t peer, const char* data, size_t len, uint32_t now);
+    bool admitMsgPack(CommandSource src, uint8_t peer, const uint8_t* data, size_t len, uint32_t now);
+    bool admit(CommandSource src, uint8_t peer, CommandClass cls, uint32_t now);
+    // After the parse of the frame admitJson() last let through from
+    // `src`; true when there is none (the source is not limited here).
+    bool settleJson(CommandSource src, JsonObjectConst doc, uint32_t now);
+
+    void peerReset(uint8_t peer);   // WS client slot (re)used: full buckets
+
+    void            setLimit(CommandSource src, CommandClass cls, const Limit& limit);
+    const Limit&    limit(CommandSource src, CommandClass cls) const { return limits[src][cls]; }
+    const Counters& counters(CommandSource src, CommandClass cls) const { return stats[src][cls]; }
+
+    static const char*  className(CommandClass cls);
+    static CommandClass classOf(RequestType type);
+
+private:
+    RateLimiter();
+    RateLimiter(const RateLimiter&)            = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    struct Bucket {
+        uint32_t creditMs;   // saved-up refill time; a token costs intervalMs
+        uint32_t lastMs;
+        uint32_t loggedMs;   // last log line about it
+        uint16_t run;        // dropped and not logged yet
+    };
+
+    static constexpr uint32_t LOG_EVERY_MS = 1000;   // per bucket, while it drops
+
+    Limit    limits[SOURCE_COUNT][CLASS_COUNT];
+    Counters stats[SOURCE_COUNT][CLASS_COUNT];
+    Bucket   shared[SOURCE_COUNT][CLASS_COUNT];
+    Bucket   peers[WS_PEERS][CLASS_COUNT];      // SOURCE_WS_LOCAL, by client
+
+    // The frame admitJson() let through, until settleJson()
+    struct Admitted {
+        bool          open = false;
+        CommandSource src  = SOURCE_BLE;
+        uint8_t       peer = 0;
+        uint8_t       need[CLASS_COUNT] = {};
+    };
+    Admitted admitted;
+
+    Bucket* buckets(CommandSource src, uint8_t peer);
+    void    fill(Bucket* row, CommandSource src);
+    bool    take(CommandSource src, uint8_t peer, const uint8_t need[CLASS_COUNT], uint32_t now);
+};
+
+#endif // RATE_LIMITER_H
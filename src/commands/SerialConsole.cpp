@@ -0,0 +1,34 @@
+#include "SerialConsole.h"
+#include "CommandProcessor.h"
+#include "RateLimiter.h"
+#include "../hal/Hal.h"
+#include "../log/Logger.h"
+
+SerialConsole::SerialConsole()
+    : lineLen(0)
+    , overflow(false) {}
+
+void SerialConsole::loop() {
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c < 0) break;
+
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (lineLen < MAX_LINE) line[lineLen++] = (char)c;
+            else overflow = true;
+            continue;
+        }
+
+        if (overflow) {
+            LOG_W(CMD, "[Serial] Line over %u bytes dropped\n", (unsigned)MAX_LINE);
+        } else if (lineLen > 0 &&
+                   RateLimiter::getInstance().admitJson(SOURCE_SERIAL, 0, line, lineLen, hal::millis())) {
+            String ack;
+            CommandProcessor::getInstance().handleJson(line, lineLen, SOURCE_SERIAL, &ack);
+            if (!ack.isEmpty()) Serial.println(ack);
+        }
+        lineLen  = 0;
+        overflow = false;
+    }
+}
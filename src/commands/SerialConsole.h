@@ -0,0 +1,28 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+
+/**
+ * Line-oriented command input on the USB serial port.
+ *
+ * Each line is one JSON command, handled by CommandProcessor as
+ * SOURCE_SERIAL; an ack (if the command carried an "id") is printed
+ * back.  This is how a trace is pulled without Wi-Fi:
+ *
+ *   {"requestType":"TRACE","action":"dump"}
+ */
+class SerialConsole {
+public:
+    SerialConsole();
+    void loop();
+
+private:
+    static constexpr size_t MAX_LINE = 512;
+
+    char   line[MAX_LINE];
+    size_t lineLen;
+    bool   overflow;   // discard until the next newline
+};
+
+#endif // SERIAL_CONSOLE_H
@@ -0,0 +1,233 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <Arduino.h>
+
+class AdcSource;
+
+/**
+ * Hardware abstraction layer.
+ *
+ * Everything the firmware needs from the chip goes through here:
+ * clock, GPIO/PWM, identity, the Wi-Fi station, mDNS, periodic timers, a
+ * background task, a mutex, whole-file flash storage, ADC inputs, the loop's event wait,
+ * CPU / modem power settings and the firmware (OTA) slots.  Two
+ * implementations exist, selected by build_src_filter:
+ *
+ *  - src/hal/esp32/  — Arduino-ESP32 / ESP-IDF
+ *  - src/hal/native/ — Linux host build (env:native), simulated GPIO
+ *                      and Wi-Fi, real sockets for WS/HTTP
+ *
+ * NVS lives in hal/Nvs.h; BLE is simulated by swapping the BLEManager
+ * implementation (see src/hal/native/BLEManagerSim.cpp).
+ */
+namespace hal {
+
+// ── Clock ────────────────────────────────────────────────────────────
+uint32_t millis();
+uint32_t micros();
+void     delayMs(uint32_t ms);
+
+// ── GPIO / PWM ───────────────────────────────────────────────────────
+void gpioOutput(int pin);
+void gpioInput(int pin, bool pullUp);
+void gpioWrite(int pin, bool high);
+bool gpioRead(int pin);
+// PWM channels (LEDC on the ESP32): attach once, then write duties of
+// `bits` resolution (0 … 2^bits − 1).  False if the channel, pin or
+// frequency / resolution pair is not supported.
+bool pwmAttach(uint8_t channel, int pin, uint32_t freqHz, uint8_t bits);
+void pwmWrite(uint8_t channel, uint32_t duty);
+
+// ── Identity ─────────────────────────────────────────────────────────
+String macAddress();   // "AA:BB:CC:DD:EE:FF"
+String deviceId();     // lower 32 bits of the factory MAC, hex
+
+// ── Wi-Fi station ────────────────────────────────────────────────────
+// The device HAL only defines these with OPENVIBE_WITH_WIFI (Features.h).
+struct WiFiScanEntry {
+    String  ssid;
+    int32_t rssi;
+    uint8_t channel;
+    uint8_t authMode;   // 0 = open
+};
+
+// Link up / down also wake() the loop.
+void   wifiInit();
+void   wifiBegin(const char* ssid, const char* password);
+void   wifiDisconnect();
+bool   wifiIsConnected();
+String wifiLocalIP();
+int8_t wifiRssi();      // dBm of the associated AP, 0 when not connected
+
+// Asynchronous scan: wifiScanStart() returns at once (false if the
+// radio refused) and completion wakes() the loop.  wifiScanComplete()
+// is -1 while running, -2 if nothing ran or it failed, else the number
+// of results.  wifiScanDelete() frees them and stops a running scan.
+bool wifiScanStart();
+int  wifiScanComplete();
+bool wifiScanResult(int index, WiFiScanEntry& out);
+void wifiScanDelete();
+
+// Modem sleep between DTIM beacons.  NONE is refused by the ESP32
+// while the BLE controller is up (coexistence needs the modem to sleep).
+enum WiFiPowerSave : uint8_t {
+    POWER_SAVE_NONE      = 0,
+    POWER_SAVE_MIN_MODEM = 1,   // wake every DTIM
+    POWER_SAVE_MAX_MODEM = 2    // wake every listen interval
+};
+void wifiSetPowerSave(WiFiPowerSave mode);
+
+// ── mDNS / DNS-SD ────────────────────────────────────────────────────
+// Only with OPENVIBE_WITH_MDNS.  A responder for <hostname>.local that
+// answers for the services added, under `instance`; it runs on its own
+// task and announces changes itself.  Names carry the underscore:
+// ("_http", "_tcp").  Setting a TXT key again replaces its value.
+bool mdnsBegin(const char* hostname, const char* instance);
+void mdnsEnd();
+bool mdnsAddService(const char* service, const char* proto, uint16_t port);
+void mdnsRemoveService(const char* service, const char* proto);
+bool mdnsSetTxt(const char* service, const char* proto, const char* key, const char* value);
+
+// ── CPU ──────────────────────────────────────────────────────────────
+bool     cpuSetFrequencyMhz(uint32_t mhz);   // 80 / 160 / 240 on the ESP32
+uint32_t cpuFrequencyMhz();
+
+// ── Loop wait ────────────────────────────────────────────────────────
+// The loop task blocks in waitForEvent() until wake() is called from
+// another task or timer callback, serial input arrives, or timeoutMs
+// passes (WAIT_FOREVER = no timeout).  Returns true when woken early.
+//
+// On the host every socket the network shims open also wakes it
+// (poll()), so socketsWakeLoop() is true.  On the device the Arduino
+// network classes buffer reads in user space where select() cannot
+// see them, so the caller has to bound its sleep while sockets are
+// open.
+constexpr uint32_t WAIT_FOREVER = UINT32_MAX;
+
+bool waitForEvent(uint32_t timeoutMs);
+void wake();
+void wakeOnSerialInput();
+size_t serialWriteRoom();   // bytes Serial takes now without blocking
+bool socketsWakeLoop();
+
+// ── System ───────────────────────────────────────────────────────────
+void     restart();    // does not return
+uint32_t heapUsed();   // bytes allocated right now
+
+// ── Firmware slots (OTA) ─────────────────────────────────────────────
+// Raw access to the app partition that is not running, so an update
+// can be streamed straight to flash.  Erase before write, a sector at
+// a time.  otaActivate() checks the image and boots it on the next
+// restart; otaRevert() boots the other slot again (rollback).  On the
+// host the slots are files under <nvs-dir>/ota/ and restart() re-execs
+// the simulator.
+constexpr size_t OTA_SECTOR = 4096;
+
+size_t otaSlotSize();   // 0 = partition table has no OTA slot
+bool   otaErase(size_t offset, size_t len);   // sector aligned
+bool   otaWrite(size_t offset, const uint8_t* data, size_t len);
+bool   otaRead(size_t offset, uint8_t* data, size_t len);
+bool   otaActivate();
+bool   otaRevert();
+void   otaConfirm();    // running image is good: cancel any bootloader rollback
+String otaRunningSlot();
+
+// ── SHA-256 (hardware-assisted on the ESP32) ─────────────────────────
+class Sha256 {
+public:
+    static constexpr size_t DIGEST_LEN = 32;
+
+    Sha256();
+    ~Sha256();
+
+    void reset();
+    void update(const uint8_t* data, size_t len);
+    void finish(uint8_t out[DIGEST_LEN]);
+
+private:
+    void* handle;
+
+    Sha256(const Sha256&)            = delete;
+    Sha256& operator=(const Sha256&) = delete;
+};
+
+// ── Periodic timer (runs off the loop task) ──────────────────────────
+class PeriodicTimer {
+public:
+    using Callback = void (*)(void* arg);
+
+    PeriodicTimer();
+    ~PeriodicTimer();
+
+    bool start(uint32_t periodMs, Callback cb, void* arg, const char* name);
+    void stop();
+
+private:
+    void* handle;
+
+    PeriodicTimer(const PeriodicTimer&)            = delete;
+    PeriodicTimer& operator=(const PeriodicTimer&) = delete;
+};
+
+// ── Background task ──────────────────────────────────────────────────
+// `entry` runs once in its own task (host: thread) at the loop's
+// priority and normally loops on waitNotify().  notify() may be called
+// from any task.  The task is never stopped.
+class Task {
+public:
+    using Entry = void (*)(void* arg);
+
+    Task();
+
+    bool start(const char* name, Entry entry, void* arg, uint32_t stackBytes);
+    void notify();
+    bool waitNotify(uint32_t timeoutMs);   // from the task; false on timeout
+
+private:
+    void* handle;
+
+    Task(const Task&)            = delete;
+    Task& operator=(const Task&) = delete;
+};
+
+// ── Mutex (state shared with BLE / timer tasks) ──────────────────────
+class Mutex {
+public:
+    Mutex();
+    ~Mutex();
+
+    void lock();
+    void unlock();
+
+private:
+    void* handle;
+
+    Mutex(const Mutex&)            = delete;
+    Mutex& operator=(const Mutex&) = delete;
+};
+
+class LockGuard {
+public:
+    explicit LockGuard(Mutex& m) : m(m) { m.lock(); }
+    ~LockGuard() { m.unlock(); }
+
+private:
+    Mutex& m;
+};
+
+// ── File storage (LittleFS on the device, <nvs-dir>/fs/ on the host) ─
+// Paths are absolute ("/trace.bin").  Mounted lazily on first use.
+bool   fileWrite(const char* path, const uint8_t* data, size_t len);
+bool   fileAppend(const char* path, const uint8_t* data, size_t len);   // creates if missing
+size_t fileSize(const char* path);   // 0 if missing
+size_t fileRead(const char* path, size_t offset, uint8_t* buf, size_t len);
+bool   fileRemove(const char* path);
+
+// ── ADC ──────────────────────────────────────────────────────────────
+// Caller owns the returned source.
+AdcSource* createAdcSource(int pin);
+
+} // namespace hal
+
+#endif // HAL_H
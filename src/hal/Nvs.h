@@ -0,0 +1,57 @@
+#ifndef HAL_NVS_H
+#define HAL_NVS_H
+
+#include <Arduino.h>
+
+#if !OPENVIBE_NATIVE
+#include <Preferences.h>
+#endif
+
+namespace hal {
+
+#if OPENVIBE_NATIVE
+struct NvsNamespace;
+#endif
+
+/**
+ * Scoped handle on one NVS namespace (RAII begin/end).
+ *
+ * Mirrors the subset of Arduino Preferences the firmware uses.  On
+ * ESP32 it wraps Preferences directly; the host build keeps one
+ * key/value file per namespace under $OPENVIBE_NVS_DIR (default
+ * ./.nvs) and rewrites it when a writable handle closes.
+ */
+class Nvs {
+public:
+    Nvs(const char* ns, bool readOnly);
+    ~Nvs();
+
+    bool isKey(const char* key);
+    bool remove(const char* key);
+
+    String   getString(const char* key, const String& def);
+    int32_t  getInt(const char* key, int32_t def);
+    uint32_t getUInt(const char* key, uint32_t def);
+    size_t   getBytes(const char* key, void* buf, size_t maxLen);
+
+    void putString(const char* key, const String& value);
+    void putInt(const char* key, int32_t value);
+    void putUInt(const char* key, uint32_t value);
+    void putBytes(const char* key, const void* buf, size_t len);
+
+private:
+#if OPENVIBE_NATIVE
+    NvsNamespace* ns;
+    bool          dirty;
+#else
+    Preferences prefs;
+#endif
+    bool readOnly;
+
+    Nvs(const Nvs&)            = delete;
+    Nvs& operator=(const Nvs&) = delete;
+};
+
+} // namespace hal
+
+#endif // HAL_NVS_H
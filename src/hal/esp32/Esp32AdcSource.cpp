@@ -0,0 +1,18 @@
+#include "Esp32AdcSource.h"
+#include "../../log/Logger.h"
+
+Esp32AdcSource::Esp32AdcSource(int pin) : pin(pin) {}
+
+bool Esp32AdcSource::begin() {
+    if (pin < 32 || pin > 39) {
+        LOG_E(POWER, "[Battery] GPIO %d is not an ADC1 pin\n", pin);
+        return false;
+    }
+    analogReadResolution(12);
+    analogSetPinAttenuation(pin, ADC_11db);   // full 0–3.1 V range
+    return true;
+}
+
+uint32_t Esp32AdcSource::readMilliVolts() {
+    return analogReadMilliVolts(pin);
+}
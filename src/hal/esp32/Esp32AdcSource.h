@@ -0,0 +1,22 @@
+#ifndef ESP32_ADC_SOURCE_H
+#define ESP32_ADC_SOURCE_H
+
+#include <Arduino.h>
+#include "../../power/AdcSource.h"
+
+/**
+ * ADC1 channel read through the eFuse-calibrated one-shot driver.
+ * ADC1 pins only (32–39): ADC2 is unusable while Wi-Fi is running.
+ */
+class Esp32AdcSource : public AdcSource {
+public:
+    explicit Esp32AdcSource(int pin);
+
+    bool     begin() override;
+    uint32_t readMilliVolts() override;
+
+private:
+    int pin;
+};
+
+#endif // ESP32_ADC_SOURCE_H
@@ -0,0 +1,366 @@
+#include "../Hal.h"
+#include "../../Features.h"
+#include "Esp32AdcSource.h"
+#if OPENVIBE_WITH_WIFI
+#include <WiFi.h>
+#include <esp_wifi.h>
+#endif
+#if OPENVIBE_WITH_MDNS
+#include <ESPmDNS.h>
+#endif
+#include <esp_timer.h>
+#include <esp_ota_ops.h>
+#include <LittleFS.h>
+#include <mbedtls/sha256.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+namespace hal {
+
+// ── Clock ────────────────────────────────────────────────────────────
+
+uint32_t millis()            { return ::millis(); }
+uint32_t micros()            { return ::micros(); }
+void     delayMs(uint32_t ms) { ::delay(ms); }
+
+// ── GPIO / PWM ───────────────────────────────────────────────────────
+
+void gpioOutput(int pin)             { pinMode(pin, OUTPUT); }
+void gpioInput(int pin, bool pullUp) { pinMode(pin, pullUp ? INPUT_PULLUP : INPUT_PULLDOWN); }
+void gpioWrite(int pin, bool high)   { digitalWrite(pin, high ? HIGH : LOW); }
+bool gpioRead(int pin)               { return digitalRead(pin) == HIGH; }
+
+bool pwmAttach(uint8_t channel, int pin, uint32_t freqHz, uint8_t bits) {
+    if (channel >= 16 || pin < 0) return false;
+    if (!ledcSetup(channel, freqHz, bits)) return false;   // 0 Hz = unreachable
+    ledcAttachPin(pin, channel);
+    return true;
+}
+
+void pwmWrite(uint8_t channel, uint32_t duty) { ledcWrite(channel, duty); }
+
+// ── Identity ─────────────────────────────────────────────────────────
+
+// Read from eFuse rather than WiFi.macAddress(): same station MAC, but
+// BLE-only builds do not link the Wi-Fi stack for it.
+String macAddress() {
+    uint8_t m[6];
+    esp_read_mac(m, ESP_MAC_WIFI_STA);
+    char buf[18];
+    snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X", m[0], m[1], m[2], m[3], m[4], m[5]);
+    return String(buf);
+}
+
+String deviceId() { return String((uint32_t)ESP.getEfuseMac(), HEX); }
+
+// ── Wi-Fi station ────────────────────────────────────────────────────
+// Absent without OPENVIBE_WITH_WIFI: a stray call fails to link.
+
+#if OPENVIBE_WITH_WIFI
+
+void wifiInit() {
+    static bool hooked = false;
+    if (!hooked) {
+        // Runs on the Arduino event task; the loop re-reads WiFi.status().
+        WiFi.onEvent([](arduino_event_id_t, arduino_event_info_t) { wake(); });
+        hooked = true;
+    }
+    WiFi.mode(WIFI_STA);
+}
+
+void wifiBegin(const char* ssid, const char* password) { WiFi.begin(ssid, password); }
+void wifiDisconnect()                                 { WiFi.disconnect(); }
+bool wifiIsConnected()                                { return WiFi.status() == WL_CONNECTED; }
+String wifiLocalIP()                                  { return WiFi.localIP().toString(); }
+int8_t wifiRssi()                                     { return wifiIsConnected() ? WiFi.RSSI() : 0; }
+
+// Active, hidden SSIDs included, 120 ms per channel (~1.6 s over 13):
+// short dwells leave the BLE controller its connection events.
+bool wifiScanStart() {
+    return WiFi.scanNetworks(true, true, false, 120) == WIFI_SCAN_RUNNING;
+}
+
+int wifiScanComplete() { return WiFi.scanComplete(); }   // WIFI_SCAN_RUNNING / _FAILED
+
+bool wifiScanResult(int index, WiFiScanEntry& out) {
+    if (index < 0 || index >= WiFi.scanComplete()) return false;
+    out.ssid     = WiFi.SSID(index);
+    out.rssi     = WiFi.RSSI(index);
+    out.channel  = WiFi.channel(index);
+    out.authMode = WiFi.encryptionType(index);
+    return true;
+}
+
+void wifiScanDelete() {
+    if (WiFi.scanComplete() == WIFI_SCAN_RUNNING) esp_wifi_scan_stop();
+    WiFi.scanDelete();
+}
+
+void wifiSetPowerSave(WiFiPowerSave mode) {
+    wifi_ps_type_t ps = mode == POWER_SAVE_NONE      ? WIFI_PS_NONE
+                      : mode == POWER_SAVE_MAX_MODEM ? WIFI_PS_MAX_MODEM
+                                                     : WIFI_PS_MIN_MODEM;
+    esp_wifi_set_ps(ps);
+}
+
+#endif // OPENVIBE_WITH_WIFI
+
+// ── mDNS / DNS-SD ────────────────────────────────────────────────────
+
+#if OPENVIBE_WITH_MDNS
+
+bool mdnsBegin(const char* hostname, const char* instance) {
+    if (!MDNS.begin(hostname)) return false;
+    MDNS.setInstanceName(instance);
+    return true;
+}
+
+void mdnsEnd() { MDNS.end(); }
+
+bool mdnsAddService(const char* service, const char* proto, uint16_t port) {
+    return MDNS.addService(service, proto, port);
+}
+
+// ESPmDNS has no remove; the IDF call takes the same names.
+void mdnsRemoveService(const char* service, const char* proto) { mdns_service_remove(service, proto); }
+
+bool mdnsSetTxt(const char* service, const char* proto, const char* key, const char* value) {
+    return MDNS.addServiceTxt(service, proto, key, value);
+}
+
+#endif // OPENVIBE_WITH_MDNS
+
+// ── CPU ──────────────────────────────────────────────────────────────
+
+bool     cpuSetFrequencyMhz(uint32_t mhz) { return setCpuFrequencyMhz(mhz); }
+uint32_t cpuFrequencyMhz()                { return getCpuFrequencyMhz(); }
+
+// ── Loop wait ────────────────────────────────────────────────────────
+
+// Task notifications: wake() from the BLE, event, timer and UART tasks
+// gives; the loop task takes.  Idle time goes to the IDLE task, which
+// halts the core in WAITI until the next interrupt.
+namespace {
+TaskHandle_t loopTask = nullptr;
+}
+
+bool waitForEvent(uint32_t timeoutMs) {
+    loopTask = xTaskGetCurrentTaskHandle();
+    TickType_t ticks = timeoutMs == WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+    return ulTaskNotifyTake(pdTRUE, ticks) > 0;
+}
+
+void wake() {
+    if (loopTask) xTaskNotifyGive(loopTask);
+}
+
+void wakeOnSerialInput() {
+    Serial.onReceive([]() { wake(); });
+}
+
+bool socketsWakeLoop() { return false; }
+
+size_t serialWriteRoom() { return Serial.availableForWrite(); }
+
+// ── System ───────────────────────────────────────────────────────────
+
+void     restart()  { ESP.restart(); }
+uint32_t heapUsed() { return ESP.getHeapSize() - ESP.getFreeHeap(); }
+
+// ── Firmware slots (OTA) ─────────────────────────────────────────────
+
+namespace {
+const esp_partition_t* updateSlot() {
+    static const esp_partition_t* slot = esp_ota_get_next_update_partition(nullptr);
+    return slot;
+}
+}
+
+size_t otaSlotSize() {
+    return updateSlot() ? updateSlot()->size : 0;
+}
+
+bool otaErase(size_t offset, size_t len) {
+    return updateSlot() && esp_partition_erase_range(updateSlot(), offset, len) == ESP_OK;
+}
+
+bool otaWrite(size_t offset, const uint8_t* data, size_t len) {
+    return updateSlot() && esp_partition_write(updateSlot(), offset, data, len) == ESP_OK;
+}
+
+bool otaRead(size_t offset, uint8_t* data, size_t len) {
+    return updateSlot() && esp_partition_read(updateSlot(), offset, data, len) == ESP_OK;
+}
+
+// esp_ota_set_boot_partition() verifies the image (header, segments,
+// checksum / appended SHA-256) before switching otadata.
+bool otaActivate() {
+    return updateSlot() && esp_ota_set_boot_partition(updateSlot()) == ESP_OK;
+}
+
+// The "next update" slot of a freshly updated image is the previous one.
+bool otaRevert() { return otaActivate(); }
+
+void otaConfirm() { esp_ota_mark_app_valid_cancel_rollback(); }
+
+String otaRunningSlot() {
+    const esp_partition_t* p = esp_ota_get_running_partition();
+    return p ? String(p->label) : String("");
+}
+
+// ── SHA-256 ──────────────────────────────────────────────────────────
+
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+#define SHA256_STARTS mbedtls_sha256_starts
+#define SHA256_UPDATE mbedtls_sha256_update
+#define SHA256_FINISH mbedtls_sha256_finish
+#else
+#define SHA256_STARTS mbedtls_sha256_starts_ret
+#define SHA256_UPDATE mbedtls_sha256_update_ret
+#define SHA256_FINISH mbedtls_sha256_finish_ret
+#endif
+
+Sha256::Sha256() : handle(new mbedtls_sha256_context) {
+    mbedtls_sha256_init(static_cast<mbedtls_sha256_context*>(handle));
+    reset();
+}
+
+Sha256::~Sha256() {
+    mbedtls_sha256_free(static_cast<mbedtls_sha256_context*>(handle));
+    delete static_cast<mbedtls_sha256_context*>(handle);
+}
+
+void Sha256::reset() {
+    SHA256_STARTS(static_cast<mbedtls_sha256_context*>(handle), 0);
+}
+
+void Sha256::update(const uint8_t* data, size_t len) {
+    SHA256_UPDATE(static_cast<mbedtls_sha256_context*>(handle), data, len);
+}
+
+void Sha256::finish(uint8_t out[DIGEST_LEN]) {
+    SHA256_FINISH(static_cast<mbedtls_sha256_context*>(handle), out);
+}
+
+// ── Periodic timer ───────────────────────────────────────────────────
+
+PeriodicTimer::PeriodicTimer() : handle(nullptr) {}
+
+PeriodicTimer::~PeriodicTimer() {
+    stop();
+    if (handle) esp_timer_delete(static_cast<esp_timer_handle_t>(handle));
+}
+
+bool PeriodicTimer::start(uint32_t periodMs, Callback cb, void* arg, const char* name) {
+    if (!handle) {
+        esp_timer_create_args_t args = {};
+        args.callback        = cb;
+        args.arg             = arg;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name            = name;
+        esp_timer_handle_t t = nullptr;
+        if (esp_timer_create(&args, &t) != ESP_OK) return false;
+        handle = t;
+    }
+    esp_timer_handle_t t = static_cast<esp_timer_handle_t>(handle);
+    esp_timer_stop(t);   // harmless if not running
+    return esp_timer_start_periodic(t, (uint64_t)periodMs * 1000) == ESP_OK;
+}
+
+void PeriodicTimer::stop() {
+    if (handle) esp_timer_stop(static_cast<esp_timer_handle_t>(handle));
+}
+
+// ── Background task ──────────────────────────────────────────────────
+
+Task::Task() : handle(nullptr) {}
+
+bool Task::start(const char* name, Entry entry, void* arg, uint32_t stackBytes) {
+    if (handle) return true;
+    TaskHandle_t t = nullptr;
+    // Arduino's loop task runs at priority 1; share it round-robin.
+    if (xTaskCreate(entry, name, stackBytes, arg, 1, &t) != pdPASS) return false;
+    handle = t;
+    return true;
+}
+
+void Task::notify() {
+    if (handle) xTaskNotifyGive(static_cast<TaskHandle_t>(handle));
+}
+
+bool Task::waitNotify(uint32_t timeoutMs) {
+    TickType_t ticks = timeoutMs == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+    return ulTaskNotifyTake(pdTRUE, ticks) != 0;
+}
+
+// ── Mutex ────────────────────────────────────────────────────────────
+
+Mutex::Mutex() : handle(xSemaphoreCreateMutex()) {}
+
+Mutex::~Mutex() {
+    if (handle) vSemaphoreDelete(static_cast<SemaphoreHandle_t>(handle));
+}
+
+void Mutex::lock()   { xSemaphoreTake(static_cast<SemaphoreHandle_t>(handle), portMAX_DELAY); }
+void Mutex::unlock() { xSemaphoreGive(static_cast<SemaphoreHandle_t>(handle)); }
+
+// ── File storage ─────────────────────────────────────────────────────
+
+namespace {
+bool mountFs() {
+    static bool mounted = LittleFS.begin(true);   // format on first boot
+    return mounted;
+}
+}
+
+bool fileWrite(const char* path, const uint8_t* data, size_t len) {
+    if (!mountFs()) return false;
+    File f = LittleFS.open(path, "w");
+    if (!f) return false;
+    bool ok = f.write(data, len) == len;
+    f.close();
+    return ok;
+}
+
+bool fileAppend(const char* path, const uint8_t* data, size_t len) {
+    if (!mountFs()) return false;
+    File f = LittleFS.open(path, "a");
+    if (!f) return false;
+    bool ok = f.write(data, len) == len;
+    f.close();
+    return ok;
+}
+
+size_t fileSize(const char* path) {
+    if (!mountFs() || !LittleFS.exists(path)) return 0;
+    File f = LittleFS.open(path, "r");
+    size_t n = f ? f.size() : 0;
+    f.close();
+    return n;
+}
+
+size_t fileRead(const char* path, size_t offset, uint8_t* buf, size_t len) {
+    if (!mountFs() || !LittleFS.exists(path)) return 0;
+    File f = LittleFS.open(path, "r");
+    if (!f || !f.seek(offset)) return 0;
+    size_t n = f.read(buf, len);
+    f.close();
+    return n;
+}
+
+bool fileRemove(const char* path) {
+    return mountFs() && LittleFS.remove(path);
+}
+
+// ── ADC ──────────────────────────────────────────────────────────────
+
+AdcSource* createAdcSource(int pin) {
+    return new Esp32AdcSource(pin);
+}
+
+} // namespace hal
+
+// Keep a freshly updated image in PENDING_VERIFY (when the bootloader
+// has rollback enabled) until OtaManager's health check confirms it;
+// the Arduino core would otherwise confirm it before setup().
+extern "C" bool verifyRollbackLater() { return true; }
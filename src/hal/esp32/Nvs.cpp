@@ -0,0 +1,28 @@
+#include "../Nvs.h"
+
+namespace hal {
+
+Nvs::Nvs(const char* ns, bool ro) : readOnly(ro) {
+    prefs.begin(ns, ro);
+}
+
+Nvs::~Nvs() {
+    prefs.end();
+}
+
+bool Nvs::isKey(const char* key)  { return prefs.isKey(key); }
+bool Nvs::remove(const char* key) { return prefs.remove(key); }
+
+String   Nvs::getString(const char* key, const String& def) { return prefs.getString(key, def); }
+int32_t  Nvs::getInt(const char* key, int32_t def)          { return prefs.getInt(key, def); }
+uint32_t Nvs::getUInt(const char* key, uint32_t def)        { return prefs.getUInt(key, def); }
+size_t   Nvs::getBytes(const char* key, void* buf, size_t maxLen) {
+    return prefs.isKey(key) ? prefs.getBytes(key, buf, maxLen) : 0;
+}
+
+void Nvs::putString(const char* key, const String& value)        { prefs.putString(key, value); }
+void Nvs::putInt(const char* key, int32_t value)                 { prefs.putInt(key, value); }
+void Nvs::putUInt(const char* key, uint32_t value)               { prefs.putUInt(key, value); }
+void Nvs::putBytes(const char* key, const void* buf, size_t len) { prefs.putBytes(key, buf, len); }
+
+} // namespace hal
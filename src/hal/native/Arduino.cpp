@@ -0,0 +1,171 @@
+#include <Arduino.h>
+#include <base64.h>
+#include "../Hal.h"
+#include "NativeNet.h"
+#include <stdarg.h>
+#include <ctype.h>
+#include <poll.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+
+uint32_t millis()       { return hal::millis(); }
+uint32_t micros()       { return hal::micros(); }
+void     delay(uint32_t ms) { hal::delayMs(ms); }
+
+// ── String ───────────────────────────────────────────────────────────
+
+namespace {
+
+std::string toBase(unsigned long long v, unsigned char base, bool negative) {
+    if (base < 2 || base > 36) base = 10;
+    char buf[72];
+    char* p = buf + sizeof(buf);
+    *--p = 0;
+    do {
+        unsigned d = (unsigned)(v % base);
+        *--p = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+        v /= base;
+    } while (v);
+    if (negative) *--p = '-';
+    return p;
+}
+
+std::string toFixed(double v, unsigned int decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    return buf;
+}
+
+} // namespace
+
+String::String(int v, unsigned char base)
+    : s(base == DEC ? toBase(v < 0 ? -(long long)v : v, 10, v < 0)
+                    : toBase((unsigned int)v, base, false)) {}
+String::String(unsigned int v, unsigned char base)  : s(toBase(v, base, false)) {}
+String::String(long v, unsigned char base)
+    : s(base == DEC ? toBase(v < 0 ? -(long long)v : v, 10, v < 0)
+                    : toBase((unsigned long)v, base, false)) {}
+String::String(unsigned long v, unsigned char base) : s(toBase(v, base, false)) {}
+String::String(float v, unsigned int decimals)      : s(toFixed(v, decimals)) {}
+String::String(double v, unsigned int decimals)     : s(toFixed(v, decimals)) {}
+
+bool String::equalsIgnoreCase(const String& o) const {
+    if (s.size() != o.s.size()) return false;
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (tolower((unsigned char)s[i]) != tolower((unsigned char)o.s[i])) return false;
+    }
+    return true;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t p = s.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::indexOf(const String& str, unsigned int from) const {
+    size_t p = s.find(str.s, from);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t p = s.rfind(c);
+    return p == std::string::npos ? -1 : (int)p;
+}
+
+String String::substring(unsigned int from) const {
+    return from >= s.size() ? String() : String(s.substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= s.size()) return String();
+    return String(s.substr(from, to - from));
+}
+
+bool String::startsWith(const String& prefix) const {
+    return s.compare(0, prefix.s.size(), prefix.s) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return s.size() >= suffix.s.size() &&
+           s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+}
+
+void String::replace(const String& from, const String& to) {
+    if (from.s.empty()) return;
+    size_t p = 0;
+    while ((p = s.find(from.s, p)) != std::string::npos) {
+        s.replace(p, from.s.size(), to.s);
+        p += to.s.size();
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index < s.size()) s.erase(index, count);
+}
+
+void String::trim() {
+    size_t b = 0, e = s.size();
+    while (b < e && isspace((unsigned char)s[b]))     ++b;
+    while (e > b && isspace((unsigned char)s[e - 1])) --e;
+    s = s.substr(b, e - b);
+}
+
+void String::toLowerCase() { for (char& c : s) c = (char)tolower((unsigned char)c); }
+void String::toUpperCase() { for (char& c : s) c = (char)toupper((unsigned char)c); }
+
+// ── Serial ───────────────────────────────────────────────────────────
+
+void HardwareSerial::flush() { fflush(stdout); }
+
+size_t HardwareSerial::write(uint8_t c) { return fwrite(&c, 1, 1, stdout); }
+size_t HardwareSerial::write(const uint8_t* buf, size_t len) { return fwrite(buf, 1, len, stdout); }
+
+namespace {
+bool stdinEof = false;   // stays "readable" forever; stop polling it
+}
+
+int HardwareSerial::available() {
+    if (stdinEof) return 0;
+    pollfd p = { STDIN_FILENO, POLLIN, 0 };
+    return poll(&p, 1, 0) > 0 && (p.revents & (POLLIN | POLLHUP)) ? 1 : 0;
+}
+
+int HardwareSerial::read() {
+    if (!available()) return -1;
+    uint8_t c;
+    ssize_t n = ::read(STDIN_FILENO, &c, 1);
+    if (n == 0) {
+        stdinEof = true;
+        native::unwatchFd(STDIN_FILENO);
+    }
+    return n == 1 ? c : -1;
+}
+
+size_t HardwareSerial::print(const char* s)     { return fputs(s, stdout) >= 0 ? strlen(s) : 0; }
+size_t HardwareSerial::print(char c)            { return write((uint8_t)c); }
+size_t HardwareSerial::print(int v)             { return ::printf("%d", v); }
+size_t HardwareSerial::print(unsigned int v)    { return ::printf("%u", v); }
+size_t HardwareSerial::print(long v)            { return ::printf("%ld", v); }
+size_t HardwareSerial::print(unsigned long v)   { return ::printf("%lu", v); }
+size_t HardwareSerial::println()                { size_t n = print("\n"); fflush(stdout); return n; }
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vprintf(fmt, ap);
+    va_end(ap);
+    fflush(stdout);
+    return n > 0 ? (size_t)n : 0;
+}
+
+// ── base64 ───────────────────────────────────────────────────────────
+
+String base64::encode(const uint8_t* data, size_t length) {
+    return String(native::base64Encode(data, length));
+}
+
+String base64::encode(const String& text) {
+    return encode((const uint8_t*)text.c_str(), text.length());
+}
@@ -0,0 +1,174 @@
+#include "../../Features.h"
+#if OPENVIBE_WITH_BLE
+
+#include "../../ble/BLEManager.h"
+#include "../../DeviceContext.h"
+#include "../../commands/CommandProcessor.h"
+#include "../../commands/RateLimiter.h"
+#include "../Hal.h"
+#include "../../log/Logger.h"
+#include "NativeNet.h"
+#include "NativeSim.h"
+
+/**
+ * Simulated BLE peripheral for the host build.
+ *
+ * A "central" is a TCP client on simOptions().blePort speaking one
+ * JSON document per line: each line received is a write to the
+ * Wi-Fi/command characteristic, each stats notification is sent back
+ * as one line, and so is a command reply (what a real central would
+ * read back from the characteristic).  Like the real peripheral only one central is served;
+ * "advertising" resumes when it disconnects.
+ *
+ * The simulated central connects at 30 ms and grants every connection
+ * parameter request at once (the slowest interval asked for), so GET
+ * /power shows the link policy at work; the TCP link itself is not
+ * slowed down.
+ */
+namespace {
+
+int                  listener = -1;
+int                  central  = -1;
+std::vector<uint8_t> rx;
+std::vector<uint8_t> tx;
+
+constexpr uint16_t CENTRAL_INTERVAL = 24;    // 30 ms, a phone's usual pick
+constexpr uint16_t CENTRAL_TIMEOUT  = 500;   // 5 s
+constexpr uint8_t  CENTRAL_ADDR[6]  = {};
+
+void dropCentral() {
+    if (central < 0) return;
+    native::closeFd(central);
+    rx.clear();
+    tx.clear();
+    BLEManager* ble = DeviceContext::getInstance().getBLEManager();
+    if (ble) ble->centralDisconnected();
+    DeviceContext::getInstance().onBLEDisconnected();
+}
+
+void sendLine(const String& text) {
+    if (central < 0) return;
+    std::string line(text.c_str(), text.length());
+    line.push_back('\n');
+    if (!native::writeQueued(central, tx, (const uint8_t*)line.data(), line.size())) dropCentral();
+}
+
+} // namespace
+
+BLEManager::BLEManager()
+    : pServer(nullptr)
+    , pService(nullptr)
+    , pWiFiChar(nullptr)
+    , pStatsChar(nullptr)
+    , pendingHead(0)
+    , pendingCount(0)
+    , session(0)
+    , peer{}
+    , peerUp(false)
+    , peerEpoch(0)
+    , seenEpoch(0)
+    , grantPending(false) {}
+
+void BLEManager::begin(const String& deviceName) {
+    uint16_t port = native::simOptions().blePort;
+    listener = native::listenTcp(port, 1);
+    if (listener < 0) {
+        LOG_E(BLE, "[BLE] Simulated link: port %u unavailable\n", (unsigned)port);
+        return;
+    }
+    LOG_I(BLE, "[BLE] Advertising as \"%s\" (simulated, tcp://0.0.0.0:%u)\n",
+               deviceName.c_str(), (unsigned)port);
+}
+
+void BLEManager::loop() {
+    uint32_t now = hal::millis();
+    serviceLink(now);
+
+    if (central < 0) {
+        central = native::acceptClient(listener);
+        if (central >= 0) {
+            DeviceContext::getInstance().onBLEConnected();
+            centralConnected(CENTRAL_ADDR, CENTRAL_INTERVAL, 0, CENTRAL_TIMEOUT);
+        }
+        return;
+    }
+
+    if (!native::readAvailable(central, rx) || !native::flushQueued(central, tx)) {
+        dropCentral();
+        return;
+    }
+
+    std::vector<uint8_t>::iterator nl;
+    while ((nl = std::find(rx.begin(), rx.end(), '\n')) != rx.end()) {
+        std::string line(rx.begin(), nl);
+        rx.erase(rx.begin(), nl + 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        LOG_D(BLE, "[BLE] Received: %s\n", line.c_str());
+        uint32_t at = hal::millis();   // one clock for the limiter and the link
+        if (!RateLimiter::getInstance().admitJson(SOURCE_BLE, 0, line.data(), line.size(), at)) {
+            continue;
+        }
+        link.command(at);
+        String ack;
+        CommandProcessor::getInstance().handleJson(line.data(), line.size(), SOURCE_BLE, &ack, nullptr, &session);
+        if (central < 0) return;
+        if (!ack.isEmpty()) sendLine(ack);
+    }
+}
+
+// ── Connection parameters (granted on the spot) ──────────────────────
+
+void BLEManager::serviceLink(uint32_t now) {
+    if (peerEpoch != seenEpoch || !peerUp) link.disconnected(now);
+    if (peerEpoch != seenEpoch && peerUp) {
+        link.connected(now);
+        session = 0;
+    }
+    if (grantPending) link.granted(grant.interval, grant.latency, grant.timeout, now);
+    seenEpoch    = peerEpoch;
+    grantPending = false;
+
+    BLELinkPolicy::Params p;
+    if (link.due(now, p)) link.granted(p.maxInterval, p.latency, p.timeout, now);
+}
+
+void BLEManager::centralConnected(const uint8_t addr[6], uint16_t interval, uint16_t latency,
+                                  uint16_t timeout) {
+    memcpy(peer, addr, sizeof(peer));
+    peerUp       = true;
+    ++peerEpoch;
+    grant        = { interval, latency, timeout };
+    grantPending = true;
+}
+
+void BLEManager::centralDisconnected() {
+    peerUp       = false;
+    grantPending = false;
+}
+
+void BLEManager::connParamsUpdated(uint16_t interval, uint16_t latency, uint16_t timeout) {
+    grant        = { interval, latency, timeout };
+    grantPending = true;
+}
+
+// The simulated link already delivers writes on the loop task.
+void BLEManager::queueWrite(const uint8_t* data, size_t len) {
+    rx.insert(rx.end(), data, data + len);
+    rx.push_back('\n');
+}
+
+void BLEManager::updateStats(const String& jsonStats) {
+    sendLine(jsonStats);
+}
+
+void BLEManager::sendProbe(const String& json) {
+    sendLine(json);
+}
+
+bool BLEManager::isConnected() const {
+    return DeviceContext::getInstance().getStats().isBluetoothConnected;
+}
+
+#endif // OPENVIBE_WITH_BLE
@@ -0,0 +1,567 @@
+#include "../Hal.h"
+#include "SimAdcSource.h"
+#include "NativeSim.h"
+#include "NativeNet.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+const Clock::time_point bootTime = Clock::now();
+
+// Simulated pin state — enough to observe LED/motor from the host.
+constexpr int GPIO_COUNT = 40;
+constexpr int PWM_COUNT  = 16;
+std::atomic<bool>     gpioLevel[GPIO_COUNT];
+std::atomic<uint32_t> pwmDuty[GPIO_COUNT];
+int                   pwmPin[PWM_COUNT];   // channel → pin, set by pwmAttach()
+
+// Simulated station: associates CONNECT_DELAY_MS after wifiBegin().
+constexpr uint32_t CONNECT_DELAY_MS = 300;
+bool     wifiStarted = false;
+uint32_t wifiStartMs = 0;
+
+// Simulated scan: results SCAN_MS after wifiScanStart(), about what the
+// device's active scan takes.
+constexpr uint32_t SCAN_MS = 1500;
+bool     scanStarted = false;
+uint32_t scanStartMs = 0;
+
+// Simulated CPU clock / modem sleep — recorded, no effect on the host.
+uint32_t cpuMhz = 240;
+
+// Self-pipe: wake() from any thread makes the loop's poll() return.
+int            wakePipe[2] = { -1, -1 };
+std::once_flag wakePipeOnce;
+
+bool validPin(int pin) { return pin >= 0 && pin < GPIO_COUNT; }
+
+void openWakePipe() {
+    std::call_once(wakePipeOnce, [] {
+        if (pipe(wakePipe) != 0) return;
+        for (int fd : wakePipe) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    });
+}
+
+} // namespace
+
+namespace hal {
+
+// ── Clock ────────────────────────────────────────────────────────────
+
+uint32_t millis() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - bootTime).count();
+}
+
+uint32_t micros() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - bootTime).count();
+}
+
+void delayMs(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// ── GPIO / PWM ───────────────────────────────────────────────────────
+
+void gpioOutput(int pin) { (void)pin; }
+
+void gpioInput(int pin, bool pullUp) {
+    if (validPin(pin)) gpioLevel[pin] = pullUp;
+}
+
+void gpioWrite(int pin, bool high) {
+    if (validPin(pin)) gpioLevel[pin] = high;
+}
+
+bool gpioRead(int pin) {
+    return validPin(pin) && gpioLevel[pin];
+}
+
+bool pwmAttach(uint8_t channel, int pin, uint32_t freqHz, uint8_t bits) {
+    if (channel >= PWM_COUNT || !validPin(pin) || !freqHz || !bits || bits > 20) return false;
+    pwmPin[channel] = pin;
+    pwmDuty[pin]    = 0;
+    return true;
+}
+
+void pwmWrite(uint8_t channel, uint32_t duty) {
+    if (channel < PWM_COUNT) pwmDuty[pwmPin[channel]] = duty;
+}
+
+// ── Identity ─────────────────────────────────────────────────────────
+
+String macAddress() {
+    const native::SimOptions& o = native::simOptions();
+    char buf[18];
+    snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X",
+             o.mac[0], o.mac[1], o.mac[2], o.mac[3], o.mac[4], o.mac[5]);
+    return String(buf);
+}
+
+String deviceId() {
+    // ESP.getEfuseMac() is little-endian: low 32 bits are MAC bytes 0..3.
+    const native::SimOptions& o = native::simOptions();
+    uint32_t low = (uint32_t)o.mac[0] | (uint32_t)o.mac[1] << 8 |
+                   (uint32_t)o.mac[2] << 16 | (uint32_t)o.mac[3] << 24;
+    return String(low, HEX);
+}
+
+// ── Wi-Fi station ────────────────────────────────────────────────────
+
+void wifiInit() {}
+
+void wifiBegin(const char* ssid, const char* password) {
+    (void)password;
+    wifiStarted = ssid && *ssid;
+    wifiStartMs = millis();
+}
+
+void wifiDisconnect() {
+    wifiStarted = false;
+}
+
+bool wifiIsConnected() {
+    return wifiStarted && millis() - wifiStartMs >= CONNECT_DELAY_MS;
+}
+
+String wifiLocalIP() {
+    return wifiIsConnected() ? String(native::simOptions().ip.c_str()) : String("0.0.0.0");
+}
+
+// A steady signal with a little jitter, so history has something to show.
+int8_t wifiRssi() {
+    return wifiIsConnected() ? (int8_t)(-55 - (int)(millis() / 1000 % 5)) : 0;
+}
+
+namespace {
+const WiFiScanEntry SIM_NETWORKS[] = {
+    { "OpenVibe-Lab",  -48,  6, 3 },
+    { "OpenVibe-Lab",  -71, 11, 3 },   // same SSID, second AP
+    { "Guest",         -63,  1, 0 },
+};
+constexpr int SIM_NETWORK_COUNT = sizeof(SIM_NETWORKS) / sizeof(SIM_NETWORKS[0]);
+}
+
+bool wifiScanStart() {
+    if (scanStarted) return false;
+    scanStarted = true;
+    scanStartMs = millis();
+    std::thread([] {   // the scan-done event
+        std::this_thread::sleep_for(std::chrono::milliseconds(SCAN_MS));
+        wake();
+    }).detach();
+    return true;
+}
+
+int wifiScanComplete() {
+    if (!scanStarted) return -2;
+    return millis() - scanStartMs >= SCAN_MS ? SIM_NETWORK_COUNT : -1;
+}
+
+bool wifiScanResult(int index, WiFiScanEntry& out) {
+    if (wifiScanComplete() < 0 || index < 0 || index >= SIM_NETWORK_COUNT) return false;
+    out = SIM_NETWORKS[index];
+    return true;
+}
+
+void wifiScanDelete() { scanStarted = false; }
+
+void wifiSetPowerSave(WiFiPowerSave mode) { (void)mode; }
+
+// ── CPU ──────────────────────────────────────────────────────────────
+
+bool cpuSetFrequencyMhz(uint32_t mhz) {
+    if (mhz != 80 && mhz != 160 && mhz != 240) return false;
+    cpuMhz = mhz;
+    return true;
+}
+
+uint32_t cpuFrequencyMhz() { return cpuMhz; }
+
+// ── Loop wait ────────────────────────────────────────────────────────
+
+bool waitForEvent(uint32_t timeoutMs) {
+    openWakePipe();
+
+    // The simulated link comes up on a deadline, not an fd.
+    if (wifiStarted && !wifiIsConnected()) {
+        uint32_t left = CONNECT_DELAY_MS - (millis() - wifiStartMs);
+        if (left < timeoutMs) timeoutMs = left;
+    }
+
+    int  ms    = timeoutMs == WAIT_FOREVER ? -1 : (int)std::min<uint32_t>(timeoutMs, INT32_MAX);
+    bool ready = native::waitFds(wakePipe[0], ms);
+
+    uint8_t drain[32];
+    while (read(wakePipe[0], drain, sizeof(drain)) > 0) {}
+    return ready;
+}
+
+void wake() {
+    openWakePipe();
+    uint8_t b = 1;
+    if (write(wakePipe[1], &b, 1) < 0) {}   // full pipe = already pending
+}
+
+void wakeOnSerialInput() { native::watchFd(STDIN_FILENO); }
+
+bool socketsWakeLoop() { return true; }
+
+size_t serialWriteRoom() { return 4096; }   // stdout: a pipe or a terminal
+
+// ── System ───────────────────────────────────────────────────────────
+
+void restart() {
+    fflush(stdout);
+    char** argv = native::simOptions().argv;
+    char   self[PATH_MAX];
+    ssize_t n   = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (!argv || n <= 0) exit(0);
+    self[n] = '\0';   // the real path, so the process keeps its name
+    // Sockets must not survive into the new image (ports stay bound).
+    for (int fd = 3; fd < 1024; ++fd) close(fd);
+    execv(self, argv);
+    exit(1);
+}
+
+uint32_t heapUsed() {
+    return (uint32_t)mallinfo2().uordblks;
+}
+
+// ── Firmware slots (OTA) ─────────────────────────────────────────────
+
+namespace {
+// Same size as an app slot of min_spiffs.csv.
+constexpr size_t SIM_SLOT_SIZE = 0x1E0000;
+constexpr uint8_t IMAGE_MAGIC  = 0xE9;   // esp_image_header_t.magic
+
+std::string otaPath(const char* name) {
+    std::string dir = native::simOptions().nvsDir;
+    mkdir(dir.c_str(), 0755);
+    dir += "/ota";
+    mkdir(dir.c_str(), 0755);
+    return dir + "/" + name;
+}
+
+// otadata: the slot to boot, read once per "boot" (process start).
+int bootSlot() {
+    static int slot = [] {
+        FILE* f = fopen(otaPath("otadata").c_str(), "r");
+        int   s = 0;
+        if (f) {
+            if (fscanf(f, "%d", &s) != 1 || (s != 0 && s != 1)) s = 0;
+            fclose(f);
+        }
+        return s;
+    }();
+    return slot;
+}
+
+std::string slotPath(int slot) { return otaPath(slot ? "app1.bin" : "app0.bin"); }
+
+bool setBootSlot(int slot) {
+    FILE* f = fopen(otaPath("otadata").c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "%d\n", slot);
+    return fclose(f) == 0;
+}
+
+bool slotIO(size_t offset, uint8_t* data, const uint8_t* src, size_t len) {
+    if (offset + len > SIM_SLOT_SIZE) return false;
+    int fd = open(slotPath(1 - bootSlot()).c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    bool ok;
+    if (src) {
+        ok = pwrite(fd, src, len, (off_t)offset) == (ssize_t)len;
+    } else {
+        ssize_t n = pread(fd, data, len, (off_t)offset);
+        ok = n >= 0;
+        if (ok) memset(data + n, 0xFF, len - n);   // past EOF = erased flash
+    }
+    close(fd);
+    return ok;
+}
+}
+
+size_t otaSlotSize() { return SIM_SLOT_SIZE; }
+
+bool otaErase(size_t offset, size_t len) {
+    if (offset % OTA_SECTOR || len % OTA_SECTOR) return false;
+    static const std::vector<uint8_t> erased(OTA_SECTOR, 0xFF);
+    for (size_t at = offset; at < offset + len; at += OTA_SECTOR) {
+        if (!slotIO(at, nullptr, erased.data(), OTA_SECTOR)) return false;
+    }
+    return true;
+}
+
+bool otaWrite(size_t offset, const uint8_t* data, size_t len) {
+    return slotIO(offset, nullptr, data, len);
+}
+
+bool otaRead(size_t offset, uint8_t* data, size_t len) {
+    return slotIO(offset, data, nullptr, len);
+}
+
+bool otaActivate() {
+    uint8_t magic = 0;
+    if (!otaRead(0, &magic, 1) || magic != IMAGE_MAGIC) return false;
+    return setBootSlot(1 - bootSlot());
+}
+
+// app0 is the simulator binary itself and always bootable.
+bool otaRevert() { return bootSlot() ? setBootSlot(0) : otaActivate(); }
+
+void otaConfirm() {}
+
+String otaRunningSlot() { return bootSlot() ? "app1" : "app0"; }
+
+// ── SHA-256 (FIPS 180-4) ─────────────────────────────────────────────
+
+namespace {
+struct Sha256State {
+    uint32_t h[8];
+    uint8_t  block[64];
+    size_t   blockLen;
+    uint64_t totalLen;
+};
+
+constexpr uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+void sha256Block(Sha256State& st, const uint8_t* p) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t)p[i * 4] << 24 | (uint32_t)p[i * 4 + 1] << 16 |
+               (uint32_t)p[i * 4 + 2] << 8 | p[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = st.h[0], b = st.h[1], c = st.h[2], d = st.h[3];
+    uint32_t e = st.h[4], f = st.h[5], g = st.h[6], h = st.h[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K256[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    st.h[0] += a; st.h[1] += b; st.h[2] += c; st.h[3] += d;
+    st.h[4] += e; st.h[5] += f; st.h[6] += g; st.h[7] += h;
+}
+}
+
+Sha256::Sha256() : handle(new Sha256State()) { reset(); }
+
+Sha256::~Sha256() { delete static_cast<Sha256State*>(handle); }
+
+void Sha256::reset() {
+    static const uint32_t IV[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    Sha256State& st = *static_cast<Sha256State*>(handle);
+    memcpy(st.h, IV, sizeof(IV));
+    st.blockLen = 0;
+    st.totalLen = 0;
+}
+
+void Sha256::update(const uint8_t* data, size_t len) {
+    Sha256State& st = *static_cast<Sha256State*>(handle);
+    st.totalLen += len;
+    while (len) {
+        size_t n = std::min(len, sizeof(st.block) - st.blockLen);
+        memcpy(st.block + st.blockLen, data, n);
+        st.blockLen += n;
+        data        += n;
+        len         -= n;
+        if (st.blockLen == sizeof(st.block)) {
+            sha256Block(st, st.block);
+            st.blockLen = 0;
+        }
+    }
+}
+
+void Sha256::finish(uint8_t out[DIGEST_LEN]) {
+    Sha256State& st   = *static_cast<Sha256State*>(handle);
+    uint64_t     bits = st.totalLen * 8;
+    uint8_t      pad  = 0x80;
+    update(&pad, 1);
+    pad = 0;
+    while (st.blockLen != 56) update(&pad, 1);
+    uint8_t len[8];
+    for (int i = 0; i < 8; ++i) len[i] = (uint8_t)(bits >> (56 - i * 8));
+    update(len, 8);
+    for (int i = 0; i < 8; ++i) {
+        out[i * 4]     = (uint8_t)(st.h[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(st.h[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(st.h[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)st.h[i];
+    }
+}
+
+// ── Periodic timer ───────────────────────────────────────────────────
+
+namespace {
+struct TimerThread {
+    std::atomic<bool> running{ true };
+    std::thread       thread;
+};
+}
+
+PeriodicTimer::PeriodicTimer() : handle(nullptr) {}
+
+PeriodicTimer::~PeriodicTimer() { stop(); }
+
+bool PeriodicTimer::start(uint32_t periodMs, Callback cb, void* arg, const char* name) {
+    (void)name;
+    stop();
+    TimerThread* t = new TimerThread();
+    t->thread = std::thread([t, periodMs, cb, arg]() {
+        auto next = Clock::now();
+        while (t->running) {
+            next += std::chrono::milliseconds(periodMs);
+            std::this_thread::sleep_until(next);
+            if (t->running) cb(arg);
+        }
+    });
+    handle = t;
+    return true;
+}
+
+void PeriodicTimer::stop() {
+    TimerThread* t = static_cast<TimerThread*>(handle);
+    if (!t) return;
+    t->running = false;
+    if (t->thread.joinable()) t->thread.join();
+    delete t;
+    handle = nullptr;
+}
+
+// ── Background task ──────────────────────────────────────────────────
+
+namespace {
+struct TaskThread {
+    std::mutex              m;
+    std::condition_variable cv;
+    bool                    pending = false;
+};
+}
+
+Task::Task() : handle(nullptr) {}
+
+// Detached: it may still be draining while static destructors run, so
+// its state is never freed.
+bool Task::start(const char* name, Entry entry, void* arg, uint32_t stackBytes) {
+    (void)name;
+    (void)stackBytes;
+    if (handle) return true;
+    handle = new TaskThread();
+    std::thread(entry, arg).detach();
+    return true;
+}
+
+void Task::notify() {
+    TaskThread* t = static_cast<TaskThread*>(handle);
+    if (!t) return;
+    {
+        std::lock_guard<std::mutex> lock(t->m);
+        t->pending = true;
+    }
+    t->cv.notify_one();
+}
+
+bool Task::waitNotify(uint32_t timeoutMs) {
+    TaskThread* t = static_cast<TaskThread*>(handle);
+    std::unique_lock<std::mutex> lock(t->m);
+    if (timeoutMs == UINT32_MAX) {
+        t->cv.wait(lock, [t] { return t->pending; });
+    } else {
+        t->cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [t] { return t->pending; });
+    }
+    bool woken = t->pending;
+    t->pending = false;
+    return woken;
+}
+
+// ── Mutex ────────────────────────────────────────────────────────────
+
+Mutex::Mutex() : handle(new std::mutex()) {}
+Mutex::~Mutex() { delete static_cast<std::mutex*>(handle); }
+void Mutex::lock()   { static_cast<std::mutex*>(handle)->lock(); }
+void Mutex::unlock() { static_cast<std::mutex*>(handle)->unlock(); }
+
+// ── File storage ─────────────────────────────────────────────────────
+
+namespace {
+std::string hostPath(const char* path) {
+    std::string dir = native::simOptions().nvsDir;
+    mkdir(dir.c_str(), 0755);
+    dir += "/fs";
+    mkdir(dir.c_str(), 0755);
+    return dir + (path[0] == '/' ? "" : "/") + path;
+}
+}
+
+bool fileWrite(const char* path, const uint8_t* data, size_t len) {
+    std::string p   = hostPath(path);
+    std::string tmp = p + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(data, 1, len, f) == len;
+    ok = fclose(f) == 0 && ok;
+    return ok && rename(tmp.c_str(), p.c_str()) == 0;
+}
+
+bool fileAppend(const char* path, const uint8_t* data, size_t len) {
+    FILE* f = fopen(hostPath(path).c_str(), "ab");
+    if (!f) return false;
+    bool ok = fwrite(data, 1, len, f) == len;
+    return fclose(f) == 0 && ok;
+}
+
+size_t fileSize(const char* path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+size_t fileRead(const char* path, size_t offset, uint8_t* buf, size_t len) {
+    FILE* f = fopen(hostPath(path).c_str(), "rb");
+    if (!f) return 0;
+    size_t n = fseek(f, (long)offset, SEEK_SET) == 0 ? fread(buf, 1, len, f) : 0;
+    fclose(f);
+    return n;
+}
+
+bool fileRemove(const char* path) {
+    return remove(hostPath(path).c_str()) == 0;
+}
+
+// ── ADC ──────────────────────────────────────────────────────────────
+
+AdcSource* createAdcSource(int pin) {
+    return new SimAdcSource(pin);
+}
+
+} // namespace hal
@@ -0,0 +1,397 @@
+#include "../Hal.h"
+#include "NativeSim.h"
+#include <atomic>
+#include <cctype>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * mDNS / DNS-SD responder for the host build (RFC 6762 / 6763 subset).
+ *
+ * Answers PTR, SRV, TXT, A and ANY questions for the services added —
+ * enough for service browsers and tools/discovery.  A query from a
+ * port other than 5353 (a "legacy unicast" resolver) gets a unicast
+ * reply with its id and questions; one from 5353 is answered on the
+ * multicast group as well.  Changes are announced unsolicited.  Runs
+ * on its own thread, like the IDF responder task on the device.
+ */
+namespace {
+
+constexpr uint16_t TYPE_A   = 1;
+constexpr uint16_t TYPE_PTR = 12;
+constexpr uint16_t TYPE_TXT = 16;
+constexpr uint16_t TYPE_SRV = 33;
+constexpr uint16_t TYPE_ANY = 255;
+constexpr uint16_t CLASS_IN    = 1;
+constexpr uint16_t CACHE_FLUSH = 0x8000;   // record is unique to us
+constexpr uint32_t TTL_HOST    = 120;
+constexpr uint32_t TTL_OTHER   = 4500;
+const char* const  MDNS_GROUP  = "224.0.0.251";
+const char* const  SERVICES    = "_services._dns-sd._udp.local";
+
+struct Service {
+    std::string type;   // "_http._tcp"
+    uint16_t    port;
+    std::vector<std::pair<std::string, std::string>> txt;
+};
+
+std::mutex           lock;   // guards everything below but the thread
+std::string          host;
+std::string          instance;
+std::vector<Service> services;
+
+int               sock = -1;
+std::thread*      worker = nullptr;   // never destroyed at exit while running
+std::atomic<bool> running(false);
+
+// ── Encoding ─────────────────────────────────────────────────────────
+
+typedef std::vector<uint8_t> Bytes;
+
+void put16(Bytes& b, uint16_t v) { b.push_back(v >> 8); b.push_back(v & 0xFF); }
+void put32(Bytes& b, uint32_t v) { put16(b, v >> 16); put16(b, v & 0xFFFF); }
+
+// Labels are given separately so an instance name may contain dots.
+void putName(Bytes& b, const std::vector<std::string>& labels) {
+    for (const std::string& l : labels) {
+        size_t n = l.size() < 63 ? l.size() : 63;
+        b.push_back((uint8_t)n);
+        b.insert(b.end(), l.begin(), l.begin() + n);
+    }
+    b.push_back(0);
+}
+
+std::vector<std::string> split(const std::string& dotted) {
+    std::vector<std::string> out;
+    size_t start = 0, dot;
+    while ((dot = dotted.find('.', start)) != std::string::npos) {
+        out.push_back(dotted.substr(start, dot - start));
+        start = dot + 1;
+    }
+    out.push_back(dotted.substr(start));
+    return out;
+}
+
+std::vector<std::string> cat(std::vector<std::string> a, const std::vector<std::string>& b) {
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+}
+
+void putRecord(Bytes& b, const std::vector<std::string>& name, uint16_t type, uint16_t cls,
+               uint32_t ttl, const Bytes& rdata) {
+    putName(b, name);
+    put16(b, type);
+    put16(b, cls);
+    put32(b, ttl);
+    put16(b, (uint16_t)rdata.size());
+    b.insert(b.end(), rdata.begin(), rdata.end());
+}
+
+std::vector<std::string> hostName() { return { host, "local" }; }
+
+std::vector<std::string> typeName(const Service& s) { return cat(split(s.type), { "local" }); }
+
+std::vector<std::string> instanceName(const Service& s) { return cat({ instance }, typeName(s)); }
+
+void putPtr(Bytes& b, const Service& s, uint32_t ttl = TTL_OTHER) {
+    Bytes rd;
+    putName(rd, instanceName(s));
+    putRecord(b, typeName(s), TYPE_PTR, CLASS_IN, ttl, rd);
+}
+
+void putSrv(Bytes& b, const Service& s) {
+    Bytes rd;
+    put16(rd, 0);   // priority
+    put16(rd, 0);   // weight
+    put16(rd, s.port);
+    putName(rd, hostName());
+    putRecord(b, instanceName(s), TYPE_SRV, CLASS_IN | CACHE_FLUSH, TTL_HOST, rd);
+}
+
+void putTxt(Bytes& b, const Service& s) {
+    Bytes rd;
+    for (const auto& kv : s.txt) {
+        std::string item = kv.first + "=" + kv.second;
+        size_t      n    = item.size() < 255 ? item.size() : 255;
+        rd.push_back((uint8_t)n);
+        rd.insert(rd.end(), item.begin(), item.begin() + n);
+    }
+    if (rd.empty()) rd.push_back(0);   // an empty TXT is one empty string
+    putRecord(b, instanceName(s), TYPE_TXT, CLASS_IN | CACHE_FLUSH, TTL_OTHER, rd);
+}
+
+void putA(Bytes& b) {
+    in_addr addr;
+    if (inet_pton(AF_INET, native::simOptions().ip.c_str(), &addr) != 1) addr.s_addr = htonl(INADDR_LOOPBACK);
+    Bytes rd((const uint8_t*)&addr, (const uint8_t*)&addr + 4);
+    putRecord(b, hostName(), TYPE_A, CLASS_IN | CACHE_FLUSH, TTL_HOST, rd);
+}
+
+void putServicesPtr(Bytes& b, const Service& s) {
+    Bytes rd;
+    putName(rd, typeName(s));
+    putRecord(b, split(SERVICES), TYPE_PTR, CLASS_IN, TTL_OTHER, rd);
+}
+
+Bytes header(uint16_t id, uint16_t questions, uint16_t answers, uint16_t additional) {
+    Bytes b;
+    put16(b, id);
+    put16(b, 0x8400);   // response, authoritative
+    put16(b, questions);
+    put16(b, answers);
+    put16(b, 0);
+    put16(b, additional);
+    return b;
+}
+
+// ── Decoding ─────────────────────────────────────────────────────────
+
+// Dotted, lower case; follows compression pointers.  False if malformed.
+bool readName(const uint8_t* msg, size_t len, size_t& pos, std::string& out) {
+    out.clear();
+    size_t at    = pos;
+    bool   moved = false;
+    for (int hops = 0; hops < 16; ) {
+        if (at >= len) return false;
+        uint8_t n = msg[at];
+        if (n == 0) {
+            if (!moved) pos = at + 1;
+            return true;
+        }
+        if ((n & 0xC0) == 0xC0) {
+            if (at + 1 >= len) return false;
+            if (!moved) pos = at + 2;
+            moved = true;
+            at    = ((n & 0x3F) << 8) | msg[at + 1];
+            ++hops;
+            continue;
+        }
+        if (at + 1 + n > len) return false;
+        if (!out.empty()) out.push_back('.');
+        for (size_t i = 0; i < n; ++i) out.push_back((char)tolower(msg[at + 1 + i]));
+        at += 1 + n;
+    }
+    return false;
+}
+
+bool same(const std::string& lower, const std::vector<std::string>& labels) {
+    std::string dotted;
+    for (const std::string& l : labels) {
+        if (!dotted.empty()) dotted.push_back('.');
+        dotted += l;
+    }
+    return dotted.size() == lower.size() && strcasecmp(dotted.c_str(), lower.c_str()) == 0;
+}
+
+// ── Responder ────────────────────────────────────────────────────────
+
+void sendTo(const Bytes& b, const sockaddr_in& to) {
+    sendto(sock, b.data(), b.size(), 0, (const sockaddr*)&to, sizeof(to));
+}
+
+sockaddr_in groupAddr() {
+    sockaddr_in g = {};
+    g.sin_family = AF_INET;
+    g.sin_port   = htons(5353);
+    inet_pton(AF_INET, MDNS_GROUP, &g.sin_addr);
+    return g;
+}
+
+// Every record we own, unsolicited (call with `lock` held).
+void announce() {
+    if (sock < 0 || host.empty()) return;
+    Bytes body;
+    uint16_t n = 1;
+    putA(body);
+    for (const Service& s : services) {
+        putPtr(body, s);
+        putSrv(body, s);
+        putTxt(body, s);
+        n += 3;
+    }
+    Bytes msg = header(0, 0, n, 0);
+    msg.insert(msg.end(), body.begin(), body.end());
+    sendTo(msg, groupAddr());
+}
+
+// TTL 0: browsers drop the instance at once (call with `lock` held).
+void goodbye(const Service& s) {
+    if (sock < 0) return;
+    Bytes msg = header(0, 0, 1, 0);
+    putPtr(msg, s, 0);
+    sendTo(msg, groupAddr());
+}
+
+void answer(const uint8_t* q, size_t len, const sockaddr_in& from) {
+    if (len < 12 || (q[2] & 0x80)) return;   // not a query
+    uint16_t id    = (q[0] << 8) | q[1];
+    uint16_t count = (q[4] << 8) | q[5];
+
+    std::lock_guard<std::mutex> guard(lock);
+    Bytes    answers, extra;
+    uint16_t nAnswers = 0, nExtra = 0;
+    bool     needA    = false;
+
+    size_t pos = 12;
+    for (uint16_t i = 0; i < count; ++i) {
+        std::string name;
+        if (!readName(q, len, pos, name) || pos + 4 > len) return;
+        uint16_t type = (q[pos] << 8) | q[pos + 1];
+        pos += 4;
+        bool any = type == TYPE_ANY;
+
+        if (same(name, split(SERVICES)) && (type == TYPE_PTR || any)) {
+            for (const Service& s : services) { putServicesPtr(answers, s); ++nAnswers; }
+        }
+        for (const Service& s : services) {
+            if (same(name, typeName(s)) && (type == TYPE_PTR || any)) {
+                putPtr(answers, s); ++nAnswers;
+                putSrv(extra, s);
+                putTxt(extra, s);
+                nExtra += 2;
+                needA = true;
+            } else if (same(name, instanceName(s))) {
+                if (type == TYPE_SRV || any) { putSrv(answers, s); ++nAnswers; needA = true; }
+                if (type == TYPE_TXT || any) { putTxt(answers, s); ++nAnswers; }
+            }
+        }
+        if (same(name, hostName()) && (type == TYPE_A || any)) {
+            putA(answers);
+            ++nAnswers;
+            needA = false;
+        }
+    }
+    if (!nAnswers) return;
+    if (needA) { putA(extra); ++nExtra; }
+
+    bool  legacy = ntohs(from.sin_port) != 5353;
+    Bytes msg    = header(legacy ? id : 0, legacy ? count : 0, nAnswers, nExtra);
+    if (legacy) msg.insert(msg.end(), q + 12, q + pos);   // echo the questions
+    msg.insert(msg.end(), answers.begin(), answers.end());
+    msg.insert(msg.end(), extra.begin(), extra.end());
+
+    sendTo(msg, from);
+    if (!legacy) sendTo(msg, groupAddr());
+}
+
+void serve() {
+    uint8_t buf[1500];
+    while (running) {
+        pollfd p = { sock, POLLIN, 0 };
+        if (poll(&p, 1, 200) <= 0) continue;
+
+        sockaddr_in from;
+        socklen_t   fromLen = sizeof(from);
+        ssize_t     n = recvfrom(sock, buf, sizeof(buf), 0, (sockaddr*)&from, &fromLen);
+        if (n > 0) answer(buf, (size_t)n, from);
+    }
+}
+
+Service* find(const char* service, const char* proto) {
+    std::string type = std::string(service) + "." + proto;
+    for (Service& s : services) {
+        if (strcasecmp(s.type.c_str(), type.c_str()) == 0) return &s;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+namespace hal {
+
+bool mdnsBegin(const char* hostname, const char* inst) {
+    uint16_t port = native::simOptions().mdnsPort;
+    if (!port) return false;
+    mdnsEnd();
+
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) return false;
+    int on = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+
+    sockaddr_in addr = {};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        sock = -1;
+        return false;
+    }
+    // Best effort: without a multicast route only unicast queries work.
+    ip_mreq group = {};
+    inet_pton(AF_INET, MDNS_GROUP, &group.imr_multiaddr);
+    group.imr_interface.s_addr = htonl(INADDR_ANY);
+    setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &group, sizeof(group));
+    uint8_t loop = 1;
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        host     = hostname;
+        instance = inst;
+        services.clear();
+        announce();
+    }
+    running = true;
+    worker  = new std::thread(serve);
+    return true;
+}
+
+void mdnsEnd() {
+    if (sock < 0) return;
+    running = false;
+    worker->join();
+    delete worker;
+    worker = nullptr;
+    close(sock);
+    sock = -1;
+
+    std::lock_guard<std::mutex> guard(lock);
+    host.clear();
+    services.clear();
+}
+
+bool mdnsAddService(const char* service, const char* proto, uint16_t port) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (sock < 0 || find(service, proto)) return false;
+    services.push_back({ std::string(service) + "." + proto, port, {} });
+    announce();
+    return true;
+}
+
+void mdnsRemoveService(const char* service, const char* proto) {
+    std::lock_guard<std::mutex> guard(lock);
+    Service* s = find(service, proto);
+    if (!s) return;
+    goodbye(*s);
+    services.erase(services.begin() + (s - services.data()));
+}
+
+bool mdnsSetTxt(const char* service, const char* proto, const char* key, const char* value) {
+    std::lock_guard<std::mutex> guard(lock);
+    Service* s = find(service, proto);
+    if (!s) return false;
+    for (auto& kv : s->txt) {
+        if (kv.first == key) {
+            if (kv.second == value) return true;
+            kv.second = value;
+            announce();
+            return true;
+        }
+    }
+    s->txt.emplace_back(key, value);
+    announce();
+    return true;
+}
+
+} // namespace hal
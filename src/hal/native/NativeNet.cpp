@@ -0,0 +1,244 @@
+#include "NativeNet.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <netdb.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+namespace native {
+
+namespace {
+
+void makeNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+std::mutex          watchLock;
+std::vector<pollfd> watched;
+
+} // namespace
+
+// ── Watch list ───────────────────────────────────────────────────────
+
+void watchFd(int fd) {
+    if (fd < 0) return;
+    std::lock_guard<std::mutex> g(watchLock);
+    for (const pollfd& p : watched) if (p.fd == fd) return;
+    watched.push_back({ fd, POLLIN, 0 });
+}
+
+void unwatchFd(int fd) {
+    std::lock_guard<std::mutex> g(watchLock);
+    for (size_t i = 0; i < watched.size(); ++i) {
+        if (watched[i].fd != fd) continue;
+        watched[i] = watched.back();
+        watched.pop_back();
+        return;
+    }
+}
+
+void watchWrite(int fd, bool on) {
+    std::lock_guard<std::mutex> g(watchLock);
+    for (pollfd& p : watched) {
+        if (p.fd == fd) p.events = on ? (POLLIN | POLLOUT) : POLLIN;
+    }
+}
+
+bool waitFds(int extraFd, int timeoutMs) {
+    std::vector<pollfd> set;
+    {
+        std::lock_guard<std::mutex> g(watchLock);
+        set = watched;
+    }
+    if (extraFd >= 0) set.push_back({ extraFd, POLLIN, 0 });
+    for (pollfd& p : set) p.revents = 0;
+    return poll(set.data(), set.size(), timeoutMs) > 0;
+}
+
+// ── Sockets ──────────────────────────────────────────────────────────
+
+int listenTcp(uint16_t port, int backlog) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr = {};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(port);
+
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, backlog) < 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    watchFd(fd);
+    return fd;
+}
+
+int acceptClient(int listenFd) {
+    if (listenFd < 0) return -1;
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) return -1;
+    makeNonBlocking(fd);
+    watchFd(fd);
+    return fd;
+}
+
+int connectTcp(const char* host, uint16_t port) {
+    addrinfo hints = {};
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", (unsigned)port);
+
+    addrinfo* res = nullptr;
+    if (getaddrinfo(host, portStr, &hints, &res) != 0 || !res) return -1;
+
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0) {
+        makeNonBlocking(fd);
+        if (connect(fd, res->ai_addr, res->ai_addrlen) < 0 && errno != EINPROGRESS) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd >= 0) {
+        watchFd(fd);
+        watchWrite(fd, true);   // until the connect resolves
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+bool connectFinished(int fd, bool& ok) {
+    fd_set w;
+    FD_ZERO(&w);
+    FD_SET(fd, &w);
+    timeval tv = { 0, 0 };
+    if (select(fd + 1, nullptr, &w, nullptr, &tv) <= 0) return false;
+
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    ok = (err == 0);
+    watchWrite(fd, false);
+    return true;
+}
+
+void closeFd(int& fd) {
+    if (fd >= 0) {
+        unwatchFd(fd);
+        close(fd);
+    }
+    fd = -1;
+}
+
+bool readAvailable(int fd, std::vector<uint8_t>& into) {
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            into.insert(into.end(), buf, buf + n);
+            continue;
+        }
+        if (n == 0) return false;
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+}
+
+bool flushQueued(int fd, std::vector<uint8_t>& pending) {
+    bool wasPending = !pending.empty();
+    while (!pending.empty()) {
+        ssize_t n = send(fd, pending.data(), pending.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            pending.erase(pending.begin(), pending.begin() + n);
+            continue;
+        }
+        bool again = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+        if (again) watchWrite(fd, true);   // wake when the socket drains
+        return again;
+    }
+    if (wasPending) watchWrite(fd, false);
+    return true;
+}
+
+bool writeQueued(int fd, std::vector<uint8_t>& pending, const uint8_t* data, size_t len) {
+    pending.insert(pending.end(), data, data + len);
+    return flushQueued(fd, pending);
+}
+
+// ── SHA-1 (WebSocket handshake only) ─────────────────────────────────
+
+namespace {
+
+inline uint32_t rol(uint32_t v, int n) { return (v << n) | (v >> (32 - n)); }
+
+} // namespace
+
+void sha1(const uint8_t* data, size_t len, uint8_t out[20]) {
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+    std::vector<uint8_t> msg(data, data + len);
+    uint64_t bits = (uint64_t)len * 8;
+    msg.push_back(0x80);
+    while (msg.size() % 64 != 56) msg.push_back(0);
+    for (int i = 7; i >= 0; --i) msg.push_back((uint8_t)(bits >> (i * 8)));
+
+    for (size_t off = 0; off < msg.size(); off += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (uint32_t)msg[off + i * 4] << 24 | (uint32_t)msg[off + i * 4 + 1] << 16 |
+                   (uint32_t)msg[off + i * 4 + 2] << 8 | msg[off + i * 4 + 3];
+        }
+        for (int i = 16; i < 80; ++i) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if      (i < 20) { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            uint32_t t = rol(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rol(b, 30); b = a; a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        out[i * 4]     = (uint8_t)(h[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(h[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(h[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)h[i];
+    }
+}
+
+std::string base64Encode(const uint8_t* data, size_t len) {
+    static const char* A = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < len) v |= data[i + 2];
+        out.push_back(A[(v >> 18) & 63]);
+        out.push_back(A[(v >> 12) & 63]);
+        out.push_back(i + 1 < len ? A[(v >> 6) & 63] : '=');
+        out.push_back(i + 2 < len ? A[v & 63] : '=');
+    }
+    return out;
+}
+
+} // namespace native
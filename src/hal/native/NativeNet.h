@@ -0,0 +1,44 @@
+#ifndef NATIVE_NET_H
+#define NATIVE_NET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/**
+ * POSIX socket and crypto helpers shared by the host-build network
+ * shims (WebSocketsServer/Client, WebServer, simulated BLE link).
+ * Every socket is non-blocking; callers poll from loop() exactly like
+ * the Arduino libraries do on the device.
+ */
+namespace native {
+
+int  listenTcp(uint16_t port, int backlog = 8);   // -1 on failure
+int  acceptClient(int listenFd);                  // -1 if none pending
+int  connectTcp(const char* host, uint16_t port); // in-progress connect, -1 on failure
+bool connectFinished(int fd, bool& ok);           // true once the connect resolved
+void closeFd(int& fd);
+
+// Read whatever is available; returns false if the peer closed / errored.
+bool readAvailable(int fd, std::vector<uint8_t>& into);
+
+// Non-blocking write through a pending buffer; returns false on error.
+bool writeQueued(int fd, std::vector<uint8_t>& pending, const uint8_t* data, size_t len);
+bool flushQueued(int fd, std::vector<uint8_t>& pending);
+
+// ── Loop wait (hal::waitForEvent) ────────────────────────────────────
+// Every socket opened above is watched for input, and for output while
+// a connect or queued write is pending, so the host loop can sleep in
+// poll() until there is real work.  Other fds (stdin) opt in.
+void watchFd(int fd);
+void unwatchFd(int fd);
+void watchWrite(int fd, bool on);
+bool waitFds(int extraFd, int timeoutMs);   // true if any fd became ready
+
+void        sha1(const uint8_t* data, size_t len, uint8_t out[20]);
+std::string base64Encode(const uint8_t* data, size_t len);
+
+} // namespace native
+
+#endif // NATIVE_NET_H
@@ -0,0 +1,10 @@
+#include "NativeSim.h"
+
+namespace native {
+
+SimOptions& simOptions() {
+    static SimOptions opts;
+    return opts;
+}
+
+} // namespace native
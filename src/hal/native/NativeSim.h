@@ -0,0 +1,27 @@
+#ifndef NATIVE_SIM_H
+#define NATIVE_SIM_H
+
+#include <stdint.h>
+#include <string>
+
+namespace native {
+
+/**
+ * Knobs for the simulated device, set from the command line / env in
+ * main.cpp (or the benchmark runner) before anything touches the HAL.
+ */
+struct SimOptions {
+    uint8_t     mac[6]    = { 0x24, 0x6F, 0x28, 0x0A, 0xB1, 0xE5 };
+    std::string ip        = "127.0.0.1";
+    std::string nvsDir    = ".nvs";
+    uint16_t    blePort   = 7070;    // simulated BLE central link (TCP, JSON lines)
+    uint16_t    mdnsPort  = 5353;    // mDNS responder (UDP; 0 = off)
+    uint32_t    batteryMv = 3950;    // simulated cell voltage
+    char**      argv      = nullptr; // re-exec'd by hal::restart() (nullptr = exit)
+};
+
+SimOptions& simOptions();
+
+} // namespace native
+
+#endif // NATIVE_SIM_H
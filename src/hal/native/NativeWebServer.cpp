@@ -0,0 +1,290 @@
+#include <WebServer.h>
+#include "NativeNet.h"
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t MAX_HEAD = 8 * 1024;
+constexpr size_t MAX_BODY = 64 * 1024;
+
+const char* statusText(int code) {
+    switch (code) {
+        case 101: return "Switching Protocols";
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default:  return "";
+    }
+}
+
+HTTPMethod parseMethod(const std::string& m) {
+    if (m == "GET")     return HTTP_GET;
+    if (m == "HEAD")    return HTTP_HEAD;
+    if (m == "POST")    return HTTP_POST;
+    if (m == "PUT")     return HTTP_PUT;
+    if (m == "PATCH")   return HTTP_PATCH;
+    if (m == "DELETE")  return HTTP_DELETE;
+    if (m == "OPTIONS") return HTTP_OPTIONS;
+    return HTTP_ANY;
+}
+
+String urlDecode(const std::string& in) {
+    std::string out;
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (in[i] == '+') {
+            out.push_back(' ');
+        } else if (in[i] == '%' && i + 2 < in.size()) {
+            out.push_back((char)strtol(in.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else {
+            out.push_back(in[i]);
+        }
+    }
+    return String(out);
+}
+
+// Blocking read with the socket's receive timeout; false on EOF/timeout.
+bool recvSome(int fd, std::string& into, size_t max) {
+    char buf[1460];
+    ssize_t n = recv(fd, buf, std::min(sizeof(buf), max), 0);
+    if (n <= 0) return false;
+    into.append(buf, n);
+    return true;
+}
+
+} // namespace
+
+WebServer::WebServer(int port)
+    : port(port), listener(-1), client(-1), reqMethod(HTTP_ANY),
+      rawState(), contentLength(CONTENT_LENGTH_NOT_SET), headersSent(false) {}
+
+WebServer::~WebServer() { close(); }
+
+void WebServer::begin() {
+    if (listener >= 0) return;
+    listener = native::listenTcp((uint16_t)port, 16);
+    if (listener < 0) Serial.printf("[native] HTTP port %d unavailable\n", port);
+}
+
+void WebServer::close() {
+    native::closeFd(client);
+    native::closeFd(listener);
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn) {
+    routes.push_back({ uri, method, fn, nullptr });
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction uploadFn) {
+    routes.push_back({ uri, method, fn, uploadFn });
+}
+
+void WebServer::onNotFound(THandlerFunction fn) { notFound = fn; }
+
+// ── Request handling ─────────────────────────────────────────────────
+
+void WebServer::handleClient() {
+    client = native::acceptClient(listener);
+    if (client < 0) return;
+
+    // Serve this one request synchronously, as the ESP32 server does.
+    fcntl(client, F_SETFL, fcntl(client, F_GETFL, 0) & ~O_NONBLOCK);
+    timeval tv = { 2, 0 };
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    args.clear();
+    reqHeaders.clear();
+    respHeaders.clear();
+    contentLength = CONTENT_LENGTH_NOT_SET;
+    headersSent   = false;
+
+    std::string body;
+    if (readRequest(body)) {
+        const Route* route = nullptr;
+        for (const Route& r : routes) {
+            if (r.uri == reqUri && (r.method == HTTP_ANY || r.method == reqMethod)) { route = &r; break; }
+        }
+
+        String type = header("Content-Type");
+        bool   form = type.startsWith("application/x-www-form-urlencoded") ||
+                      type.startsWith("multipart/form-data");
+        size_t length = (size_t)header("Content-Length").toInt();
+
+        if (route && route->uploadFn && !form && (reqMethod == HTTP_POST || reqMethod == HTTP_PUT)) {
+            // Raw body streamed to the upload handler chunk by chunk.
+            rawState.status      = RAW_START;
+            rawState.totalSize   = 0;
+            rawState.currentSize = 0;
+            route->uploadFn();
+
+            bool aborted = false;
+            while (rawState.totalSize < length) {
+                if (body.empty() && !recvSome(client, body, length - rawState.totalSize)) {
+                    aborted = true;
+                    break;
+                }
+                size_t n = std::min(body.size(), sizeof(rawState.buf));
+                memcpy(rawState.buf, body.data(), n);
+                body.erase(0, n);
+                rawState.status      = RAW_WRITE;
+                rawState.currentSize = n;
+                rawState.totalSize  += n;
+                route->uploadFn();
+            }
+            rawState.status      = aborted ? RAW_ABORTED : RAW_END;
+            rawState.currentSize = 0;
+            route->uploadFn();
+        } else {
+            while (body.size() < std::min(length, MAX_BODY) && recvSome(client, body, length - body.size())) {}
+            if (form && type.startsWith("application/x-www-form-urlencoded")) {
+                size_t p = 0;
+                while (p < body.size()) {
+                    size_t amp = body.find('&', p);
+                    if (amp == std::string::npos) amp = body.size();
+                    std::string kv = body.substr(p, amp - p);
+                    size_t eq = kv.find('=');
+                    args.push_back({ urlDecode(kv.substr(0, eq)),
+                                     eq == std::string::npos ? String() : urlDecode(kv.substr(eq + 1)) });
+                    p = amp + 1;
+                }
+            } else if (!body.empty()) {
+                args.push_back({ String("plain"), String(body) });
+            }
+        }
+
+        if (route)         route->fn();
+        else if (notFound) notFound();
+        if (!headersSent)  send(500, "text/plain", "No response");
+    }
+
+    native::closeFd(client);
+}
+
+bool WebServer::readRequest(std::string& body) {
+    std::string head;
+    size_t end;
+    while ((end = head.find("\r\n\r\n")) == std::string::npos) {
+        if (head.size() > MAX_HEAD || !recvSome(client, head, MAX_HEAD)) return false;
+    }
+    body = head.substr(end + 4);
+    head.resize(end + 2);
+
+    // Request line: METHOD SP URI SP VERSION
+    size_t lineEnd = head.find("\r\n");
+    std::string line = head.substr(0, lineEnd);
+    size_t sp1 = line.find(' ');
+    size_t sp2 = line.find(' ', sp1 + 1);
+    if (sp1 == std::string::npos || sp2 == std::string::npos) return false;
+
+    reqMethod = parseMethod(line.substr(0, sp1));
+    std::string target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+
+    size_t q = target.find('?');
+    reqUri = String(target.substr(0, q));
+    if (q != std::string::npos) {
+        std::string query = target.substr(q + 1);
+        size_t p = 0;
+        while (p < query.size()) {
+            size_t amp = query.find('&', p);
+            if (amp == std::string::npos) amp = query.size();
+            std::string kv = query.substr(p, amp - p);
+            size_t eq = kv.find('=');
+            args.push_back({ urlDecode(kv.substr(0, eq)),
+                             eq == std::string::npos ? String() : urlDecode(kv.substr(eq + 1)) });
+            p = amp + 1;
+        }
+    }
+
+    size_t p = lineEnd + 2;
+    while (p < head.size()) {
+        size_t e = head.find("\r\n", p);
+        std::string h = head.substr(p, e - p);
+        size_t colon = h.find(':');
+        if (colon != std::string::npos) {
+            String value(h.substr(colon + 1));
+            value.trim();
+            reqHeaders.push_back({ String(h.substr(0, colon)), value });
+        }
+        p = e + 2;
+    }
+    return true;
+}
+
+bool WebServer::hasArg(const String& name) const {
+    for (const Pair& a : args) if (a.name == name) return true;
+    return false;
+}
+
+String WebServer::arg(const String& name) const {
+    for (const Pair& a : args) if (a.name == name) return a.value;
+    return String();
+}
+
+bool WebServer::hasHeader(const String& name) const {
+    for (const Pair& h : reqHeaders) if (h.name.equalsIgnoreCase(name)) return true;
+    return false;
+}
+
+String WebServer::header(const String& name) const {
+    for (const Pair& h : reqHeaders) if (h.name.equalsIgnoreCase(name)) return h.value;
+    return String();
+}
+
+// ── Responses ────────────────────────────────────────────────────────
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    if (first) respHeaders.insert(respHeaders.begin(), { name, value });
+    else       respHeaders.push_back({ name, value });
+}
+
+void WebServer::writeAll(const char* data, size_t len) {
+    while (len && client >= 0) {
+        ssize_t n = ::send(client, data, len, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        data += n;
+        len  -= n;
+    }
+}
+
+void WebServer::sendHead(int code, const char* contentType, size_t length) {
+    String head = String("HTTP/1.1 ") + code + " " + statusText(code) + "\r\n";
+    if (contentType) head += String("Content-Type: ") + contentType + "\r\n";
+    // As on the device, setContentLength() wins over the send() body size.
+    if (contentLength != CONTENT_LENGTH_NOT_SET) length = contentLength;
+    if (length != CONTENT_LENGTH_UNKNOWN) head += String("Content-Length: ") + (unsigned long)length + "\r\n";
+    for (const Pair& h : respHeaders) head += h.name + ": " + h.value + "\r\n";
+    head += "Connection: close\r\n\r\n";
+    writeAll(head.c_str(), head.length());
+    headersSent = true;
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    sendHead(code, contentType, content.length());
+    if (reqMethod != HTTP_HEAD) writeAll(content.c_str(), content.length());
+}
+
+void WebServer::send(int code, const String& contentType, const String& content) {
+    send(code, contentType.c_str(), content);
+}
+
+void WebServer::send_P(int code, const char* contentType, const char* content, size_t length) {
+    sendHead(code, contentType, length);
+    if (reqMethod != HTTP_HEAD) writeAll(content, length);
+}
+
+void WebServer::sendContent(const char* content, size_t length) {
+    if (!headersSent) sendHead(200, nullptr, contentLength);
+    writeAll(content, length);
+}
@@ -0,0 +1,450 @@
+#include <WebSocketsServer.h>
+#include <WebSocketsClient.h>
+#include "NativeNet.h"
+#include "../Hal.h"
+
+namespace {
+
+constexpr uint8_t OP_CONT  = 0x0;
+constexpr uint8_t OP_TEXT  = 0x1;
+constexpr uint8_t OP_BIN   = 0x2;
+constexpr uint8_t OP_CLOSE = 0x8;
+constexpr uint8_t OP_PING  = 0x9;
+constexpr uint8_t OP_PONG  = 0xA;
+
+constexpr size_t MAX_MESSAGE = 64 * 1024;
+
+const char* WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC11B85";
+
+// Case-insensitive header lookup inside a raw HTTP head.
+String headerValue(const std::string& head, const char* name) {
+    String lower(head);
+    lower.toLowerCase();
+    String key = String("\r\n") + name + ":";
+    key.toLowerCase();
+
+    int p = lower.indexOf(key);
+    if (p < 0) return String();
+    int start = p + key.length();
+    int end   = lower.indexOf("\r\n", start);
+    String v  = String(head.substr(start, end - start));
+    v.trim();
+    return v;
+}
+
+String acceptKey(const String& key) {
+    std::string in = std::string(key.c_str()) + WS_GUID;
+    uint8_t digest[20];
+    native::sha1((const uint8_t*)in.data(), in.size(), digest);
+    return String(native::base64Encode(digest, sizeof(digest)));
+}
+
+} // namespace
+
+// ── WsConnection ─────────────────────────────────────────────────────
+
+namespace native {
+
+void WsConnection::reset() {
+    closeFd(fd);
+    state = IDLE;
+    rx.clear();
+    tx.clear();
+    fragment.clear();
+    fragmentOpcode = 0;
+    protocol       = String();
+}
+
+bool WsConnection::sendFrame(uint8_t opcode, const uint8_t* data, size_t len) {
+    if (fd < 0) return false;
+
+    uint8_t head[14];
+    size_t  h = 0;
+    head[h++] = 0x80 | opcode;
+
+    uint8_t maskBit = isClient ? 0x80 : 0x00;
+    if (len < 126) {
+        head[h++] = maskBit | (uint8_t)len;
+    } else if (len <= 0xFFFF) {
+        head[h++] = maskBit | 126;
+        head[h++] = (uint8_t)(len >> 8);
+        head[h++] = (uint8_t)len;
+    } else {
+        head[h++] = maskBit | 127;
+        for (int i = 7; i >= 0; --i) head[h++] = (uint8_t)((uint64_t)len >> (i * 8));
+    }
+
+    std::vector<uint8_t> frame(head, head + h);
+    if (isClient) {
+        uint8_t mask[4];
+        uint32_t r = (uint32_t)rand();
+        memcpy(mask, &r, 4);
+        frame.insert(frame.end(), mask, mask + 4);
+        for (size_t i = 0; i < len; ++i) frame.push_back(data[i] ^ mask[i & 3]);
+    } else {
+        frame.insert(frame.end(), data, data + len);
+    }
+    return writeQueued(fd, tx, frame.data(), frame.size());
+}
+
+bool WsConnection::nextMessage(uint8_t& opcode, std::vector<uint8_t>& payload, bool& protocolError) {
+    protocolError = false;
+
+    for (;;) {
+        if (rx.size() < 2) return false;
+
+        bool     fin    = rx[0] & 0x80;
+        uint8_t  op     = rx[0] & 0x0F;
+        bool     masked = rx[1] & 0x80;
+        uint64_t len    = rx[1] & 0x7F;
+        size_t   pos    = 2;
+
+        if (len == 126) {
+            if (rx.size() < 4) return false;
+            len = (uint64_t)rx[2] << 8 | rx[3];
+            pos = 4;
+        } else if (len == 127) {
+            if (rx.size() < 10) return false;
+            len = 0;
+            for (int i = 0; i < 8; ++i) len = len << 8 | rx[2 + i];
+            pos = 10;
+        }
+        if (len > MAX_MESSAGE) { protocolError = true; return false; }
+
+        uint8_t mask[4] = { 0, 0, 0, 0 };
+        if (masked) {
+            if (rx.size() < pos + 4) return false;
+            memcpy(mask, &rx[pos], 4);
+            pos += 4;
+        }
+        if (rx.size() < pos + len) return false;
+
+        std::vector<uint8_t> data(rx.begin() + pos, rx.begin() + pos + len);
+        if (masked) for (size_t i = 0; i < data.size(); ++i) data[i] ^= mask[i & 3];
+        rx.erase(rx.begin(), rx.begin() + pos + len);
+
+        // Control frames are never fragmented.
+        if (op >= OP_CLOSE) {
+            opcode  = op;
+            payload = std::move(data);
+            return true;
+        }
+
+        if (op != OP_CONT) {
+            fragmentOpcode = op;
+            fragment.clear();
+        }
+        fragment.insert(fragment.end(), data.begin(), data.end());
+        if (fragment.size() > MAX_MESSAGE) { protocolError = true; return false; }
+        if (!fin) continue;
+
+        opcode  = fragmentOpcode;
+        payload = std::move(fragment);
+        fragment.clear();
+        return true;
+    }
+}
+
+} // namespace native
+
+// ── WebSocketsServer ─────────────────────────────────────────────────
+
+WebSocketsServer::WebSocketsServer(uint16_t port, const String& origin, const String& protocol)
+    : port(port), protocol(protocol), listener(-1) {
+    (void)origin;
+}
+
+WebSocketsServer::~WebSocketsServer() { close(); }
+
+void WebSocketsServer::begin() {
+    if (listener >= 0) return;
+    listener = native::listenTcp(port);
+    if (listener < 0) Serial.printf("[native] WS port %u unavailable\n", (unsigned)port);
+}
+
+void WebSocketsServer::close() {
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) drop(i, false);
+    native::closeFd(listener);
+}
+
+void WebSocketsServer::onEvent(WebSocketServerEvent handler) { cb = handler; }
+
+void WebSocketsServer::loop() {
+    acceptPending();
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) {
+        native::WsConnection& c = clients[i];
+        if (c.fd < 0) continue;
+
+        if (!native::readAvailable(c.fd, c.rx) || !native::flushQueued(c.fd, c.tx)) {
+            drop(i, c.state == native::WsConnection::OPEN);
+            continue;
+        }
+        if (c.state == native::WsConnection::HANDSHAKE) handleHandshake(i);
+        if (c.state == native::WsConnection::OPEN)      handleFrames(i);
+    }
+}
+
+void WebSocketsServer::acceptPending() {
+    int fd;
+    while ((fd = native::acceptClient(listener)) >= 0) {
+        uint8_t slot = WEBSOCKETS_SERVER_CLIENT_MAX;
+        for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) {
+            if (clients[i].fd < 0) { slot = i; break; }
+        }
+        if (slot == WEBSOCKETS_SERVER_CLIENT_MAX) {
+            static const char busy[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n";
+            std::vector<uint8_t> pending;
+            native::writeQueued(fd, pending, (const uint8_t*)busy, sizeof(busy) - 1);
+            native::closeFd(fd);
+            continue;
+        }
+        clients[slot].reset();
+        clients[slot].fd    = fd;
+        clients[slot].state = native::WsConnection::HANDSHAKE;
+    }
+}
+
+void WebSocketsServer::handleHandshake(uint8_t num) {
+    native::WsConnection& c = clients[num];
+    static const char END[] = "\r\n\r\n";
+    auto it = std::search(c.rx.begin(), c.rx.end(), END, END + 4);
+    if (it == c.rx.end()) return;
+
+    std::string head(c.rx.begin(), it + 4);
+    c.rx.erase(c.rx.begin(), it + 4);
+
+    String key = headerValue(head, "Sec-WebSocket-Key");
+    if (key.isEmpty()) {
+        drop(num, false);
+        return;
+    }
+    c.protocol = headerValue(head, "Sec-WebSocket-Protocol");
+
+    String resp = String("HTTP/1.1 101 Switching Protocols\r\n"
+                         "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                         "Sec-WebSocket-Accept: ") + acceptKey(key) + "\r\n";
+    if (!c.protocol.isEmpty()) {
+        // Echo the first offered subprotocol, like the Arduino server.
+        int comma = c.protocol.indexOf(',');
+        if (comma >= 0) c.protocol = c.protocol.substring(0, comma);
+        c.protocol.trim();
+        resp += String("Sec-WebSocket-Protocol: ") + c.protocol + "\r\n";
+    }
+    resp += "\r\n";
+
+    native::writeQueued(c.fd, c.tx, (const uint8_t*)resp.c_str(), resp.length());
+    c.state = native::WsConnection::OPEN;
+    if (cb) cb(num, WStype_CONNECTED, (uint8_t*)"/", 1);
+}
+
+void WebSocketsServer::handleFrames(uint8_t num) {
+    native::WsConnection& c = clients[num];
+    uint8_t              op;
+    std::vector<uint8_t> payload;
+    bool                 error = false;
+
+    while (c.fd >= 0 && c.nextMessage(op, payload, error)) {
+        size_t len = payload.size();
+        payload.push_back(0);   // NUL-terminate for TEXT consumers
+        switch (op) {
+            case OP_TEXT:  if (cb) cb(num, WStype_TEXT, payload.data(), len); break;
+            case OP_BIN:   if (cb) cb(num, WStype_BIN,  payload.data(), len); break;
+            case OP_PING:  c.sendFrame(OP_PONG, payload.data(), len); break;
+            case OP_PONG:  break;
+            case OP_CLOSE:
+                c.sendFrame(OP_CLOSE, nullptr, 0);
+                drop(num, true);
+                return;
+            default: break;
+        }
+    }
+    if (error) drop(num, true);
+}
+
+void WebSocketsServer::drop(uint8_t num, bool notify) {
+    if (clients[num].fd < 0) return;
+    clients[num].reset();
+    if (notify && cb) cb(num, WStype_DISCONNECTED, nullptr, 0);
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, const char* payload, size_t length) {
+    if (num >= WEBSOCKETS_SERVER_CLIENT_MAX || clients[num].state != native::WsConnection::OPEN) return false;
+    if (!length) length = strlen(payload);
+    return clients[num].sendFrame(OP_TEXT, (const uint8_t*)payload, length);
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, const String& payload) {
+    return sendTXT(num, payload.c_str(), payload.length());
+}
+
+bool WebSocketsServer::sendBIN(uint8_t num, const uint8_t* payload, size_t length) {
+    if (num >= WEBSOCKETS_SERVER_CLIENT_MAX || clients[num].state != native::WsConnection::OPEN) return false;
+    return clients[num].sendFrame(OP_BIN, payload, length);
+}
+
+bool WebSocketsServer::broadcastTXT(const char* payload, size_t length) {
+    if (!length) length = strlen(payload);
+    bool ok = true;
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) {
+        if (clients[i].state == native::WsConnection::OPEN) ok &= sendTXT(i, payload, length);
+    }
+    return ok;
+}
+
+bool WebSocketsServer::broadcastTXT(const String& payload) {
+    return broadcastTXT(payload.c_str(), payload.length());
+}
+
+bool WebSocketsServer::broadcastBIN(const uint8_t* payload, size_t length) {
+    bool ok = true;
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) {
+        if (clients[i].state == native::WsConnection::OPEN) ok &= sendBIN(i, payload, length);
+    }
+    return ok;
+}
+
+void WebSocketsServer::disconnect(uint8_t num) {
+    if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) return;
+    clients[num].sendFrame(OP_CLOSE, nullptr, 0);
+    drop(num, true);
+}
+
+int WebSocketsServer::connectedClients(bool ping) {
+    (void)ping;
+    int n = 0;
+    for (const native::WsConnection& c : clients) n += c.state == native::WsConnection::OPEN;
+    return n;
+}
+
+String WebSocketsServer::clientProtocol(uint8_t num) const {
+    return num < WEBSOCKETS_SERVER_CLIENT_MAX ? clients[num].protocol : String();
+}
+
+void WebSocketsServer::collectFds(std::vector<int>& out) const {
+    if (listener >= 0) out.push_back(listener);
+    for (const native::WsConnection& c : clients) if (c.fd >= 0) out.push_back(c.fd);
+}
+
+// ── WebSocketsClient ─────────────────────────────────────────────────
+
+WebSocketsClient::WebSocketsClient()
+    : port(0), reconnectMs(500), lastAttempt(0), started(false), wasOpen(false) {
+    conn.isClient = true;
+}
+
+WebSocketsClient::~WebSocketsClient() { conn.reset(); }
+
+void WebSocketsClient::begin(const char* h, uint16_t p, const char* u, const char* proto) {
+    host     = h;
+    port     = p;
+    url      = u;
+    protocol = proto;
+    started  = true;
+    startConnect();
+}
+
+void WebSocketsClient::begin(const String& h, uint16_t p, const String& u, const String& proto) {
+    begin(h.c_str(), p, u.c_str(), proto.c_str());
+}
+
+void WebSocketsClient::onEvent(WebSocketClientEvent handler) { cb = handler; }
+
+void WebSocketsClient::startConnect() {
+    conn.reset();
+    conn.isClient = true;
+    lastAttempt   = hal::millis();
+    conn.fd       = native::connectTcp(host.c_str(), port);
+    conn.state    = conn.fd >= 0 ? native::WsConnection::CONNECTING : native::WsConnection::IDLE;
+}
+
+void WebSocketsClient::fail() {
+    bool notify = wasOpen;
+    wasOpen = false;
+    conn.reset();
+    if (notify && cb) cb(WStype_DISCONNECTED, nullptr, 0);
+}
+
+void WebSocketsClient::disconnect() {
+    if (conn.state == native::WsConnection::OPEN) conn.sendFrame(OP_CLOSE, nullptr, 0);
+    started = false;
+    fail();
+}
+
+void WebSocketsClient::loop() {
+    if (!started) return;
+
+    if (conn.state == native::WsConnection::IDLE) {
+        if (hal::millis() - lastAttempt >= reconnectMs) startConnect();
+        return;
+    }
+
+    if (conn.state == native::WsConnection::CONNECTING) {
+        bool ok = false;
+        if (!native::connectFinished(conn.fd, ok)) return;
+        if (!ok) { fail(); return; }
+
+        uint8_t nonce[16];
+        for (uint8_t& b : nonce) b = (uint8_t)rand();
+        String req = String("GET ") + url + " HTTP/1.1\r\nHost: " + host + ":" + (unsigned int)port +
+                     "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Version: 13\r\n"
+                     "Sec-WebSocket-Key: " + String(native::base64Encode(nonce, sizeof(nonce))) + "\r\n";
+        if (!protocol.isEmpty()) req += String("Sec-WebSocket-Protocol: ") + protocol + "\r\n";
+        req += "\r\n";
+        native::writeQueued(conn.fd, conn.tx, (const uint8_t*)req.c_str(), req.length());
+        conn.state = native::WsConnection::HANDSHAKE;
+    }
+
+    if (!native::readAvailable(conn.fd, conn.rx) || !native::flushQueued(conn.fd, conn.tx)) {
+        fail();
+        return;
+    }
+
+    if (conn.state == native::WsConnection::HANDSHAKE) {
+        static const char END[] = "\r\n\r\n";
+        auto it = std::search(conn.rx.begin(), conn.rx.end(), END, END + 4);
+        if (it == conn.rx.end()) return;
+
+        std::string head(conn.rx.begin(), it + 4);
+        conn.rx.erase(conn.rx.begin(), it + 4);
+        if (head.compare(0, 12, "HTTP/1.1 101") != 0) { fail(); return; }
+
+        conn.state = native::WsConnection::OPEN;
+        wasOpen    = true;
+        if (cb) cb(WStype_CONNECTED, (uint8_t*)url.c_str(), url.length());
+    }
+
+    uint8_t              op;
+    std::vector<uint8_t> payload;
+    bool                 error = false;
+    while (conn.state == native::WsConnection::OPEN && conn.nextMessage(op, payload, error)) {
+        size_t len = payload.size();
+        payload.push_back(0);
+        switch (op) {
+            case OP_TEXT:  if (cb) cb(WStype_TEXT, payload.data(), len); break;
+            case OP_BIN:   if (cb) cb(WStype_BIN,  payload.data(), len); break;
+            case OP_PING:  conn.sendFrame(OP_PONG, payload.data(), len); break;
+            case OP_CLOSE: fail(); return;
+            default: break;
+        }
+    }
+    if (error) fail();
+}
+
+bool WebSocketsClient::sendTXT(const char* payload, size_t length) {
+    if (!isConnected()) return false;
+    if (!length) length = strlen(payload);
+    return conn.sendFrame(OP_TEXT, (const uint8_t*)payload, length);
+}
+
+bool WebSocketsClient::sendTXT(const String& payload) {
+    return sendTXT(payload.c_str(), payload.length());
+}
+
+bool WebSocketsClient::sendBIN(const uint8_t* payload, size_t length) {
+    if (!isConnected()) return false;
+    return conn.sendFrame(OP_BIN, payload, length);
+}
+
+bool WebSocketsClient::isConnected() const {
+    return conn.state == native::WsConnection::OPEN;
+}
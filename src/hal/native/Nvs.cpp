@@ -0,0 +1,146 @@
+#include "../Nvs.h"
+#include "NativeSim.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sys/stat.h>
+
+namespace hal {
+
+/**
+ * One namespace held in memory and mirrored to
+ * <nvsDir>/<namespace>.nvs as "key<TAB>type<TAB>value" lines
+ * (s = string, i = int, u = uint, b = hex bytes).
+ */
+struct NvsNamespace {
+    struct Entry {
+        char        type;
+        std::string value;
+    };
+    std::string                  path;
+    std::map<std::string, Entry> entries;
+    std::mutex                   lock;
+};
+
+namespace {
+
+std::mutex registryLock;
+std::map<std::string, std::unique_ptr<NvsNamespace>> registry;
+
+std::string toHex(const uint8_t* p, size_t n) {
+    static const char* H = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < n; ++i) { out.push_back(H[p[i] >> 4]); out.push_back(H[p[i] & 15]); }
+    return out;
+}
+
+NvsNamespace* openNamespace(const char* name) {
+    std::lock_guard<std::mutex> g(registryLock);
+    std::unique_ptr<NvsNamespace>& slot = registry[name];
+    if (slot) return slot.get();
+
+    slot.reset(new NvsNamespace());
+    const std::string& dir = native::simOptions().nvsDir;
+    mkdir(dir.c_str(), 0755);
+    slot->path = dir + "/" + name + ".nvs";
+
+    FILE* f = fopen(slot->path.c_str(), "r");
+    if (f) {
+        char line[4096];
+        while (fgets(line, sizeof(line), f)) {
+            char* t1 = strchr(line, '\t');
+            char* t2 = t1 ? strchr(t1 + 1, '\t') : nullptr;
+            if (!t1 || !t2) continue;
+            *t1 = *t2 = 0;
+            char* v = t2 + 1;
+            v[strcspn(v, "\n")] = 0;
+            slot->entries[line] = { t1[1], v };
+        }
+        fclose(f);
+    }
+    return slot.get();
+}
+
+void save(NvsNamespace* ns) {
+    std::string tmp = ns->path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) return;
+    for (const auto& kv : ns->entries) {
+        fprintf(f, "%s\t%c\t%s\n", kv.first.c_str(), kv.second.type, kv.second.value.c_str());
+    }
+    fclose(f);
+    rename(tmp.c_str(), ns->path.c_str());
+}
+
+} // namespace
+
+Nvs::Nvs(const char* name, bool ro) : ns(openNamespace(name)), dirty(false), readOnly(ro) {
+    ns->lock.lock();
+}
+
+Nvs::~Nvs() {
+    if (dirty) save(ns);
+    ns->lock.unlock();
+}
+
+bool Nvs::isKey(const char* key) {
+    return ns->entries.count(key) != 0;
+}
+
+bool Nvs::remove(const char* key) {
+    if (readOnly) return false;
+    dirty |= ns->entries.erase(key) != 0;
+    return true;
+}
+
+String Nvs::getString(const char* key, const String& def) {
+    auto it = ns->entries.find(key);
+    return it != ns->entries.end() && it->second.type == 's' ? String(it->second.value) : def;
+}
+
+int32_t Nvs::getInt(const char* key, int32_t def) {
+    auto it = ns->entries.find(key);
+    return it != ns->entries.end() && it->second.type == 'i' ? (int32_t)strtol(it->second.value.c_str(), nullptr, 10) : def;
+}
+
+uint32_t Nvs::getUInt(const char* key, uint32_t def) {
+    auto it = ns->entries.find(key);
+    return it != ns->entries.end() && it->second.type == 'u' ? (uint32_t)strtoul(it->second.value.c_str(), nullptr, 10) : def;
+}
+
+size_t Nvs::getBytes(const char* key, void* buf, size_t maxLen) {
+    auto it = ns->entries.find(key);
+    if (it == ns->entries.end() || it->second.type != 'b') return 0;
+    const std::string& hex = it->second.value;
+    size_t n = std::min(hex.size() / 2, maxLen);
+    for (size_t i = 0; i < n; ++i) {
+        ((uint8_t*)buf)[i] = (uint8_t)strtoul(hex.substr(i * 2, 2).c_str(), nullptr, 16);
+    }
+    return n;
+}
+
+void Nvs::putString(const char* key, const String& value) {
+    if (readOnly) return;
+    ns->entries[key] = { 's', value.c_str() };
+    dirty = true;
+}
+
+void Nvs::putInt(const char* key, int32_t value) {
+    if (readOnly) return;
+    ns->entries[key] = { 'i', std::to_string(value) };
+    dirty = true;
+}
+
+void Nvs::putUInt(const char* key, uint32_t value) {
+    if (readOnly) return;
+    ns->entries[key] = { 'u', std::to_string(value) };
+    dirty = true;
+}
+
+void Nvs::putBytes(const char* key, const void* buf, size_t len) {
+    if (readOnly) return;
+    ns->entries[key] = { 'b', toHex((const uint8_t*)buf, len) };
+    dirty = true;
+}
+
+} // namespace hal
@@ -0,0 +1,21 @@
+#include "SimAdcSource.h"
+#include "NativeSim.h"
+#include "../Hal.h"
+
+SimAdcSource::SimAdcSource(int pin) : pin(pin), lcg(0x1234567u) {}
+
+bool SimAdcSource::begin() {
+    return pin >= 0;
+}
+
+uint32_t SimAdcSource::readMilliVolts() {
+    // ~1 mV per minute of uptime, like a lightly loaded cell.
+    uint32_t cellMv = native::simOptions().batteryMv;
+    uint32_t drop   = hal::millis() / 60000;
+    cellMv = cellMv > drop + 3300 ? cellMv - drop : 3300;
+
+    lcg = lcg * 1664525u + 1013904223u;
+    int32_t noise = (int32_t)(lcg >> 28) - 8;   // -8 .. +7 mV
+
+    return (uint32_t)((int32_t)(cellMv / 2) + noise);
+}
@@ -0,0 +1,24 @@
+#ifndef SIM_ADC_SOURCE_H
+#define SIM_ADC_SOURCE_H
+
+#include "../../power/AdcSource.h"
+
+/**
+ * Synthetic battery input for the host build: the simulated cell
+ * voltage behind a 2:1 divider, slowly discharging, plus ±8 mV of
+ * deterministic pseudo-random noise so the oversampling and IIR stages
+ * actually have something to do.
+ */
+class SimAdcSource : public AdcSource {
+public:
+    explicit SimAdcSource(int pin);
+
+    bool     begin() override;
+    uint32_t readMilliVolts() override;
+
+private:
+    int      pin;
+    uint32_t lcg;
+};
+
+#endif // SIM_ADC_SOURCE_H
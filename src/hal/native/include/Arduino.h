@@ -0,0 +1,162 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+/**
+ * Host-build stand-in for the Arduino core.
+ *
+ * Only the language-level pieces the firmware and ArduinoJson rely on
+ * live here (String, Serial, math helpers).  Anything that touches
+ * hardware goes through hal:: instead — there is deliberately no
+ * pinMode()/analogWrite()/WiFi in this header.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+#define HEX 16
+#define DEC 10
+
+using std::min;
+using std::max;
+
+template <typename T, typename L, typename H>
+inline T constrain(T x, L lo, H hi) {
+    return x < (T)lo ? (T)lo : (x > (T)hi ? (T)hi : x);
+}
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Libraries occasionally call these directly; firmware code uses hal::.
+uint32_t millis();
+uint32_t micros();
+void     delay(uint32_t ms);
+
+// ── String ───────────────────────────────────────────────────────────
+
+class StringSumHelper;
+
+class String {
+public:
+    String() {}
+    String(const char* s) : s(s ? s : "") {}
+    String(const char* s, size_t n) : s(s ? s : "", s ? n : 0) {}
+    String(const std::string& s) : s(s) {}
+    String(const String& o) = default;
+    String(String&& o) = default;
+    explicit String(char c) : s(1, c) {}
+    explicit String(int v, unsigned char base = DEC);
+    explicit String(unsigned int v, unsigned char base = DEC);
+    explicit String(long v, unsigned char base = DEC);
+    explicit String(unsigned long v, unsigned char base = DEC);
+    explicit String(float v, unsigned int decimals = 2);
+    explicit String(double v, unsigned int decimals = 2);
+
+    String& operator=(const String& o) = default;
+    String& operator=(String&& o) = default;
+    String& operator=(const char* c) { s = c ? c : ""; return *this; }
+
+    const char*  c_str() const  { return s.c_str(); }
+    unsigned int length() const { return (unsigned int)s.size(); }
+    bool         isEmpty() const { return s.empty(); }
+    bool         reserve(unsigned int n) { s.reserve(n); return true; }
+
+    // ArduinoJson's String writer appends through concat().
+    bool concat(const char* c)           { if (c) s.append(c); return true; }
+    bool concat(const char* c, size_t n) { if (c) s.append(c, n); return true; }
+    bool concat(const String& o)         { s.append(o.s); return true; }
+    bool concat(char c)                  { s.push_back(c); return true; }
+
+    String& operator+=(const String& o) { s.append(o.s); return *this; }
+    String& operator+=(const char* c)   { if (c) s.append(c); return *this; }
+    String& operator+=(char c)          { s.push_back(c); return *this; }
+    String& operator+=(int v)           { s.append(std::to_string(v)); return *this; }
+    String& operator+=(unsigned int v)  { s.append(std::to_string(v)); return *this; }
+    String& operator+=(long v)          { s.append(std::to_string(v)); return *this; }
+    String& operator+=(unsigned long v) { s.append(std::to_string(v)); return *this; }
+
+    bool operator==(const String& o) const { return s == o.s; }
+    bool operator==(const char* c) const   { return s == (c ? c : ""); }
+    bool operator!=(const String& o) const { return s != o.s; }
+    bool operator!=(const char* c) const   { return !(*this == c); }
+    bool operator<(const String& o) const  { return s < o.s; }
+    bool equals(const String& o) const     { return s == o.s; }
+    bool equalsIgnoreCase(const String& o) const;
+
+    char  charAt(unsigned int i) const { return i < s.size() ? s[i] : 0; }
+    char  operator[](unsigned int i) const { return charAt(i); }
+    char& operator[](unsigned int i) { return s[i]; }
+
+    int    indexOf(char c, unsigned int from = 0) const;
+    int    indexOf(const String& str, unsigned int from = 0) const;
+    int    lastIndexOf(char c) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    bool   startsWith(const String& prefix) const;
+    bool   endsWith(const String& suffix) const;
+
+    void replace(const String& from, const String& to);
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1);
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+
+    long  toInt() const   { return strtol(s.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(s.c_str(), nullptr); }
+
+    const std::string& str() const { return s; }
+
+private:
+    std::string s;
+};
+
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+};
+
+inline StringSumHelper operator+(const String& a, const String& b) { StringSumHelper r(a); r += b; return r; }
+inline StringSumHelper operator+(const String& a, const char* b)   { StringSumHelper r(a); r += b; return r; }
+inline StringSumHelper operator+(const char* a, const String& b)   { StringSumHelper r = String(a); r += b; return r; }
+inline StringSumHelper operator+(const String& a, char b)          { StringSumHelper r(a); r += b; return r; }
+inline StringSumHelper operator+(const String& a, int b)           { StringSumHelper r(a); r += b; return r; }
+inline StringSumHelper operator+(const String& a, unsigned int b)  { StringSumHelper r(a); r += b; return r; }
+inline StringSumHelper operator+(const String& a, long b)          { StringSumHelper r(a); r += b; return r; }
+inline StringSumHelper operator+(const String& a, unsigned long b) { StringSumHelper r(a); r += b; return r; }
+
+// ── Serial (stdout / stdin) ──────────────────────────────────────────
+
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void flush();
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buf, size_t len);
+    int    available();
+    int    read();
+
+    size_t print(const char* s);
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(char c);
+    size_t print(int v);
+    size_t print(unsigned int v);
+    size_t print(long v);
+    size_t print(unsigned long v);
+    size_t println();
+    template <typename T>
+    size_t println(const T& v) { size_t n = print(v); return n + println(); }
+
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,101 @@
+#ifndef NATIVE_WEBSERVER_H
+#define NATIVE_WEBSERVER_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+typedef enum {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS,
+} HTTPMethod;
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+enum HTTPRawStatus { RAW_START, RAW_WRITE, RAW_END, RAW_ABORTED };
+
+struct HTTPRaw {
+    HTTPRawStatus status;
+    size_t        totalSize;
+    size_t        currentSize;
+    uint8_t       buf[1436];
+};
+
+/**
+ * Host-build stand-in for the Arduino-ESP32 WebServer.
+ *
+ * Like the original it serves one connection per handleClient() call
+ * and blocks the loop while doing so (bounded by a short timeout), so
+ * load on the REST API shows up in loop latency the same way.
+ */
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit WebServer(int port = 80);
+    ~WebServer();
+
+    void begin();
+    void close();
+    void handleClient();
+
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn);
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction uploadFn);
+    void onNotFound(THandlerFunction fn);
+
+    HTTPMethod method() const { return reqMethod; }
+    String     uri() const    { return reqUri; }
+    bool       hasArg(const String& name) const;
+    String     arg(const String& name) const;
+    String     header(const String& name) const;
+    bool       hasHeader(const String& name) const;
+    void       collectHeaders(const char* headerKeys[], size_t count) { (void)headerKeys; (void)count; }
+    HTTPRaw&   raw() { return rawState; }
+
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void send(int code, const String& contentType, const String& content);
+    void send_P(int code, const char* contentType, const char* content, size_t length);
+    void setContentLength(size_t length) { contentLength = length; }
+    void sendContent(const char* content, size_t length);
+    void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+
+    int listenFd() const { return listener; }
+
+private:
+    struct Route {
+        String           uri;
+        HTTPMethod       method;
+        THandlerFunction fn;
+        THandlerFunction uploadFn;
+    };
+    struct Pair { String name, value; };
+
+    int                port;
+    int                listener;
+    int                client;
+    std::vector<Route> routes;
+    THandlerFunction   notFound;
+
+    HTTPMethod        reqMethod;
+    String            reqUri;
+    std::vector<Pair> args;
+    std::vector<Pair> reqHeaders;
+    std::vector<Pair> respHeaders;
+    HTTPRaw           rawState;
+    size_t            contentLength;
+    bool              headersSent;
+
+    bool readRequest(std::string& body);
+    void writeAll(const char* data, size_t len);
+    void sendHead(int code, const char* contentType, size_t length);
+};
+
+#endif // NATIVE_WEBSERVER_H
@@ -0,0 +1,58 @@
+#ifndef NATIVE_WEBSOCKETS_H
+#define NATIVE_WEBSOCKETS_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+// Host-build stand-in for links2004/WebSockets — same event model.
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN,
+    WStype_FRAGMENT_TEXT_START,
+    WStype_FRAGMENT_BIN_START,
+    WStype_FRAGMENT,
+    WStype_FRAGMENT_FIN,
+    WStype_PING,
+    WStype_PONG,
+} WStype_t;
+
+#ifndef WEBSOCKETS_SERVER_CLIENT_MAX
+#define WEBSOCKETS_SERVER_CLIENT_MAX 5   // same limit as the ESP32 build
+#endif
+
+namespace native {
+
+/**
+ * One RFC 6455 connection over a non-blocking socket: HTTP upgrade,
+ * frame (de)masking, ping/pong/close.  Shared by the server and
+ * client shims.
+ */
+struct WsConnection {
+    enum State { IDLE, CONNECTING, HANDSHAKE, OPEN };
+
+    int                  fd    = -1;
+    State                state = IDLE;
+    bool                 isClient = false;   // clients mask outgoing frames
+    std::vector<uint8_t> rx;
+    std::vector<uint8_t> tx;
+    std::vector<uint8_t> fragment;
+    uint8_t              fragmentOpcode = 0;
+    String               protocol;
+
+    bool sendFrame(uint8_t opcode, const uint8_t* data, size_t len);
+
+    // Parse one complete frame out of rx.  Returns false when more data
+    // is needed; on success fills opcode/payload (payload is
+    // NUL-terminated like the Arduino library guarantees).
+    bool nextMessage(uint8_t& opcode, std::vector<uint8_t>& payload, bool& protocolError);
+
+    void reset();
+};
+
+} // namespace native
+
+#endif // NATIVE_WEBSOCKETS_H
@@ -0,0 +1,48 @@
+#ifndef NATIVE_WEBSOCKETS_CLIENT_H
+#define NATIVE_WEBSOCKETS_CLIENT_H
+
+#include "WebSockets.h"
+
+/**
+ * Host-build WebSocketsClient: non-blocking connect, automatic
+ * reconnect every setReconnectInterval() ms, same callbacks as the
+ * Arduino library.
+ */
+class WebSocketsClient {
+public:
+    typedef std::function<void(WStype_t type, uint8_t* payload, size_t length)> WebSocketClientEvent;
+
+    WebSocketsClient();
+    ~WebSocketsClient();
+
+    void begin(const char* host, uint16_t port, const char* url = "/", const char* protocol = "arduino");
+    void begin(const String& host, uint16_t port, const String& url = "/", const String& protocol = "arduino");
+    void loop();
+    void onEvent(WebSocketClientEvent cb);
+    void disconnect();
+    void setReconnectInterval(unsigned long ms) { reconnectMs = ms; }
+
+    bool sendTXT(const char* payload, size_t length = 0);
+    bool sendTXT(const String& payload);
+    bool sendBIN(const uint8_t* payload, size_t length);
+    bool isConnected() const;
+
+    int socketFd() const { return conn.fd; }
+
+private:
+    String               host;
+    uint16_t             port;
+    String               url;
+    String               protocol;
+    native::WsConnection conn;
+    WebSocketClientEvent cb;
+    unsigned long        reconnectMs;
+    uint32_t             lastAttempt;
+    bool                 started;
+    bool                 wasOpen;
+
+    void startConnect();
+    void fail();
+};
+
+#endif // NATIVE_WEBSOCKETS_CLIENT_H
@@ -0,0 +1,51 @@
+#ifndef NATIVE_WEBSOCKETS_SERVER_H
+#define NATIVE_WEBSOCKETS_SERVER_H
+
+#include "WebSockets.h"
+
+/**
+ * Host-build WebSocketsServer: real TCP listener, polled from loop(),
+ * at most WEBSOCKETS_SERVER_CLIENT_MAX clients (extra connections are
+ * refused with 503, as on the device).
+ */
+class WebSocketsServer {
+public:
+    typedef std::function<void(uint8_t num, WStype_t type, uint8_t* payload, size_t length)> WebSocketServerEvent;
+
+    WebSocketsServer(uint16_t port, const String& origin = "", const String& protocol = "arduino");
+    ~WebSocketsServer();
+
+    void begin();
+    void close();
+    void loop();
+    void onEvent(WebSocketServerEvent cb);
+
+    bool sendTXT(uint8_t num, const char* payload, size_t length = 0);
+    bool sendTXT(uint8_t num, const String& payload);
+    bool sendBIN(uint8_t num, const uint8_t* payload, size_t length);
+    bool broadcastTXT(const char* payload, size_t length = 0);
+    bool broadcastTXT(const String& payload);
+    bool broadcastBIN(const uint8_t* payload, size_t length);
+
+    void   disconnect(uint8_t num);
+    int    connectedClients(bool ping = false);
+    String clientProtocol(uint8_t num) const;
+
+    // Host-only: listening socket and client sockets, for event waits.
+    int  listenFd() const { return listener; }
+    void collectFds(std::vector<int>& out) const;
+
+private:
+    uint16_t             port;
+    String               protocol;
+    int                  listener;
+    native::WsConnection clients[WEBSOCKETS_SERVER_CLIENT_MAX];
+    WebSocketServerEvent cb;
+
+    void acceptPending();
+    void handleHandshake(uint8_t num);
+    void handleFrames(uint8_t num);
+    void drop(uint8_t num, bool notify);
+};
+
+#endif // NATIVE_WEBSOCKETS_SERVER_H
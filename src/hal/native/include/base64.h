@@ -0,0 +1,13 @@
+#ifndef NATIVE_BASE64_H
+#define NATIVE_BASE64_H
+
+#include <Arduino.h>
+
+// Host-build stand-in for the Arduino-ESP32 base64 helper.
+class base64 {
+public:
+    static String encode(const uint8_t* data, size_t length);
+    static String encode(const String& text);
+};
+
+#endif // NATIVE_BASE64_H
@@ -0,0 +1,100 @@
+#include <Arduino.h>
+#include "NativeSim.h"
+#include "../Hal.h"
+#include "../../ConfigManager.h"
+#include "../../log/Logger.h"
+#include "../../../include/types/device_stats.h"
+#include <signal.h>
+
+/**
+ * Host-build entry point: parses simulation options, optionally seeds
+ * NVS, then runs the same setup()/loop() as the device (src/main.cpp).
+ *
+ *   .pio/build/native/program [--nvs-dir DIR] [--ble-port N] [--mdns-port N] [--mac AA:BB:CC:DD:EE:FF]
+ *                             [--ip A.B.C.D] [--battery-mv N] [--ssid NAME | --no-wifi]
+ *                             [--transport BLE|WIFI|REMOTE|AUTO] [--remote ws://host:port/path]
+ */
+
+void setup();
+void loop();
+
+namespace {
+
+volatile sig_atomic_t running = 1;
+
+void onSignal(int) { running = 0; }
+
+bool parseMac(const char* s, uint8_t out[6]) {
+    unsigned v[6];
+    if (sscanf(s, "%x:%x:%x:%x:%x:%x", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5]) != 6) return false;
+    for (int i = 0; i < 6; ++i) out[i] = (uint8_t)v[i];
+    return true;
+}
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [--nvs-dir DIR] [--ble-port N] [--mdns-port N] [--mac MAC] [--ip ADDR] [--battery-mv N]\n"
+            "          [--ssid NAME | --no-wifi] [--transport BLE|WIFI|REMOTE|AUTO] [--remote URL]\n",
+            prog);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    native::SimOptions& o = native::simOptions();
+    const char* ssid      = nullptr;
+    const char* transport = nullptr;
+    const char* remote    = nullptr;
+    bool        noWifi    = false;
+
+    if (const char* dir = getenv("OPENVIBE_NVS_DIR")) o.nvsDir = dir;
+    o.argv = argv;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a    = argv[i];
+        const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool        ok   = true;
+
+        if      (!strcmp(a, "--nvs-dir")    && next) { o.nvsDir = next; ++i; }
+        else if (!strcmp(a, "--ble-port")   && next) { o.blePort = (uint16_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--mdns-port")  && next) { o.mdnsPort = (uint16_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--mac")        && next) { ok = parseMac(next, o.mac); ++i; }
+        else if (!strcmp(a, "--ip")         && next) { o.ip = next; ++i; }
+        else if (!strcmp(a, "--battery-mv") && next) { o.batteryMv = (uint32_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--ssid")       && next) { ssid = next; ++i; }
+        else if (!strcmp(a, "--transport")  && next) { transport = next; ++i; }
+        else if (!strcmp(a, "--remote")     && next) { remote = next; ++i; }
+        else if (!strcmp(a, "--no-wifi"))            { noWifi = true; }
+        else if (!strcmp(a, "--help"))               { usage(argv[0]); return 0; }
+        else ok = false;
+
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    // ── Seed NVS so the simulated device comes up on the LAN ─────────
+    ConfigManager& cfg = ConfigManager::getInstance();
+    if (noWifi) {
+        cfg.clearWiFiCredentials();
+    } else if (ssid || !cfg.hasWiFiCredentials()) {
+        cfg.setWiFiCredentials(ssid ? ssid : "OpenVibe-Lab", "");
+    }
+    if (remote) cfg.setRemoteServer(remote);
+    if (transport) {
+        if      (!strcmp(transport, "BLE"))    cfg.setLastTransport(TRANSPORT_BLE);
+        else if (!strcmp(transport, "WIFI"))   cfg.setLastTransport(TRANSPORT_WIFI);
+        else if (!strcmp(transport, "REMOTE")) cfg.setLastTransport(TRANSPORT_REMOTE);
+        else if (!strcmp(transport, "AUTO"))   cfg.setLastTransport(TRANSPORT_AUTO);
+    }
+
+    signal(SIGINT,  onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    setup();
+    while (running) loop();   // sleeps in hal::waitForEvent() when idle
+    Logger::getInstance().flush();
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "Logger.h"
+#include <stdarg.h>
+
+Logger& Logger::getInstance() {
+    static Logger inst;
+    return inst;
+}
+
+Logger::Logger()
+    : ring{}
+    , head(0)
+    , tail(0)
+    , written(0)
+    , dropped(0)
+    , peak(0)
+    , reportedDrops(0) {}
+
+void Logger::begin() {
+    if (!task.start("log", drainTask, this, 3072)) {
+        Serial.println("[Log] Drain task failed — logging disabled");
+        return;
+    }
+    task.notify();   // lines from before begin()
+}
+
+// ── Producers ────────────────────────────────────────────────────────
+
+void Logger::write(const char* fmt, ...) {
+    char    line[MAX_LINE];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    if (n <= 0) return;
+    if ((size_t)n >= sizeof(line)) {   // cut, but keep the line break
+        n            = sizeof(line) - 1;
+        line[n - 1]  = '\n';
+    }
+
+    uint32_t need = (4 + (uint32_t)n + 3) & ~3u;
+    uint32_t h    = head.load(std::memory_order_relaxed);
+    uint32_t pad, used;
+    do {
+        uint32_t pos = h & (CAPACITY - 1);
+        pad  = CAPACITY - pos < need ? CAPACITY - pos : 0;
+        used = h + pad + need - tail.load(std::memory_order_acquire);
+        if (used > CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } while (!head.compare_exchange_weak(h, h + pad + need,
+                                         std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    if (pad) publish(h & (CAPACITY - 1), (pad << 16) | REC_PAD);
+    uint32_t at = (h + pad) & (CAPACITY - 1);
+    memcpy(ring + at + 4, line, n);
+    publish(at, (need << 16) | ((uint32_t)n << 2) | REC_LINE);
+
+    written.fetch_add(1, std::memory_order_relaxed);
+    uint32_t p = peak.load(std::memory_order_relaxed);
+    while (used > p && !peak.compare_exchange_weak(p, used, std::memory_order_relaxed)) {}
+    task.notify();
+}
+
+void Logger::publish(uint32_t at, uint32_t header) {
+    __atomic_store_n(reinterpret_cast<uint32_t*>(ring + at), header, __ATOMIC_RELEASE);
+}
+
+// ── Drain ────────────────────────────────────────────────────────────
+
+void Logger::drainTask(void* arg) {
+    Logger* self = static_cast<Logger*>(arg);
+    for (;;) {
+        self->task.waitNotify(UINT32_MAX);
+        self->drain();
+    }
+}
+
+void Logger::flush() {
+    drain();
+    Serial.flush();
+}
+
+// Stops at the first record that is claimed but not yet published; its
+// writer notifies again when it is.
+void Logger::drain() {
+    hal::LockGuard lock(drainLock);
+
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    while (t != head.load(std::memory_order_acquire)) {
+        uint32_t* hdr    = reinterpret_cast<uint32_t*>(ring + (t & (CAPACITY - 1)));
+        uint32_t  header = __atomic_load_n(hdr, __ATOMIC_ACQUIRE);
+        uint32_t  state  = header & 3;
+        if (state == REC_EMPTY) break;
+
+        if (state == REC_LINE) {
+            Serial.write(reinterpret_cast<uint8_t*>(hdr + 1), (header >> 2) & 0x3FFF);
+        }
+        // Zero the whole record: a later header may land anywhere in it.
+        memset(hdr, 0, header >> 16);
+        t += header >> 16;
+        tail.store(t, std::memory_order_release);
+    }
+
+    uint32_t d = dropped.load(std::memory_order_relaxed);
+    if (d != reportedDrops) {
+        Serial.printf("[Log] %u lines dropped\n", (unsigned)(d - reportedDrops));
+        reportedDrops = d;
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "../hal/Hal.h"
+
+// ── Levels ───────────────────────────────────────────────────────────
+// 0 none, 1 error, 2 warn, 3 info, 4 debug.  OPENVIBE_LOG_LEVEL is the
+// default for every module; OPENVIBE_LOG_<MODULE> overrides one, e.g.
+//   build_flags = -DOPENVIBE_LOG_LEVEL=2 -DOPENVIBE_LOG_BLE=4
+// A call above its module's level is a constant-false branch: it is
+// compiled (format checked) and then removed, arguments included.
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef OPENVIBE_LOG_LEVEL
+#define OPENVIBE_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef OPENVIBE_LOG_SYS          // DeviceContext, link up / down
+#define OPENVIBE_LOG_SYS   OPENVIBE_LOG_LEVEL
+#endif
+#ifndef OPENVIBE_LOG_BLE
+#define OPENVIBE_LOG_BLE   OPENVIBE_LOG_LEVEL
+#endif
+#ifndef OPENVIBE_LOG_WIFI         // station, WS server / client, REST
+#define OPENVIBE_LOG_WIFI  OPENVIBE_LOG_LEVEL
+#endif
+#ifndef OPENVIBE_LOG_CMD          // CommandProcessor, serial console
+#define OPENVIBE_LOG_CMD   OPENVIBE_LOG_LEVEL
+#endif
+#ifndef OPENVIBE_LOG_TLM          // every status sent (debug), offline events
+#define OPENVIBE_LOG_TLM   OPENVIBE_LOG_LEVEL
+#endif
+#ifndef OPENVIBE_LOG_POWER        // power profiles, battery
+#define OPENVIBE_LOG_POWER OPENVIBE_LOG_LEVEL
+#endif
+#ifndef OPENVIBE_LOG_TRACE
+#define OPENVIBE_LOG_TRACE OPENVIBE_LOG_LEVEL
+#endif
+#ifndef OPENVIBE_LOG_OTA
+#define OPENVIBE_LOG_OTA   OPENVIBE_LOG_LEVEL
+#endif
+#ifndef OPENVIBE_LOG_MOTOR
+#define OPENVIBE_LOG_MOTOR OPENVIBE_LOG_LEVEL
+#endif
+
+// RAM ring for formatted lines (power of two).
+#ifndef OPENVIBE_LOG_BYTES
+#define OPENVIBE_LOG_BYTES 4096
+#endif
+
+#define OPENVIBE_LOG(mod, lvl, ...)                                              \
+    do {                                                                         \
+        if (OPENVIBE_LOG_##mod >= (lvl)) Logger::getInstance().write(__VA_ARGS__); \
+    } while (0)
+
+#define LOG_E(mod, ...) OPENVIBE_LOG(mod, LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_W(mod, ...) OPENVIBE_LOG(mod, LOG_LEVEL_WARN,  __VA_ARGS__)
+#define LOG_I(mod, ...) OPENVIBE_LOG(mod, LOG_LEVEL_INFO,  __VA_ARGS__)
+#define LOG_D(mod, ...) OPENVIBE_LOG(mod, LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+/**
+ * Asynchronous serial log.
+ *
+ * write() formats the line on the caller's stack and appends it to a
+ * RAM ring; a background task (hal::Task) drains the ring to Serial.
+ * Callers — the loop, the BLE task, timer callbacks — never wait for
+ * the UART and never take a lock: space is claimed with a CAS on the
+ * head, the line copied in, and the record published with a release
+ * store of its header.  When the ring is full the line is dropped and
+ * counted; the drain reports the count inline ("[Log] N lines dropped").
+ *
+ * Lines are delivered in the order their space was claimed.  Protocol
+ * output that must not be dropped (console acks, trace dumps) still
+ * goes to Serial directly.
+ */
+class Logger {
+public:
+    static constexpr size_t CAPACITY = OPENVIBE_LOG_BYTES;
+    static constexpr size_t MAX_LINE = 192;   // longer lines are cut
+
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "OPENVIBE_LOG_BYTES must be a power of two");
+
+    static Logger& getInstance();
+
+    void begin();   // start the drain task (lines written before are kept)
+    void write(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    void flush();   // drain synchronously, e.g. before a restart
+
+    uint32_t linesWritten() const { return written.load(std::memory_order_relaxed); }
+    uint32_t linesDropped() const { return dropped.load(std::memory_order_relaxed); }
+    uint32_t highWater() const    { return peak.load(std::memory_order_relaxed); }   // bytes
+
+private:
+    Logger();
+    Logger(const Logger&)            = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Record header (one 32-bit word, 4-byte aligned), text follows:
+    //   bits 0-1 state, 2-15 text length, 16-31 record size
+    static constexpr uint32_t REC_EMPTY = 0;   // claimed, not yet published
+    static constexpr uint32_t REC_LINE  = 1;
+    static constexpr uint32_t REC_PAD   = 2;   // filler up to the end of the ring
+
+    alignas(4) uint8_t    ring[CAPACITY];
+    std::atomic<uint32_t> head;      // producers: next byte to claim (monotonic)
+    std::atomic<uint32_t> tail;      // drain: next byte to read (monotonic)
+    std::atomic<uint32_t> written;
+    std::atomic<uint32_t> dropped;
+    std::atomic<uint32_t> peak;
+    uint32_t              reportedDrops;
+    hal::Mutex            drainLock;   // drain task vs flush(); producers never take it
+    hal::Task             task;
+
+    void        publish(uint32_t at, uint32_t header);
+    void        drain();
+    static void drainTask(void* arg);
+};
+
+#endif // LOGGER_H
@@ -0,0 +1,131 @@
+#include "MotorBank.h"
+#include "../log/Logger.h"
+
+static_assert(MotorBank::pinCount(OPENVIBE_MOTOR_PINS) <= MAX_MOTOR_CHANNELS,
+              "OPENVIBE_MOTOR_PINS lists more than MAX_MOTOR_CHANNELS pins");
+
+// Indexed by MotorPattern.
+static const char* const PATTERN_NAMES[PATTERN_COUNT] = { "constant", "pulse", "wave", "ramp" };
+
+MotorBank::MotorBank()
+    : channels(0)
+    , maxDuty(0)
+{
+    for (uint8_t i = 0; i < MAX_MOTOR_CHANNELS; ++i) {
+        pattern[i]  = PATTERN_CONSTANT;
+        periodMs[i] = DEFAULT_PERIOD_MS;
+        startMs[i]  = 0;
+        lastDuty[i] = -1;
+    }
+}
+
+// ── Lifecycle ────────────────────────────────────────────────────────
+
+uint8_t MotorBank::begin(const Config& c) {
+    cfg      = c;
+    channels = 0;
+    maxDuty  = (1u << cfg.pwmBits) - 1;
+
+    // Channel i is LEDC channel i: contiguous, so the first pin that
+    // cannot be set up ends the bank.
+    uint8_t n = cfg.count < MAX_MOTOR_CHANNELS ? cfg.count : MAX_MOTOR_CHANNELS;
+    String  pins;
+    for (uint8_t i = 0; i < n; ++i) {
+        if (!hal::pwmAttach(i, cfg.pins[i], cfg.pwmHz, cfg.pwmBits)) {
+            LOG_E(MOTOR, "[Motor] PWM on GPIO %d refused\n", cfg.pins[i]);
+            break;
+        }
+        hal::pwmWrite(i, 0);
+        lastDuty[i] = 0;
+        if (i) pins += ",";
+        pins += String(cfg.pins[i]);
+        ++channels;
+    }
+
+    LOG_I(MOTOR, "[Motor] %u channel(s) on GPIO %s, %u Hz / %u bit\n",
+                 (unsigned)channels, pins.c_str(), (unsigned)cfg.pwmHz, (unsigned)cfg.pwmBits);
+    return channels;
+}
+
+// ── Patterns ─────────────────────────────────────────────────────────
+
+bool MotorBank::setPattern(int channel, MotorPattern p, uint32_t period) {
+    if (p >= PATTERN_COUNT || channel >= (int)channels || channel < -1) return false;
+    if (p != PATTERN_CONSTANT && (period < MIN_PERIOD_MS || period > MAX_PERIOD_MS)) return false;
+
+    uint32_t now   = hal::millis();
+    uint8_t  first = channel < 0 ? 0 : channel;
+    uint8_t  last  = channel < 0 ? channels : channel + 1;
+    for (uint8_t i = first; i < last; ++i) {
+        pattern[i]  = p;
+        periodMs[i] = period;
+        startMs[i]  = now;
+    }
+    return true;
+}
+
+MotorPattern MotorBank::getPattern(uint8_t channel) const {
+    return channel < channels ? pattern[channel] : PATTERN_CONSTANT;
+}
+
+// ── Output ───────────────────────────────────────────────────────────
+
+uint32_t MotorBank::dutyOf(uint8_t ch, uint8_t level, uint32_t now) const {
+    uint32_t full = (uint32_t)level * maxDuty / 100;
+    if (pattern[ch] == PATTERN_CONSTANT || !full) return full;
+
+    uint32_t period = periodMs[ch];
+    uint32_t phase  = (now - startMs[ch]) % period;
+    switch (pattern[ch]) {
+        case PATTERN_PULSE: return phase < period / 2 ? full : 0;
+        case PATTERN_RAMP:  return (uint64_t)full * phase / period;
+        case PATTERN_WAVE: {
+            uint32_t half = period / 2;
+            uint32_t pos  = phase < half ? phase : period - phase;
+            return (uint64_t)full * pos / half;
+        }
+        default: return full;
+    }
+}
+
+void MotorBank::update(const uint8_t levels[MAX_MOTOR_CHANNELS], uint32_t now) {
+    for (uint8_t i = 0; i < channels; ++i) {
+        int32_t duty = (int32_t)dutyOf(i, levels[i], now);
+        if (duty == lastDuty[i]) continue;
+        lastDuty[i] = duty;
+        hal::pwmWrite(i, (uint32_t)duty);
+    }
+}
+
+uint32_t MotorBank::msUntilNextWork(const uint8_t levels[MAX_MOTOR_CHANNELS], uint32_t now) const {
+    uint32_t wait = UINT32_MAX;
+    for (uint8_t i = 0; i < channels; ++i) {
+        if (pattern[i] == PATTERN_CONSTANT || !levels[i]) continue;
+
+        uint32_t next = PATTERN_STEP_MS;
+        if (pattern[i] == PATTERN_PULSE) {
+            uint32_t half  = periodMs[i] / 2;
+            uint32_t phase = (now - startMs[i]) % periodMs[i];
+            next = phase < half ? half - phase : periodMs[i] - phase;
+        }
+        if (next < wait) wait = next;
+    }
+    return wait;
+}
+
+// ── Names ────────────────────────────────────────────────────────────
+
+const char* MotorBank::patternName(MotorPattern p) {
+    return p < PATTERN_COUNT ? PATTERN_NAMES[p] : "unknown";
+}
+
+bool MotorBank::parsePattern(const char* name, MotorPattern& out) {
+    if (!name) return false;
+    for (uint8_t i = 0; i < PATTERN_COUNT; ++i) {
+        if (strcmp(name, PATTERN_NAMES[i]) == 0) {
+            out = (MotorPattern)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,87 @@
+#ifndef MOTOR_BANK_H
+#define MOTOR_BANK_H
+
+#include <Arduino.h>
+#include "../../include/types/device_stats.h"   // MAX_MOTOR_CHANNELS
+#include "../hal/Hal.h"
+
+// Board wiring — override per board with build_flags in platformio.ini,
+// e.g. -DOPENVIBE_MOTOR_PINS=4,16,17,18 for four actuators.
+#ifndef OPENVIBE_MOTOR_PINS
+#define OPENVIBE_MOTOR_PINS     4      // one GPIO per channel, comma separated
+#endif
+#ifndef OPENVIBE_MOTOR_PWM_HZ
+#define OPENVIBE_MOTOR_PWM_HZ   1000
+#endif
+#ifndef OPENVIBE_MOTOR_PWM_BITS
+#define OPENVIBE_MOTOR_PWM_BITS 8
+#endif
+
+/** Per-channel modulation of the commanded level; values go on the wire. */
+enum MotorPattern : uint8_t {
+    PATTERN_CONSTANT = 0,   // the level itself
+    PATTERN_PULSE    = 1,   // level for the first half of the period, then off
+    PATTERN_WAVE     = 2,   // triangle 0 → level → 0
+    PATTERN_RAMP     = 3,   // sawtooth 0 → level
+    PATTERN_COUNT
+};
+
+/**
+ * Motor outputs: one PWM (LEDC) channel per configured pin.
+ *
+ * Levels (0–100 %) live in DeviceStats::levels, where commands put
+ * them; update() turns them into duty cycles, applying each channel's
+ * pattern, and writes only the channels whose duty changed — setting
+ * every channel is one command and one pass.  Patterns are phase-locked
+ * to when they were set; msUntilNextWork() tells the idle loop when
+ * the next step is due, so nothing polls while all channels are steady.
+ */
+class MotorBank {
+public:
+    template <typename... Pins>
+    static constexpr uint8_t pinCount(Pins...) { return sizeof...(Pins); }
+
+    struct Config {
+        int8_t   pins[MAX_MOTOR_CHANNELS] = { OPENVIBE_MOTOR_PINS };
+        uint8_t  count   = pinCount(OPENVIBE_MOTOR_PINS);
+        uint32_t pwmHz   = OPENVIBE_MOTOR_PWM_HZ;
+        uint8_t  pwmBits = OPENVIBE_MOTOR_PWM_BITS;   // duty resolution
+    };
+
+    static constexpr uint32_t PATTERN_STEP_MS   = 20;     // wave / ramp refresh
+    static constexpr uint32_t MIN_PERIOD_MS     = 100;
+    static constexpr uint32_t MAX_PERIOD_MS     = 60000;
+    static constexpr uint32_t DEFAULT_PERIOD_MS = 1000;
+
+    MotorBank();
+
+    // Attaches LEDC channel i to cfg.pins[i]; returns the channels
+    // actually available (0 if none could be set up).
+    uint8_t begin(const Config& cfg);
+    uint8_t count() const { return channels; }
+
+    // `channel` -1 = every channel.  False if the channel or period is
+    // out of range.
+    bool         setPattern(int channel, MotorPattern pattern, uint32_t periodMs);
+    MotorPattern getPattern(uint8_t channel) const;
+
+    void     update(const uint8_t levels[MAX_MOTOR_CHANNELS], uint32_t now);
+    uint32_t msUntilNextWork(const uint8_t levels[MAX_MOTOR_CHANNELS], uint32_t now) const;
+
+    static const char* patternName(MotorPattern p);
+    static bool        parsePattern(const char* name, MotorPattern& out);
+
+private:
+    Config   cfg;
+    uint8_t  channels;
+    uint32_t maxDuty;
+
+    MotorPattern pattern[MAX_MOTOR_CHANNELS];
+    uint32_t     periodMs[MAX_MOTOR_CHANNELS];
+    uint32_t     startMs[MAX_MOTOR_CHANNELS];
+    int32_t      lastDuty[MAX_MOTOR_CHANNELS];   // -1 = never written
+
+    uint32_t dutyOf(uint8_t ch, uint8_t level, uint32_t now) const;
+};
+
+#endif // MOTOR_BANK_H
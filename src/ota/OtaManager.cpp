@@ -0,0 +1,364 @@
+#include "OtaManager.h"
+#include "../ConfigManager.h"
+#include "../DeviceContext.h"
+#include "../wifi/WiFiManager.h"
+#include "../log/Logger.h"
+
+OtaManager& OtaManager::getInstance() {
+    static OtaManager inst;
+    return inst;
+}
+
+OtaManager::OtaManager()
+    : state(OTA_IDLE)
+    , lastStatus(OTA_OK)
+    , imageSize(0)
+    , expected{}
+    , written(0)
+    , erasedTo(0)
+    , checkpointed(0)
+    , sessionStart(0)
+    , firstChunkUs(0)
+    , lastChunkUs(0)
+    , heapBase(0)
+    , heapPeak(0)
+    , chunks(0)
+    , restartAtMs(0)
+    , trialStartMs(0) {}
+
+// ── Lifecycle ────────────────────────────────────────────────────────
+
+void OtaManager::bootCheck() {
+    ConfigManager& cfg   = ConfigManager::getInstance();
+    int            trial = cfg.getOtaTrial();
+    if (trial < 0) return;
+
+    if (trial > 0) {
+        LOG_W(OTA, "[OTA] Image on %s restarted before passing its health check\n",
+                   hal::otaRunningSlot().c_str());
+        rollback();
+        return;
+    }
+
+    cfg.setOtaTrial(1);
+    state        = OTA_TRIAL;
+    trialStartMs = hal::millis();
+    LOG_I(OTA, "[OTA] Trial boot of %s: health check in %u s\n",
+               hal::otaRunningSlot().c_str(), (unsigned)(OPENVIBE_OTA_HEALTH_MS / 1000));
+}
+
+void OtaManager::loop() {
+    uint32_t now = hal::millis();
+
+    if (state == OTA_REBOOTING && (int32_t)(now - restartAtMs) >= 0) {
+        LOG_I(OTA, "[OTA] Restarting into the new image\n");
+        Logger::getInstance().flush();
+        hal::restart();
+    }
+
+    if (state == OTA_TRIAL) {
+        uint32_t up = now - trialStartMs;
+        if (up >= OPENVIBE_OTA_HEALTH_MS && healthy()) {
+            hal::otaConfirm();
+            ConfigManager::getInstance().clearOtaTrial();
+            state = OTA_IDLE;
+            LOG_I(OTA, "[OTA] Image on %s confirmed\n", hal::otaRunningSlot().c_str());
+        } else if (up >= OPENVIBE_OTA_HEALTH_TIMEOUT_MS) {
+            LOG_W(OTA, "[OTA] Image on %s not healthy after %u s\n",
+                       hal::otaRunningSlot().c_str(), (unsigned)(up / 1000));
+            rollback();
+        }
+    }
+}
+
+uint32_t OtaManager::msUntilNextWork(uint32_t now) const {
+    if (state == OTA_REBOOTING) {
+        int32_t left = (int32_t)(restartAtMs - now);
+        return left > 0 ? (uint32_t)left : 0;
+    }
+    if (state == OTA_TRIAL) {
+        // Wait out the minimum uptime, then poll: link state has no
+        // deadline of its own.
+        uint32_t up = now - trialStartMs;
+        return up < OPENVIBE_OTA_HEALTH_MS ? OPENVIBE_OTA_HEALTH_MS - up : 1000;
+    }
+    return UINT32_MAX;
+}
+
+// Alive and reachable the way it is configured to be reachable.
+bool OtaManager::healthy() const {
+#if OPENVIBE_WITH_WIFI
+    ConfigManager& cfg = ConfigManager::getInstance();
+    DeviceContext& ctx = DeviceContext::getInstance();
+    WiFiManager*   wifi = ctx.getWiFiManager();
+
+    if (cfg.hasWiFiCredentials() && !ctx.getStats().isWifiConnected) return false;
+    if (ctx.getTransport() == TRANSPORT_REMOTE && !cfg.getRemoteServer().isEmpty()
+        && !(wifi && wifi->isRemoteConnected())) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+void OtaManager::rollback() {
+    ConfigManager::getInstance().clearOtaTrial();
+    state = OTA_IDLE;
+    if (hal::otaRevert()) {
+        LOG_I(OTA, "[OTA] Rolling back to the previous image\n");
+        Logger::getInstance().flush();
+        hal::restart();
+    }
+    LOG_W(OTA, "[OTA] No previous image to roll back to — keeping this one\n");
+    hal::otaConfirm();
+}
+
+// ── Transfer ─────────────────────────────────────────────────────────
+
+OtaStatus OtaManager::begin(uint32_t size, const uint8_t sha256[hal::Sha256::DIGEST_LEN],
+                            const uint8_t sig[hal::Sha256::DIGEST_LEN], uint32_t& resumeAt) {
+    resumeAt = 0;
+    if (!authorized(size, sha256, sig))            return fail(OTA_ERR_AUTH);
+    if (!hal::otaSlotSize())                       return fail(OTA_ERR_UNSUPPORTED);
+    if (state == OTA_REBOOTING || state == OTA_TRIAL) return fail(OTA_ERR_STATE);
+    if (size == 0 || size > hal::otaSlotSize())    return fail(OTA_ERR_SIZE);
+
+    bool same = size == imageSize && !memcmp(sha256, expected, sizeof(expected));
+    if (state == OTA_RECEIVING) {
+        if (!same) return fail(OTA_ERR_BUSY);
+        // Same image, new connection: carry on from RAM.
+        resumeAt   = written;
+        lastStatus = OTA_OK;
+        return OTA_OK;
+    }
+
+    ConfigManager& cfg = ConfigManager::getInstance();
+    imageSize = size;
+    memcpy(expected, sha256, sizeof(expected));
+    hash.reset();
+    written = 0;
+
+    // Interrupted by a reboot?  The checkpoint is sector aligned, so
+    // everything past it is simply erased and written again.
+    uint32_t cpSize, cpOffset;
+    uint8_t  cpSha[hal::Sha256::DIGEST_LEN];
+    if (cfg.getOtaProgress(cpSize, cpSha, cpOffset) && cpSize == size
+        && !memcmp(cpSha, sha256, sizeof(cpSha)) && cpOffset < size) {
+        if (rehash(cpOffset)) {
+            written = cpOffset;
+        } else {
+            hash.reset();
+        }
+    }
+
+    erasedTo     = written;
+    checkpointed = written;
+    cfg.setOtaProgress(imageSize, expected, written);
+
+    sessionStart = written;
+    heapBase     = hal::heapUsed();
+    heapPeak     = heapBase;
+    chunks       = 0;
+    state        = OTA_RECEIVING;
+    lastStatus   = OTA_OK;
+    resumeAt     = written;
+
+    LOG_I(OTA, "[OTA] Receiving %u bytes into the inactive slot (running %s), from %u\n",
+               (unsigned)size, hal::otaRunningSlot().c_str(), (unsigned)written);
+    return OTA_OK;
+}
+
+OtaStatus OtaManager::write(uint32_t offset, const uint8_t* data, size_t len) {
+    if (state != OTA_RECEIVING)     return fail(OTA_ERR_STATE);
+    if (offset != written)          return fail(OTA_ERR_OFFSET);
+    if (len > imageSize - written)  return fail(OTA_ERR_SIZE);
+    if (!len)                       return OTA_OK;
+
+    while (erasedTo < written + len) {
+        if (!hal::otaErase(erasedTo, hal::OTA_SECTOR)) {
+            discard();
+            return fail(OTA_ERR_FLASH);
+        }
+        erasedTo += hal::OTA_SECTOR;
+    }
+    if (!hal::otaWrite(offset, data, len)) {
+        discard();
+        return fail(OTA_ERR_FLASH);
+    }
+    hash.update(data, len);
+
+    uint32_t nowUs = hal::micros();
+    if (!chunks) firstChunkUs = nowUs;
+    lastChunkUs = nowUs;
+    ++chunks;
+    written += len;
+
+    uint32_t heap = hal::heapUsed();
+    if (heap > heapPeak) heapPeak = heap;
+
+    if (written - checkpointed >= CHECKPOINT_BYTES) {
+        checkpointed = written - written % CHECKPOINT_BYTES;
+        ConfigManager::getInstance().setOtaProgress(imageSize, expected, checkpointed);
+    }
+    lastStatus = OTA_OK;
+    return OTA_OK;
+}
+
+OtaStatus OtaManager::finish() {
+    if (state != OTA_RECEIVING) return fail(OTA_ERR_STATE);
+    if (written != imageSize)   return fail(OTA_ERR_SIZE);
+
+    uint8_t digest[hal::Sha256::DIGEST_LEN];
+    hash.finish(digest);
+    if (memcmp(digest, expected, sizeof(digest))) {
+        LOG_W(OTA, "[OTA] SHA-256 mismatch — image discarded\n");
+        discard();
+        return fail(OTA_ERR_HASH);
+    }
+    if (!hal::otaActivate()) {
+        LOG_E(OTA, "[OTA] Image rejected — not activated\n");
+        discard();
+        return fail(OTA_ERR_IMAGE);
+    }
+
+    ConfigManager& cfg = ConfigManager::getInstance();
+    cfg.clearOtaProgress();
+    cfg.setOtaTrial(0);
+    state       = OTA_REBOOTING;
+    restartAtMs = hal::millis() + RESTART_DELAY_MS;
+    lastStatus  = OTA_OK;
+
+    LOG_I(OTA, "[OTA] Image verified: %u bytes at %u KB/s, peak RAM +%u bytes\n",
+               (unsigned)imageSize, (unsigned)(bytesPerSec() / 1024), (unsigned)peakRamBytes());
+    return OTA_OK;
+}
+
+void OtaManager::abort() {
+    if (state != OTA_RECEIVING) return;
+    LOG_I(OTA, "[OTA] Aborted at %u / %u\n", (unsigned)written, (unsigned)imageSize);
+    discard();
+}
+
+size_t OtaManager::handleChunkFrame(const uint8_t* data, size_t len, uint8_t reply[CHUNK_REPLY]) {
+    uint32_t offset = ((uint32_t)data[1] << 24) | ((uint32_t)data[2] << 16)
+                    | ((uint32_t)data[3] << 8)  |  (uint32_t)data[4];
+    OtaStatus st = write(offset, data + CHUNK_HEADER, len - CHUNK_HEADER);
+
+    reply[0] = CHUNK_MAGIC;
+    reply[1] = st;
+    reply[2] = (uint8_t)(written >> 24);
+    reply[3] = (uint8_t)(written >> 16);
+    reply[4] = (uint8_t)(written >> 8);
+    reply[5] = (uint8_t)written;
+    return CHUNK_REPLY;
+}
+
+// ── Key ──────────────────────────────────────────────────────────────
+
+void OtaManager::setKey(const uint8_t key[hal::Sha256::DIGEST_LEN]) {
+    ConfigManager::getInstance().setOtaKey(key);
+    LOG_I(OTA, "[OTA] Key provisioned\n");
+}
+
+bool OtaManager::hasKey() {
+    uint8_t key[hal::Sha256::DIGEST_LEN];
+    return ConfigManager::getInstance().getOtaKey(key);
+}
+
+// HMAC-SHA256(key, sha256 || u32 BE size) == sig, compared in constant time.
+bool OtaManager::authorized(uint32_t size, const uint8_t sha256[hal::Sha256::DIGEST_LEN],
+                            const uint8_t sig[hal::Sha256::DIGEST_LEN]) {
+    constexpr size_t BLOCK = 64;
+    uint8_t key[hal::Sha256::DIGEST_LEN];
+    if (!ConfigManager::getInstance().getOtaKey(key)) {
+        LOG_W(OTA, "[OTA] Refused: no OTA key provisioned\n");
+        return false;
+    }
+
+    uint8_t pad[BLOCK];
+    uint8_t mac[hal::Sha256::DIGEST_LEN];
+    uint8_t sizeBE[4] = { (uint8_t)(size >> 24), (uint8_t)(size >> 16), (uint8_t)(size >> 8), (uint8_t)size };
+    hal::Sha256 h;
+
+    memset(pad, 0x36, sizeof(pad));
+    for (size_t i = 0; i < sizeof(key); ++i) pad[i] ^= key[i];
+    h.reset();
+    h.update(pad, sizeof(pad));
+    h.update(sha256, hal::Sha256::DIGEST_LEN);
+    h.update(sizeBE, sizeof(sizeBE));
+    h.finish(mac);
+
+    memset(pad, 0x5c, sizeof(pad));
+    for (size_t i = 0; i < sizeof(key); ++i) pad[i] ^= key[i];
+    h.reset();
+    h.update(pad, sizeof(pad));
+    h.update(mac, sizeof(mac));
+    h.finish(mac);
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < sizeof(mac); ++i) diff |= mac[i] ^ sig[i];
+    if (diff) LOG_W(OTA, "[OTA] Refused: bad signature\n");
+    return diff == 0;
+}
+
+// ── Helpers ──────────────────────────────────────────────────────────
+
+OtaStatus OtaManager::fail(OtaStatus status) {
+    lastStatus = status;
+    return status;
+}
+
+void OtaManager::discard() {
+    ConfigManager::getInstance().clearOtaProgress();
+    state     = OTA_IDLE;
+    imageSize = 0;
+    written   = 0;
+    memset(expected, 0, sizeof(expected));
+}
+
+bool OtaManager::rehash(uint32_t upTo) {
+    uint8_t buf[512];
+    for (uint32_t pos = 0; pos < upTo; pos += sizeof(buf)) {
+        size_t n = upTo - pos < sizeof(buf) ? upTo - pos : sizeof(buf);
+        if (!hal::otaRead(pos, buf, n)) return false;
+        hash.update(buf, n);
+    }
+    return true;
+}
+
+uint32_t OtaManager::bytesPerSec() const {
+    uint32_t spanUs = lastChunkUs - firstChunkUs;
+    if (chunks < 2 || !spanUs) return 0;
+    return (uint32_t)((uint64_t)(written - sessionStart) * 1000000 / spanUs);
+}
+
+const char* OtaManager::stateName(OtaState s) {
+    switch (s) {
+        case OTA_IDLE:      return "idle";
+        case OTA_RECEIVING: return "receiving";
+        case OTA_REBOOTING: return "rebooting";
+        case OTA_TRIAL:     return "trial";
+    }
+    return "unknown";
+}
+
+const char* OtaManager::statusName(OtaStatus s) {
+    static const char* const NAMES[] = {
+        "ok", "unsupported", "busy", "state", "size", "offset", "flash", "hash", "image", "auth"
+    };
+    return s < sizeof(NAMES) / sizeof(NAMES[0]) ? NAMES[s] : "unknown";
+}
+
+bool OtaManager::parseDigest(const char* hex, uint8_t out[hal::Sha256::DIGEST_LEN]) {
+    if (!hex || strlen(hex) != hal::Sha256::DIGEST_LEN * 2) return false;
+    for (size_t i = 0; i < hal::Sha256::DIGEST_LEN * 2; ++i) {
+        char    c = hex[i];
+        uint8_t v;
+        if      (c >= '0' && c <= '9') v = c - '0';
+        else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+        else return false;
+        out[i / 2] = (i & 1) ? (out[i / 2] | v) : (uint8_t)(v << 4);
+    }
+    return true;
+}
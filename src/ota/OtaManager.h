@@ -0,0 +1,150 @@
+#ifndef OTA_MANAGER_H
+#define OTA_MANAGER_H
+
+#include <Arduino.h>
+#include "../hal/Hal.h"
+
+// Boot-trial health check: a new image must be up this long (and have
+// its links back, see healthy()) to be kept, and is rolled back if it
+// is not healthy by the timeout or restarts before then.
+#ifndef OPENVIBE_OTA_HEALTH_MS
+#define OPENVIBE_OTA_HEALTH_MS         15000
+#endif
+#ifndef OPENVIBE_OTA_HEALTH_TIMEOUT_MS
+#define OPENVIBE_OTA_HEALTH_TIMEOUT_MS 90000
+#endif
+
+/** Result of an OTA step; numeric values go on the wire. */
+enum OtaStatus : uint8_t {
+    OTA_OK              = 0,
+    OTA_ERR_UNSUPPORTED = 1,   // no OTA slot in the partition table
+    OTA_ERR_BUSY        = 2,   // another image is being received
+    OTA_ERR_STATE       = 3,   // no transfer in progress / restart pending
+    OTA_ERR_SIZE        = 4,   // image too large, or finish before the end
+    OTA_ERR_OFFSET      = 5,   // chunk not at the expected offset
+    OTA_ERR_FLASH       = 6,   // erase / write / read failed
+    OTA_ERR_HASH        = 7,   // SHA-256 mismatch — image discarded
+    OTA_ERR_IMAGE       = 8,   // image rejected by the bootloader check
+    OTA_ERR_AUTH        = 9    // no OTA key provisioned, or a bad signature
+};
+
+enum OtaState : uint8_t {
+    OTA_IDLE      = 0,
+    OTA_RECEIVING = 1,
+    OTA_REBOOTING = 2,   // image activated, restart pending
+    OTA_TRIAL     = 3    // running a new image that is not confirmed yet
+};
+
+/**
+ * Streams a firmware image into the inactive app slot.
+ *
+ * Chunks go straight to flash — erased a sector ahead, SHA-256 updated
+ * on the fly — so RAM use is one transport buffer, not the image.  The
+ * transfer is strictly sequential: a chunk at any offset other than
+ * getOffset() is refused with OTA_ERR_OFFSET and the expected offset,
+ * which is how clients resume after a dropped connection.  Progress is
+ * checkpointed to NVS every CHECKPOINT_BYTES, so a transfer also
+ * survives a reboot (the already-written part is re-hashed from flash).
+ *
+ * finish() checks the digest, activates the slot and restarts.  The
+ * new image boots in OTA_TRIAL: if it is not healthy within the timeout,
+ * or restarts before it gets there, the previous slot is booted again.
+ *
+ * Transports: OTA command (begin / finish / abort / status) plus WS
+ * binary chunk frames, or POST /ota with the image (or its tail) as
+ * the body.
+ *
+ * begin() needs the image signed: HMAC-SHA256, keyed with the OTA key
+ * (provisioned over serial only, stored in NVS), of the digest and the
+ * big-endian u32 size.  Without a key nothing can be updated.  Chunks
+ * only extend a session begun that way, and finish() accepts nothing
+ * but the signed digest, so an unsigned chunk can spoil a transfer but
+ * never boot.
+ */
+class OtaManager {
+public:
+    // WS chunk frame: [CHUNK_MAGIC][u32 BE offset][data...]
+    // reply:          [CHUNK_MAGIC][OtaStatus][u32 BE next offset]
+    // 0xC1 is the one byte MessagePack never uses.
+    static constexpr uint8_t  CHUNK_MAGIC      = 0xC1;
+    static constexpr size_t   CHUNK_HEADER     = 5;
+    static constexpr size_t   CHUNK_REPLY      = 6;
+    static constexpr uint32_t CHECKPOINT_BYTES = 64 * 1024;   // multiple of hal::OTA_SECTOR
+    static constexpr uint32_t RESTART_DELAY_MS = 1000;        // let the finish reply go out
+
+    static OtaManager& getInstance();
+
+    // ── Lifecycle (DeviceContext) ────────────────────────────────────
+    void     bootCheck();   // early in setup(): trial bookkeeping / rollback
+    void     loop();
+    uint32_t msUntilNextWork(uint32_t now) const;
+
+    // ── Transfer ─────────────────────────────────────────────────────
+    // `resumeAt` is where the sender should continue (0 for a new image).
+    OtaStatus begin(uint32_t size, const uint8_t sha256[hal::Sha256::DIGEST_LEN],
+                    const uint8_t sig[hal::Sha256::DIGEST_LEN], uint32_t& resumeAt);
+    OtaStatus write(uint32_t offset, const uint8_t* data, size_t len);
+    OtaStatus finish();
+    void      abort();
+
+    static bool isChunkFrame(const uint8_t* data, size_t len) {
+        return len >= CHUNK_HEADER && data[0] == CHUNK_MAGIC;
+    }
+    // Applies a WS chunk frame and fills the reply; returns its length.
+    size_t handleChunkFrame(const uint8_t* data, size_t len, uint8_t reply[CHUNK_REPLY]);
+
+    // ── Status ───────────────────────────────────────────────────────
+    OtaState  getState() const      { return state; }
+    OtaStatus lastError() const     { return lastStatus; }
+    uint32_t  getSize() const       { return imageSize; }
+    uint32_t  getOffset() const     { return written; }
+    uint32_t  bytesPerSec() const;  // this session, first to last chunk
+    uint32_t  peakRamBytes() const  { return heapPeak - heapBase; }
+    uint32_t  chunkCount() const    { return chunks; }
+
+    static const char* stateName(OtaState s);
+    static const char* statusName(OtaStatus s);
+
+    // 64 hex digits → digest (also a signature or the key).
+    static bool parseDigest(const char* hex, uint8_t out[hal::Sha256::DIGEST_LEN]);
+
+    // ── Key (SOURCE_SERIAL only, see CommandProcessor::handleOta) ────
+    static void setKey(const uint8_t key[hal::Sha256::DIGEST_LEN]);
+    static bool hasKey();
+
+private:
+    OtaManager();
+    OtaManager(const OtaManager&)            = delete;
+    OtaManager& operator=(const OtaManager&) = delete;
+
+    OtaState    state;
+    OtaStatus   lastStatus;
+    uint32_t    imageSize;
+    uint8_t     expected[hal::Sha256::DIGEST_LEN];
+    hal::Sha256 hash;
+    uint32_t    written;
+    uint32_t    erasedTo;       // flash [written, erasedTo) is blank
+    uint32_t    checkpointed;
+
+    // Session statistics
+    uint32_t sessionStart;      // offset the session began at
+    uint32_t firstChunkUs;
+    uint32_t lastChunkUs;
+    uint32_t heapBase;
+    uint32_t heapPeak;
+    uint32_t chunks;
+
+    uint32_t restartAtMs;       // OTA_REBOOTING
+    uint32_t trialStartMs;      // OTA_TRIAL
+
+    static bool authorized(uint32_t size, const uint8_t sha256[hal::Sha256::DIGEST_LEN],
+                           const uint8_t sig[hal::Sha256::DIGEST_LEN]);
+
+    OtaStatus fail(OtaStatus status);   // records the error; keeps the session
+    void      discard();                // drops the session and its checkpoint
+    bool      rehash(uint32_t upTo);
+    bool      healthy() const;
+    void      rollback();
+};
+
+#endif // OTA_MANAGER_H
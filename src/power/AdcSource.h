@@ -0,0 +1,20 @@
+#ifndef ADC_SOURCE_H
+#define ADC_SOURCE_H
+
+#include <stdint.h>
+
+/**
+ * One ADC input, already converted to calibrated millivolts at the pin.
+ *
+ * BatteryMonitor only talks to this interface so a host build can feed
+ * synthetic waveforms (steps, ramps, noise) instead of real hardware.
+ */
+class AdcSource {
+public:
+    virtual ~AdcSource() = default;
+
+    virtual bool     begin() = 0;
+    virtual uint32_t readMilliVolts() = 0;
+};
+
+#endif // ADC_SOURCE_H
@@ -0,0 +1,161 @@
+#include "BLELinkPolicy.h"
+#include "../log/Logger.h"
+
+static_assert(OPENVIBE_BLE_ACTIVE_COMMANDS >= 1, "BLE: at least one command to speed up");
+
+// Supervision timeouts: above 3 × interval × (latency + 1), 2–6 s.
+const BLELinkPolicy::Params BLELinkPolicy::PARAMS[BLE_LINK_STATE_COUNT] = {
+    { OPENVIBE_BLE_IDLE_INTERVAL_MIN, OPENVIBE_BLE_IDLE_INTERVAL_MAX, OPENVIBE_BLE_IDLE_LATENCY, 400 },
+    { OPENVIBE_BLE_ACTIVE_INTERVAL,   OPENVIBE_BLE_ACTIVE_INTERVAL,   0,                         200 },
+};
+
+static const char* const STATE_NAMES[BLE_LINK_STATE_COUNT] = { "idle", "active" };
+
+BLELinkPolicy::BLELinkPolicy()
+    : up(false)
+    , current(BLE_LINK_IDLE)
+    , wantRequest(false)
+    , awaiting(false)
+    , lastRequestMs(0)
+    , lastCommandMs(0)
+    , recent{}
+    , recentCount(0)
+    , recentHead(0)
+    , requestCount(0)
+    , updateCount(0)
+    , segmentMs(0) {}
+
+const char* BLELinkPolicy::stateName(BLELinkState s) {
+    return s < BLE_LINK_STATE_COUNT ? STATE_NAMES[s] : "?";
+}
+
+// ── Events ───────────────────────────────────────────────────────────
+
+void BLELinkPolicy::connected(uint32_t now) {
+    up            = true;
+    awaiting      = false;
+    params        = Granted();
+    recentCount   = 0;
+    lastCommandMs = now;
+    lastRequestMs = now;   // let the central settle first
+    segmentMs     = now;
+    enter(BLE_LINK_ACTIVE, now);
+}
+
+void BLELinkPolicy::disconnected(uint32_t now) {
+    if (!up) return;
+    roll(now);
+    up          = false;
+    wantRequest = false;
+    awaiting    = false;
+}
+
+void BLELinkPolicy::command(uint32_t now) {
+    if (!up) return;
+    ++totals[current].commands;
+    lastCommandMs = now;
+
+    recent[recentHead] = now;
+    recentHead = (recentHead + 1) % OPENVIBE_BLE_ACTIVE_COMMANDS;
+    if (recentCount < OPENVIBE_BLE_ACTIVE_COMMANDS) ++recentCount;
+
+    // recentHead is now the oldest of the last ACTIVE_COMMANDS.
+    if (current == BLE_LINK_IDLE && recentCount == OPENVIBE_BLE_ACTIVE_COMMANDS &&
+        now - recent[recentHead] <= OPENVIBE_BLE_ACTIVE_WINDOW_MS) {
+        enter(BLE_LINK_ACTIVE, now);
+    }
+}
+
+void BLELinkPolicy::granted(uint16_t interval, uint16_t latency, uint16_t timeout, uint32_t now) {
+    if (!up) return;
+    roll(now);
+    params.interval = interval;
+    params.latency  = latency;
+    params.timeout  = timeout;
+    ++updateCount;
+
+    LOG_I(BLE, "[BLE] Connection %u.%02u ms, latency %u, timeout %u ms\n",
+               (unsigned)(interval * 125 / 100), (unsigned)(interval * 125 % 100),
+               (unsigned)latency, (unsigned)timeout * 10);
+    if (awaiting) {
+        // Refused or bargained down: keep what we got until the next change.
+        awaiting = false;
+        if (!matches(current)) {
+            LOG_W(BLE, "[BLE] Central did not grant the %s parameters\n", STATE_NAMES[current]);
+        }
+    } else {
+        wantRequest = !matches(current);   // the central's own choice
+    }
+}
+
+bool BLELinkPolicy::due(uint32_t now, Params& out) {
+    if (!up) return false;
+    if (current == BLE_LINK_ACTIVE && now - lastCommandMs >= OPENVIBE_BLE_IDLE_AFTER_MS) {
+        enter(BLE_LINK_IDLE, now);
+    }
+    if (!wantRequest || now - lastRequestMs < REQUEST_GAP_MS) return false;
+
+    wantRequest   = false;
+    awaiting      = true;
+    lastRequestMs = now;
+    ++requestCount;
+    out = PARAMS[current];
+    return true;
+}
+
+uint32_t BLELinkPolicy::msUntilNextWork(uint32_t now) const {
+    if (!up) return UINT32_MAX;
+    uint32_t wait = UINT32_MAX;
+    if (wantRequest) {
+        uint32_t since = now - lastRequestMs;
+        wait = since >= REQUEST_GAP_MS ? 0 : REQUEST_GAP_MS - since;
+    }
+    if (current == BLE_LINK_ACTIVE) {
+        uint32_t since = now - lastCommandMs;
+        uint32_t idle  = since >= OPENVIBE_BLE_IDLE_AFTER_MS ? 0 : OPENVIBE_BLE_IDLE_AFTER_MS - since;
+        if (idle < wait) wait = idle;
+    }
+    return wait;
+}
+
+void BLELinkPolicy::enter(BLELinkState s, uint32_t now) {
+    if (s != current) {
+        roll(now);
+        LOG_I(BLE, "[BLE] Link %s\n", STATE_NAMES[s]);
+        current = s;
+    }
+    // Nothing to ask if the central already runs these.
+    wantRequest = !matches(s);
+}
+
+// ── Statistics ───────────────────────────────────────────────────────
+
+void BLELinkPolicy::roll(uint32_t now) {
+    if (!up) return;
+    uint32_t ms = now - segmentMs;
+    totals[current].ms      += ms;
+    totals[current].wakeups += wakeupsIn(ms);
+    segmentMs = now;
+}
+
+// Events the peripheral must listen to over `ms` with nothing to send:
+// one every interval × (latency + 1).
+uint32_t BLELinkPolicy::wakeupsIn(uint32_t ms) const {
+    if (!params.interval) return 0;
+    return (uint32_t)((uint64_t)ms * 4 / (5u * params.interval * (params.latency + 1u)));
+}
+
+BLELinkPolicy::StateStats BLELinkPolicy::stats(BLELinkState s, uint32_t now) const {
+    StateStats out = totals[s];
+    if (up && s == current) {
+        out.ms      += now - segmentMs;
+        out.wakeups += wakeupsIn(now - segmentMs);
+    }
+    return out;
+}
+
+bool BLELinkPolicy::matches(BLELinkState s) const {
+    const Params& p = PARAMS[s];
+    return params.interval >= p.minInterval && params.interval <= p.maxInterval &&
+           params.latency <= p.latency;
+}
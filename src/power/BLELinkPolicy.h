@@ -0,0 +1,131 @@
+#ifndef BLE_LINK_POLICY_H
+#define BLE_LINK_POLICY_H
+
+#include <Arduino.h>
+
+// Connection parameters asked of the central, in BLE units (interval
+// 1.25 ms, supervision timeout 10 ms).  Both sets keep to Apple's
+// accessory rules, so iOS grants them as well as Android.
+#ifndef OPENVIBE_BLE_ACTIVE_INTERVAL
+#define OPENVIBE_BLE_ACTIVE_INTERVAL     12    // 15 ms
+#endif
+#ifndef OPENVIBE_BLE_IDLE_INTERVAL_MIN
+#define OPENVIBE_BLE_IDLE_INTERVAL_MIN   72    // 90 ms
+#endif
+#ifndef OPENVIBE_BLE_IDLE_INTERVAL_MAX
+#define OPENVIBE_BLE_IDLE_INTERVAL_MAX   96    // 120 ms
+#endif
+#ifndef OPENVIBE_BLE_IDLE_LATENCY
+#define OPENVIBE_BLE_IDLE_LATENCY        4     // wake every 5th event: 600 ms
+#endif
+// Hysteresis: ACTIVE_COMMANDS within ACTIVE_WINDOW_MS to speed up,
+// IDLE_AFTER_MS without any to back off.
+#ifndef OPENVIBE_BLE_ACTIVE_COMMANDS
+#define OPENVIBE_BLE_ACTIVE_COMMANDS     3
+#endif
+#ifndef OPENVIBE_BLE_ACTIVE_WINDOW_MS
+#define OPENVIBE_BLE_ACTIVE_WINDOW_MS    1000
+#endif
+#ifndef OPENVIBE_BLE_IDLE_AFTER_MS
+#define OPENVIBE_BLE_IDLE_AFTER_MS       5000
+#endif
+
+enum BLELinkState : uint8_t {
+    BLE_LINK_IDLE   = 0,
+    BLE_LINK_ACTIVE = 1,
+    BLE_LINK_STATE_COUNT
+};
+
+/**
+ * Picks the BLE connection parameters from what the client is doing.
+ *
+ * A central chooses the interval at connect and keeps it: too slow for
+ * a slider, or awake every 15–30 ms for a phone that only polls.  The
+ * peripheral may ask for something else, so:
+ *
+ *   active   15 ms, no slave latency                ACTIVE_COMMANDS command
+ *                                                   frames within ACTIVE_WINDOW_MS
+ *   idle     90–120 ms, slave latency 4             IDLE_AFTER_MS without one
+ *
+ * A link starts active (setup traffic follows a connect).  Sparse
+ * polls never leave idle; a stream of writes — a slider, or a pattern
+ * the client drives itself — holds active.  Requests go at most every
+ * REQUEST_GAP_MS, only on a change of state, and a central that grants
+ * something else is not asked again until the next change.
+ *
+ * BLEManager feeds it from the loop task and sends the requests.  Per
+ * state it counts time, commands and the connection events the
+ * peripheral has to wake for under the granted parameters — the part
+ * of the radio duty cycle the parameters decide.
+ */
+class BLELinkPolicy {
+public:
+    struct Params {
+        uint16_t minInterval;   // 1.25 ms
+        uint16_t maxInterval;
+        uint16_t latency;       // connection events the peripheral may skip
+        uint16_t timeout;       // 10 ms
+    };
+
+    // What the central last granted.
+    struct Granted {
+        uint16_t interval = 0;   // 1.25 ms; 0 = not known yet
+        uint16_t latency  = 0;
+        uint16_t timeout  = 0;
+    };
+
+    struct StateStats {
+        uint32_t ms       = 0;
+        uint32_t commands = 0;
+        uint32_t wakeups  = 0;   // connection events listened to (estimated)
+    };
+
+    static constexpr uint32_t REQUEST_GAP_MS = 1000;   // also the wait after a connect
+    static const Params PARAMS[BLE_LINK_STATE_COUNT];
+
+    BLELinkPolicy();
+
+    // ── Events (loop task) ───────────────────────────────────────────
+    void connected(uint32_t now);
+    void disconnected(uint32_t now);
+    void command(uint32_t now);
+    void granted(uint16_t interval, uint16_t latency, uint16_t timeout, uint32_t now);
+
+    // True when `out` should be requested of the central now.
+    bool     due(uint32_t now, Params& out);
+    uint32_t msUntilNextWork(uint32_t now) const;
+
+    // ── State ────────────────────────────────────────────────────────
+    bool           isConnected() const { return up; }
+    BLELinkState   state() const       { return current; }
+    const Granted& lastGrant() const   { return params; }
+    uint32_t       requests() const    { return requestCount; }
+    uint32_t       updates() const     { return updateCount; }
+    StateStats     stats(BLELinkState s, uint32_t now) const;   // since boot
+
+    static const char* stateName(BLELinkState s);
+
+private:
+    bool         up;
+    BLELinkState current;
+    Granted      params;
+    bool         wantRequest;
+    bool         awaiting;        // requested, no answer yet
+    uint32_t     lastRequestMs;
+    uint32_t     lastCommandMs;
+    uint32_t     recent[OPENVIBE_BLE_ACTIVE_COMMANDS];   // ring of command times
+    uint8_t      recentCount;
+    uint8_t      recentHead;
+    uint32_t     requestCount;
+    uint32_t     updateCount;
+
+    StateStats   totals[BLE_LINK_STATE_COUNT];
+    uint32_t     segmentMs;   // start of the time not yet in totals
+
+    void     enter(BLELinkState s, uint32_t now);
+    void     roll(uint32_t now);
+    uint32_t wakeupsIn(uint32_t ms) const;
+    bool     matches(BLELinkState s) const;
+};
+
+#endif // BLE_LINK_POLICY_H
@@ -0,0 +1,169 @@
+#include "BatteryMonitor.h"
+#include "../log/Logger.h"
+
+// ── Discharge curve ──────────────────────────────────────────────────
+// Typical 1S Li-ion/LiPo resting voltage → state of charge, descending.
+// Percent is linearly interpolated between points.
+
+namespace {
+
+struct DischargePoint {
+    uint16_t milliVolts;
+    uint8_t  percent;
+};
+
+constexpr DischargePoint DISCHARGE_CURVE[] = {
+    { 4200, 100 }, { 4150, 95 }, { 4110, 90 }, { 4080, 85 }, { 4020, 80 },
+    { 3980,  75 }, { 3950, 70 }, { 3910, 65 }, { 3870, 60 }, { 3850, 55 },
+    { 3840,  50 }, { 3820, 45 }, { 3800, 40 }, { 3790, 35 }, { 3770, 30 },
+    { 3750,  25 }, { 3730, 20 }, { 3710, 15 }, { 3690, 10 }, { 3610,  5 },
+    { 3270,   0 },
+};
+
+constexpr size_t CURVE_LEN = sizeof(DISCHARGE_CURVE) / sizeof(DISCHARGE_CURVE[0]);
+
+constexpr bool curveIsDescending(size_t i) {
+    return i + 1 >= CURVE_LEN ||
+           (DISCHARGE_CURVE[i].milliVolts > DISCHARGE_CURVE[i + 1].milliVolts &&
+            DISCHARGE_CURVE[i].percent    > DISCHARGE_CURVE[i + 1].percent &&
+            curveIsDescending(i + 1));
+}
+
+static_assert(curveIsDescending(0), "DISCHARGE_CURVE must be strictly descending");
+static_assert(DISCHARGE_CURVE[0].percent == 100 && DISCHARGE_CURVE[CURVE_LEN - 1].percent == 0,
+              "DISCHARGE_CURVE must span 100 % .. 0 %");
+
+} // namespace
+
+uint8_t BatteryMonitor::percentFromMilliVolts(uint16_t mv) {
+    if (mv >= DISCHARGE_CURVE[0].milliVolts)             return 100;
+    if (mv <= DISCHARGE_CURVE[CURVE_LEN - 1].milliVolts) return 0;
+
+    size_t i = 1;
+    while (mv < DISCHARGE_CURVE[i].milliVolts) ++i;
+
+    const DischargePoint& hi = DISCHARGE_CURVE[i - 1];
+    const DischargePoint& lo = DISCHARGE_CURVE[i];
+    uint32_t span = hi.milliVolts - lo.milliVolts;
+    uint32_t pos  = mv - lo.milliVolts;
+    return lo.percent + ((hi.percent - lo.percent) * pos + span / 2) / span;
+}
+
+// ── Lifecycle ────────────────────────────────────────────────────────
+
+BatteryMonitor::BatteryMonitor()
+    : source(nullptr)
+    , filteredQ16(0)
+    , primed(false)
+    , milliVolts(0)
+    , percent(100)
+    , charging(false)
+    , sampleCostUs(0) {}
+
+BatteryMonitor::~BatteryMonitor() {
+    timer.stop();
+    delete source;
+}
+
+bool BatteryMonitor::begin(AdcSource* src, const Config& config) {
+    source = src;
+    cfg    = config;
+
+    if (cfg.chargePin >= 0) {
+        hal::gpioInput(cfg.chargePin, cfg.chargeActiveLow);
+    }
+
+    if (!source || cfg.adcPin < 0) {
+        LOG_W(POWER, "[Battery] No sense pin configured — reporting 100 %%\n");
+        return false;
+    }
+    if (!source->begin()) {
+        delete source;
+        source = nullptr;
+        return false;
+    }
+
+    sample();   // prime the filter so the first status is meaningful
+    LOG_I(POWER, "[Battery] %u mV (%u %%) on GPIO %d\n",
+                 (unsigned)getMilliVolts(), (unsigned)getPercent(), cfg.adcPin);
+    return true;
+}
+
+bool BatteryMonitor::startSampling(uint32_t periodMs) {
+    if (!hasSensor() && cfg.chargePin < 0) return false;
+    if (!timer.start(periodMs, &BatteryMonitor::timerCallback, this, "battery")) {
+        LOG_E(POWER, "[Battery] Failed to start sampling timer\n");
+        return false;
+    }
+    return true;
+}
+
+void BatteryMonitor::stopSampling() {
+    timer.stop();
+}
+
+void BatteryMonitor::timerCallback(void* arg) {
+    static_cast<BatteryMonitor*>(arg)->sample();
+}
+
+// ── Sampling ─────────────────────────────────────────────────────────
+
+void BatteryMonitor::sample() {
+    uint32_t start   = hal::micros();
+    bool     changed = false;
+
+    if (cfg.chargePin >= 0) {
+        bool level = hal::gpioRead(cfg.chargePin);
+        bool now   = level != cfg.chargeActiveLow;
+        changed |= charging.exchange(now, std::memory_order_relaxed) != now;
+    }
+
+    if (hasSensor()) {
+        // Oversample: averaging N conversions cuts white noise by √N.
+        uint32_t sum = 0;
+        for (uint8_t i = 0; i < OVERSAMPLE; ++i) sum += source->readMilliVolts();
+        uint32_t pinMv = (sum + OVERSAMPLE / 2) / OVERSAMPLE;
+        int32_t  batMv = (int32_t)((pinMv * cfg.dividerX1000 + 500) / 1000);
+
+        // Single-pole IIR in Q16.16: y += (x - y) >> k
+        int32_t x = batMv << 16;
+        if (!primed) {
+            filteredQ16 = x;
+            primed      = true;
+        } else {
+            filteredQ16 += (x - filteredQ16) >> IIR_SHIFT;
+        }
+
+        uint16_t mv = (uint16_t)((filteredQ16 + (1 << 15)) >> 16);
+        milliVolts.store(mv, std::memory_order_relaxed);
+        uint8_t pct = percentFromMilliVolts(mv);
+        changed |= percent.exchange(pct, std::memory_order_relaxed) != pct;
+    }
+
+    // The loop sleeps until something is due; a new reading may be.
+    if (changed) hal::wake();
+
+    sampleCostUs.store(hal::micros() - start, std::memory_order_relaxed);
+}
+
+// ── Accessors ────────────────────────────────────────────────────────
+
+bool BatteryMonitor::hasSensor() const {
+    return source && cfg.adcPin >= 0;
+}
+
+uint8_t BatteryMonitor::getPercent() const {
+    return percent.load(std::memory_order_relaxed);
+}
+
+uint16_t BatteryMonitor::getMilliVolts() const {
+    return milliVolts.load(std::memory_order_relaxed);
+}
+
+bool BatteryMonitor::isCharging() const {
+    return charging.load(std::memory_order_relaxed);
+}
+
+uint32_t BatteryMonitor::getSampleCostMicros() const {
+    return sampleCostUs.load(std::memory_order_relaxed);
+}
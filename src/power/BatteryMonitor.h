@@ -0,0 +1,83 @@
+#ifndef BATTERY_MONITOR_H
+#define BATTERY_MONITOR_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "AdcSource.h"
+#include "../hal/Hal.h"
+
+// Board wiring — override per board with build_flags in platformio.ini.
+#ifndef OPENVIBE_BATTERY_ADC_PIN
+#define OPENVIBE_BATTERY_ADC_PIN     -1     // ADC1 pin behind the divider
+#endif
+#ifndef OPENVIBE_BATTERY_DIVIDER_X1000
+#define OPENVIBE_BATTERY_DIVIDER_X1000 2000 // 100k/100k divider
+#endif
+#ifndef OPENVIBE_CHARGE_PIN
+#define OPENVIBE_CHARGE_PIN          -1
+#endif
+#ifndef OPENVIBE_CHARGE_ACTIVE_LOW
+#define OPENVIBE_CHARGE_ACTIVE_LOW   1
+#endif
+
+/**
+ * Battery voltage / charge-state pipeline.
+ *
+ * Sampling runs from a hal::PeriodicTimer (timer task), never from
+ * loop(): each sample oversamples the ADC, feeds a fixed-point
+ * single-pole IIR and maps the filtered voltage to percent through a
+ * constexpr discharge-curve LUT.  loop() only reads the published
+ * atomics, so refreshDeviceStats() stays O(1).
+ *
+ * sample() is public so a host harness can drive the filter directly
+ * with a synthetic AdcSource and measure settling time / CPU cost.
+ */
+class BatteryMonitor {
+public:
+    struct Config {
+        int      adcPin          = OPENVIBE_BATTERY_ADC_PIN;        // -1 = no battery sense
+        uint16_t dividerX1000    = OPENVIBE_BATTERY_DIVIDER_X1000;  // Vbat = Vpin * divider / 1000
+        int      chargePin       = OPENVIBE_CHARGE_PIN;             // -1 = no charge detection
+        bool     chargeActiveLow = OPENVIBE_CHARGE_ACTIVE_LOW;      // e.g. TP4056 CHRG (open drain)
+    };
+
+    static constexpr uint8_t  OVERSAMPLE       = 16;    // conversions per sample
+    static constexpr uint8_t  IIR_SHIFT        = 3;     // alpha = 1/8 → ~2.3 s to 95 % at 10 Hz
+    static constexpr uint32_t SAMPLE_PERIOD_MS = 100;
+
+    BatteryMonitor();
+    ~BatteryMonitor();
+
+    // Takes ownership of `source` (may be nullptr when adcPin < 0).
+    bool begin(AdcSource* source, const Config& cfg);
+    bool startSampling(uint32_t periodMs = SAMPLE_PERIOD_MS);
+    void stopSampling();
+
+    // One oversampled conversion + filter step.
+    void sample();
+
+    bool     hasSensor() const;
+    uint8_t  getPercent() const;
+    uint16_t getMilliVolts() const;
+    bool     isCharging() const;
+    uint32_t getSampleCostMicros() const;   // CPU time of the last sample()
+
+    static uint8_t percentFromMilliVolts(uint16_t mv);
+
+private:
+    AdcSource*         source;
+    Config             cfg;
+    hal::PeriodicTimer timer;
+
+    int32_t filteredQ16;   // battery mV, Q16.16
+    bool    primed;
+
+    std::atomic<uint16_t> milliVolts;
+    std::atomic<uint8_t>  percent;
+    std::atomic<bool>     charging;
+    std::atomic<uint32_t> sampleCostUs;
+
+    static void timerCallback(void* arg);
+};
+
+#endif // BATTERY_MONITOR_H
@@ -0,0 +1,93 @@
+#include "PowerManager.h"
+#include "../log/Logger.h"
+#include "../Features.h"
+
+const PowerManager::Profile PowerManager::PROFILES[POWER_PROFILE_COUNT] = {
+    { "performance", 240, hal::POWER_SAVE_MIN_MODEM,  1 },
+    { "balanced",    160, hal::POWER_SAVE_MIN_MODEM, 10 },
+    { "low",          80, hal::POWER_SAVE_MAX_MODEM, 50 },
+};
+
+PowerManager::PowerManager()
+    : current(POWER_BALANCED)
+    , windowStartUs(0)
+    , windowSleptUs(0)
+    , windowWakeups(0)
+    , windowEarly(0) {}
+
+// ── Profile ──────────────────────────────────────────────────────────
+
+void PowerManager::begin(PowerProfile profile) {
+    current       = profile < POWER_PROFILE_COUNT ? profile : POWER_BALANCED;
+    windowStartUs = hal::micros();
+    apply();
+}
+
+bool PowerManager::setProfile(PowerProfile profile) {
+    if (profile >= POWER_PROFILE_COUNT) return false;
+    if (profile == current) return true;
+    current = profile;
+    apply();
+    return true;
+}
+
+void PowerManager::apply() {
+    const Profile& p = PROFILES[current];
+    if (!hal::cpuSetFrequencyMhz(p.cpuMhz)) {
+        LOG_W(POWER, "[Power] CPU %u MHz refused\n", (unsigned)p.cpuMhz);
+    }
+#if OPENVIBE_WITH_WIFI
+    hal::wifiSetPowerSave(p.modemSleep);
+#endif
+    LOG_I(POWER, "[Power] Profile %s: %u MHz, poll %u ms\n",
+                 p.name, (unsigned)hal::cpuFrequencyMhz(), (unsigned)p.netPollMs);
+}
+
+const char* PowerManager::profileName(PowerProfile p) {
+    return p < POWER_PROFILE_COUNT ? PROFILES[p].name : "unknown";
+}
+
+bool PowerManager::parseProfile(const char* name, PowerProfile& out) {
+    if (!name) return false;
+    for (uint8_t i = 0; i < POWER_PROFILE_COUNT; ++i) {
+        if (!strcmp(name, PROFILES[i].name)) {
+            out = static_cast<PowerProfile>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ── Idle wait ────────────────────────────────────────────────────────
+
+void PowerManager::idle(uint32_t budgetMs, bool socketsOpen) {
+    if (socketsOpen && !hal::socketsWakeLoop() && budgetMs > profile().netPollMs) {
+        budgetMs = profile().netPollMs;
+    }
+    if (budgetMs > MAX_SLEEP_MS) budgetMs = MAX_SLEEP_MS;
+
+    if (budgetMs > 0) {
+        uint32_t start = hal::micros();
+        bool     early = hal::waitForEvent(budgetMs);
+        windowSleptUs += hal::micros() - start;
+        ++windowWakeups;
+        if (early) ++windowEarly;
+    }
+    rollWindow(hal::micros());
+}
+
+void PowerManager::rollWindow(uint32_t nowUs) {
+    uint32_t spanUs = nowUs - windowStartUs;
+    if (spanUs < STATS_WINDOW_MS * 1000) return;
+
+    uint32_t slept = windowSleptUs < spanUs ? windowSleptUs : spanUs;
+    last.wakeups       = windowWakeups;
+    last.earlyWakeups  = windowEarly;
+    last.awakePermille = (uint16_t)(((uint64_t)(spanUs - slept) * 1000 + spanUs / 2) / spanUs);
+    last.windowMs      = spanUs / 1000;
+
+    windowStartUs = nowUs;
+    windowSleptUs = 0;
+    windowWakeups = 0;
+    windowEarly   = 0;
+}
@@ -0,0 +1,92 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "../hal/Hal.h"
+
+/** Latency / power trade-off, persisted and switchable with POWER. */
+enum PowerProfile : uint8_t {
+    POWER_PERFORMANCE = 0,
+    POWER_BALANCED    = 1,
+    POWER_LOW         = 2,
+    POWER_PROFILE_COUNT
+};
+
+/**
+ * Owns the CPU clock / modem sleep setting and the loop's idle wait.
+ *
+ * The main loop no longer spins: after each service pass DeviceContext
+ * works out when the next timed job is due (telemetry window or
+ * heartbeat, Wi-Fi connect timeout, remote retry, trace flush) and
+ * calls idle() with that budget.  Anything that produces work from
+ * another task — a BLE write, the battery timer seeing a new reading,
+ * Wi-Fi link events, serial input — calls hal::wake().
+ *
+ * Where sockets cannot wake the loop (the device: the Arduino network
+ * classes buffer in user space), the wait is additionally capped at the
+ * profile's netPollMs while any server or client is open.  That poll
+ * interval is the profile's worst-case added command latency:
+ *
+ *   performance  240 MHz  modem sleep MIN  poll  1 ms
+ *   balanced     160 MHz  modem sleep MIN  poll 10 ms   (default)
+ *   low          80 MHz   modem sleep MAX  poll 50 ms
+ *
+ * Modem sleep is never turned off completely: the ESP32 requires it
+ * while BLE and Wi-Fi share the radio.
+ *
+ * Loop statistics (wakeups, early wakeups, share of time awake) are
+ * kept over a rolling window for GET /power.
+ */
+class PowerManager {
+public:
+    struct Profile {
+        const char*        name;
+        uint32_t           cpuMhz;
+        hal::WiFiPowerSave modemSleep;
+        uint32_t           netPollMs;
+    };
+
+    // Over the last complete STATS_WINDOW_MS (all zero until one ends).
+    struct LoopStats {
+        uint32_t wakeups       = 0;   // idle() calls that slept
+        uint32_t earlyWakeups  = 0;   // ... of which ended by hal::wake() / I/O
+        uint16_t awakePermille = 0;   // share of time spent outside idle()
+        uint32_t windowMs      = 0;
+    };
+
+    static constexpr uint32_t MAX_SLEEP_MS    = 60000;   // re-evaluate at least this often
+    static constexpr uint32_t STATS_WINDOW_MS = 10000;
+
+    PowerManager();
+
+    void begin(PowerProfile profile);
+    bool setProfile(PowerProfile profile);   // false if out of range
+    PowerProfile   getProfile() const { return current; }
+    const Profile& profile() const    { return PROFILES[current]; }
+
+    // Sleep until woken or `budgetMs` passes.  `socketsOpen`: the caller
+    // has network sockets that must be polled (ignored on the host).
+    void idle(uint32_t budgetMs, bool socketsOpen);
+
+    const LoopStats& loopStats() const { return last; }
+
+    static const char* profileName(PowerProfile p);
+    static bool        parseProfile(const char* name, PowerProfile& out);
+
+private:
+    PowerProfile current;
+
+    // Window being filled; times in µs.
+    uint32_t  windowStartUs;
+    uint32_t  windowSleptUs;
+    uint32_t  windowWakeups;
+    uint32_t  windowEarly;
+    LoopStats last;
+
+    void apply();
+    void rollWindow(uint32_t nowUs);
+
+    static const Profile PROFILES[POWER_PROFILE_COUNT];
+};
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,200 @@
+#include "MsgPack.h"
+
+// ── Writer ───────────────────────────────────────────────────────────
+
+MsgPackWriter::MsgPackWriter(uint8_t* b, size_t c)
+    : buf(b)
+    , cap(c)
+    , len(0)
+    , overflow(false) {}
+
+void MsgPackWriter::put(uint8_t b) {
+    if (len < cap) buf[len++] = b;
+    else overflow = true;
+}
+
+void MsgPackWriter::put(const uint8_t* p, size_t n) {
+    if (n > cap - len) {
+        overflow = true;
+        return;
+    }
+    memcpy(buf + len, p, n);
+    len += n;
+}
+
+void MsgPackWriter::putBE(uint32_t v, uint8_t bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) put((uint8_t)(v >> shift));
+}
+
+void MsgPackWriter::map(uint32_t n) {
+    if      (n < 16)      put(0x80 | n);
+    else if (n <= 0xFFFF) { put(0xDE); putBE(n, 2); }
+    else                  { put(0xDF); putBE(n, 4); }
+}
+
+void MsgPackWriter::array(uint32_t n) {
+    if      (n < 16)      put(0x90 | n);
+    else if (n <= 0xFFFF) { put(0xDC); putBE(n, 2); }
+    else                  { put(0xDD); putBE(n, 4); }
+}
+
+void MsgPackWriter::nil()            { put(0xC0); }
+void MsgPackWriter::boolean(bool v)  { put(v ? 0xC3 : 0xC2); }
+
+void MsgPackWriter::uint(uint32_t v) {
+    if      (v < 0x80)    put((uint8_t)v);
+    else if (v <= 0xFF)   { put(0xCC); putBE(v, 1); }
+    else if (v <= 0xFFFF) { put(0xCD); putBE(v, 2); }
+    else                  { put(0xCE); putBE(v, 4); }
+}
+
+void MsgPackWriter::sint(int32_t v) {
+    if (v >= 0)          uint((uint32_t)v);
+    else if (v >= -32)   put((uint8_t)v);
+    else if (v >= -128)  { put(0xD0); putBE((uint32_t)v, 1); }
+    else if (v >= -32768) { put(0xD1); putBE((uint32_t)v, 2); }
+    else                 { put(0xD2); putBE((uint32_t)v, 4); }
+}
+
+void MsgPackWriter::str(const char* s, size_t n) {
+    if      (n < 32)      put(0xA0 | n);
+    else if (n <= 0xFF)   { put(0xD9); putBE(n, 1); }
+    else if (n <= 0xFFFF) { put(0xDA); putBE(n, 2); }
+    else                  { put(0xDB); putBE(n, 4); }
+    put((const uint8_t*)s, n);
+}
+
+// ── Reader ───────────────────────────────────────────────────────────
+
+MsgPackReader::MsgPackReader(const uint8_t* d, size_t n)
+    : data(d)
+    , len(n)
+    , pos(0)
+    , error(false) {}
+
+bool MsgPackReader::need(size_t n) {
+    if (error || n > len - pos) return fail();
+    return true;
+}
+
+uint32_t MsgPackReader::getBE(uint8_t bytes) {
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < bytes; ++i) v = (v << 8) | data[pos++];
+    return v;
+}
+
+bool MsgPackReader::map(uint32_t& n) {
+    if (!need(1)) return false;
+    uint8_t t = data[pos];
+    if ((t & 0xF0) == 0x80) { ++pos; n = t & 0x0F; return true; }
+    if (t == 0xDE && need(3)) { ++pos; n = getBE(2); return true; }
+    if (t == 0xDF && need(5)) { ++pos; n = getBE(4); return true; }
+    return false;
+}
+
+bool MsgPackReader::array(uint32_t& n) {
+    if (!need(1)) return false;
+    uint8_t t = data[pos];
+    if ((t & 0xF0) == 0x90) { ++pos; n = t & 0x0F; return true; }
+    if (t == 0xDC && need(3)) { ++pos; n = getBE(2); return true; }
+    if (t == 0xDD && need(5)) { ++pos; n = getBE(4); return true; }
+    return false;
+}
+
+bool MsgPackReader::boolean(bool& v) {
+    if (!need(1)) return false;
+    uint8_t t = data[pos];
+    if (t != 0xC2 && t != 0xC3) return false;
+    ++pos;
+    v = t == 0xC3;
+    return true;
+}
+
+bool MsgPackReader::sint(int64_t& v) {
+    if (!need(1)) return false;
+    uint8_t t = data[pos];
+    if (t < 0x80) { ++pos; v = t; return true; }
+    if (t >= 0xE0) { ++pos; v = (int8_t)t; return true; }
+
+    uint8_t bytes;
+    bool    isSigned;
+    switch (t) {
+        case 0xCC: bytes = 1; isSigned = false; break;
+        case 0xCD: bytes = 2; isSigned = false; break;
+        case 0xCE: bytes = 4; isSigned = false; break;
+        case 0xD0: bytes = 1; isSigned = true;  break;
+        case 0xD1: bytes = 2; isSigned = true;  break;
+        case 0xD2: bytes = 4; isSigned = true;  break;
+        default:   return false;   // not an int (64-bit ints fit no field either)
+    }
+    if (!need(1 + bytes)) return false;
+    ++pos;
+    uint32_t raw = getBE(bytes);
+    if (!isSigned)       v = raw;
+    else if (bytes == 1) v = (int8_t)raw;
+    else if (bytes == 2) v = (int16_t)raw;
+    else                 v = (int32_t)raw;
+    return true;
+}
+
+bool MsgPackReader::str(const char*& s, uint32_t& n) {
+    if (!need(1)) return false;
+    uint8_t t = data[pos];
+    if      ((t & 0xE0) == 0xA0)    { ++pos; n = t & 0x1F; }
+    else if (t == 0xD9 && need(2))  { ++pos; n = getBE(1); }
+    else if (t == 0xDA && need(3))  { ++pos; n = getBE(2); }
+    else if (t == 0xDB && need(5))  { ++pos; n = getBE(4); }
+    else return false;
+
+    if (!need(n)) return false;
+    s    = (const char*)data + pos;
+    pos += n;
+    return true;
+}
+
+bool MsgPackReader::str(String& out) {
+    const char* s;
+    uint32_t    n;
+    if (!str(s, n)) return false;
+    out = String();
+    out.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) out += s[i];
+    return true;
+}
+
+bool MsgPackReader::isNil() {
+    if (error || pos >= len || data[pos] != 0xC0) return false;
+    ++pos;
+    return true;
+}
+
+bool MsgPackReader::skip() {
+    return skipDepth(0);
+}
+
+bool MsgPackReader::skipDepth(uint8_t depth) {
+    if (depth > MAX_DEPTH || !need(1)) return fail();
+    uint8_t t = data[pos];
+
+    if (t == 0xC0 || t == 0xC2 || t == 0xC3) { ++pos; return true; }
+    if (t < 0x80 || t >= 0xE0 || (t >= 0xCC && t <= 0xCE) || (t >= 0xD0 && t <= 0xD2)) {
+        int64_t v;
+        return sint(v);
+    }
+    if ((t & 0xE0) == 0xA0 || (t >= 0xD9 && t <= 0xDB)) {
+        const char* s;
+        uint32_t    n;
+        return str(s, n);
+    }
+
+    uint32_t n;
+    if (((t & 0xF0) == 0x90 || t == 0xDC || t == 0xDD) && array(n)) {
+        while (n--) if (!skipDepth(depth + 1)) return false;
+        return true;
+    }
+    if (((t & 0xF0) == 0x80 || t == 0xDE || t == 0xDF) && map(n)) {
+        while (n--) if (!skipDepth(depth + 1) || !skipDepth(depth + 1)) return false;
+        return true;
+    }
+    return fail();   // float, bin, ext, 64-bit: not part of the protocol
+}
@@ -0,0 +1,89 @@
+#ifndef MSGPACK_H
+#define MSGPACK_H
+
+#include <Arduino.h>
+
+/**
+ * Minimal MessagePack writer/reader for the binary wire protocol
+ * (see WireProtocol.h).  Fixed buffers, no allocation, only the
+ * types the protocol uses: nil, bool, ints, str, array, map.
+ *
+ * The writer latches overflow, so an encoder is written straight
+ * through and checked once.  Reader calls return false without
+ * consuming anything when the next value has another type (the caller
+ * may skip() it); truncated or unsupported input latches ok() = false.
+ */
+class MsgPackWriter {
+public:
+    MsgPackWriter(uint8_t* buf, size_t cap);
+
+    void map(uint32_t entries);
+    void array(uint32_t items);
+    void nil();
+    void boolean(bool v);
+    void uint(uint32_t v);
+    void sint(int32_t v);
+    void str(const char* s, size_t len);
+    void str(const char* s) { str(s, s ? strlen(s) : 0); }
+    void str(const String& s) { str(s.c_str(), s.length()); }
+
+    const uint8_t* data() const { return buf; }
+    size_t         size() const { return len; }
+    size_t         room() const { return cap - len; }
+    bool           ok() const   { return !overflow; }
+    void           reset()      { len = 0; overflow = false; }
+
+private:
+    uint8_t* buf;
+    size_t   cap;
+    size_t   len;
+    bool     overflow;
+
+    void put(uint8_t b);
+    void put(const uint8_t* p, size_t n);
+    void putBE(uint32_t v, uint8_t bytes);
+};
+
+/** Fixed-capacity writer with its own storage. */
+template <size_t N>
+class MsgPackBuffer : public MsgPackWriter {
+public:
+    MsgPackBuffer() : MsgPackWriter(storage, N) {}
+
+private:
+    uint8_t storage[N];
+};
+
+class MsgPackReader {
+public:
+    MsgPackReader(const uint8_t* data, size_t len);
+
+    // Each returns false, consuming nothing, if the next value is not of that type.
+    bool map(uint32_t& entries);
+    bool array(uint32_t& items);
+    bool boolean(bool& v);
+    bool sint(int64_t& v);                       // any int format
+    bool str(const char*& s, uint32_t& len);     // borrowed, not NUL-terminated
+    bool str(String& out);
+    bool skip();                                 // any one value, nested
+
+    bool isNil();                                // peeks; consumes a nil
+    bool ok() const      { return !error; }
+    bool atEnd() const   { return pos == len; }
+    const uint8_t* cursor() const { return data + pos; }   // next value's first byte
+
+private:
+    static constexpr uint8_t MAX_DEPTH = 8;
+
+    const uint8_t* data;
+    size_t         len;
+    size_t         pos;
+    bool           error;
+
+    bool     need(size_t n);
+    uint32_t getBE(uint8_t bytes);
+    bool     skipDepth(uint8_t depth);
+    bool     fail() { error = true; return false; }
+};
+
+#endif // MSGPACK_H
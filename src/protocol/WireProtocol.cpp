@@ -0,0 +1,308 @@
+#include "WireProtocol.h"
+#include "../ota/OtaManager.h"
+#include "../wifi/WiFiScanCache.h"
+#include "../session/SessionManager.h"
+
+namespace wire {
+
+// ── Decode ───────────────────────────────────────────────────────────
+
+// Each helper consumes the value whatever its type and returns false
+// when it was not usable (wrong type or out of range).
+static bool readInt(MsgPackReader& r, int64_t lo, int64_t hi, int64_t& out) {
+    if (r.sint(out)) return out >= lo && out <= hi;
+    r.skip();
+    return false;
+}
+
+static bool readStr(MsgPackReader& r, String& out) {
+    if (r.str(out)) return true;
+    r.skip();
+    return false;
+}
+
+static bool readBool(MsgPackReader& r, bool& out) {
+    if (r.boolean(out)) return true;
+    r.skip();
+    return false;
+}
+
+bool decodeField(MsgPackReader& r, uint32_t key, Command& cmd) {
+    int64_t v;
+    bool    good;
+
+    switch (key) {
+        case KEY_INTENSITY:
+            good = readInt(r, INT32_MIN, INT32_MAX, v);
+            if (good) cmd.intensity = (int)v;   // clamped on execute
+            break;
+        case KEY_CHANNEL:
+            good = readInt(r, 0, MAX_MOTOR_CHANNELS - 1, v);
+            if (good) cmd.channel = (int)v;
+            break;
+        case KEY_CHANNELS: {
+            uint32_t n;
+            if (!r.array(n)) { r.skip(); good = false; break; }
+            good = n > 0;
+            for (uint32_t i = 0; i < n; ++i) {   // past MAX_MOTOR_CHANNELS: read, dropped
+                bool item = readInt(r, INT32_MIN, INT32_MAX, v);
+                if (item && good && i < MAX_MOTOR_CHANNELS) cmd.levels[i] = (uint8_t)constrain(v, 0, 100);
+                good = good && item;
+            }
+            if (good) cmd.levelCount = (uint8_t)min(n, (uint32_t)MAX_MOTOR_CHANNELS);
+            break;
+        }
+        case KEY_PATTERN:
+            good = readInt(r, PATTERN_CONSTANT, PATTERN_COUNT - 1, v);
+            if (good) cmd.pattern = (MotorPattern)v;
+            break;
+        case KEY_PERIOD:
+            good = readInt(r, 0, UINT32_MAX, v);
+            if (good) cmd.periodMs = (uint32_t)v;   // range checked on execute
+            break;
+        case KEY_SEQ:
+            good = readInt(r, 1, UINT32_MAX, v);
+            if (good) { cmd.seq = (uint32_t)v; cmd.hasSeq = true; }
+            break;
+        case KEY_TRANSPORT:
+            good = readInt(r, TRANSPORT_BLE, TRANSPORT_AUTO, v);
+            if (good) cmd.transport = (TransportMode)v;
+            break;
+        case KEY_SSID:           good = readStr(r, cmd.ssid);          break;
+        case KEY_PASSWORD:       good = readStr(r, cmd.password);      break;
+        case KEY_SERVER_ADDRESS: good = readStr(r, cmd.serverAddress); break;
+        case KEY_MIN_INTERVAL:
+            good = readInt(r, 0, UINT32_MAX, v);
+            if (good) { cmd.rate.minIntervalMs = (uint32_t)v; cmd.hasMinInterval = true; }
+            break;
+        case KEY_HEARTBEAT:
+            good = readInt(r, 0, UINT32_MAX, v);
+            if (good) { cmd.rate.heartbeatMs = (uint32_t)v; cmd.hasHeartbeat = true; }
+            break;
+        case KEY_TRACE_ACTION:
+            good = readInt(r, TRACE_ACTION_START, TRACE_ACTION_DUMP, v);
+            if (good) cmd.traceAction = (TraceAction)v;
+            break;
+        case KEY_TRACE_FLASH:    good = readBool(r, cmd.traceFromFlash); break;
+        case KEY_ENCODING:
+            good = readInt(r, WIRE_JSON, WIRE_MSGPACK, v);
+            if (good) cmd.encoding = (WireEncoding)v;
+            break;
+        case KEY_SESSION:
+            good = readInt(r, 1, SessionManager::MAX_CLIENT_SESSION, v);
+            if (good) cmd.session = (uint32_t)v;
+            break;
+        case KEY_POWER_PROFILE:
+            good = readInt(r, POWER_PERFORMANCE, POWER_LOW, v);
+            if (good) cmd.powerProfile = (PowerProfile)v;
+            break;
+        case KEY_OTA_ACTION:
+            good = readInt(r, OTA_ACTION_BEGIN, OTA_ACTION_STATUS, v);
+            if (good) cmd.otaAction = (OtaAction)v;
+            break;
+        case KEY_OTA_SIZE:
+            good = readInt(r, 0, UINT32_MAX, v);
+            if (good) cmd.otaSize = (uint32_t)v;
+            break;
+        case KEY_HIST_FROM:
+            good = readInt(r, INT32_MIN, INT32_MAX, v);
+            if (good) cmd.history.from = (int32_t)v;
+            break;
+        case KEY_HIST_TO:
+            good = readInt(r, INT32_MIN, INT32_MAX, v);
+            if (good) cmd.history.to = (int32_t)v;
+            break;
+        case KEY_HIST_RES:
+            good = readInt(r, 0, UINT32_MAX, v);
+            if (good) cmd.history.res = (uint32_t)v;
+            break;
+        case KEY_OTA_SHA256: {
+            String hex;
+            good = readStr(r, hex) && OtaManager::parseDigest(hex.c_str(), cmd.otaSha256);
+            cmd.otaHasDigest = good;
+            break;
+        }
+        case KEY_OTA_SIG: {
+            String hex;
+            good = readStr(r, hex) && OtaManager::parseDigest(hex.c_str(), cmd.otaSig);
+            cmd.otaHasSig = good;
+            break;
+        }
+        default:
+            return r.skip();   // unknown key: ignored
+    }
+
+    if (!good) cmd.valid = false;
+    return r.ok();
+}
+
+bool hasRequiredFields(RequestType type, uint64_t seenKeys) {
+    uint64_t need = 0;
+    switch (type) {
+        case REQ_WIFI_CREDENTIALS: need = 1ull << KEY_SSID;          break;
+        case REQ_SWITCH_TRANSPORT:
+        case REQ_TELEMETRY_RATE:   need = 1ull << KEY_TRANSPORT;     break;
+        case REQ_TRACE:            need = 1ull << KEY_TRACE_ACTION;  break;
+        case REQ_POWER:            need = 1ull << KEY_POWER_PROFILE; break;
+        case REQ_OTA:              need = 1ull << KEY_OTA_ACTION;    break;
+        case REQ_PATTERN:          need = 1ull << KEY_PATTERN;       break;
+        case REQ_PROBE:            need = 1ull << KEY_SEQ;           break;
+        default: break;
+    }
+    return (seenKeys & need) == need;
+}
+
+// ── Encode ───────────────────────────────────────────────────────────
+
+void encodeStatus(MsgPackWriter& w, const DeviceStats& stats, const String& deviceId, int route) {
+    bool withServer   = (stats.transport == TRANSPORT_REMOTE || stats.transport == TRANSPORT_AUTO)
+                     && !stats.serverAddress.isEmpty();
+    bool withChannels = stats.channelCount > 1;
+    bool withRoute    = route >= 0;
+
+    w.map(11 + withServer + withChannels + withRoute);
+    w.uint(KEY_TYPE);         w.uint(MSG_STATUS);
+    w.uint(KEY_ST_INTENSITY); w.sint(stats.levels[0]);
+    w.uint(KEY_ST_BATTERY);   w.sint(stats.battery);
+    w.uint(KEY_ST_CHARGING);  w.boolean(stats.isCharging);
+    w.uint(KEY_ST_BLE);       w.boolean(stats.isBluetoothConnected);
+    w.uint(KEY_ST_WIFI);      w.boolean(stats.isWifiConnected);
+    w.uint(KEY_ST_IP);        w.str(stats.ipAddress);
+    w.uint(KEY_ST_MAC);       w.str(stats.macAddress);
+    w.uint(KEY_ST_VERSION);   w.str(stats.version);
+    w.uint(KEY_ST_DEVICE_ID); w.str(deviceId);
+    w.uint(KEY_ST_TRANSPORT); w.uint(stats.transport);
+    if (withServer) {
+        w.uint(KEY_ST_SERVER); w.str(stats.serverAddress);
+    }
+    if (withChannels) {
+        w.uint(KEY_ST_CHANNELS);
+        w.array(stats.channelCount);
+        for (uint8_t i = 0; i < stats.channelCount; ++i) w.uint(stats.levels[i]);
+    }
+    if (withRoute) {
+        w.uint(KEY_ST_ROUTE); w.uint(route);
+    }
+}
+
+void encodeProbe(MsgPackWriter& w, uint32_t seq) {
+    w.map(2);
+    w.uint(KEY_TYPE); w.uint(MSG_PROBE);
+    w.uint(KEY_SEQ);  w.uint(seq);
+}
+
+void encodeEvents(MsgPackWriter& w, const BufferedEvent* events, size_t n,
+                  uint32_t now, uint32_t dropped) {
+    w.map(4);
+    w.uint(KEY_TYPE);       w.uint(MSG_EVENTS);
+    w.uint(KEY_EV_NOW);     w.uint(now);
+    w.uint(KEY_EV_DROPPED); w.uint(dropped);
+    w.uint(KEY_EV_LIST);
+    w.array(n);
+    for (size_t i = 0; i < n; ++i) {
+        w.array(4);
+        w.uint(events[i].timeMs);
+        w.uint(events[i].kind);
+        w.uint(events[i].channel);
+        w.sint(events[i].value);
+    }
+}
+
+// ── SCAN ─────────────────────────────────────────────────────────────
+
+uint8_t scanFieldCount(const WiFiScanCache& scan) {
+    return 3 + scan.hasResults();
+}
+
+// Encoded size of one [ssid, rssi, channel, auth] entry.
+static size_t networkBytes(const WiFiScanCache::Network& net) {
+    size_t ssid = strlen(net.ssid);
+    return 1 + (ssid < 32 ? 1 : 2) + ssid
+             + (net.rssi >= -32 ? 1 : 2)
+             + (net.channel < 0x80 ? 1 : 2)
+             + (net.auth < 0x80 ? 1 : 2);
+}
+
+void encodeScan(MsgPackWriter& w, const WiFiScanCache& scan, uint32_t now) {
+    if (scan.hasResults()) {
+        w.uint(KEY_SCAN_AGE); w.uint(scan.ageMs(now));
+    }
+    w.uint(KEY_SCANNING);   w.boolean(scan.isScanning());
+    w.uint(KEY_SCAN_TOTAL); w.uint(scan.count());
+
+    // Strongest first, until the writer is full (key + array header).
+    size_t  room = w.room() > 4 ? w.room() - 4 : 0;
+    uint8_t n    = 0;
+    for (; n < scan.count(); ++n) {
+        size_t bytes = networkBytes(scan.at(n));
+        if (bytes > room) break;
+        room -= bytes;
+    }
+
+    w.uint(KEY_NETWORKS);
+    w.array(n);
+    for (uint8_t i = 0; i < n; ++i) {
+        const WiFiScanCache::Network& net = scan.at(i);
+        w.array(4);
+        w.str(net.ssid);
+        w.sint(net.rssi);
+        w.uint(net.channel);
+        w.uint(net.auth);
+    }
+}
+
+// ── HISTORY ──────────────────────────────────────────────────────────
+
+// Encoded size of one row (a value array, or nil when empty).
+static size_t rowBytes(const HistoryStore::Row& row) {
+    if (!row.count) return 1;
+    size_t bytes = 1;
+    for (uint8_t i = 0; i < row.count; ++i) {
+        int16_t v = row.values[i];
+        bytes += (v >= -32 && v < 0x80) ? 1 : 2;   // values fit an int8 / uint8
+    }
+    return bytes;
+}
+
+void encodeHistory(MsgPackWriter& w, const HistoryStore& history,
+                   const HistoryStore::Range& range, uint32_t nowMs) {
+    uint32_t p = HistoryStore::periodS(range.tier);
+    w.uint(KEY_HIST_NOW);  w.uint(history.uptimeS(nowMs));
+    w.uint(KEY_HIST_RES);  w.uint(p);
+    w.uint(KEY_HIST_FROM);
+    if (range.empty) w.nil();
+    else             w.uint(range.first * p);
+
+    // Oldest first, until MAX_ROWS or the writer is full (rows key and
+    // array header, then the next key and a uint32).
+    static constexpr size_t RESERVE = 1 + 3 + 1 + 5;
+    size_t   room = w.room() > RESERVE ? w.room() - RESERVE : 0;
+    uint32_t n    = 0;
+    HistoryStore::Row row;
+    if (!range.empty) {
+        for (uint32_t b = range.first; b <= range.last && n < HistoryStore::MAX_ROWS; ++b, ++n) {
+            history.row(range, b, row);
+            size_t bytes = rowBytes(row);
+            if (bytes > room) break;
+            room -= bytes;
+        }
+    }
+
+    w.uint(KEY_HIST_ROWS);
+    w.array(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        history.row(range, range.first + i, row);
+        if (!row.count) {
+            w.nil();
+            continue;
+        }
+        w.array(row.count);
+        for (uint8_t k = 0; k < row.count; ++k) w.sint(row.values[k]);
+    }
+
+    w.uint(KEY_HIST_NEXT);
+    if (range.empty || range.first + n > range.last) w.nil();
+    else                                             w.uint((range.first + n) * p);
+}
+
+} // namespace wire
@@ -0,0 +1,163 @@
+#ifndef WIRE_PROTOCOL_H
+#define WIRE_PROTOCOL_H
+
+#include <Arduino.h>
+#include "MsgPack.h"
+#include "../commands/Command.h"
+#include "../telemetry/EventBuffer.h"
+#include "../../include/types/device_stats.h"
+
+class WiFiScanCache;
+
+/**
+ * Binary (MessagePack) form of the command/status protocol, used on
+ * WebSocket binary frames once a peer has sent
+ *
+ *   {"requestType":"HELLO","encoding":"msgpack"}
+ *
+ * Every message is one map with small integer keys; KEY_TYPE says what
+ * it is (a RequestType for commands, MSG_* for what the device sends).
+ * Field keys are shared, so a command and the JSON it replaces line up
+ * one to one:
+ *
+ *   {0:2, 1:17, 2:40}               INTENSITY 40, id 17
+ *   {0:2, 34:[40, 0, 75]}           INTENSITY per channel
+ *   {0:0x41, 1:17, 13:0}            ack 17, OK
+ *   {0:0x40, 20:40, 21:70, ...}     status
+ *   {0:0x42, 38:t, 39:0, 40:[...]}  buffered events (REMOTE replay)
+ *   {0:0x43, 41:7} / {0:12, 41:7}   link probe / its echo (AUTO)
+ *   {0:13, 1:3} → {0:0x41, 1:3, 13:0, 46:false, 47:2, 44:[...]}   SCAN
+ *   {0:14, 48:-600, 50:10} → {0:0x41, 13:0, 53:t, 50:10, 48:t0, 51:[...], 52:nil}
+ *                                                                   HISTORY
+ *
+ * Values are typed: transport is a TransportMode, result a
+ * CommandResult, encoding a WireEncoding.  Unknown keys are skipped,
+ * so fields can be added without breaking older peers.
+ */
+namespace wire {
+
+// ── Message types (KEY_TYPE) sent by the device ──────────────────────
+constexpr uint8_t MSG_STATUS = 0x40;
+constexpr uint8_t MSG_ACK    = 0x41;
+constexpr uint8_t MSG_EVENTS = 0x42;   // buffered events, replayed to the remote
+constexpr uint8_t MSG_PROBE  = 0x43;   // link probe (TRANSPORT_AUTO), echoed with REQ_PROBE
+
+// ── Keys ─────────────────────────────────────────────────────────────
+constexpr uint8_t KEY_TYPE           = 0;
+constexpr uint8_t KEY_ID             = 1;    // uint
+constexpr uint8_t KEY_INTENSITY      = 2;
+constexpr uint8_t KEY_TRANSPORT      = 3;
+constexpr uint8_t KEY_SSID           = 4;
+constexpr uint8_t KEY_PASSWORD       = 5;
+constexpr uint8_t KEY_SERVER_ADDRESS = 6;
+constexpr uint8_t KEY_MIN_INTERVAL   = 7;
+constexpr uint8_t KEY_HEARTBEAT      = 8;
+constexpr uint8_t KEY_TRACE_ACTION   = 9;
+constexpr uint8_t KEY_TRACE_FLASH    = 10;   // bool
+constexpr uint8_t KEY_COMMANDS       = 11;   // BATCH: array of command maps
+constexpr uint8_t KEY_ENCODING       = 12;
+constexpr uint8_t KEY_RESULT         = 13;
+constexpr uint8_t KEY_RESULTS        = 14;   // BATCH ack: array of results
+constexpr uint8_t KEY_POWER_PROFILE  = 15;   // POWER: PowerProfile
+constexpr uint8_t KEY_OTA_ACTION     = 16;   // OTA: OtaAction
+constexpr uint8_t KEY_OTA_SIZE       = 17;   // OTA begin: image bytes
+constexpr uint8_t KEY_OTA_SHA256     = 18;   // OTA begin: 64 hex digits
+constexpr uint8_t KEY_OTA_OFFSET     = 19;   // OTA ack: next offset expected
+
+// Status fields (same meaning as the JSON status keys)
+constexpr uint8_t KEY_ST_INTENSITY   = 20;
+constexpr uint8_t KEY_ST_BATTERY     = 21;
+constexpr uint8_t KEY_ST_CHARGING    = 22;
+constexpr uint8_t KEY_ST_BLE         = 23;
+constexpr uint8_t KEY_ST_WIFI        = 24;
+constexpr uint8_t KEY_ST_IP          = 25;
+constexpr uint8_t KEY_ST_MAC         = 26;
+constexpr uint8_t KEY_ST_VERSION     = 27;
+constexpr uint8_t KEY_ST_DEVICE_ID   = 28;
+constexpr uint8_t KEY_ST_TRANSPORT   = 29;
+constexpr uint8_t KEY_ST_SERVER      = 30;
+
+// OTA ack fields
+constexpr uint8_t KEY_OTA_STATE      = 31;   // OtaState
+constexpr uint8_t KEY_OTA_ERROR      = 32;   // OtaStatus, when not OK
+
+// Motor channels
+constexpr uint8_t KEY_CHANNEL        = 33;   // INTENSITY / PATTERN: one channel
+constexpr uint8_t KEY_CHANNELS       = 34;   // INTENSITY: array of levels from channel 0
+constexpr uint8_t KEY_PATTERN        = 35;   // PATTERN: MotorPattern
+constexpr uint8_t KEY_PERIOD         = 36;   // PATTERN: ms
+constexpr uint8_t KEY_ST_CHANNELS    = 37;   // status: array of levels (2+ channels)
+
+// Buffered events (MSG_EVENTS)
+constexpr uint8_t KEY_EV_NOW         = 38;   // sender's uptime ms, the clock of the event times
+constexpr uint8_t KEY_EV_DROPPED     = 39;   // events lost since boot
+constexpr uint8_t KEY_EV_LIST        = 40;   // array of [timeMs, EventKind, channel, value]
+
+// Sessions (TRANSPORT_AUTO)
+constexpr uint8_t KEY_SEQ            = 41;   // command: session seq (dedupe); probe / PROBE: probe number
+constexpr uint8_t KEY_DUPLICATE      = 42;   // ack: true when the seq had already run
+constexpr uint8_t KEY_ST_ROUTE       = 43;   // status: link status goes out on (AUTO only)
+
+// SCAN ack
+constexpr uint8_t KEY_NETWORKS       = 44;   // array of [ssid, rssi, channel, auth], strongest first
+constexpr uint8_t KEY_SCAN_AGE       = 45;   // ms since the list was taken (absent: no scan yet)
+constexpr uint8_t KEY_SCANNING       = 46;   // a refresh is under way
+constexpr uint8_t KEY_SCAN_TOTAL     = 47;   // networks cached (KEY_NETWORKS may hold fewer)
+
+// HISTORY (command: the query; ack: the rows, HistoryStore.h)
+constexpr uint8_t KEY_HIST_FROM      = 48;   // command: from (< 0: relative to now); ack: time of the first row (nil: no rows)
+constexpr uint8_t KEY_HIST_TO        = 49;   // command: to (≤ 0: relative to now)
+constexpr uint8_t KEY_HIST_RES       = 50;   // command: wanted resolution; ack: seconds per row
+constexpr uint8_t KEY_HIST_ROWS      = 51;   // ack: array of value arrays, nil = nothing recorded
+constexpr uint8_t KEY_HIST_NEXT      = 52;   // ack: the from that continues the range (nil: complete)
+constexpr uint8_t KEY_HIST_NOW       = 53;   // ack: device uptime, s
+
+// OTA begin, after the HISTORY block
+constexpr uint8_t KEY_OTA_SIG        = 54;   // 64 hex digits, see OtaManager.h
+
+// HELLO, after the OTA signature
+constexpr uint8_t KEY_SESSION        = 55;   // client session the seqs count in (SessionManager.h)
+
+constexpr size_t MAX_STATUS_BYTES = 212;   // 192 + KEY_ST_CHANNELS + KEY_ST_ROUTE
+constexpr size_t MAX_ACK_BYTES    = 512;   // id + result + MAX_BATCH results, a SCAN list or HISTORY rows
+
+typedef MsgPackBuffer<MAX_STATUS_BYTES> StatusBuffer;
+typedef MsgPackBuffer<MAX_ACK_BYTES>    AckBuffer;
+typedef MsgPackBuffer<EventBuffer::MAX_BATCH_BYTES> EventsBuffer;
+
+/**
+ * Applies one key/value of a command map to `cmd`.  A value of the
+ * wrong type or out of range is skipped and marks the command invalid;
+ * returns false only when the input is malformed.  KEY_TYPE, KEY_ID
+ * and KEY_COMMANDS are the caller's.
+ */
+bool decodeField(MsgPackReader& r, uint32_t key, Command& cmd);
+
+/**
+ * True when a command of `type` carried the keys it cannot do without
+ * (bit n of `seenKeys` = key n was present), the same ones the JSON
+ * form requires: ssid, transport, trace action, power profile, OTA
+ * action, pattern, probe seq.
+ */
+bool hasRequiredFields(RequestType type, uint64_t seenKeys);
+
+void encodeStatus(MsgPackWriter& w, const DeviceStats& stats, const String& deviceId,
+                  int route = -1);   // TransportMode status is routed on (AUTO), -1 = none
+void encodeProbe(MsgPackWriter& w, uint32_t seq);
+void encodeEvents(MsgPackWriter& w, const BufferedEvent* events, size_t n,
+                  uint32_t now, uint32_t dropped);
+
+// The SCAN fields of an ack (scanFieldCount() map entries); the list
+// holds as many networks as `w` has room for.
+uint8_t scanFieldCount(const WiFiScanCache& scan);
+void    encodeScan(MsgPackWriter& w, const WiFiScanCache& scan, uint32_t now);
+
+// The HISTORY fields of an ack (HISTORY_FIELDS map entries): the rows
+// of `range` that fit in `w`, and where to continue if not all did.
+constexpr uint8_t HISTORY_FIELDS = 5;
+void encodeHistory(MsgPackWriter& w, const HistoryStore& history,
+                   const HistoryStore::Range& range, uint32_t nowMs);
+
+} // namespace wire
+
+#endif // WIRE_PROTOCOL_H
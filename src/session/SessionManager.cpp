@@ -0,0 +1,262 @@
+#include "SessionManager.h"
+#include "../commands/CommandProcessor.h"   // transportName
+#include "../log/Logger.h"
+
+// Rank of a link whose RTT is not measured yet: local Wi-Fi, then BLE
+// (connection interval), then the remote (WAN round trip).
+static constexpr uint32_t DEFAULT_RTT_MS[SessionManager::LINK_COUNT] = { 60, 20, 120 };
+
+// Elapsed ms from `t` to `now`, across the millis() wrap.
+static inline uint32_t since(uint32_t now, uint32_t t) { return now - t; }
+
+SessionManager& SessionManager::getInstance() {
+    static SessionManager inst;
+    return inst;
+}
+
+SessionManager::SessionManager()
+    : autoMode(false)
+    , routed(false)
+    , current(TRANSPORT_BLE)
+    , nextProbeSeq(1)
+    , failing(false)
+    , failStartMs(0)
+    , failedFrom(TRANSPORT_BLE)
+    , useCount(0)
+    , nextPrivate(0)
+    , stats()
+{
+}
+
+// ── Dedupe ───────────────────────────────────────────────────────────
+
+bool SessionManager::isDuplicate(uint32_t session, uint32_t seq, uint8_t& prior) {
+    Window* w = find(session);
+    if (!w || seq > w->highestSeq) return false;
+
+    uint32_t age = w->highestSeq - seq;
+    if (age >= SEQ_RESTART_GAP) {
+        LOG_I(SYS, "[Session] seq %u after %u: client started over\n",
+                   (unsigned)seq, (unsigned)w->highestSeq);
+        w->highestSeq = 0;
+        w->seenBits   = 0;
+        return false;
+    }
+    if (age < SEQ_WINDOW && !((w->seenBits >> age) & 1)) return false;   // late, not seen
+
+    // Too old to know how it went: it is not run again, but not claimed OK either.
+    prior = age < SEQ_WINDOW ? w->results[seq % SEQ_WINDOW] : (uint8_t)CMD_INVALID;
+    ++stats.duplicates;
+    return true;
+}
+
+void SessionManager::remember(uint32_t session, uint32_t seq, uint8_t result) {
+    Window& w = claim(session);
+    if (seq > w.highestSeq) {
+        uint32_t shift = w.highestSeq ? seq - w.highestSeq : SEQ_WINDOW;
+        w.seenBits   = shift >= SEQ_WINDOW ? 0 : w.seenBits << shift;
+        w.seenBits  |= 1;
+        w.highestSeq = seq;
+    } else if (w.highestSeq - seq < SEQ_WINDOW) {
+        w.seenBits |= 1ull << (w.highestSeq - seq);
+    }
+    w.results[seq % SEQ_WINDOW] = result;
+    w.lastUse = ++useCount;
+}
+
+uint32_t SessionManager::privateSession() {
+    nextPrivate = (nextPrivate + 1) & MAX_CLIENT_SESSION;
+    if (!nextPrivate) nextPrivate = 1;
+    return (MAX_CLIENT_SESSION + 1) | nextPrivate;
+}
+
+SessionManager::Window* SessionManager::find(uint32_t session) {
+    for (Window& w : windows) {
+        if (w.session == session) return &w;
+    }
+    return nullptr;
+}
+
+// The session's window, or a new one in a free slot or the least
+// recently used.
+SessionManager::Window& SessionManager::claim(uint32_t session) {
+    Window* w = find(session);
+    if (w) return *w;
+
+    w = &windows[0];
+    for (Window& c : windows) {
+        if (!c.session) { w = &c; break; }
+        if (c.lastUse < w->lastUse) w = &c;
+    }
+    if (w->session) {
+        LOG_D(SYS, "[Session] Window of %08x dropped for %08x\n", (unsigned)w->session, (unsigned)session);
+    }
+    *w         = Window();
+    w->session = session;
+    return *w;
+}
+
+// ── Links ────────────────────────────────────────────────────────────
+
+void SessionManager::update(uint8_t upMask, bool autoOn, uint32_t now) {
+    autoMode = autoOn;
+
+    for (uint8_t i = 0; i < LINK_COUNT; ++i) {
+        TransportMode l  = (TransportMode)i;
+        Link&         k  = links[i];
+        bool          up = upMask & (1u << i);
+
+        if (up && !k.up) {
+            k             = Link();   // a new connection: fresh RTT
+            k.up          = true;
+            k.lastHeardMs = now;
+        } else if (!up && k.up) {
+            k.up      = false;
+            k.probing = false;
+            if (routed && current == l) lose(l, now);
+        } else if (up && routed && current == l && !isHealthy(l, now)) {
+            lose(l, k.silentMs);   // lost since the first probe it left unanswered
+        }
+    }
+
+    choose(now);
+}
+
+void SessionManager::heard(TransportMode link, uint32_t now) {
+    if (link >= LINK_COUNT) return;
+    links[link].lastHeardMs = now;
+    links[link].probing     = false;
+}
+
+void SessionManager::probeReply(TransportMode link, uint32_t seq, uint32_t now) {
+    if (link >= LINK_COUNT) return;
+    Link& k = links[link];
+    if (!seq || seq != k.probeSeq) return;   // stale or not ours
+
+    uint32_t rtt = since(now, k.probeSentMs);
+    rtt          = k.rttMs ? (k.rttMs * 3 + rtt) / 4 : rtt;
+    k.rttMs      = rtt ? rtt : 1;   // 0 would read as "not measured"
+    k.probeSeq   = 0;
+    LOG_D(SYS, "[Session] %s rtt %u ms (avg %u)\n", CommandProcessor::transportName(link),
+               (unsigned)rtt, (unsigned)k.rttMs);
+}
+
+uint8_t SessionManager::probesDue(uint32_t now) const {
+    if (!autoMode) return 0;
+    uint8_t due = 0;
+    for (uint8_t i = 0; i < LINK_COUNT; ++i) {
+        const Link& k = links[i];
+        if (!k.up) continue;
+        // Unanswered: probe again once it has timed out; otherwise
+        // once the link has been quiet for PROBE_MS.
+        uint32_t quiet = since(now, k.lastHeardMs);
+        if (k.probing ? since(now, k.probeSentMs) >= PROBE_TIMEOUT_MS
+                      : quiet >= PROBE_MS && (!k.probeSeq || since(now, k.probeSentMs) >= PROBE_MS)) {
+            due |= 1u << i;
+        }
+    }
+    return due;
+}
+
+uint32_t SessionManager::takeProbe(TransportMode link, uint32_t now) {
+    Link& k = links[link];
+    if (!nextProbeSeq) nextProbeSeq = 1;
+    if (!k.probing) k.silentMs = now;
+    k.probing     = true;
+    k.probeSeq    = nextProbeSeq++;
+    k.probeSentMs = now;
+    return k.probeSeq;
+}
+
+bool SessionManager::isHealthy(TransportMode link, uint32_t now) const {
+    const Link& k = links[link];
+    return k.up && !(k.probing && since(now, k.silentMs) >= PROBE_TIMEOUT_MS);
+}
+
+// ── Route ────────────────────────────────────────────────────────────
+
+uint32_t SessionManager::score(TransportMode link) const {
+    return links[link].rttMs ? links[link].rttMs : DEFAULT_RTT_MS[link];
+}
+
+void SessionManager::choose(uint32_t now) {
+    if (!autoMode) {
+        routed  = false;
+        failing = false;
+        return;
+    }
+
+    int best = -1;
+    for (uint8_t i = 0; i < LINK_COUNT; ++i) {
+        if (!isHealthy((TransportMode)i, now)) continue;
+        if (best < 0 || score((TransportMode)i) < score((TransportMode)best)) best = i;
+    }
+    if (best < 0) {
+        routed = false;
+        return;
+    }
+
+    // Hysteresis: stay on a healthy route unless the other is 25 % faster.
+    TransportMode next = (TransportMode)best;
+    if (routed && next == current) return;
+    if (routed && isHealthy(current, now) && score(next) * 4 > score(current) * 3) return;
+
+    LOG_I(SYS, "[Session] Route %s → %s (%u ms)\n",
+               routed ? CommandProcessor::transportName(current) : "-",
+               CommandProcessor::transportName(next), (unsigned)score(next));
+    current = next;
+    routed  = true;
+}
+
+void SessionManager::lose(TransportMode link, uint32_t sinceMs) {
+    routed = false;
+    if (failing) return;   // still timing the first loss
+    failing     = true;
+    failStartMs = sinceMs;
+    failedFrom  = link;
+    LOG_W(SYS, "[Session] Route %s lost\n", CommandProcessor::transportName(link));
+}
+
+void SessionManager::delivered(TransportMode link, uint32_t now) {
+    if (!failing || !routed || link != current) return;
+
+    uint32_t ms = since(now, failStartMs);
+    failing = false;
+    ++stats.failovers;
+    stats.lastFailoverMs = ms;
+    if (ms > stats.maxFailoverMs) stats.maxFailoverMs = ms;
+
+    if (ms > FAILOVER_TARGET_MS) {
+        ++stats.overTarget;
+        LOG_W(SYS, "[Session] Failover %s → %s took %u ms (target %u)\n",
+                   CommandProcessor::transportName(failedFrom), CommandProcessor::transportName(link),
+                   (unsigned)ms, (unsigned)FAILOVER_TARGET_MS);
+    } else {
+        LOG_I(SYS, "[Session] Failover %s → %s in %u ms\n",
+                   CommandProcessor::transportName(failedFrom), CommandProcessor::transportName(link),
+                   (unsigned)ms);
+    }
+}
+
+uint32_t SessionManager::msUntilNextWork(uint32_t now) const {
+    if (!autoMode) return UINT32_MAX;
+
+    uint32_t wait = UINT32_MAX;
+    for (uint8_t i = 0; i < LINK_COUNT; ++i) {
+        const Link& k = links[i];
+        if (!k.up) continue;
+        uint32_t left;
+        if (k.probing) {   // the next probe and the health check coincide
+            uint32_t out = since(now, k.probeSentMs);
+            left = out >= PROBE_TIMEOUT_MS ? 0 : PROBE_TIMEOUT_MS - out;
+        } else {
+            uint32_t quiet = since(now, k.lastHeardMs);
+            uint32_t gap   = k.probeSeq ? since(now, k.probeSentMs) : PROBE_MS;
+            uint32_t q     = quiet >= PROBE_MS ? 0 : PROBE_MS - quiet;
+            uint32_t g     = gap   >= PROBE_MS ? 0 : PROBE_MS - gap;
+            left = q > g ? q : g;
+        }
+        if (left < wait) wait = left;
+    }
+    return wait;
+}
@@ -0,0 +1,169 @@
+#ifndef SESSION_MANAGER_H
+#define SESSION_MANAGER_H
+
+#include <Arduino.h>
+#include "../../include/types/device_stats.h"
+
+// Link probing in TRANSPORT_AUTO and the failover budget it must meet:
+// a link silent for PROBE_MS is probed, and one that leaves a probe
+// unanswered for PROBE_TIMEOUT_MS stops being routed to.
+#ifndef OPENVIBE_PROBE_MS
+#define OPENVIBE_PROBE_MS           250
+#endif
+#ifndef OPENVIBE_PROBE_TIMEOUT_MS
+#define OPENVIBE_PROBE_TIMEOUT_MS   500
+#endif
+#ifndef OPENVIBE_FAILOVER_TARGET_MS
+#define OPENVIBE_FAILOVER_TARGET_MS 1000
+#endif
+
+// Client sessions whose dedupe windows are kept at once; the least
+// recently used is dropped for a new one.
+#ifndef OPENVIBE_SESSION_SLOTS
+#define OPENVIBE_SESSION_SLOTS      8
+#endif
+
+/**
+ * One client session over every link at once (TRANSPORT_AUTO).
+ *
+ * In AUTO the BLE service, the local WebSocket server and the REMOTE
+ * client all stay up; a client may hold any of them and send the same
+ * command down several.  This class keeps the per-link bookkeeping:
+ *
+ *  - Dedupe: a command with a "seq" runs once, on whichever link
+ *    delivers it first.  Seqs are counted per client session: a
+ *    client names its session (1 … MAX_CLIENT_SESSION) in HELLO on
+ *    each link it opens, and every link so named shares one window.
+ *    A connection that has not named one gets a private window.  The
+ *    last SEQ_WINDOW numbers are remembered with their result, so a
+ *    copy that arrives later (or a resend after a failover) is
+ *    answered, not re-run.  Anything older than the window counts as
+ *    a duplicate, unless it is SEQ_RESTART_GAP or more behind: that
+ *    is a client counting from scratch.  A duplicate whose result is
+ *    no longer known is answered CMD_INVALID, never OK.  SESSION_SLOTS
+ *    windows are kept; connecting does not clear one.  This applies
+ *    in every mode.
+ *
+ *  - Health and latency: any inbound frame proves a link alive.  A
+ *    link silent for PROBE_MS gets {"type":"probe","seq":n}, which the
+ *    client echoes as {"requestType":"PROBE","seq":n}; the round trip
+ *    feeds the link's RTT estimate.  A probe left unanswered for
+ *    PROBE_TIMEOUT_MS makes the link unhealthy until it is heard again.
+ *
+ *  - Route: status goes out on the healthy link with the lowest RTT
+ *    (links not measured yet rank by a per-transport default).  A
+ *    healthy route is only left for one at least 25 % faster.
+ *
+ *  - Failover: when the route is lost the clock starts (at the
+ *    disconnect, or at the unanswered probe) and stops at the first
+ *    status delivered on the new route.  Each failover is logged; one
+ *    over OPENVIBE_FAILOVER_TARGET_MS is a warning and is counted.
+ *
+ * Links are indexed by TransportMode (BLE, WIFI, REMOTE), like the
+ * telemetry channels.  Loop task only.
+ */
+class SessionManager {
+public:
+    static constexpr uint8_t  LINK_COUNT         = 3;
+    static constexpr uint32_t PROBE_MS           = OPENVIBE_PROBE_MS;
+    static constexpr uint32_t PROBE_TIMEOUT_MS   = OPENVIBE_PROBE_TIMEOUT_MS;
+    static constexpr uint32_t FAILOVER_TARGET_MS = OPENVIBE_FAILOVER_TARGET_MS;
+    static constexpr uint8_t  SEQ_WINDOW         = 64;
+    static constexpr uint32_t SEQ_RESTART_GAP    = 1024;   // this far back: a client that started over
+    static constexpr uint8_t  SESSION_SLOTS      = OPENVIBE_SESSION_SLOTS;
+    static constexpr uint32_t MAX_CLIENT_SESSION = 0x7FFFFFFF;   // above: ids the device hands out
+
+    static_assert(PROBE_MS + PROBE_TIMEOUT_MS < FAILOVER_TARGET_MS,
+                  "a silent link must be detected within the failover target");
+
+    struct Link {
+        bool     up          = false;
+        bool     probing     = false;   // a probe is outstanding
+        uint32_t probeSeq    = 0;       // last probe sent, 0 once answered
+        uint32_t probeSentMs = 0;
+        uint32_t silentMs    = 0;       // first probe of the unanswered run
+        uint32_t lastHeardMs = 0;
+        uint32_t rttMs       = 0;       // smoothed, 0 = not measured
+    };
+
+    struct Counters {
+        uint32_t duplicates;       // commands not re-run
+        uint32_t failovers;
+        uint32_t lastFailoverMs;
+        uint32_t maxFailoverMs;
+        uint32_t overTarget;       // failovers slower than the target
+    };
+
+    static SessionManager& getInstance();
+
+    // ── Dedupe (every mode) ──────────────────────────────────────────
+    // True if `seq` already ran in `session` (or is too old to tell);
+    // `prior` is its result when still known, CMD_INVALID otherwise.
+    bool isDuplicate(uint32_t session, uint32_t seq, uint8_t& prior);
+    void remember(uint32_t session, uint32_t seq, uint8_t result);
+    // A session id above MAX_CLIENT_SESSION that no client can name,
+    // for a connection that has not named its own.
+    uint32_t privateSession();
+
+    // ── Links ────────────────────────────────────────────────────────
+    // `upMask` (bit = TransportMode) is the links a frame can go out
+    // on right now; called once per loop pass.
+    void update(uint8_t upMask, bool autoMode, uint32_t now);
+    void heard(TransportMode link, uint32_t now);
+    void probeReply(TransportMode link, uint32_t seq, uint32_t now);
+
+    // Links a probe should go out on now; takeProbe() marks it sent.
+    uint8_t  probesDue(uint32_t now) const;
+    uint32_t takeProbe(TransportMode link, uint32_t now);
+
+    // ── Route ────────────────────────────────────────────────────────
+    bool hasRoute() const { return routed; }
+    TransportMode route() const { return current; }
+    void delivered(TransportMode link, uint32_t now);   // status went out on `link`
+
+    uint32_t msUntilNextWork(uint32_t now) const;
+
+    bool            isHealthy(TransportMode link, uint32_t now) const;
+    const Link&     link(TransportMode l) const { return links[l]; }
+    const Counters& counters() const            { return stats; }
+
+private:
+    SessionManager();
+    SessionManager(const SessionManager&)            = delete;
+    SessionManager& operator=(const SessionManager&) = delete;
+
+    Link          links[LINK_COUNT];
+    bool          autoMode;
+    bool          routed;
+    TransportMode current;
+    uint32_t      nextProbeSeq;
+
+    // Failover in progress
+    bool          failing;
+    uint32_t      failStartMs;
+    TransportMode failedFrom;
+
+    // Dedupe window of one session: bit n of seenBits = highestSeq - n
+    // ran.  highestSeq 0 is an empty window (seqs start at 1).
+    struct Window {
+        uint32_t session    = 0;   // 0 = free slot
+        uint32_t lastUse    = 0;   // useCount when last written
+        uint32_t highestSeq = 0;
+        uint64_t seenBits   = 0;
+        uint8_t  results[SEQ_WINDOW] = {};   // by seq % SEQ_WINDOW
+    };
+
+    Window        windows[SESSION_SLOTS];
+    uint32_t      useCount;
+    uint32_t      nextPrivate;
+
+    Counters      stats;
+
+    Window*  find(uint32_t session);
+    Window&  claim(uint32_t session);
+    uint32_t score(TransportMode link) const;
+    void     choose(uint32_t now);
+    void     lose(TransportMode link, uint32_t since);
+};
+
+#endif // SESSION_MANAGER_H
@@ -0,0 +1,213 @@
+#include "EventBuffer.h"
+#include "../log/Logger.h"
+#include <ArduinoJson.h>
+
+static_assert(EventBuffer::CAPACITY >= 2, "OPENVIBE_EVENT_CAPACITY too small");
+static_assert(EventBuffer::BATCH > 0, "OPENVIBE_EVENT_BATCH must be positive");
+
+EventBuffer::EventBuffer()
+    : head(0)
+    , count(0)
+    , spillBytes(0)
+    , spillRead(0)
+    , peekedSpill(false)
+    , stats()
+    , replaying(false)
+    , replayStart(0)
+    , replayEvents(0)
+    , replayBytes(0)
+    , lastBatchMs(0)
+    , tracking(false)
+    , battery(0)
+    , charging(false)
+    , ble(false)
+    , wifi(false)
+    , transport(TRANSPORT_BLE)
+{
+    memset(levels, 0, sizeof(levels));
+}
+
+void EventBuffer::begin() {
+    if (!SPILL_CAPACITY) return;
+    size_t stale = hal::fileSize(SPILL_PATH) / sizeof(BufferedEvent);
+    if (!stale) return;
+    hal::fileRemove(SPILL_PATH);
+    LOG_W(TLM, "[Events] Discarded %u spilled event(s) from the previous boot\n", (unsigned)stale);
+}
+
+// ── Recording ────────────────────────────────────────────────────────
+
+void EventBuffer::track(const DeviceStats& s, uint32_t now) {
+    if (!tracking) {
+        tracking  = true;
+        replaying = false;   // an interrupted replay restarts its count
+        memcpy(levels, s.levels, sizeof(levels));
+        battery   = s.battery;
+        charging  = s.isCharging;
+        ble       = s.isBluetoothConnected;
+        wifi      = s.isWifiConnected;
+        transport = s.transport;
+        push(now, EVENT_REMOTE, 0, 0);
+        return;
+    }
+
+    for (uint8_t i = 0; i < s.channelCount && i < MAX_MOTOR_CHANNELS; ++i) {
+        if (s.levels[i] == levels[i]) continue;
+        levels[i] = s.levels[i];
+        push(now, EVENT_INTENSITY, i, levels[i]);
+    }
+    if (abs(s.battery - battery) >= BATTERY_STEP) {
+        battery = s.battery;
+        push(now, EVENT_BATTERY, 0, (int16_t)battery);
+    }
+    if (s.isCharging != charging) {
+        charging = s.isCharging;
+        push(now, EVENT_CHARGING, 0, charging);
+    }
+    if (s.isBluetoothConnected != ble) {
+        ble = s.isBluetoothConnected;
+        push(now, EVENT_BLE, 0, ble);
+    }
+    if (s.isWifiConnected != wifi) {
+        wifi = s.isWifiConnected;
+        push(now, EVENT_WIFI, 0, wifi);
+    }
+    if (s.transport != transport) {
+        transport = s.transport;
+        push(now, EVENT_TRANSPORT, 0, transport);
+    }
+}
+
+void EventBuffer::push(uint32_t now, EventKind kind, uint8_t channel, int16_t value) {
+    if (count == CAPACITY) {
+        spillOldestHalf();
+        if (count == CAPACITY) {   // no room in flash either
+            head = (head + 1) % CAPACITY;
+            --count;
+            ++stats.dropped;
+        }
+    }
+
+    BufferedEvent& e = ring[(head + count) % CAPACITY];
+    e.timeMs  = now;
+    e.kind    = kind;
+    e.channel = channel;
+    e.value   = value;
+    ++count;
+    ++stats.recorded;
+}
+
+// Appends the ring's older half to the spill file (two writes when it
+// wraps).  Nothing moves unless all of it fits under the cap.
+void EventBuffer::spillOldestHalf() {
+    size_t n = CAPACITY / 2;
+    if (spillBytes + n * sizeof(BufferedEvent) > SPILL_CAPACITY * sizeof(BufferedEvent)) return;
+
+    size_t first = CAPACITY - head < n ? CAPACITY - head : n;
+    bool   ok    = hal::fileAppend(SPILL_PATH, (const uint8_t*)&ring[head], first * sizeof(BufferedEvent));
+    if (ok && first < n) {
+        ok = hal::fileAppend(SPILL_PATH, (const uint8_t*)&ring[0], (n - first) * sizeof(BufferedEvent));
+    }
+    if (!ok) {
+        // A partial append leaves the file out of step: start it over.
+        LOG_E(TLM, "[Events] Spill to %s failed\n", SPILL_PATH);
+        hal::fileRemove(SPILL_PATH);
+        stats.dropped += (spillBytes - spillRead) / sizeof(BufferedEvent);
+        spillBytes = spillRead = 0;
+        return;
+    }
+
+    spillBytes    += n * sizeof(BufferedEvent);
+    head           = (head + n) % CAPACITY;
+    count         -= n;
+    stats.spilled += n;
+}
+
+// ── Replay ───────────────────────────────────────────────────────────
+
+size_t EventBuffer::pending() const {
+    return count + spillCount();
+}
+
+uint32_t EventBuffer::msUntilBatch(uint32_t now) const {
+    if (!pending()) return UINT32_MAX;
+    if (!replaying) return 0;
+    uint32_t elapsed = now - lastBatchMs;
+    return elapsed >= FLUSH_MS ? 0 : FLUSH_MS - elapsed;
+}
+
+size_t EventBuffer::peek(BufferedEvent* out, size_t max) {
+    peekedSpill = spillRead < spillBytes;
+    if (peekedSpill) {
+        size_t want = spillCount() < max ? spillCount() : max;
+        size_t got  = hal::fileRead(SPILL_PATH, spillRead, (uint8_t*)out, want * sizeof(BufferedEvent));
+        if (got == want * sizeof(BufferedEvent)) return want;
+
+        // Unreadable: count what is left there as lost, go on with RAM.
+        LOG_E(TLM, "[Events] Spill file unreadable, %u event(s) lost\n", (unsigned)spillCount());
+        stats.dropped += spillCount();
+        hal::fileRemove(SPILL_PATH);
+        spillBytes = spillRead = 0;
+        peekedSpill = false;
+    }
+
+    size_t n = count < max ? count : max;
+    for (size_t i = 0; i < n; ++i) out[i] = ring[(head + i) % CAPACITY];
+    return n;
+}
+
+void EventBuffer::consume(size_t n, size_t bytes, uint32_t now) {
+    if (!replaying) {
+        replaying    = true;
+        replayStart  = now;
+        replayEvents = 0;
+        replayBytes  = 0;
+    }
+
+    if (peekedSpill) {
+        spillRead += n * sizeof(BufferedEvent);
+        if (spillRead >= spillBytes) {
+            hal::fileRemove(SPILL_PATH);
+            spillBytes = spillRead = 0;
+        }
+    } else {
+        if (n > count) n = count;
+        head   = (head + n) % CAPACITY;
+        count -= n;
+    }
+
+    stats.sent   += n;
+    replayEvents += n;
+    replayBytes  += bytes;
+    lastBatchMs   = now;
+    if (pending()) return;
+
+    // Drained: report throughput over the whole replay.
+    replaying        = false;
+    stats.lastEvents = replayEvents;
+    stats.lastBytes  = replayBytes;
+    stats.lastMs     = now - replayStart;
+    uint32_t ms      = stats.lastMs ? stats.lastMs : 1;
+    LOG_I(TLM, "[Events] Replayed %u event(s), %u bytes in %u ms (%u events/s), %u dropped\n",
+               (unsigned)replayEvents, (unsigned)replayBytes, (unsigned)stats.lastMs,
+               (unsigned)((uint64_t)replayEvents * 1000 / ms), (unsigned)stats.dropped);
+}
+
+String EventBuffer::encodeJson(const BufferedEvent* events, size_t n, uint32_t now, uint32_t dropped) {
+    JsonDocument doc;
+    doc["type"]    = "events";
+    doc["now"]     = now;
+    doc["dropped"] = dropped;
+    JsonArray list = doc["events"].to<JsonArray>();
+    for (size_t i = 0; i < n; ++i) {
+        JsonArray e = list.add<JsonArray>();
+        e.add(events[i].timeMs);
+        e.add(events[i].kind);
+        e.add(events[i].channel);
+        e.add(events[i].value);
+    }
+
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
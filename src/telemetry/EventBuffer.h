@@ -0,0 +1,134 @@
+#ifndef EVENT_BUFFER_H
+#define EVENT_BUFFER_H
+
+#include <Arduino.h>
+#include "../../include/types/device_stats.h"
+#include "../hal/Hal.h"
+
+// RAM ring, flash overflow (0 = RAM only) and the replay rate once the
+// remote is back: at most BATCH events per frame, one frame per FLUSH_MS.
+#ifndef OPENVIBE_EVENT_CAPACITY
+#define OPENVIBE_EVENT_CAPACITY    256
+#endif
+#ifndef OPENVIBE_EVENT_SPILL_BYTES
+#define OPENVIBE_EVENT_SPILL_BYTES 8192
+#endif
+#ifndef OPENVIBE_EVENT_BATCH
+#define OPENVIBE_EVENT_BATCH       32
+#endif
+#ifndef OPENVIBE_EVENT_FLUSH_MS
+#define OPENVIBE_EVENT_FLUSH_MS    50
+#endif
+
+/** What changed; values go on the wire. */
+enum EventKind : uint8_t {
+    EVENT_REMOTE    = 0,   // value 0: remote lost, recording starts
+    EVENT_INTENSITY = 1,   // channel, value = level 0–100
+    EVENT_BATTERY   = 2,   // value = percent
+    EVENT_CHARGING  = 3,   // value 0 / 1
+    EVENT_BLE       = 4,   // value 0 / 1 (central connected)
+    EVENT_WIFI      = 5,   // value 0 / 1 (station connected)
+    EVENT_TRANSPORT = 6    // value = TransportMode
+};
+
+/** One buffered event; also the record layout of the spill file. */
+struct __attribute__((packed)) BufferedEvent {
+    uint32_t timeMs;    // hal::millis() when it was seen
+    uint8_t  kind;      // EventKind
+    uint8_t  channel;   // motor channel (EVENT_INTENSITY), else 0
+    int16_t  value;
+};
+static_assert(sizeof(BufferedEvent) == 8, "event record layout");
+
+/**
+ * Outbound store for the REMOTE transport while its server is away.
+ *
+ * DeviceContext calls track() on every pass the remote is down; it
+ * diffs DeviceStats against the last pass and appends what changed
+ * (levels per channel, battery in 2 % steps, charging, links,
+ * transport) to a ring in RAM.  When the ring is full its older half
+ * is appended to SPILL_PATH, as long as that stays under
+ * OPENVIBE_EVENT_SPILL_BYTES; past that the oldest event is dropped
+ * and counted.  Spilled events are from this boot only — begin()
+ * discards the file, since their timestamps are uptime.
+ *
+ * Once the remote is back the events go out oldest first (the spill
+ * file, then the ring), BATCH at a time and no more than one batch per
+ * FLUSH_MS, so status pushes and command acks interleave with the
+ * replay.  A batch is only consumed after it was sent.
+ */
+class EventBuffer {
+public:
+    static constexpr size_t      CAPACITY       = OPENVIBE_EVENT_CAPACITY;
+    static constexpr size_t      SPILL_CAPACITY = OPENVIBE_EVENT_SPILL_BYTES / sizeof(BufferedEvent);
+    static constexpr size_t      BATCH          = OPENVIBE_EVENT_BATCH;
+    static constexpr uint32_t    FLUSH_MS       = OPENVIBE_EVENT_FLUSH_MS;
+    static constexpr int         BATTERY_STEP   = 2;   // percent
+    static constexpr const char* SPILL_PATH     = "/events.bin";
+
+    // Batch encodings: {"type":"events","now":…,"dropped":…,"events":[[t,k,c,v],…]}
+    // and MSG_EVENTS (see WireProtocol.h); a MessagePack event is at most 13 bytes.
+    static constexpr size_t MAX_BATCH_BYTES = 24 + BATCH * 13;
+
+    /** Totals since boot, and the last completed replay. */
+    struct Counters {
+        uint32_t recorded;     // events appended
+        uint32_t spilled;      // events moved to flash
+        uint32_t dropped;      // events lost to a full store
+        uint32_t sent;         // events delivered
+        uint32_t lastEvents;   // last replay: events, bytes, duration
+        uint32_t lastBytes;
+        uint32_t lastMs;
+    };
+
+    EventBuffer();
+    void begin();
+
+    // ── Recording (remote down) ──────────────────────────────────────
+    // The first call after stopTracking() only takes the baseline and
+    // records EVENT_REMOTE.
+    void track(const DeviceStats& stats, uint32_t now);
+    void stopTracking() { tracking = false; }
+
+    // ── Replay (remote up) ───────────────────────────────────────────
+    size_t   pending() const;                     // RAM + unsent spill
+    uint32_t msUntilBatch(uint32_t now) const;    // UINT32_MAX = nothing pending
+    size_t   peek(BufferedEvent* out, size_t max);  // oldest first, at most one source
+    void     consume(size_t n, size_t bytes, uint32_t now);
+
+    static String encodeJson(const BufferedEvent* events, size_t n, uint32_t now, uint32_t dropped);
+
+    size_t          ramCount() const   { return count; }
+    size_t          spillCount() const { return (spillBytes - spillRead) / sizeof(BufferedEvent); }
+    const Counters& counters() const   { return stats; }
+
+private:
+    BufferedEvent ring[CAPACITY];
+    size_t        head;          // index of the oldest event
+    size_t        count;
+    size_t        spillBytes;    // file size
+    size_t        spillRead;     // bytes of it already sent
+    bool          peekedSpill;   // source of the last peek()
+    Counters      stats;
+
+    // Replay in progress (counters for the throughput report)
+    bool          replaying;
+    uint32_t      replayStart;
+    uint32_t      replayEvents;
+    uint32_t      replayBytes;
+    uint32_t      lastBatchMs;
+
+    // Baseline for track()
+    bool          tracking;
+    uint8_t       levels[MAX_MOTOR_CHANNELS];
+    int           battery;
+    bool          charging;
+    bool          ble;
+    bool          wifi;
+    TransportMode transport;
+
+    void push(uint32_t now, EventKind kind, uint8_t channel, int16_t value);
+    void spillOldestHalf();
+};
+
+#endif // EVENT_BUFFER_H
@@ -0,0 +1,238 @@
+#include "HistoryStore.h"
+
+static_assert(HistoryStore::RAW_SLOTS > 0 && HistoryStore::MID_SLOTS > 0 &&
+              HistoryStore::LONG_SLOTS > 0, "history tiers need slots");
+static_assert(HistoryStore::MID_S > 1 && HistoryStore::LONG_S > HistoryStore::MID_S,
+              "history tiers must get coarser");
+
+HistoryStore::HistoryStore()
+    : rawNewest(0)
+    , rawAny(false)
+    , clockMs(0)
+    , lastMs(0)
+{
+    for (Sample& s : raw)      s.battery    = EMPTY;
+    for (Bucket& b : mid)      b.batteryMin = EMPTY;
+    for (Bucket& b : longTerm) b.batteryMin = EMPTY;
+
+    AggTier defaults[TIERS - 1] = {
+        { mid,      MID_SLOTS,  MID_S,  0, false, false, Accumulator() },
+        { longTerm, LONG_SLOTS, LONG_S, 0, false, false, Accumulator() },
+    };
+    memcpy(tiers, defaults, sizeof(tiers));
+}
+
+// ── Clock ────────────────────────────────────────────────────────────
+
+void HistoryStore::tick(uint32_t nowMs) {
+    clockMs += nowMs - lastMs;
+    lastMs   = nowMs;
+}
+
+uint32_t HistoryStore::uptimeS(uint32_t nowMs) const {
+    return (uint32_t)((clockMs + (nowMs - lastMs)) / 1000);
+}
+
+uint32_t HistoryStore::periodS(uint8_t tier) {
+    return tier == 0 ? 1 : tier == 1 ? MID_S : LONG_S;
+}
+
+// ── Recording ────────────────────────────────────────────────────────
+
+uint32_t HistoryStore::msUntilSample(uint32_t nowMs) const {
+    if (!rawAny) return 0;
+    uint64_t now  = clockMs + (nowMs - lastMs);
+    uint64_t next = (uint64_t)(rawNewest + 1) * 1000;
+    return now >= next ? 0 : (uint32_t)(next - now);
+}
+
+void HistoryStore::record(const Sample& s, uint32_t nowMs) {
+    tick(nowMs);
+    uint32_t second = uptimeS(nowMs);
+    if (rawAny && second <= rawNewest) return;
+
+    // Seconds the loop missed stay empty.
+    if (rawAny) {
+        uint32_t gap = second - rawNewest - 1;
+        for (uint32_t i = 1; i <= gap && i <= RAW_SLOTS; ++i) {
+            raw[(rawNewest + i) % RAW_SLOTS].battery = EMPTY;
+        }
+    }
+    raw[second % RAW_SLOTS] = s;
+    rawNewest = second;
+    rawAny    = true;
+
+    for (AggTier& t : tiers) add(t, second, s);
+}
+
+void HistoryStore::add(AggTier& t, uint32_t second, const Sample& s) {
+    uint32_t bucket = second / t.periodS;
+    if (t.open && bucket != t.acc.bucket) close(t);
+
+    Accumulator& a = t.acc;
+    if (!t.open) {
+        a              = Accumulator();
+        a.bucket       = bucket;
+        a.b.levelMin   = 0xFF;
+        a.b.batteryMin = 0xFF;
+        a.b.rssiMax    = -128;
+        a.b.linksAll   = 0xFF;
+        t.open         = true;
+    }
+
+    ++a.samples;
+    a.levelSum   += s.level;
+    a.batterySum += s.battery;
+    a.b.levelMin    = min(a.b.levelMin, s.level);
+    a.b.levelMax    = max(a.b.levelMax, s.level);
+    a.b.batteryMin  = min(a.b.batteryMin, s.battery);
+    a.b.batteryMax  = max(a.b.batteryMax, s.battery);
+    a.b.linksAll   &= s.links;
+    a.b.linksAny   |= s.links;
+    if (s.rssi) {
+        a.b.rssiMin = a.rssiSamples ? min(a.b.rssiMin, s.rssi) : s.rssi;
+        a.b.rssiMax = max(a.b.rssiMax, s.rssi);
+        a.rssiSum  += s.rssi;
+        ++a.rssiSamples;
+    }
+}
+
+// The bucket so far, averages rounded to nearest.
+void HistoryStore::finish(const Accumulator& a, Bucket& b) {
+    b            = a.b;
+    b.levelAvg   = (uint8_t)((a.levelSum + a.samples / 2) / a.samples);
+    b.batteryAvg = (uint8_t)((a.batterySum + a.samples / 2) / a.samples);
+    if (a.rssiSamples) {
+        b.rssiAvg = (int8_t)((a.rssiSum - a.rssiSamples / 2) / (int32_t)a.rssiSamples);
+    } else {
+        b.rssiMin = b.rssiAvg = b.rssiMax = 0;
+    }
+}
+
+void HistoryStore::close(AggTier& t) {
+    Accumulator& a = t.acc;
+    Bucket       b;
+    finish(a, b);
+
+    // Buckets with no sample at all stay empty.
+    if (t.closedAny) {
+        uint32_t gap = a.bucket - t.newest - 1;
+        for (uint32_t i = 1; i <= gap && i <= t.slots; ++i) {
+            t.ring[(t.newest + i) % t.slots].batteryMin = EMPTY;
+        }
+    }
+    t.ring[a.bucket % t.slots] = b;
+    t.newest    = a.bucket;
+    t.closedAny = true;
+    t.open      = false;
+}
+
+// ── Queries ──────────────────────────────────────────────────────────
+
+uint32_t HistoryStore::oldest(uint8_t tier) const {
+    if (tier == 0) return rawAny && rawNewest >= RAW_SLOTS ? rawNewest - RAW_SLOTS + 1 : 0;
+    const AggTier& t = tiers[tier - 1];
+    if (t.closedAny) return t.newest >= t.slots ? t.newest - t.slots + 1 : 0;
+    return t.open ? t.acc.bucket : 0;
+}
+
+bool HistoryStore::newest(uint8_t tier, uint32_t& out) const {
+    if (tier == 0) {
+        out = rawNewest;
+        return rawAny;
+    }
+    const AggTier& t = tiers[tier - 1];
+    out = t.open ? t.acc.bucket : t.newest;
+    return t.open || t.closedAny;
+}
+
+bool HistoryStore::resolve(const Query& q, uint32_t nowMs, Range& out) const {
+    int64_t  now  = uptimeS(nowMs);
+    int64_t  from = q.from >= 0 ? q.from : max<int64_t>(0, now + q.from);
+    int64_t  to   = q.to   > 0 ? q.to   : max<int64_t>(0, now + q.to);
+    if (from > to) return false;
+
+    uint8_t pick = TIERS;
+    for (uint8_t t = 0; t < TIERS; ++t) {
+        if (periodS(t) < q.res) continue;
+        pick = t;
+        if ((int64_t)oldest(t) * periodS(t) <= from) break;   // still holds `from`
+    }
+    if (pick == TIERS) pick = TIERS - 1;   // coarser than any tier
+
+    uint32_t p = periodS(pick);
+    uint32_t last;
+    out.tier  = pick;
+    out.first = max<uint32_t>((uint32_t)(from / p), oldest(pick));
+    out.last  = (uint32_t)(to / p);
+    out.empty = !newest(pick, last) || out.first > min(out.last, last);
+    if (!out.empty) out.last = min(out.last, last);
+    return true;
+}
+
+void HistoryStore::row(const Range& r, uint32_t bucket, Row& out) const {
+    out.count = 0;
+
+    if (r.tier == 0) {
+        if (!rawAny || bucket > rawNewest || bucket < oldest(0)) return;
+        const Sample& s = raw[bucket % RAW_SLOTS];
+        if (s.battery == EMPTY) return;
+        out.count     = 4;
+        out.values[0] = s.level;
+        out.values[1] = s.battery;
+        out.values[2] = s.rssi;
+        out.values[3] = s.links;
+        return;
+    }
+
+    const AggTier& t = tiers[r.tier - 1];
+    Bucket         b;
+    if (t.open && bucket == t.acc.bucket) {
+        finish(t.acc, b);   // still filling: what it holds so far
+    } else if (t.closedAny && bucket <= t.newest && bucket >= oldest(r.tier)) {
+        b = t.ring[bucket % t.slots];
+        if (b.batteryMin == EMPTY) return;
+    } else {
+        return;
+    }
+
+    const int16_t v[ROW_VALUES] = {
+        b.levelMin,   b.levelAvg,   b.levelMax,
+        b.batteryMin, b.batteryAvg, b.batteryMax,
+        b.rssiMin,    b.rssiAvg,    b.rssiMax,
+        b.linksAll,   b.linksAny
+    };
+    memcpy(out.values, v, sizeof(v));
+    out.count = ROW_VALUES;
+}
+
+void HistoryStore::toJson(JsonObject out, const Range& r, uint32_t nowMs, size_t maxBytes) const {
+    uint32_t p = periodS(r.tier);
+    out["now"] = uptimeS(nowMs);
+    out["res"] = p;
+    if (!r.empty) out["from"] = r.first * p;
+
+    JsonArray rows = out["rows"].to<JsonArray>();
+    if (r.empty) return;
+
+    static constexpr size_t NEXT_BYTES = 20;   // ,"next":4294967295
+    Row row;
+    for (uint32_t b = r.first; b <= r.last; ++b) {
+        if (rows.size() == MAX_ROWS) {
+            out["next"] = b * p;
+            return;
+        }
+        this->row(r, b, row);
+        if (!row.count) {
+            rows.add<JsonVariant>();   // null: nothing recorded
+        } else {
+            JsonArray values = rows.add<JsonArray>();
+            for (uint8_t i = 0; i < row.count; ++i) values.add(row.values[i]);
+        }
+        if (maxBytes != SIZE_MAX && measureJson(out) + NEXT_BYTES > maxBytes) {
+            rows.remove(rows.size() - 1);
+            out["next"] = b * p;
+            return;
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Ring sizes: raw 1 s samples, then min / avg / max over MID_S and
+// LONG_S buckets.  Defaults keep 5 min, 1 h and 24 h in about 8 KB.
+#ifndef OPENVIBE_HISTORY_RAW_SLOTS
+#define OPENVIBE_HISTORY_RAW_SLOTS  300
+#endif
+#ifndef OPENVIBE_HISTORY_MID_S
+#define OPENVIBE_HISTORY_MID_S      10
+#endif
+#ifndef OPENVIBE_HISTORY_MID_SLOTS
+#define OPENVIBE_HISTORY_MID_SLOTS  360
+#endif
+#ifndef OPENVIBE_HISTORY_LONG_S
+#define OPENVIBE_HISTORY_LONG_S     300
+#endif
+#ifndef OPENVIBE_HISTORY_LONG_SLOTS
+#define OPENVIBE_HISTORY_LONG_SLOTS 288
+#endif
+// Rows per reply; a longer range is paged with "next".
+#ifndef OPENVIBE_HISTORY_MAX_ROWS
+#define OPENVIBE_HISTORY_MAX_ROWS   120
+#endif
+
+/**
+ * Fixed-memory time series of what the status reports, so a dashboard
+ * asks once for a range instead of polling /status.
+ *
+ * DeviceContext records one Sample per second: channel 0's level,
+ * battery %, Wi-Fi RSSI (0 while not associated) and the links that are
+ * up (bit = TransportMode: BLE central, Wi-Fi station, remote server).
+ * Three tiers keep it:
+ *
+ *   tier 0   1 s        RAW_SLOTS samples              [level, battery, rssi, links]
+ *   tier 1   MID_S      MID_SLOTS buckets              [lvMin, lvAvg, lvMax,
+ *   tier 2   LONG_S     LONG_SLOTS buckets              batMin, batAvg, batMax,
+ *                                                       rssiMin, rssiAvg, rssiMax,
+ *                                                       linksAll, linksAny]
+ *
+ * Every tier is fed from the raw samples, so averages are exact.  The
+ * RSSI figures only cover seconds with a link; linksAll are the links
+ * up the whole bucket, linksAny those up at some point.  The bucket
+ * still filling is reported too.  Times are seconds of uptime; a
+ * second the loop missed is an empty row (null).
+ *
+ * A Query picks the finest tier that is at least `res` seconds and
+ * still holds `from` (else the coarsest one at least `res`).  A
+ * negative `from` counts back from now (0 is boot); a `to` of 0 or
+ * less does (0 is now).
+ */
+class HistoryStore {
+public:
+    static constexpr uint16_t RAW_SLOTS  = OPENVIBE_HISTORY_RAW_SLOTS;
+    static constexpr uint32_t MID_S      = OPENVIBE_HISTORY_MID_S;
+    static constexpr uint16_t MID_SLOTS  = OPENVIBE_HISTORY_MID_SLOTS;
+    static constexpr uint32_t LONG_S     = OPENVIBE_HISTORY_LONG_S;
+    static constexpr uint16_t LONG_SLOTS = OPENVIBE_HISTORY_LONG_SLOTS;
+    static constexpr uint16_t MAX_ROWS   = OPENVIBE_HISTORY_MAX_ROWS;
+    static constexpr uint8_t  TIERS      = 3;
+    static constexpr uint8_t  ROW_VALUES = 11;   // an aggregated row; raw rows have 4
+
+    struct Sample {
+        uint8_t level;
+        uint8_t battery;   // EMPTY: no sample that second
+        int8_t  rssi;      // dBm, 0 = no Wi-Fi link
+        uint8_t links;
+    };
+
+    struct Query {
+        int32_t  from = 1 - (int32_t)RAW_SLOTS;   // the whole raw ring
+        int32_t  to   = 0;
+        uint32_t res  = 0;   // seconds; 0 = finest that covers `from`
+    };
+
+    // Resolved query: buckets first..last of one tier.
+    struct Range {
+        uint8_t  tier;
+        uint32_t first;
+        uint32_t last;
+        bool     empty;
+    };
+
+    struct Row {
+        uint8_t count;               // 0 = nothing recorded in that bucket
+        int16_t values[ROW_VALUES];
+    };
+
+    HistoryStore();
+
+    // ── Recording ────────────────────────────────────────────────────
+    uint32_t msUntilSample(uint32_t nowMs) const;   // 0 = record() now
+    void     record(const Sample& s, uint32_t nowMs);
+
+    // ── Queries ──────────────────────────────────────────────────────
+    // False when the range is inverted.
+    bool     resolve(const Query& q, uint32_t nowMs, Range& out) const;
+    void     row(const Range& r, uint32_t bucket, Row& out) const;
+    uint32_t uptimeS(uint32_t nowMs) const;
+    static uint32_t periodS(uint8_t tier);
+
+    // {"now":…,"res":…,"from":…,"rows":[…],"next":…} added to `out`;
+    // rows stop at MAX_ROWS, or where `out` would pass maxBytes, and
+    // "next" is then the `from` that continues the range.
+    void toJson(JsonObject out, const Range& r, uint32_t nowMs, size_t maxBytes = SIZE_MAX) const;
+
+private:
+    static constexpr uint8_t EMPTY = 0xFF;
+
+    struct Bucket {
+        uint8_t levelMin, levelAvg, levelMax;
+        uint8_t batteryMin, batteryAvg, batteryMax;   // batteryMin EMPTY: no samples
+        int8_t  rssiMin, rssiAvg, rssiMax;
+        uint8_t linksAll, linksAny;
+    };
+
+    // The bucket a tier is filling.
+    struct Accumulator {
+        uint32_t bucket;
+        uint16_t samples;
+        uint16_t rssiSamples;
+        uint32_t levelSum, batterySum;
+        int32_t  rssiSum;
+        Bucket   b;
+    };
+
+    struct AggTier {
+        Bucket*     ring;
+        uint16_t    slots;
+        uint32_t    periodS;
+        uint32_t    newest;   // last closed bucket
+        bool        closedAny;
+        bool        open;
+        Accumulator acc;
+    };
+
+    Sample   raw[RAW_SLOTS];
+    Bucket   mid[MID_SLOTS];
+    Bucket   longTerm[LONG_SLOTS];
+    AggTier  tiers[TIERS - 1];
+    uint32_t rawNewest;   // second of the last sample
+    bool     rawAny;
+
+    // Uptime clock that survives the millis() wrap.
+    uint64_t clockMs;
+    uint32_t lastMs;
+
+    static void finish(const Accumulator& a, Bucket& out);
+    void     close(AggTier& t);
+    void     add(AggTier& t, uint32_t second, const Sample& s);
+    uint32_t oldest(uint8_t tier) const;
+    bool     newest(uint8_t tier, uint32_t& out) const;
+    void     tick(uint32_t nowMs);
+};
+
+#endif // HISTORY_STORE_H
@@ -0,0 +1,148 @@
+#include "TelemetryScheduler.h"
+
+constexpr TelemetryRate TelemetryScheduler::DEFAULT_RATES[];
+
+TelemetryScheduler::TelemetryScheduler()
+    : lastAvailable(0)
+{
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        channels[i].rate = DEFAULT_RATES[i];
+    }
+}
+
+// ── Configuration ────────────────────────────────────────────────────
+
+void TelemetryScheduler::setRate(TransportMode ch, const TelemetryRate& rate) {
+    if (ch >= CHANNEL_COUNT) return;
+    channels[ch].rate = rate;
+}
+
+const TelemetryRate& TelemetryScheduler::getRate(TransportMode ch) const {
+    return channels[ch < CHANNEL_COUNT ? ch : 0].rate;
+}
+
+void TelemetryScheduler::setDeadbands(const TelemetryDeadbands& db) {
+    deadbands = db;
+}
+
+void TelemetryScheduler::requestImmediate() {
+    for (Channel& c : channels) c.forced = true;
+}
+
+// ── Scheduling ───────────────────────────────────────────────────────
+
+bool TelemetryScheduler::anyWindowOpen(uint8_t availableMask, uint32_t now) const {
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        if (!(availableMask & channelBit(static_cast<TransportMode>(i)))) continue;
+        const Channel& c = channels[i];
+        if (!c.sentOnce || now - c.lastSentMs >= c.rate.minIntervalMs) return true;
+    }
+    return false;
+}
+
+uint8_t TelemetryScheduler::due(const DeviceStats& stats, uint8_t availableMask, uint32_t now) {
+    // A channel that just came up gets a fresh status right away.
+    uint8_t rising = availableMask & ~lastAvailable;
+    lastAvailable  = availableMask;
+
+    Snapshot cur  = snapshotOf(stats);
+    uint8_t  mask = 0;
+
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        uint8_t bit = channelBit(static_cast<TransportMode>(i));
+        Channel& c  = channels[i];
+
+        if (!(availableMask & bit)) {
+            c.forced = false;   // nobody to answer
+            continue;
+        }
+        if (rising & bit) c.sentOnce = false;
+
+        uint32_t elapsed = now - c.lastSentMs;
+        if (c.sentOnce && elapsed < c.rate.minIntervalMs) continue;
+
+        if (!c.sentOnce || c.forced || changed(c.last, cur) ||
+            (c.rate.heartbeatMs && elapsed >= c.rate.heartbeatMs)) {
+            mask |= bit;
+        }
+    }
+    return mask;
+}
+
+void TelemetryScheduler::markSent(uint8_t mask, const DeviceStats& stats, uint32_t now) {
+    Snapshot cur = snapshotOf(stats);
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        if (!(mask & channelBit(static_cast<TransportMode>(i)))) continue;
+        Channel& c   = channels[i];
+        c.last       = cur;
+        c.lastSentMs = now;
+        c.sentOnce   = true;
+        c.forced     = false;
+    }
+}
+
+uint32_t TelemetryScheduler::msUntilDue(const DeviceStats& stats, uint8_t availableMask,
+                                        uint32_t now) const {
+    uint8_t  rising = availableMask & ~lastAvailable;
+    Snapshot cur    = snapshotOf(stats);
+    uint32_t wait   = UINT32_MAX;
+
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        uint8_t bit = channelBit(static_cast<TransportMode>(i));
+        if (!(availableMask & bit)) continue;
+        const Channel& c = channels[i];
+        if (!c.sentOnce) return 0;
+
+        // Same conditions as due(), as a time after lastSentMs.
+        uint32_t elapsed = now - c.lastSentMs;
+        uint32_t at;
+        if ((rising & bit) || c.forced || changed(c.last, cur)) {
+            at = c.rate.minIntervalMs;
+        } else if (c.rate.heartbeatMs) {
+            at = c.rate.heartbeatMs > c.rate.minIntervalMs ? c.rate.heartbeatMs : c.rate.minIntervalMs;
+        } else {
+            continue;
+        }
+        uint32_t left = elapsed >= at ? 0 : at - elapsed;
+        if (left < wait) wait = left;
+    }
+    return wait;
+}
+
+// ── Change detection ─────────────────────────────────────────────────
+
+TelemetryScheduler::Snapshot TelemetryScheduler::snapshotOf(const DeviceStats& stats) {
+    Snapshot s;
+    memcpy(s.levels, stats.levels, sizeof(s.levels));
+    s.battery              = stats.battery;
+    s.isCharging           = stats.isCharging;
+    s.isBluetoothConnected = stats.isBluetoothConnected;
+    s.isWifiConnected      = stats.isWifiConnected;
+    s.transport            = static_cast<uint8_t>(stats.transport);
+    s.addressHash          = hashString(stats.serverAddress, hashString(stats.ipAddress, 2166136261u));
+    return s;
+}
+
+bool TelemetryScheduler::changed(const Snapshot& a, const Snapshot& b) const {
+    for (uint8_t i = 0; i < MAX_MOTOR_CHANNELS; ++i) {
+        if (a.levels[i] != b.levels[i] && abs(a.levels[i] - b.levels[i]) >= deadbands.intensity) return true;
+    }
+    if (a.battery   != b.battery   && abs(a.battery   - b.battery)   >= deadbands.battery)   return true;
+
+    return a.isCharging           != b.isCharging
+        || a.isBluetoothConnected != b.isBluetoothConnected
+        || a.isWifiConnected      != b.isWifiConnected
+        || a.transport            != b.transport
+        || a.addressHash          != b.addressHash;
+}
+
+uint32_t TelemetryScheduler::hashString(const String& s, uint32_t seed) {
+    // FNV-1a
+    uint32_t h = seed;
+    const char* p = s.c_str();
+    for (unsigned int i = 0; i < s.length(); ++i) {
+        h ^= static_cast<uint8_t>(p[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
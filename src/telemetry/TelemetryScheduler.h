@@ -0,0 +1,99 @@
+#ifndef TELEMETRY_SCHEDULER_H
+#define TELEMETRY_SCHEDULER_H
+
+#include <Arduino.h>
+#include "../../include/types/device_stats.h"
+
+/**
+ * Decides when each transport gets a status update.
+ *
+ * Channels are indexed by TransportMode: BLE notify, local WebSocket
+ * server (TRANSPORT_WIFI) and remote WebSocket client.  A channel is
+ * due when its minimum interval has elapsed AND either something
+ * meaningful changed since the last status it received, a client
+ * explicitly asked (STATUS), the channel just came up, or its
+ * heartbeat expired.  DeviceContext serialises the JSON once per tick
+ * and hands it to every due channel.
+ */
+struct TelemetryRate {
+    uint32_t minIntervalMs;   // rate cap — never send more often than this
+    uint32_t heartbeatMs;     // resend unchanged stats after this (0 = never)
+};
+
+// Smallest delta that counts as a change worth sending.
+struct TelemetryDeadbands {
+    int intensity = 1;        // any intensity change (on any channel) is reported
+    int battery   = 2;        // battery only after ±2 %
+};
+
+class TelemetryScheduler {
+public:
+    static constexpr uint8_t CHANNEL_COUNT = 3;
+
+    static constexpr uint8_t channelBit(TransportMode ch) {
+        return static_cast<uint8_t>(1u << static_cast<uint8_t>(ch));
+    }
+
+    TelemetryScheduler();
+
+    void                 setRate(TransportMode ch, const TelemetryRate& rate);
+    const TelemetryRate& getRate(TransportMode ch) const;
+    void                 setDeadbands(const TelemetryDeadbands& db);
+
+    // Force a status on every connected channel at its next window.
+    void requestImmediate();
+
+    // Cheap pre-check: true if at least one available channel's rate
+    // window is open, i.e. it is worth refreshing stats at all.
+    bool anyWindowOpen(uint8_t availableMask, uint32_t now) const;
+
+    // Bitmask (channelBit) of channels that should receive `stats` now.
+    uint8_t due(const DeviceStats& stats, uint8_t availableMask, uint32_t now);
+
+    // Record that `stats` went out on every channel in `mask`.
+    void markSent(uint8_t mask, const DeviceStats& stats, uint32_t now);
+
+    // Milliseconds until due() would next return a channel if `stats`
+    // stays as it is (0 = now, UINT32_MAX = never).  The loop sleeps
+    // this long; anything that changes stats wakes it sooner.
+    uint32_t msUntilDue(const DeviceStats& stats, uint8_t availableMask, uint32_t now) const;
+
+private:
+    // Only the fields clients care about; strings are reduced to a hash
+    // so comparing a snapshot never allocates.
+    struct Snapshot {
+        uint8_t  levels[MAX_MOTOR_CHANNELS] = {};
+        int      battery              = 0;
+        bool     isCharging           = false;
+        bool     isBluetoothConnected = false;
+        bool     isWifiConnected      = false;
+        uint8_t  transport            = 0;
+        uint32_t addressHash          = 0;
+    };
+
+    struct Channel {
+        TelemetryRate rate;
+        Snapshot      last;
+        uint32_t      lastSentMs = 0;
+        bool          sentOnce   = false;
+        bool          forced     = false;
+    };
+
+    Channel            channels[CHANNEL_COUNT];
+    TelemetryDeadbands deadbands;
+    uint8_t            lastAvailable;
+
+    static Snapshot snapshotOf(const DeviceStats& stats);
+    bool            changed(const Snapshot& a, const Snapshot& b) const;
+    static uint32_t hashString(const String& s, uint32_t seed);
+
+    // Defaults: BLE ~10 Hz, local WS ~20 Hz, REMOTE ~4 Hz (bandwidth is
+    // paid for and fanned out server-side).
+    static constexpr TelemetryRate DEFAULT_RATES[CHANNEL_COUNT] = {
+        { 100,  5000 },
+        {  50,  5000 },
+        { 250, 30000 },
+    };
+};
+
+#endif // TELEMETRY_SCHEDULER_H
@@ -0,0 +1,219 @@
+#include "TraceRecorder.h"
+#include "../log/Logger.h"
+#include <base64.h>
+
+// ── Singleton ────────────────────────────────────────────────────────
+
+TraceRecorder& TraceRecorder::getInstance() {
+    static TraceRecorder inst;
+    return inst;
+}
+
+TraceRecorder::TraceRecorder()
+    : head(0)
+    , used(0)
+    , records(0)
+    , dropped(0)
+    , enabled(true)
+    , dirty(false)
+    , lastFlushMs(0)
+    , dumpBuf(nullptr)
+    , dumpLen(0)
+    , dumpOff(0) {}
+
+// ── Recording ────────────────────────────────────────────────────────
+
+void TraceRecorder::recordBoot(uint8_t transport, const String& version) {
+    append(hal::micros(), TRACE_BOOT, transport, 0, version.c_str(), version.length());
+}
+
+void TraceRecorder::recordCommand(uint32_t timeUs, uint8_t source, uint8_t result,
+                                  const char* payload, size_t len, bool binary) {
+    append(timeUs, TRACE_COMMAND, source, result, payload, len, binary ? TRACE_FLAG_BINARY : 0);
+}
+
+void TraceRecorder::recordState(TraceType type, uint8_t from, uint8_t to) {
+    append(hal::micros(), type, from, to, nullptr, 0);
+}
+
+void TraceRecorder::append(uint32_t timeUs, uint8_t type, uint8_t a, uint8_t b,
+                           const char* payload, size_t len, uint8_t flags) {
+    if (!enabled) return;
+
+    TraceRecord rec;
+    rec.timeUs = timeUs;
+    rec.type   = type;
+    rec.a      = a;
+    rec.b      = b;
+    rec.size   = len > 0xFFFF ? 0xFFFF : (uint16_t)len;
+    rec.stored = len > MAX_PAYLOAD ? MAX_PAYLOAD : (uint16_t)len;
+    rec.flags  = flags | (rec.stored < len ? TRACE_FLAG_TRUNCATED : 0);
+
+    size_t need = sizeof(rec) + rec.stored;
+    if (need > CAPACITY) return;
+
+    hal::LockGuard g(lock);
+    while (used + need > CAPACITY) dropOldest();
+
+    size_t tail = (head + used) % CAPACITY;
+    copyIn(tail, (const uint8_t*)&rec, sizeof(rec));
+    copyIn((tail + sizeof(rec)) % CAPACITY, (const uint8_t*)payload, rec.stored);
+    used += need;
+    ++records;
+    dirty = true;
+}
+
+void TraceRecorder::dropOldest() {
+    TraceRecord rec;
+    copyOut(head, (uint8_t*)&rec, sizeof(rec));
+    size_t n = sizeof(rec) + rec.stored;
+    head  = (head + n) % CAPACITY;
+    used -= n;
+    --records;
+    ++dropped;
+}
+
+void TraceRecorder::copyIn(size_t pos, const uint8_t* src, size_t n) {
+    if (n == 0) return;
+    size_t first = n < CAPACITY - pos ? n : CAPACITY - pos;
+    memcpy(ring + pos, src, first);
+    memcpy(ring, src + first, n - first);
+}
+
+void TraceRecorder::copyOut(size_t pos, uint8_t* dst, size_t n) const {
+    size_t first = n < CAPACITY - pos ? n : CAPACITY - pos;
+    memcpy(dst, ring + pos, first);
+    memcpy(dst + first, ring, n - first);
+}
+
+// ── Export ───────────────────────────────────────────────────────────
+
+size_t TraceRecorder::snapshot(uint8_t* out, size_t cap) {
+    hal::LockGuard g(lock);
+    if (cap < sizeof(TraceFileHeader) + used) return 0;
+
+    TraceFileHeader hdr;
+    memcpy(hdr.magic, "OVTR", 4);
+    hdr.version    = VERSION;
+    hdr.headerSize = sizeof(TraceFileHeader);
+    hdr.recordSize = sizeof(TraceRecord);
+    hdr.records    = records;
+    hdr.dropped    = dropped;
+
+    memcpy(out, &hdr, sizeof(hdr));
+    copyOut(head, out + sizeof(hdr), used);
+    return sizeof(hdr) + used;
+}
+
+bool TraceRecorder::flushToFlash() {
+    uint8_t* buf = new uint8_t[MAX_SNAPSHOT];
+    size_t   n   = snapshot(buf, MAX_SNAPSHOT);
+    bool     ok  = n > 0 && hal::fileWrite(FLASH_PATH, buf, n);
+    delete[] buf;
+
+    lastFlushMs = hal::millis();
+    if (ok) dirty = false;
+    LOG_I(TRACE, "[Trace] Flush %s (%u bytes)\n", ok ? "ok" : "FAILED", (unsigned)n);
+    return ok;
+}
+
+void TraceRecorder::clear() {
+    hal::LockGuard g(lock);
+    head    = 0;
+    used    = 0;
+    records = 0;
+    dropped = 0;
+    dirty   = false;
+}
+
+uint32_t TraceRecorder::recordCount() {
+    hal::LockGuard g(lock);
+    return records;
+}
+
+uint32_t TraceRecorder::droppedCount() {
+    hal::LockGuard g(lock);
+    return dropped;
+}
+
+void TraceRecorder::loop() {
+    if (dumpBuf) serviceDump();
+#if OPENVIBE_TRACE_FLUSH_MS > 0
+    if (dirty && hal::millis() - lastFlushMs >= OPENVIBE_TRACE_FLUSH_MS) flushToFlash();
+#endif
+}
+
+uint32_t TraceRecorder::msUntilNextWork(uint32_t now) const {
+    uint32_t wait = dumpBuf ? DUMP_POLL_MS : UINT32_MAX;
+#if OPENVIBE_TRACE_FLUSH_MS > 0
+    if (dirty) {
+        uint32_t elapsed = now - lastFlushMs;
+        uint32_t flush   = elapsed >= OPENVIBE_TRACE_FLUSH_MS ? 0 : OPENVIBE_TRACE_FLUSH_MS - elapsed;
+        if (flush < wait) wait = flush;
+    }
+#else
+    (void)now;
+#endif
+    return wait;
+}
+
+// ── Serial dump ──────────────────────────────────────────────────────
+
+// A whole trace at 115200 baud takes about a second; written all at
+// once it would hold the loop (and the motors) that long.  The lines
+// go out a few per pass instead, only as the UART has room, so tools
+// reading the capture see the same format as before.
+bool TraceRecorder::startDump(bool fromFlash) {
+    if (dumpBuf) return false;
+
+    size_t cap = fromFlash ? hal::fileSize(FLASH_PATH) : MAX_SNAPSHOT;
+    dumpBuf = new uint8_t[cap ? cap : 1];
+    dumpLen = fromFlash ? hal::fileRead(FLASH_PATH, 0, dumpBuf, cap) : snapshot(dumpBuf, cap);
+    dumpOff = 0;
+
+    Serial.printf("TRACE-BEGIN %u\n", (unsigned)dumpLen);
+    hal::wake();
+    return true;
+}
+
+void TraceRecorder::serviceDump() {
+    static constexpr size_t LINE = (DUMP_CHUNK + 2) / 3 * 4 + 2;   // base64 + CRLF
+
+    while (dumpOff < dumpLen && hal::serialWriteRoom() >= LINE) {
+        size_t chunk = dumpLen - dumpOff < DUMP_CHUNK ? dumpLen - dumpOff : DUMP_CHUNK;
+        Serial.println(base64::encode(dumpBuf + dumpOff, chunk));
+        dumpOff += chunk;
+    }
+    if (dumpOff < dumpLen || hal::serialWriteRoom() < LINE) return;
+
+    Serial.println("TRACE-END");
+    delete[] dumpBuf;
+    dumpBuf = nullptr;
+}
+
+// ── Reader ───────────────────────────────────────────────────────────
+
+TraceReader::TraceReader(const uint8_t* d, size_t n)
+    : data(d)
+    , len(n)
+    , pos(0)
+    , ok(false) {
+    if (len < sizeof(TraceFileHeader)) return;
+    memcpy(&hdr, data, sizeof(hdr));
+    ok = memcmp(hdr.magic, "OVTR", 4) == 0
+      && hdr.version == TraceRecorder::VERSION
+      && hdr.headerSize >= sizeof(TraceFileHeader)
+      && hdr.recordSize >= sizeof(TraceRecord)
+      && hdr.headerSize <= len;
+    pos = ok ? hdr.headerSize : len;
+}
+
+bool TraceReader::next(TraceRecord& rec, const uint8_t*& payload) {
+    if (!ok || len - pos < hdr.recordSize) return false;
+    memcpy(&rec, data + pos, sizeof(rec));
+    if (len - pos - hdr.recordSize < rec.stored) return false;   // torn tail
+
+    payload = data + pos + hdr.recordSize;
+    pos    += hdr.recordSize + rec.stored;
+    return true;
+}
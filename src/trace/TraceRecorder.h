@@ -0,0 +1,153 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <Arduino.h>
+#include "../hal/Hal.h"
+
+// RAM ring size and optional periodic flash flush (0 = only on TRACE flush).
+#ifndef OPENVIBE_TRACE_BYTES
+#define OPENVIBE_TRACE_BYTES    8192
+#endif
+#ifndef OPENVIBE_TRACE_FLUSH_MS
+#define OPENVIBE_TRACE_FLUSH_MS 0
+#endif
+
+enum TraceType : uint8_t {
+    TRACE_BOOT       = 0,   // a = restored transport, payload = firmware version
+    TRACE_COMMAND    = 1,   // a = CommandSource, b = CommandResult, payload = frame
+                            //   (JSON text, or MessagePack with TRACE_FLAG_BINARY)
+    TRACE_WIFI_STATE = 2,   // a = from, b = to (WiFiManager state)
+    TRACE_TRANSPORT  = 3    // a = from, b = to (TransportMode)
+};
+
+/**
+ * Fixed record header; `stored` payload bytes follow it directly.
+ * Little-endian, packed — the on-wire layout of the trace format.
+ */
+struct __attribute__((packed)) TraceRecord {
+    uint32_t timeUs;    // hal::micros() on arrival (wraps; only deltas matter)
+    uint8_t  type;      // TraceType
+    uint8_t  a;
+    uint8_t  b;
+    uint8_t  flags;     // TRACE_FLAG_*
+    uint16_t size;      // original payload length
+    uint16_t stored;    // bytes kept (≤ MAX_PAYLOAD)
+};
+static_assert(sizeof(TraceRecord) == 12, "trace record layout");
+
+static constexpr uint8_t TRACE_FLAG_TRUNCATED = 0x01;
+static constexpr uint8_t TRACE_FLAG_BINARY    = 0x02;   // MessagePack command frame
+
+/**
+ * Serialized trace: this header, then the records oldest first.
+ * Served by GET /trace, dumped by {"requestType":"TRACE","action":"dump"}
+ * and written to flash as TraceRecorder::FLASH_PATH.
+ */
+struct __attribute__((packed)) TraceFileHeader {
+    char     magic[4];     // "OVTR"
+    uint8_t  version;
+    uint8_t  headerSize;   // sizeof(TraceFileHeader)
+    uint16_t recordSize;   // sizeof(TraceRecord)
+    uint32_t records;
+    uint32_t dropped;      // records evicted from the ring before this snapshot
+};
+static_assert(sizeof(TraceFileHeader) == 16, "trace header layout");
+
+/**
+ * Black-box recorder for inbound commands and state transitions.
+ *
+ * Every frame CommandProcessor handles (any transport, including
+ * parse failures) and every Wi-Fi / transport transition is appended
+ * to a byte ring in RAM; when it is full the oldest records go.
+ * Appends are O(record) with no allocation and are mutex-guarded
+ * because BLE writes arrive on the BLE task.  tools/replay feeds a
+ * captured trace back through the command path on the host.
+ */
+class TraceRecorder {
+public:
+    static constexpr size_t      CAPACITY     = OPENVIBE_TRACE_BYTES;
+    static constexpr size_t      MAX_PAYLOAD  = 256;
+    static constexpr size_t      MAX_SNAPSHOT = sizeof(TraceFileHeader) + CAPACITY;
+    static constexpr uint8_t     VERSION      = 1;
+    static constexpr const char* FLASH_PATH   = "/trace.bin";
+
+    static TraceRecorder& getInstance();
+
+    void recordBoot(uint8_t transport, const String& version);
+    void recordCommand(uint32_t timeUs, uint8_t source, uint8_t result,
+                       const char* payload, size_t len, bool binary = false);
+    void recordState(TraceType type, uint8_t from, uint8_t to);
+
+    // Serialized copy (header + records) into `out`; returns bytes written.
+    size_t snapshot(uint8_t* out, size_t cap);
+    bool   flushToFlash();
+    void   clear();
+
+    void     setEnabled(bool on) { enabled = on; }
+    bool     isEnabled() const   { return enabled; }
+    uint32_t recordCount();
+    uint32_t droppedCount();
+
+    // Serial download: base64 lines between TRACE-BEGIN / TRACE-END,
+    // written from loop() as the UART takes them.  False while one runs.
+    bool startDump(bool fromFlash);
+    bool isDumping() const { return dumpBuf != nullptr; }
+
+    // Periodic flush when OPENVIBE_TRACE_FLUSH_MS > 0, and the dump.
+    void     loop();
+    uint32_t msUntilNextWork(uint32_t now) const;   // UINT32_MAX = nothing pending
+
+private:
+    TraceRecorder();
+    TraceRecorder(const TraceRecorder&)            = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    void append(uint32_t timeUs, uint8_t type, uint8_t a, uint8_t b,
+                const char* payload, size_t len, uint8_t flags = 0);
+    void dropOldest();
+    void copyIn(size_t pos, const uint8_t* src, size_t n);
+    void copyOut(size_t pos, uint8_t* dst, size_t n) const;
+    void serviceDump();
+
+    hal::Mutex    lock;
+    uint8_t       ring[CAPACITY];
+    size_t        head;       // offset of the oldest record
+    size_t        used;       // bytes in the ring
+    uint32_t      records;
+    uint32_t      dropped;
+    volatile bool enabled;
+    bool          dirty;      // appended since the last flash flush
+    uint32_t      lastFlushMs;
+
+    static constexpr size_t   DUMP_CHUNK   = 48;   // → 64 base64 chars per line
+    static constexpr uint32_t DUMP_POLL_MS = 5;    // a line at 115200 baud
+
+    uint8_t*      dumpBuf;    // snapshot being written; null = no dump
+    size_t        dumpLen;
+    size_t        dumpOff;
+};
+
+/**
+ * Walks a serialized trace (snapshot / file / download).
+ *
+ *   TraceReader r(buf, len);
+ *   TraceRecord rec; const uint8_t* payload;
+ *   while (r.next(rec, payload)) { ... }
+ */
+class TraceReader {
+public:
+    TraceReader(const uint8_t* data, size_t len);
+
+    bool                   valid() const  { return ok; }
+    const TraceFileHeader& header() const { return hdr; }
+    bool                   next(TraceRecord& rec, const uint8_t*& payload);
+
+private:
+    const uint8_t*  data;
+    size_t          len;
+    size_t          pos;
+    bool            ok;
+    TraceFileHeader hdr;
+};
+
+#endif // TRACE_RECORDER_H
@@ -0,0 +1,215 @@
+// Generated by tools/webui/embed.py from web/ — do not edit.
+#include "WebAssets.h"
+
+#if OPENVIBE_WITH_WEBUI
+
+namespace webui {
+
+namespace {
+
+// /: 817 -> 442 bytes
+const uint8_t INDEX_HTML[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x65, 0x93, 0x4b, 0x8e, 0x1b, 0x21,
+    0x10, 0x86, 0xf7, 0x3e, 0x05, 0x61, 0x1d, 0x9b, 0x76, 0x1e, 0xa3, 0x89, 0x04, 0x7d, 0x85, 0x44,
+    0x8a, 0x94, 0x7d, 0x35, 0x94, 0xa7, 0x49, 0x68, 0x40, 0x50, 0x6d, 0xc7, 0xbb, 0x9c, 0x26, 0x07,
+    0xcb, 0x49, 0xc2, 0xa3, 0x3d, 0xf2, 0xc8, 0x9b, 0x06, 0x7e, 0xbe, 0xaa, 0xfa, 0x0b, 0x1a, 0xf9,
+    0xce, 0x04, 0x4d, 0xd7, 0x88, 0x6c, 0xa6, 0xc5, 0x8d, 0x3b, 0x59, 0x07, 0xe6, 0xc0, 0xbf, 0x28,
+    0x8e, 0x9e, 0x57, 0x01, 0xc1, 0x94, 0x61, 0x41, 0x02, 0xa6, 0x67, 0x48, 0x19, 0x49, 0xf1, 0x95,
+    0x4e, 0xfb, 0x67, 0x7e, 0x93, 0x3d, 0x2c, 0xa8, 0xf8, 0xd9, 0xe2, 0x25, 0x86, 0x44, 0x9c, 0xe9,
+    0xe0, 0x09, 0x7d, 0xc1, 0x2e, 0xd6, 0xd0, 0xac, 0x0c, 0x9e, 0xad, 0xc6, 0x7d, 0x5b, 0xbc, 0xb7,
+    0xde, 0x92, 0x05, 0xb7, 0xcf, 0x1a, 0x1c, 0xaa, 0x63, 0xcd, 0x41, 0x96, 0x1c, 0x8e, 0x5f, 0x23,
+    0xfa, 0x1f, 0x76, 0x42, 0x29, 0xfa, 0x7a, 0x27, 0x9d, 0xf5, 0xbf, 0x58, 0x42, 0xa7, 0x78, 0xa6,
+    0xab, 0xc3, 0x3c, 0x23, 0x96, 0xe4, 0x73, 0xc2, 0x93, 0xe2, 0xa2, 0x49, 0x07, 0x78, 0xd6, 0x46,
+    0x7f, 0xf8, 0x38, 0x1d, 0x74, 0xce, 0x35, 0x55, 0xd6, 0xc9, 0x46, 0x62, 0x06, 0x4f, 0x98, 0x58,
+    0x4e, 0xba, 0x80, 0x10, 0xe3, 0x41, 0x0f, 0x5f, 0x9e, 0x3e, 0x7d, 0x36, 0xc7, 0xc3, 0xcf, 0x42,
+    0x49, 0xd1, 0xa9, 0x82, 0x8b, 0xad, 0xb9, 0x29, 0x98, 0xeb, 0xd6, 0x2a, 0xa6, 0x71, 0xc7, 0x98,
+    0x9c, 0x8f, 0x77, 0x86, 0xca, 0xa2, 0x6a, 0x39, 0x82, 0x67, 0xd6, 0x28, 0x5e, 0x8d, 0x95, 0x2e,
+    0x1d, 0xe4, 0xac, 0x78, 0x38, 0x9d, 0xf8, 0x58, 0x3a, 0xf6, 0xa8, 0xc9, 0xfa, 0x97, 0x7f, 0x7f,
+    0xfe, 0x96, 0x02, 0x85, 0xbc, 0xa5, 0xaf, 0x09, 0xe5, 0x02, 0xd6, 0xf7, 0x1c, 0x95, 0x0a, 0x3d,
+    0x4d, 0x39, 0xcd, 0x12, 0xe5, 0xba, 0xa5, 0xae, 0x3f, 0x30, 0x11, 0x88, 0x30, 0xf9, 0xfc, 0x5a,
+    0x2e, 0x85, 0x0b, 0xaf, 0x54, 0xe1, 0x1c, 0x4c, 0xe8, 0xc6, 0x6f, 0x9d, 0x68, 0x52, 0x0b, 0x76,
+    0x25, 0xfc, 0x3e, 0x76, 0xc3, 0xdb, 0x6e, 0x88, 0xad, 0x4a, 0xb1, 0x9b, 0x09, 0x3c, 0x49, 0xb1,
+    0x09, 0xb7, 0x8d, 0xb8, 0xba, 0x8c, 0x0f, 0xea, 0x05, 0xce, 0x8f, 0x62, 0x82, 0x25, 0xbe, 0x8a,
+    0xb7, 0xea, 0xa2, 0x97, 0xdf, 0x0c, 0x8a, 0xee, 0xf0, 0x8d, 0x5b, 0x4c, 0x36, 0x18, 0x26, 0xad,
+    0x8f, 0xeb, 0xe6, 0xb2, 0x29, 0x9c, 0xd5, 0x9f, 0x50, 0x71, 0xbf, 0x2e, 0x13, 0x26, 0xce, 0x16,
+    0xeb, 0x15, 0x3f, 0x0e, 0x43, 0x99, 0xc1, 0x6f, 0xc5, 0x9f, 0x86, 0xa1, 0xce, 0x33, 0x61, 0xdc,
+    0xe4, 0x33, 0xb8, 0x15, 0xdb, 0x7c, 0xe0, 0x23, 0x5b, 0xf2, 0x5d, 0xb1, 0xb7, 0xa7, 0x39, 0xad,
+    0x44, 0xdb, 0x61, 0x66, 0x0a, 0x91, 0x8f, 0xdf, 0xcb, 0x57, 0x8a, 0x2e, 0x37, 0xc2, 0xb8, 0x6d,
+    0x17, 0x68, 0x6d, 0x97, 0x61, 0xea, 0x43, 0x10, 0xfd, 0xce, 0x0a, 0xd9, 0x7f, 0x0e, 0xd1, 0x1f,
+    0xc8, 0x7f, 0x7d, 0x3c, 0x45, 0x98, 0x31, 0x03, 0x00, 0x00,
+};
+
+// /app.c09645d1.js: 4653 -> 1835 bytes
+const uint8_t APP_C09645D1_JS[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xcd, 0x58, 0xeb, 0x6e, 0xdb, 0x46,
+    0x16, 0xfe, 0xef, 0xa7, 0x38, 0x01, 0xbc, 0x25, 0x09, 0x6b, 0x29, 0x65, 0xd1, 0x2d, 0x50, 0x69,
+    0xdd, 0x20, 0x4d, 0xd5, 0xc2, 0x0b, 0xc7, 0x36, 0x2c, 0xb5, 0xc1, 0xc2, 0x30, 0x62, 0x8a, 0x1c,
+    0x59, 0xac, 0x29, 0x0e, 0xcb, 0x19, 0x49, 0x11, 0x54, 0x02, 0xfb, 0x10, 0xfb, 0x84, 0xfb, 0x24,
+    0xfd, 0xce, 0x5c, 0x28, 0xd2, 0x49, 0x8a, 0xfe, 0x8c, 0x61, 0x38, 0x9a, 0x8b, 0xce, 0xfd, 0x7c,
+    0xe7, 0x9b, 0x04, 0x1b, 0x25, 0x48, 0xe9, 0x3a, 0x4f, 0x75, 0x30, 0x39, 0x19, 0x0e, 0xe9, 0x8d,
+    0x2c, 0x75, 0x2d, 0x0b, 0xaa, 0x92, 0x47, 0x1c, 0x88, 0x7a, 0x2b, 0x32, 0x5a, 0xec, 0x49, 0xaf,
+    0x04, 0x65, 0x62, 0x9b, 0xa7, 0x82, 0x42, 0x2d, 0x65, 0xa1, 0x86, 0x3b, 0xb1, 0xd8, 0xe4, 0x43,
+    0xb1, 0x5e, 0x88, 0x2c, 0xae, 0xf6, 0x54, 0x6d, 0xb4, 0xa2, 0x5c, 0x53, 0x5e, 0xb2, 0x94, 0x65,
+    0x91, 0xa8, 0x55, 0x14, 0x13, 0xc4, 0xad, 0xd7, 0x49, 0x99, 0x29, 0x7a, 0x94, 0x94, 0x28, 0xfa,
+    0xf7, 0xec, 0xfa, 0x8a, 0xe4, 0x56, 0xd4, 0x46, 0x60, 0x21, 0xd3, 0xa4, 0xa0, 0x77, 0x62, 0x31,
+    0x93, 0xe9, 0x93, 0xd0, 0x13, 0xda, 0xad, 0x44, 0x89, 0x93, 0x04, 0x62, 0x14, 0x8b, 0x29, 0xa5,
+    0xa6, 0x4d, 0x05, 0x8d, 0x75, 0x52, 0xaa, 0x4a, 0xd6, 0x9a, 0xbe, 0xbf, 0x9c, 0x92, 0xac, 0xe9,
+    0x76, 0xfa, 0xf6, 0x7a, 0x3e, 0x8d, 0xa0, 0x4d, 0x8b, 0x52, 0xe5, 0x7a, 0x0f, 0xf9, 0x42, 0x91,
+    0x96, 0x74, 0x73, 0x3d, 0x9b, 0xd3, 0xf0, 0xb8, 0x0f, 0xe5, 0x2c, 0x49, 0xe9, 0x44, 0x6f, 0x60,
+    0xa0, 0xa2, 0x4a, 0x16, 0x05, 0x7c, 0x5a, 0xd6, 0x72, 0x4d, 0x3f, 0x4d, 0x71, 0xd7, 0x1e, 0xc1,
+    0xd6, 0x57, 0x3b, 0x75, 0x7e, 0x73, 0x7d, 0x3b, 0xa7, 0x7c, 0x69, 0xcc, 0x7b, 0x37, 0x23, 0xa3,
+    0x13, 0x5f, 0x62, 0x43, 0xbe, 0xf9, 0xf6, 0x9b, 0x6f, 0xe3, 0x93, 0x30, 0x8c, 0xe8, 0xfc, 0x3b,
+    0x3a, 0x9c, 0x10, 0xa5, 0xb2, 0x54, 0x9a, 0x4e, 0xe9, 0x9c, 0xf2, 0x8c, 0xf7, 0x32, 0x99, 0x6e,
+    0xd6, 0xa2, 0xd4, 0xf1, 0xa3, 0xd0, 0xd3, 0x42, 0xf0, 0xc7, 0xef, 0xf7, 0x17, 0x59, 0x98, 0x67,
+    0xd1, 0xa4, 0xbd, 0xfe, 0x6e, 0xf6, 0xde, 0xe8, 0x38, 0xa7, 0x52, 0xec, 0xe8, 0xe7, 0xdb, 0xcb,
+    0x99, 0x48, 0xea, 0x74, 0x75, 0x93, 0xd4, 0xc9, 0x5a, 0x85, 0x1c, 0x11, 0x9d, 0xcb, 0x32, 0x56,
+    0x66, 0x37, 0x62, 0x51, 0x61, 0xb0, 0x53, 0x41, 0x44, 0xbf, 0xff, 0x6e, 0x2c, 0x38, 0x4a, 0x9a,
+    0x4d, 0xaf, 0x7e, 0x78, 0xff, 0x76, 0x06, 0x49, 0x5f, 0x8f, 0x26, 0xc4, 0x3f, 0xf0, 0x53, 0x96,
+    0x02, 0xc7, 0x26, 0xe6, 0x54, 0x21, 0xcc, 0x5f, 0x8f, 0x68, 0xad, 0xc6, 0xb4, 0x29, 0x33, 0x17,
+    0xf3, 0x7f, 0x8e, 0x08, 0xd1, 0x60, 0x11, 0x26, 0xcd, 0x45, 0xbe, 0xce, 0x75, 0x2b, 0xf2, 0xe6,
+    0xfa, 0xf2, 0xd2, 0x8a, 0xfc, 0xc7, 0x68, 0x64, 0x84, 0x42, 0xe4, 0xed, 0x14, 0x11, 0x5d, 0x26,
+    0x45, 0xb1, 0x48, 0xd2, 0xa7, 0xf6, 0xea, 0x8f, 0x17, 0xd3, 0xcb, 0x1f, 0x66, 0x84, 0xab, 0x07,
+    0x5a, 0x24, 0x5a, 0x8b, 0x7a, 0x3f, 0xa6, 0xe0, 0x6f, 0xc1, 0x80, 0xda, 0x64, 0x61, 0x8d, 0x65,
+    0x5e, 0xbd, 0xce, 0xb2, 0x5a, 0x28, 0x65, 0x97, 0xb6, 0x88, 0x2e, 0x32, 0xbb, 0x42, 0x25, 0x28,
+    0xb8, 0xcb, 0x0b, 0x6a, 0x26, 0x27, 0x90, 0x5e, 0x08, 0x4d, 0x3b, 0xc5, 0xe1, 0xd9, 0x14, 0xc5,
+    0x80, 0x54, 0x91, 0xc3, 0x72, 0x5e, 0xdf, 0xdd, 0x0f, 0x70, 0xb8, 0x15, 0x85, 0x5f, 0x64, 0x79,
+    0x8d, 0xfc, 0x9e, 0xb3, 0x69, 0x4a, 0x0c, 0x4c, 0x29, 0xd4, 0x49, 0xaa, 0xf3, 0xad, 0xf0, 0x9b,
+    0x46, 0xe0, 0x72, 0x53, 0xa6, 0x1c, 0x52, 0xe4, 0x52, 0xe9, 0xb0, 0x4a, 0xf4, 0x6a, 0x40, 0x0b,
+    0x99, 0xed, 0x23, 0x93, 0x43, 0xa2, 0x5a, 0xe8, 0x4d, 0x5d, 0xd2, 0x52, 0xe8, 0x74, 0xe5, 0x8e,
+    0x0f, 0xb4, 0x16, 0x7a, 0x25, 0xd9, 0x46, 0x2e, 0x27, 0xd8, 0xb9, 0x12, 0x09, 0x9b, 0x31, 0xc6,
+    0x51, 0xc0, 0x1d, 0x82, 0xd4, 0xfe, 0x7d, 0xbe, 0xaf, 0x44, 0x80, 0x2b, 0x49, 0x55, 0x15, 0xb9,
+    0x4d, 0xdb, 0xf0, 0x57, 0x25, 0x4b, 0x78, 0x32, 0x30, 0x92, 0x3f, 0xf9, 0xc3, 0xaa, 0xc7, 0xa6,
+    0x0f, 0x62, 0x6e, 0xbb, 0xf2, 0x31, 0x5f, 0xee, 0x43, 0x6b, 0x4f, 0x63, 0xca, 0xa4, 0x39, 0x69,
+    0x63, 0x5c, 0x58, 0x5f, 0x6c, 0xc5, 0x21, 0x28, 0x5f, 0x7d, 0x85, 0xbf, 0x71, 0x0d, 0x5b, 0xf6,
+    0x33, 0x14, 0x2d, 0xce, 0xce, 0xcf, 0x8f, 0xed, 0x13, 0x5f, 0xdf, 0x4c, 0xaf, 0xfa, 0x2e, 0x2b,
+    0x51, 0x66, 0x61, 0xba, 0xce, 0xbc, 0xaf, 0x28, 0xec, 0x90, 0x85, 0x86, 0x51, 0xc4, 0x92, 0xcc,
+    0xf1, 0x33, 0x53, 0xf8, 0xb6, 0xb1, 0x83, 0x08, 0xa1, 0x16, 0xe6, 0x2b, 0xd8, 0x83, 0xd6, 0xdf,
+    0x36, 0x42, 0x69, 0x76, 0xda, 0xa8, 0x0d, 0x2e, 0xae, 0xe6, 0xd3, 0xab, 0xd9, 0xc5, 0xfc, 0x3f,
+    0xa8, 0x4d, 0x13, 0xda, 0xe0, 0xd8, 0x75, 0x88, 0x18, 0xcb, 0x89, 0x11, 0x15, 0x04, 0xd5, 0x75,
+    0x4c, 0xc7, 0x3d, 0x54, 0xd5, 0xff, 0xff, 0xf7, 0x5f, 0xfc, 0xd2, 0x9b, 0x55, 0x52, 0x96, 0x9c,
+    0x53, 0xbb, 0xfe, 0x92, 0x7f, 0xbb, 0x81, 0x05, 0xf4, 0x15, 0x88, 0xac, 0xdc, 0x94, 0xda, 0xc7,
+    0xd6, 0xa6, 0x6c, 0x21, 0x3f, 0x20, 0x63, 0xa7, 0x61, 0x90, 0x3a, 0xc7, 0x02, 0x17, 0x4c, 0x1c,
+    0xc4, 0x5a, 0x7c, 0xd0, 0xae, 0x7a, 0x70, 0x29, 0x08, 0xec, 0x49, 0xb7, 0xc4, 0xed, 0xce, 0x12,
+    0x08, 0x17, 0x72, 0x23, 0xa4, 0xd8, 0x44, 0x1b, 0xa6, 0xf4, 0x2f, 0x32, 0xba, 0x26, 0x74, 0x76,
+    0x96, 0x7a, 0x85, 0x5e, 0x65, 0x2d, 0x77, 0xb8, 0xd6, 0x82, 0x4f, 0x8a, 0xfa, 0xd0, 0xc2, 0xe1,
+    0x4f, 0x18, 0x64, 0xf9, 0x36, 0x88, 0x06, 0x24, 0x37, 0xfa, 0x4f, 0x2e, 0xe1, 0x14, 0xf8, 0xed,
+    0x4d, 0xf5, 0x82, 0x15, 0x71, 0x7b, 0x5f, 0x2f, 0x7e, 0x15, 0xa9, 0x8e, 0x13, 0xa5, 0xf2, 0xc7,
+    0x32, 0xfc, 0x9c, 0x84, 0xbc, 0x34, 0x02, 0xb8, 0x77, 0x34, 0x4a, 0x04, 0x6d, 0x01, 0x14, 0x78,
+    0x14, 0x28, 0x84, 0x75, 0x8e, 0xf6, 0x1e, 0xe1, 0xdf, 0xe4, 0xc3, 0x98, 0x5e, 0x8e, 0xf0, 0x69,
+    0x9b, 0x14, 0x1b, 0xdc, 0x18, 0xb9, 0x82, 0x37, 0x4d, 0x28, 0x77, 0x71, 0x8a, 0x99, 0xa1, 0xae,
+    0x92, 0x35, 0x97, 0xbc, 0x0f, 0x5f, 0xd0, 0xbd, 0x80, 0x46, 0x33, 0xf5, 0xcc, 0x91, 0xa0, 0xef,
+    0xe8, 0x25, 0xbd, 0xa2, 0x87, 0x37, 0x2b, 0x3a, 0x3d, 0xa4, 0xcd, 0x03, 0x41, 0xe3, 0x25, 0xa3,
+    0x03, 0x34, 0x2a, 0xe3, 0x6e, 0x2b, 0x5b, 0xc5, 0xb2, 0x34, 0xe6, 0xb5, 0xad, 0x74, 0x70, 0x40,
+    0x72, 0x97, 0xde, 0x63, 0xef, 0x4c, 0xc5, 0xc6, 0xa2, 0x09, 0x7f, 0xcb, 0x7e, 0xc4, 0x6e, 0xbb,
+    0xe9, 0x61, 0x46, 0xd7, 0xbc, 0x6a, 0xbc, 0x54, 0xce, 0xa7, 0x33, 0x08, 0xb6, 0x1d, 0x95, 0xd9,
+    0x64, 0xc6, 0xd5, 0x46, 0xad, 0xc2, 0x3b, 0x6b, 0xc9, 0xbd, 0x3b, 0x6d, 0xcc, 0xdf, 0x16, 0xc3,
+    0x18, 0xff, 0x5f, 0xd7, 0x75, 0xb2, 0x77, 0x75, 0x14, 0x2f, 0xf3, 0xa2, 0x08, 0x47, 0xc7, 0x2e,
+    0x51, 0x42, 0x5f, 0x30, 0xa8, 0xc1, 0x90, 0xce, 0xd4, 0xb1, 0x5d, 0xfc, 0xc2, 0x98, 0x15, 0x39,
+    0xf4, 0xb2, 0xf2, 0x7b, 0x80, 0xe8, 0x6a, 0x8b, 0xed, 0xb3, 0x1a, 0xe3, 0x42, 0x94, 0x8f, 0x7a,
+    0xe5, 0x02, 0x77, 0xa0, 0x4e, 0x43, 0x8f, 0xbb, 0xdd, 0x8c, 0xd6, 0x75, 0xa5, 0x3b, 0xf6, 0xb6,
+    0x36, 0x9f, 0x87, 0x33, 0xa2, 0xf1, 0x9f, 0xca, 0x6a, 0x21, 0xc1, 0x0b, 0xbb, 0x1b, 0xdd, 0x7b,
+    0xa0, 0x1b, 0xf8, 0x11, 0x16, 0x4d, 0xfa, 0xa0, 0x30, 0xb3, 0xc3, 0xfa, 0xcb, 0x87, 0x84, 0x8f,
+    0x81, 0x41, 0xad, 0xe4, 0x2e, 0x54, 0xba, 0x0b, 0xb8, 0x4a, 0xc7, 0x47, 0x3a, 0xc2, 0xd0, 0xc9,
+    0xc3, 0x78, 0x99, 0x97, 0x22, 0x6b, 0xd3, 0x67, 0x07, 0x6d, 0x52, 0x12, 0x26, 0xec, 0xc0, 0x90,
+    0x8d, 0xc4, 0x31, 0x96, 0x0e, 0xb4, 0x94, 0xa6, 0xcf, 0x21, 0xcd, 0xe7, 0x87, 0x29, 0xc1, 0x5d,
+    0x57, 0xba, 0x83, 0x0f, 0x56, 0x8a, 0xcb, 0x3e, 0xe1, 0x2f, 0xa0, 0xd2, 0x97, 0xa5, 0xdd, 0x8a,
+    0x1c, 0x7e, 0x1d, 0x2f, 0xb9, 0x0a, 0xe5, 0x0d, 0x80, 0xcf, 0x34, 0x61, 0xd4, 0xde, 0xa2, 0x12,
+    0x3a, 0x55, 0xe7, 0xcd, 0xf0, 0x45, 0x4d, 0xad, 0x54, 0xb4, 0x91, 0x2f, 0x7f, 0x56, 0xdd, 0x42,
+    0x84, 0x1d, 0xc6, 0x0e, 0x22, 0xac, 0x19, 0x88, 0x8b, 0xef, 0x2c, 0x7c, 0x7f, 0xdb, 0x6f, 0x39,
+    0x2c, 0xbb, 0x7d, 0x89, 0xa5, 0x2d, 0x3c, 0x0f, 0x13, 0x56, 0x7f, 0x56, 0x58, 0x80, 0xb5, 0xf1,
+    0xf1, 0x98, 0x95, 0x15, 0x9f, 0x41, 0x57, 0x83, 0xa5, 0xf6, 0x9b, 0x4f, 0xa8, 0x46, 0xc7, 0x5b,
+    0x8e, 0x18, 0x6a, 0x33, 0x74, 0xf7, 0x74, 0xdf, 0x4f, 0x0d, 0xc7, 0xf6, 0xb8, 0x1d, 0x60, 0xc6,
+    0x31, 0x63, 0xca, 0xcb, 0x8d, 0xf0, 0xae, 0x42, 0xa3, 0xeb, 0xff, 0xbf, 0x86, 0x90, 0x99, 0x87,
+    0xc7, 0xa3, 0x99, 0x63, 0x98, 0xd4, 0x44, 0x1f, 0x93, 0x85, 0xbf, 0x28, 0x30, 0xfb, 0x84, 0x40,
+    0x6b, 0xf3, 0x99, 0x73, 0x93, 0x3f, 0x37, 0x51, 0x0f, 0x7e, 0x0c, 0x78, 0x74, 0xb8, 0x52, 0x27,
+    0x12, 0x3d, 0x02, 0x65, 0xe0, 0xce, 0x9d, 0x80, 0x48, 0x22, 0x8c, 0xe0, 0x94, 0xa9, 0x88, 0xd7,
+    0x49, 0xfd, 0xc4, 0x70, 0xdf, 0xde, 0xed, 0x4f, 0x0d, 0x59, 0x08, 0xd4, 0xe3, 0x52, 0x86, 0x0f,
+    0x77, 0xd7, 0x08, 0xce, 0x2f, 0xf9, 0x42, 0xdc, 0xf7, 0x24, 0x27, 0x4b, 0x7c, 0x06, 0x66, 0xbf,
+    0x05, 0xd3, 0x8a, 0x6b, 0x00, 0x5f, 0x16, 0x76, 0xc5, 0xa3, 0x02, 0x41, 0x4e, 0x1a, 0x90, 0xd6,
+    0x87, 0x8e, 0xd9, 0x4d, 0x8f, 0xd5, 0x14, 0x79, 0xf9, 0x64, 0xf8, 0x4f, 0xc8, 0xae, 0x0f, 0xf0,
+    0x42, 0xf0, 0x4e, 0xa0, 0x2c, 0xf8, 0x30, 0x88, 0x9e, 0x15, 0x03, 0xaf, 0x26, 0xcf, 0x6e, 0x74,
+    0xc7, 0x0d, 0xde, 0x18, 0xaf, 0x98, 0x82, 0x02, 0xbc, 0xe4, 0x72, 0x19, 0xb4, 0x57, 0x2b, 0x43,
+    0x6c, 0x4b, 0x54, 0x59, 0xbc, 0xca, 0xb3, 0x0c, 0x8f, 0x13, 0x2b, 0xcb, 0x16, 0x05, 0x13, 0xe3,
+    0xc0, 0xf5, 0xee, 0xcd, 0xeb, 0xf9, 0x7c, 0x7a, 0x7b, 0x45, 0xab, 0x84, 0x1f, 0x0b, 0x96, 0x33,
+    0xc3, 0x3b, 0x2d, 0x3e, 0x41, 0x79, 0x24, 0xba, 0xd7, 0x7a, 0xf2, 0x85, 0xa3, 0x1a, 0x53, 0x10,
+    0xf3, 0x5c, 0xaa, 0x0d, 0x0f, 0xe9, 0x93, 0x69, 0xcc, 0x2a, 0x1f, 0x76, 0xcb, 0x9d, 0x83, 0xa1,
+    0x6f, 0xc9, 0x18, 0x0f, 0x8d, 0x32, 0xac, 0x19, 0x3b, 0xea, 0x58, 0x3e, 0x21, 0xb6, 0x75, 0xcc,
+    0xcc, 0x18, 0x5f, 0x18, 0x1b, 0x5e, 0x1f, 0xb9, 0x8a, 0xb1, 0x17, 0xd1, 0x9a, 0x66, 0x28, 0xdb,
+    0x56, 0x64, 0x96, 0xfb, 0xc2, 0x93, 0xd4, 0x43, 0x27, 0xd9, 0x36, 0xde, 0x03, 0x53, 0x99, 0xd1,
+    0xa4, 0x45, 0x5a, 0xa0, 0x04, 0x6a, 0xdc, 0x0b, 0xec, 0x32, 0xce, 0xce, 0x57, 0x91, 0x55, 0xac,
+    0x98, 0x8e, 0x98, 0xe1, 0x18, 0x1d, 0x87, 0x6c, 0xeb, 0x51, 0x6a, 0xd3, 0xd2, 0x3a, 0xb5, 0xf3,
+    0x33, 0xba, 0x25, 0xd8, 0xe1, 0xc3, 0x4e, 0x8d, 0x87, 0xc3, 0xd3, 0x43, 0xfb, 0x4a, 0x5b, 0x81,
+    0xf7, 0x96, 0x28, 0xa1, 0x66, 0x7c, 0x7a, 0x70, 0x0f, 0xbb, 0x66, 0xe8, 0x0b, 0x77, 0xc7, 0xc4,
+    0x43, 0x56, 0xa6, 0x68, 0xc2, 0x3e, 0x90, 0x16, 0x78, 0xdd, 0xb5, 0xa3, 0xdd, 0x46, 0xb8, 0xed,
+    0xa2, 0x7e, 0xc0, 0x0d, 0x63, 0x38, 0xfa, 0xc1, 0x71, 0x69, 0x43, 0xe0, 0x29, 0x07, 0x63, 0xd0,
+    0xf3, 0x19, 0x3c, 0x9b, 0xbf, 0x9e, 0xff, 0x3c, 0x0b, 0x5a, 0xec, 0x6c, 0x3a, 0x36, 0xad, 0xf1,
+    0x18, 0xe3, 0xd7, 0xfd, 0x39, 0x09, 0x1b, 0x78, 0x5d, 0xef, 0x19, 0x97, 0x39, 0xa0, 0xe6, 0x35,
+    0x50, 0x25, 0xb5, 0x12, 0xa1, 0x88, 0xb3, 0x44, 0x27, 0x91, 0x09, 0xb0, 0x09, 0x2b, 0x85, 0xef,
+    0x11, 0x9c, 0xa6, 0x27, 0x2b, 0x2d, 0xa4, 0x12, 0x1f, 0x39, 0xd8, 0x3e, 0xe0, 0xba, 0x73, 0xe1,
+    0x85, 0x73, 0xb4, 0xbd, 0x45, 0xae, 0x8a, 0x26, 0xbd, 0xb5, 0xf1, 0xbd, 0x4b, 0x7d, 0x78, 0x73,
+    0xe0, 0x9f, 0xa6, 0xed, 0xe5, 0xa6, 0xf5, 0x5e, 0xcf, 0xf3, 0xb5, 0x40, 0xab, 0x85, 0x2e, 0x83,
+    0x03, 0xbc, 0x71, 0x47, 0xa3, 0xae, 0xdf, 0x26, 0xd1, 0xc7, 0x76, 0x46, 0x81, 0xc2, 0xf0, 0x15,
+    0xf3, 0x53, 0x3b, 0x4a, 0x00, 0x40, 0xb9, 0xcc, 0xfa, 0xdb, 0xd6, 0x21, 0x1b, 0x5b, 0xf7, 0x4e,
+    0xec, 0xc6, 0xd7, 0xf5, 0x3b, 0x72, 0xe1, 0x84, 0x8e, 0xfb, 0x0a, 0xcc, 0x4c, 0x1b, 0x90, 0x95,
+    0xfc, 0x16, 0x54, 0xea, 0xac, 0xab, 0xc7, 0x4e, 0x3c, 0x9b, 0x1b, 0x33, 0xca, 0x64, 0x65, 0xb5,
+    0xe3, 0x21, 0xf9, 0xf4, 0x2c, 0x9a, 0x8e, 0xbd, 0x75, 0xc8, 0xe1, 0x91, 0x65, 0xb6, 0xb3, 0xba,
+    0x65, 0x9a, 0x36, 0xa1, 0xc7, 0x11, 0x3b, 0xea, 0x8f, 0x58, 0x2c, 0x7d, 0x45, 0xf4, 0x78, 0xed,
+    0x09, 0xb9, 0xe7, 0xb7, 0x25, 0x06, 0x2f, 0xfd, 0x7f, 0x58, 0xd8, 0x8e, 0x98, 0x9c, 0x34, 0x11,
+    0xff, 0xfd, 0x03, 0x18, 0xca, 0x34, 0x6a, 0x2d, 0x12, 0x00, 0x00,
+};
+
+// /style.a8cdc23b.css: 1205 -> 573 bytes
+const uint8_t STYLE_A8CDC23B_CSS[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x53, 0xd1, 0x8e, 0x9b, 0x30,
+    0x10, 0x7c, 0xcf, 0x57, 0x58, 0x8a, 0x2a, 0xb5, 0x55, 0x4d, 0x21, 0xb9, 0x5c, 0x52, 0xa3, 0x7e,
+    0xc9, 0xe9, 0x1e, 0x16, 0x6c, 0xc0, 0x0d, 0xd8, 0xc8, 0x36, 0x4d, 0x68, 0x95, 0x7f, 0xef, 0xae,
+    0x03, 0x17, 0x92, 0xd3, 0x49, 0x15, 0x92, 0x01, 0xdb, 0x3b, 0x3b, 0x3b, 0x3b, 0x2b, 0x9c, 0xb5,
+    0x81, 0xfd, 0x65, 0xa5, 0x6d, 0xad, 0xe3, 0xbe, 0x6c, 0x54, 0xa7, 0x04, 0x6b, 0x75, 0xdd, 0x04,
+    0x26, 0xc1, 0x1d, 0x73, 0xc6, 0x39, 0x94, 0xa5, 0x32, 0x41, 0xb0, 0xb5, 0x4c, 0xb7, 0x9b, 0x3d,
+    0xe4, 0xec, 0xb2, 0xfa, 0x8a, 0x21, 0x85, 0x3d, 0x73, 0xaf, 0xff, 0x68, 0x53, 0x0b, 0xfc, 0x76,
+    0x52, 0x39, 0x8e, 0x5b, 0x74, 0x5a, 0x58, 0x39, 0xe2, 0x85, 0x0e, 0x5c, 0xad, 0x8d, 0x60, 0x69,
+    0xce, 0x2a, 0x4b, 0x00, 0xd9, 0x73, 0x7f, 0xfe, 0x9e, 0x25, 0x4f, 0xcc, 0x8f, 0x3e, 0xa8, 0x8e,
+    0x0f, 0xfa, 0x1b, 0xf3, 0x60, 0x3c, 0xf7, 0xca, 0xe9, 0x8a, 0x22, 0x1b, 0x05, 0x88, 0x83, 0xb1,
+    0x52, 0xfb, 0xbe, 0x85, 0x51, 0xb0, 0xaa, 0x55, 0x88, 0x09, 0xc8, 0xc8, 0x70, 0x8d, 0x41, 0x5e,
+    0x30, 0x62, 0xa3, 0x5c, 0xce, 0x7e, 0x0d, 0x3e, 0xe8, 0x6a, 0xe4, 0x25, 0x82, 0x47, 0x82, 0xbe,
+    0x87, 0x52, 0xf1, 0x42, 0x85, 0x93, 0x52, 0x26, 0x67, 0x3d, 0x48, 0x19, 0xd9, 0x25, 0xfb, 0x9d,
+    0x53, 0x1d, 0xcb, 0x70, 0xc9, 0x6f, 0x54, 0x43, 0xb0, 0x1d, 0x72, 0xea, 0xcf, 0xcc, 0xdb, 0x56,
+    0x4b, 0xb6, 0x3e, 0x1c, 0x0e, 0x4f, 0x91, 0x44, 0xf6, 0x9e, 0x3c, 0x55, 0x8a, 0xc2, 0x64, 0xc9,
+    0x26, 0x82, 0x5c, 0x56, 0x1d, 0x68, 0x13, 0xaf, 0x9d, 0xf9, 0x49, 0xcb, 0xd0, 0x08, 0xb6, 0xbd,
+    0x1e, 0xbd, 0x05, 0x32, 0x18, 0x82, 0x5d, 0xb0, 0xc8, 0xa6, 0xc8, 0x75, 0xab, 0xcd, 0x11, 0x43,
+    0x17, 0xb0, 0xc9, 0x61, 0x17, 0x0f, 0x6f, 0x8c, 0xb3, 0xc8, 0x38, 0xd9, 0x2d, 0x29, 0x3b, 0x90,
+    0x7a, 0xf0, 0x33, 0x50, 0x01, 0xe5, 0xb1, 0x76, 0x76, 0x30, 0x12, 0x3b, 0xb3, 0x81, 0xbd, 0xdc,
+    0x16, 0xf9, 0xb5, 0x8d, 0xf8, 0x5f, 0x55, 0xd5, 0x5b, 0xaa, 0xc4, 0x56, 0x15, 0xb5, 0x6b, 0x79,
+    0xff, 0x00, 0xf4, 0xd0, 0x95, 0xa4, 0x6c, 0xc0, 0x18, 0xd5, 0x2e, 0x35, 0xaf, 0x9d, 0x96, 0x79,
+    0x5c, 0x39, 0x2a, 0x8e, 0x7b, 0x41, 0xa1, 0xc8, 0xed, 0xd0, 0x19, 0xcc, 0xbe, 0x8d, 0x52, 0x56,
+    0x2e, 0x7e, 0x7c, 0xd0, 0x99, 0x1a, 0x7a, 0x31, 0x93, 0x9f, 0xf5, 0x98, 0x9a, 0x90, 0xde, 0x25,
+    0xb5, 0x43, 0xe8, 0x07, 0xf2, 0x5f, 0x50, 0xe7, 0xc0, 0x23, 0x96, 0x60, 0x8e, 0xdc, 0x37, 0xc9,
+    0xfe, 0x1b, 0x9c, 0x06, 0x7c, 0x9b, 0xa1, 0x43, 0x8f, 0x94, 0x82, 0x05, 0x28, 0x86, 0x16, 0x1c,
+    0x6d, 0x78, 0x82, 0xd2, 0x06, 0x01, 0x5e, 0xc2, 0xd8, 0xab, 0x9f, 0x0e, 0x4c, 0xad, 0x5e, 0x11,
+    0x6c, 0x6a, 0x48, 0x96, 0xa6, 0x9f, 0x90, 0x60, 0x74, 0x2f, 0x9f, 0x94, 0x41, 0xbc, 0xcf, 0xb3,
+    0xa3, 0xbf, 0x44, 0x2a, 0xce, 0x9e, 0xde, 0xfb, 0x8d, 0x56, 0x7e, 0x72, 0x54, 0x06, 0xad, 0x53,
+    0x45, 0xd9, 0x5d, 0x41, 0xd9, 0xad, 0x1c, 0xc2, 0x88, 0x44, 0x6e, 0xc9, 0x9f, 0xe7, 0x6e, 0xf7,
+    0x10, 0x50, 0x13, 0xe3, 0x5f, 0x1a, 0x2d, 0xa5, 0x32, 0xaf, 0xcb, 0x64, 0xc6, 0x1a, 0x15, 0x07,
+    0x66, 0x40, 0x33, 0x9a, 0x47, 0xe6, 0x0f, 0xfe, 0x9d, 0xa7, 0x48, 0x9b, 0x06, 0xa5, 0x98, 0x05,
+    0x3a, 0x29, 0x52, 0x0b, 0xf3, 0xa5, 0xe9, 0x43, 0xfb, 0x97, 0x0d, 0x7f, 0x28, 0xfb, 0x6a, 0xa8,
+    0x68, 0xee, 0x07, 0x6f, 0x4d, 0x4d, 0xbb, 0xac, 0xe4, 0xff, 0x3b, 0x82, 0x66, 0x60, 0x9a, 0x41,
+    0x32, 0xc6, 0xdc, 0xfe, 0xcd, 0x62, 0xe8, 0xae, 0x9a, 0xf1, 0x60, 0x49, 0xc5, 0xe4, 0x56, 0xcd,
+    0xec, 0xff, 0x1f, 0x73, 0x56, 0x52, 0xd0, 0xe2, 0x18, 0xeb, 0x30, 0x52, 0xdd, 0x71, 0x4f, 0xde,
+    0x8f, 0xe3, 0x65, 0xf5, 0x0f, 0x10, 0xec, 0x6e, 0xcb, 0xb5, 0x04, 0x00, 0x00,
+};
+
+} // namespace
+
+const Asset ASSETS[] = {
+    { "/", "text/html", "\"90339752cb2752f5\"", INDEX_HTML, sizeof(INDEX_HTML), false },
+    { "/app.c09645d1.js", "application/javascript", "\"6bf1ce8141bbab55\"", APP_C09645D1_JS, sizeof(APP_C09645D1_JS), true },
+    { "/style.a8cdc23b.css", "text/css", "\"dd22e27100097773\"", STYLE_A8CDC23B_CSS, sizeof(STYLE_A8CDC23B_CSS), true },
+};
+
+const uint8_t  ASSET_COUNT  = sizeof(ASSETS) / sizeof(ASSETS[0]);
+const uint32_t SOURCE_BYTES = 6675;
+const uint32_t GZIP_BYTES   = 2850;
+
+} // namespace webui
+
+#endif // OPENVIBE_WITH_WEBUI
@@ -0,0 +1,45 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+#include "../Features.h"
+
+#if OPENVIBE_WITH_WEBUI
+
+/**
+ * The control page (web/), gzip-compressed into flash.
+ *
+ * WebAssets.cpp is generated by tools/webui/embed.py, which PlatformIO
+ * runs before every build; edit web/, not the .cpp.  The REST server
+ * sends an asset's bytes as they are, straight from flash, with
+ * Content-Encoding: gzip.  Assets with a content hash in the name are
+ * `immutable` (cached for a year); "/" is revalidated by ETag.
+ */
+namespace webui {
+
+struct Asset {
+    const char*    path;
+    const char*    type;
+    const char*    etag;        // quoted
+    const uint8_t* data;        // gzip
+    uint32_t       size;
+    bool           immutable;
+};
+
+extern const Asset    ASSETS[];
+extern const uint8_t  ASSET_COUNT;
+extern const uint32_t SOURCE_BYTES;   // every asset, before / after compression
+extern const uint32_t GZIP_BYTES;
+
+inline const Asset* find(const char* path) {
+    for (uint8_t i = 0; i < ASSET_COUNT; ++i) {
+        if (strcmp(ASSETS[i].path, path) == 0) return &ASSETS[i];
+    }
+    return nullptr;
+}
+
+} // namespace webui
+
+#endif // OPENVIBE_WITH_WEBUI
+
+#endif // WEB_ASSETS_H
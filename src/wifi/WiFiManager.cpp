@@ -1,7 +1,17 @@
 #include "WiFiManager.h"
 #include "../DeviceContext.h"
 #include "../ConfigManager.h"
-#include <WiFi.h>
+#include "../commands/CommandProcessor.h"
+#include "../commands/RateLimiter.h"
+#include "../ble/BLEManager.h"
+#include "../session/SessionManager.h"
+#include "../trace/TraceRecorder.h"
+#include "../log/Logger.h"
+#include "../protocol/WireProtocol.h"
+#include "../webui/WebAssets.h"
+#include "../hal/Hal.h"
+
+#if OPENVIBE_WITH_WIFI
 
 WiFiManager* WiFiManager::instance = nullptr;
 
@@ -10,21 +20,44 @@ WiFiManager* WiFiManager::instance = nullptr;
 WiFiManager::WiFiManager()
     : wifiState(WIFI_IDLE)
     , wifiStateStart(0)
+#if OPENVIBE_WITH_WS
     , wsServer(nullptr)
-    , wsServerHasClient(false)
+    , binaryClients(0)
+#endif
+#if OPENVIBE_WITH_REST
     , restServer(nullptr)
+    , httpOtaStatus(OTA_OK)
+    , httpOtaBase(0)
+#endif
+#if OPENVIBE_WITH_REMOTE
     , wsClient(nullptr)
     , wsClientConnected(false)
+    , remoteEncoding(WIRE_JSON)
+    , remoteSession(0)
     , lastRemoteRetry(0)
     , remoteRetryCount(0)
+#endif
+#if OPENVIBE_WITH_MDNS
+    , mdnsUp(false)
+    , mdnsServices(0)
+    , mdnsTransport(TRANSPORT_BLE)
+#endif
 {
+#if OPENVIBE_WITH_WS
+    for (WireEncoding& e : clientEncoding) e = WIRE_JSON;
+    for (uint32_t& s : clientSession)      s = 0;
+#endif
     instance = this;
 }
 
 // ── Lifecycle ────────────────────────────────────────────────────────
 
 void WiFiManager::begin() {
-    WiFi.mode(WIFI_STA);
+    hal::wifiInit();
+
+    // First list for provisioning; it starts once any association is
+    // over, so stored credentials connect without waiting for it.
+    scanCache.request(hal::millis());
 
     if (ConfigManager::getInstance().hasWiFiCredentials()) {
         connect();
@@ -33,12 +66,18 @@ void WiFiManager::begin() {
 
 void WiFiManager::loop() {
     handleWiFiState();
+    scanCache.loop(wifiState != WIFI_CONNECTING, hal::millis());
 
+#if OPENVIBE_WITH_WS
     if (wsServer) wsServer->loop();
+#endif
+#if OPENVIBE_WITH_REMOTE
     if (wsClient) wsClient->loop();
-    if (restServer) restServer->handleClient();
-
     retryRemoteIfNeeded();
+#endif
+#if OPENVIBE_WITH_REST
+    if (restServer) restServer->handleClient();
+#endif
 }
 
 // ── WiFi connection (non-blocking) ───────────────────────────────────
@@ -49,18 +88,19 @@ void WiFiManager::connect() {
     String pass = cfg.getWiFiPassword();
 
     if (ssid.isEmpty()) {
-        Serial.println("[WiFi] No credentials stored");
+        LOG_I(WIFI, "[WiFi] No credentials stored\n");
         updateWiFiState(WIFI_DISCONNECTED);
         return;
     }
 
-    Serial.printf("[WiFi] Connecting to \"%s\"...\n", ssid.c_str());
-    WiFi.begin(ssid.c_str(), pass.c_str());
+    LOG_I(WIFI, "[WiFi] Connecting to \"%s\"...\n", ssid.c_str());
+    scanCache.cancel();   // association first; the scan runs after
+    hal::wifiBegin(ssid.c_str(), pass.c_str());
     updateWiFiState(WIFI_CONNECTING);
 }
 
 void WiFiManager::disconnect() {
-    WiFi.disconnect();
+    hal::wifiDisconnect();
     stopWebSocketServer();
     stopRestServer();
     disconnectRemote();
@@ -71,47 +111,33 @@ bool WiFiManager::isWiFiConnected() const {
     return wifiState == WIFI_CONNECTED;
 }
 
-void WiFiManager::scanNetworks() {
-    Serial.println("[WiFi] Scanning for networks...");
-    
-    // Explicitly scan in station mode
-    WiFi.mode(WIFI_STA);
-    WiFi.disconnect(); // Ensure we are not trying to connect during scan
-
-    int n = WiFi.scanNetworks(false, true); // show_hidden = false, passive = true for better stability
-    if (n == 0) {
-        Serial.println("[WiFi] No networks found");
-    } else {
-        Serial.printf("[WiFi] Found %d networks:\n", n);
-        for (int i = 0; i < n; ++i) {
-            Serial.printf("[WiFi]  - %s (RSSI: %d, Ch: %d)\n", 
-                          WiFi.SSID(i).c_str(), WiFi.RSSI(i), WiFi.channel(i));
-        }
-    }
-    
-    // CRITICAL: Clean up scan results and reset WiFi state
-    WiFi.scanDelete();
-    WiFi.disconnect(); 
-    delay(100); // Short breather for the hardware
-}
-
 void WiFiManager::updateWiFiState(WiFiState s) {
+    TraceRecorder::getInstance().recordState(TRACE_WIFI_STATE, wifiState, s);
     wifiState      = s;
-    wifiStateStart = millis();
+    wifiStateStart = hal::millis();
 
     DeviceContext& ctx = DeviceContext::getInstance();
 
     switch (s) {
         case WIFI_CONNECTED:
             ctx.onWiFiConnected();
-            // Auto-start appropriate transport
-            if (ctx.getTransport() == TRANSPORT_WIFI)   startWebSocketServer();
-            if (ctx.getTransport() == TRANSPORT_REMOTE)  connectToRemote();
+#if OPENVIBE_WITH_MDNS
+            startDiscovery();
+#endif
+            // Auto-start appropriate transport (AUTO: both)
+            if (wantsLocalServer(ctx.getTransport())) startWebSocketServer();
+            if (wantsRemote(ctx.getTransport()))      connectToRemote();
             startRestServer();
+#if OPENVIBE_WITH_MDNS
+            publishServices();
+#endif
             break;
 
         case WIFI_DISCONNECTED:
         case WIFI_CONNECTION_FAILED:
+#if OPENVIBE_WITH_MDNS
+            stopDiscovery();
+#endif
             ctx.onWiFiDisconnected();
             break;
 
@@ -123,17 +149,17 @@ void WiFiManager::updateWiFiState(WiFiState s) {
 void WiFiManager::handleWiFiState() {
     switch (wifiState) {
         case WIFI_CONNECTING:
-            if (WiFi.status() == WL_CONNECTED) {
+            if (hal::wifiIsConnected()) {
                 updateWiFiState(WIFI_CONNECTED);
-            } else if (millis() - wifiStateStart > CONNECT_TIMEOUT_MS) {
-                Serial.println("[WiFi] Connection timeout");
+            } else if (hal::millis() - wifiStateStart > CONNECT_TIMEOUT_MS) {
+                LOG_W(WIFI, "[WiFi] Connection timeout\n");
                 updateWiFiState(WIFI_CONNECTION_FAILED);
             }
             break;
 
         case WIFI_CONNECTED:
-            if (WiFi.status() != WL_CONNECTED) {
-                Serial.println("[WiFi] Connection lost — reconnecting");
+            if (!hal::wifiIsConnected()) {
+                LOG_W(WIFI, "[WiFi] Connection lost — reconnecting\n");
                 updateWiFiState(WIFI_DISCONNECTED);
                 connect();
             }
@@ -147,35 +173,126 @@ void WiFiManager::handleWiFiState() {
 // ── Transport change ─────────────────────────────────────────────────
 
 void WiFiManager::handleTransportChange(TransportMode oldMode, TransportMode newMode) {
-    // Tear down old transport channel
-    if (oldMode == TRANSPORT_WIFI)   stopWebSocketServer();
-    if (oldMode == TRANSPORT_REMOTE) disconnectRemote();
+    // Tear down what the new mode does not keep (AUTO keeps both)
+    if (wantsLocalServer(oldMode) && !wantsLocalServer(newMode)) stopWebSocketServer();
+    if (wantsRemote(oldMode)      && !wantsRemote(newMode))      disconnectRemote();
 
-    // Bring up new one (only if WiFi is already connected)
+    // Bring up the rest (only if WiFi is already connected)
     if (wifiState != WIFI_CONNECTED) return;
-    if (newMode == TRANSPORT_WIFI)   startWebSocketServer();
-    if (newMode == TRANSPORT_REMOTE) connectToRemote();
+    if (wantsLocalServer(newMode)) startWebSocketServer();
+    if (wantsRemote(newMode) && !wantsRemote(oldMode)) connectToRemote();
+#if OPENVIBE_WITH_MDNS
+    publishServices();
+#endif
+}
+
+// WIFI / REMOTE each need one Wi-Fi link; AUTO keeps both, the remote
+// only once a URL is stored (no warning and no retries without one).
+bool WiFiManager::wantsLocalServer(TransportMode mode) {
+    return mode == TRANSPORT_WIFI || mode == TRANSPORT_AUTO;
+}
+
+bool WiFiManager::wantsRemote(TransportMode mode) {
+    if (mode == TRANSPORT_REMOTE) return true;
+    return mode == TRANSPORT_AUTO && !ConfigManager::getInstance().getRemoteServer().isEmpty();
+}
+
+// ── DNS-SD ───────────────────────────────────────────────────────────
+
+#if OPENVIBE_WITH_MDNS
+
+void WiFiManager::startDiscovery() {
+    if (mdnsUp) return;
+    String id       = hal::deviceId();
+    String host     = "openvibe-" + id;
+    String instance = ConfigManager::getInstance().getDeviceName() + "-" + id;
+    if (!hal::mdnsBegin(host.c_str(), instance.c_str())) {
+        LOG_W(WIFI, "[mDNS] Responder failed to start\n");
+        return;
+    }
+    mdnsUp       = true;
+    mdnsServices = 0;
+    LOG_I(WIFI, "[mDNS] %s.local as \"%s\"\n", host.c_str(), instance.c_str());
+}
+
+void WiFiManager::stopDiscovery() {
+    if (!mdnsUp) return;
+    hal::mdnsEnd();
+    mdnsUp       = false;
+    mdnsServices = 0;
+}
+
+void WiFiManager::publishServices() {
+    if (!mdnsUp) return;
+    TransportMode transport = DeviceContext::getInstance().getTransport();
+#if OPENVIBE_WITH_WS || OPENVIBE_WITH_REST
+    bool          txtStale  = transport != mdnsTransport;
+#endif
+    mdnsTransport = transport;
+
+#if OPENVIBE_WITH_WS
+    publishService(MDNS_WS, "_openvibe-ws", OPENVIBE_WS_PORT, wsServer != nullptr, txtStale);
+#endif
+#if OPENVIBE_WITH_REST
+    publishService(MDNS_HTTP, "_http", OPENVIBE_REST_PORT, restServer != nullptr, txtStale);
+#endif
 }
 
+// A new service gets every TXT key; one already out only the transport,
+// and only when it changed (each change is announced on the link).
+void WiFiManager::publishService(uint8_t bit, const char* service, uint16_t port,
+                                 bool listening, bool txtStale) {
+    bool published = mdnsServices & bit;
+    if (!listening) {
+        if (published) hal::mdnsRemoveService(service, "_tcp");
+        mdnsServices &= ~bit;
+        return;
+    }
+
+    const DeviceStats& stats = DeviceContext::getInstance().getStats();
+    if (!published) {
+        if (!hal::mdnsAddService(service, "_tcp", port)) {
+            LOG_W(WIFI, "[mDNS] Could not advertise %s._tcp\n", service);
+            return;
+        }
+        mdnsServices |= bit;
+        hal::mdnsSetTxt(service, "_tcp", "deviceId", hal::deviceId().c_str());
+        hal::mdnsSetTxt(service, "_tcp", "version", stats.version);
+        LOG_I(WIFI, "[mDNS] Advertising %s._tcp on port %u\n", service, (unsigned)port);
+    } else if (!txtStale) {
+        return;
+    }
+    hal::mdnsSetTxt(service, "_tcp", "transport", CommandProcessor::transportName(stats.transport));
+}
+
+#endif // OPENVIBE_WITH_MDNS
+
 // ── WebSocket server ─────────────────────────────────────────────────
 
+#if OPENVIBE_WITH_WS
+
+static_assert(WEBSOCKETS_SERVER_CLIENT_MAX <= RateLimiter::WS_PEERS,
+              "every WS client needs its own rate limit buckets");
+
 void WiFiManager::startWebSocketServer() {
     if (wsServer) return;
 
-    wsServer = new WebSocketsServer(6969);
+    wsServer = new WebSocketsServer(OPENVIBE_WS_PORT);
     wsServer->begin();
     wsServer->onEvent(wsServerEventWrapper);
 
-    Serial.printf("[WS-Server] Listening on ws://%s:6969\n",
-                  WiFi.localIP().toString().c_str());
+    LOG_I(WIFI, "[WS-Server] Listening on ws://%s:%d\n",
+                hal::wifiLocalIP().c_str(), OPENVIBE_WS_PORT);
 }
 
 void WiFiManager::stopWebSocketServer() {
     if (!wsServer) return;
     wsServer->close();
     delete wsServer;
-    wsServer          = nullptr;
-    wsServerHasClient = false;
+    wsServer      = nullptr;
+    binaryClients = 0;
+    for (WireEncoding& e : clientEncoding) e = WIRE_JSON;
+    for (uint32_t& s : clientSession)      s = 0;
 }
 
 void WiFiManager::wsServerEventWrapper(uint8_t num, WStype_t type, uint8_t* payload, size_t len) {
@@ -183,28 +300,73 @@ void WiFiManager::wsServerEventWrapper(uint8_t num, WStype_t type, uint8_t* payl
 }
 
 void WiFiManager::onWsServerEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t len) {
+    if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) return;
+    CommandProcessor& cmds = CommandProcessor::getInstance();
+
     switch (type) {
         case WStype_CONNECTED:
-            wsServerHasClient = true;
-            Serial.printf("[WS-Server] Client #%u connected\n", num);
-            break;
         case WStype_DISCONNECTED:
-            wsServerHasClient = false;
-            Serial.printf("[WS-Server] Client #%u disconnected\n", num);
+            // Every connection starts out on JSON, in no session
+            clientEncoding[num] = WIRE_JSON;
+            clientSession[num]  = 0;
+            binaryClients      &= ~(1u << num);
+            RateLimiter::getInstance().peerReset(num);
+            LOG_I(WIFI, "[WS-Server] Client #%u %s\n", num,
+                        type == WStype_CONNECTED ? "connected" : "disconnected");
+            // Late joiners get a status without waiting for a change
+            if (type == WStype_CONNECTED) DeviceContext::getInstance().requestStatusBroadcast();
             break;
-        case WStype_TEXT:
-            processIncomingJson(payload);
+        case WStype_TEXT: {
+            if (!RateLimiter::getInstance().admitJson(SOURCE_WS_LOCAL, num, (const char*)payload, len,
+                                                      hal::millis())) return;
+            String ack;
+            cmds.handleJson((const char*)payload, len, SOURCE_WS_LOCAL, &ack, &clientEncoding[num],
+                            &clientSession[num]);
+            // The command may have switched transport and torn the server down
+            if (!ack.isEmpty() && wsServer) wsServer->sendTXT(num, ack.c_str(), ack.length());
             break;
-        default: break;
+        }
+        case WStype_BIN: {
+            // Firmware chunks bypass the command path (and the trace).  They
+            // are not rate limited: outside a signed session, or away from
+            // the expected offset, one is refused in two compares, and in
+            // one the client waits for each reply before the next.
+            if (OtaManager::isChunkFrame(payload, len)) {
+                uint8_t reply[OtaManager::CHUNK_REPLY];
+                size_t  n = OtaManager::getInstance().handleChunkFrame(payload, len, reply);
+                if (wsServer) wsServer->sendBIN(num, reply, n);
+                return;
+            }
+            if (!RateLimiter::getInstance().admitMsgPack(SOURCE_WS_LOCAL, num, payload, len,
+                                                         hal::millis())) return;
+            wire::AckBuffer ack;
+            cmds.handleMsgPack(payload, len, SOURCE_WS_LOCAL, &ack, &clientEncoding[num],
+                            &clientSession[num]);
+            if (ack.size() && wsServer) wsServer->sendBIN(num, ack.data(), ack.size());
+            break;
+        }
+        default: return;
     }
+
+    if (clientEncoding[num] == WIRE_MSGPACK) binaryClients |= 1u << num;
+    else                                     binaryClients &= ~(1u << num);
 }
 
+#else
+
+void WiFiManager::startWebSocketServer() {}
+void WiFiManager::stopWebSocketServer()  {}
+
+#endif // OPENVIBE_WITH_WS
+
 // ── REST API server ──────────────────────────────────────────────────
 
+#if OPENVIBE_WITH_REST
+
 void WiFiManager::startRestServer() {
     if (restServer) return;
 
-    restServer = new WebServer(80);
+    restServer = new WebServer(OPENVIBE_REST_PORT);
     
     // Enable CORS for all routes by handling OPTIONS
     restServer->onNotFound(handleNotFoundStatic);
@@ -214,10 +376,27 @@ void WiFiManager::startRestServer() {
     
     restServer->on("/status", HTTP_GET, handleGetStatusStatic);
     restServer->on("/intensity", HTTP_POST, handlePostIntensityStatic);
+    restServer->on("/trace", HTTP_GET, handleGetTraceStatic);
+    restServer->on("/power", HTTP_GET, handleGetPowerStatic);
+    restServer->on("/events", HTTP_GET, handleGetEventsStatic);
+    restServer->on("/session", HTTP_GET, handleGetSessionStatic);
+    restServer->on("/scan", HTTP_GET, handleGetScanStatic);
+    restServer->on("/history", HTTP_GET, handleGetHistoryStatic);
+    restServer->on("/limits", HTTP_GET, handleGetLimitsStatic);
+    restServer->on("/ota", HTTP_GET, handleGetOtaStatic);
+    restServer->on("/ota", HTTP_POST, handlePostOtaStatic, handleOtaUploadStatic);
+
+#if OPENVIBE_WITH_WEBUI
+    static const char* ASSET_HEADERS[] = { "If-None-Match" };
+    restServer->collectHeaders(ASSET_HEADERS, 1);
+    for (uint8_t i = 0; i < webui::ASSET_COUNT; ++i) {
+        restServer->on(webui::ASSETS[i].path, HTTP_GET, handleAssetStatic);
+    }
+#endif
 
     restServer->begin();
-    Serial.printf("[REST-Server] Listening on http://%s:80\n",
-                  WiFi.localIP().toString().c_str());
+    LOG_I(WIFI, "[REST-Server] Listening on http://%s:%d\n",
+                hal::wifiLocalIP().c_str(), OPENVIBE_REST_PORT);
 }
 
 void WiFiManager::stopRestServer() {
@@ -235,9 +414,11 @@ void WiFiManager::handleOptionsStatic() {
     instance->restServer->send(204);
 }
 
+// /ota is left out of the preflight answer, and sends no CORS headers
+// of its own: a web page on another origin gets nowhere near it.
 void WiFiManager::handleNotFoundStatic() {
     if (!instance || !instance->restServer) return;
-    if (instance->restServer->method() == HTTP_OPTIONS) {
+    if (instance->restServer->method() == HTTP_OPTIONS && instance->restServer->uri() != "/ota") {
         handleOptionsStatic();
         return;
     }
@@ -245,15 +426,370 @@ void WiFiManager::handleNotFoundStatic() {
     instance->restServer->send(404, "text/plain", "Not Found");
 }
 
+#if OPENVIBE_WITH_WEBUI
+
+// The control page, as the gzip bytes in flash: no copy, no inflate.
+// A browser without gzip is not served anything it can read.
+void WiFiManager::handleAssetStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
+    WebServer*          srv = instance->restServer;
+    const webui::Asset* a   = webui::find(srv->uri().c_str());
+    if (!a) {
+        handleNotFoundStatic();
+        return;
+    }
+
+    srv->sendHeader("ETag", a->etag);
+    srv->sendHeader("Cache-Control", a->immutable ? "public, max-age=31536000, immutable" : "no-cache");
+    if (srv->header("If-None-Match") == a->etag) {
+        srv->send(304);
+        return;
+    }
+    srv->sendHeader("Content-Encoding", "gzip");
+    srv->send_P(200, a->type, (const char*)a->data, a->size);
+}
+
+#endif // OPENVIBE_WITH_WEBUI
+
+// One budget for every HTTP client (SOURCE_REST); POST /ota is not
+// limited, its chunks arrive through the upload handler.
+bool WiFiManager::admitRest(CommandClass cls) {
+    if (RateLimiter::getInstance().admit(SOURCE_REST, 0, cls, hal::millis())) return true;
+    WebServer* srv = instance->restServer;
+    srv->sendHeader("Access-Control-Allow-Origin", "*");
+    srv->sendHeader("Retry-After", "1");
+    srv->send(429, "application/json", "{\"error\":\"Too many requests\"}");
+    return false;
+}
+
 void WiFiManager::handleGetStatusStatic() {
-    if (!instance || !instance->restServer) return;
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
     String json = DeviceContext::getInstance().buildStatusJson();
     instance->restServer->sendHeader("Access-Control-Allow-Origin", "*");
     instance->restServer->send(200, "application/json", json);
 }
 
-void WiFiManager::handlePostIntensityStatic() {
+// Active power profile and how the loop spent the last stats window.
+void WiFiManager::handleGetPowerStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
+    const PowerManager&            pm = DeviceContext::getInstance().getPower();
+    const PowerManager::LoopStats& ls = pm.loopStats();
+
+    JsonDocument doc;
+    doc["profile"]      = pm.profile().name;
+    doc["cpuMhz"]       = hal::cpuFrequencyMhz();
+    doc["netPollMs"]    = pm.profile().netPollMs;
+    doc["windowMs"]     = ls.windowMs;
+    doc["wakeups"]      = ls.wakeups;
+    doc["earlyWakeups"] = ls.earlyWakeups;
+    doc["awakePct"]     = ls.awakePermille / 10.0f;
+
+#if OPENVIBE_WITH_BLE
+    // Connection parameters and, per link state, what they cost the radio.
+    const BLEManager* ble = DeviceContext::getInstance().getBLEManager();
+    if (ble) {
+        const BLELinkPolicy&          link = ble->linkPolicy();
+        const BLELinkPolicy::Granted& g    = link.lastGrant();
+        uint32_t                      now  = hal::millis();
+
+        JsonObject b = doc["ble"].to<JsonObject>();
+        b["connected"] = link.isConnected();
+        b["state"]     = BLELinkPolicy::stateName(link.state());
+        if (g.interval) {
+            b["intervalMs"] = g.interval * 1.25f;
+            b["latency"]    = g.latency;
+            b["timeoutMs"]  = g.timeout * 10u;
+        }
+        b["requests"] = link.requests();
+        b["updates"]  = link.updates();
+        for (uint8_t s = 0; s < BLE_LINK_STATE_COUNT; ++s) {
+            BLELinkPolicy::StateStats st = link.stats((BLELinkState)s, now);
+            JsonObject o = b[BLELinkPolicy::stateName((BLELinkState)s)].to<JsonObject>();
+            o["ms"]          = st.ms;
+            o["commands"]    = st.commands;
+            o["wakeups"]     = st.wakeups;
+            o["wakeupsPerS"] = st.ms ? (uint32_t)((uint64_t)st.wakeups * 10000 / st.ms) / 10.0f : 0.0f;
+        }
+    }
+#endif
+
+    String json;
+    serializeJson(doc, json);
+    instance->restServer->sendHeader("Access-Control-Allow-Origin", "*");
+    instance->restServer->send(200, "application/json", json);
+}
+
+// Offline event store for the remote: fill, losses, last replay.
+void WiFiManager::handleGetEventsStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
+    JsonDocument doc;
+#if OPENVIBE_WITH_REMOTE
+    const EventBuffer&           ev = DeviceContext::getInstance().getEvents();
+    const EventBuffer::Counters& c  = ev.counters();
+
+    doc["capacity"]      = EventBuffer::CAPACITY;
+    doc["spillCapacity"] = EventBuffer::SPILL_CAPACITY;
+    doc["buffered"]      = ev.ramCount();
+    doc["spilledNow"]    = ev.spillCount();
+    doc["recorded"]      = c.recorded;
+    doc["spilled"]       = c.spilled;
+    doc["dropped"]       = c.dropped;
+    doc["sent"]          = c.sent;
+
+    JsonObject last = doc["lastReplay"].to<JsonObject>();
+    last["events"]       = c.lastEvents;
+    last["bytes"]        = c.lastBytes;
+    last["ms"]           = c.lastMs;
+    last["eventsPerSec"] = c.lastMs ? (uint32_t)((uint64_t)c.lastEvents * 1000 / c.lastMs) : 0;
+    last["bytesPerSec"]  = c.lastMs ? (uint32_t)((uint64_t)c.lastBytes * 1000 / c.lastMs) : 0;
+#else
+    doc["capacity"] = 0;
+#endif
+
+    String json;
+    serializeJson(doc, json);
+    instance->restServer->sendHeader("Access-Control-Allow-Origin", "*");
+    instance->restServer->send(200, "application/json", json);
+}
+
+// Links, route and failover record of the AUTO session.
+void WiFiManager::handleGetSessionStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
+    const SessionManager&           s   = SessionManager::getInstance();
+    const SessionManager::Counters& c   = s.counters();
+    uint32_t                        now = hal::millis();
+
+    JsonDocument doc;
+    doc["transport"] = CommandProcessor::transportName(DeviceContext::getInstance().getTransport());
+    if (s.hasRoute()) doc["route"] = CommandProcessor::transportName(s.route());
+    else              doc["route"] = nullptr;
+
+    JsonObject links = doc["links"].to<JsonObject>();
+    for (uint8_t i = 0; i < SessionManager::LINK_COUNT; ++i) {
+        const SessionManager::Link& k = s.link((TransportMode)i);
+        JsonObject l = links[CommandProcessor::transportName((TransportMode)i)].to<JsonObject>();
+        l["up"]      = k.up;
+        l["healthy"] = s.isHealthy((TransportMode)i, now);
+        l["rttMs"]   = k.rttMs;
+        if (k.up) l["heardMsAgo"] = now - k.lastHeardMs;
+    }
+
+    doc["duplicates"]     = c.duplicates;
+    doc["failovers"]      = c.failovers;
+    doc["lastFailoverMs"] = c.lastFailoverMs;
+    doc["maxFailoverMs"]  = c.maxFailoverMs;
+    doc["overTarget"]     = c.overTarget;
+    doc["targetMs"]       = SessionManager::FAILOVER_TARGET_MS;
+
+    String json;
+    serializeJson(doc, json);
+    instance->restServer->sendHeader("Access-Control-Allow-Origin", "*");
+    instance->restServer->send(200, "application/json", json);
+}
+
+// Cached networks at once; a stale list also starts a refresh.
+void WiFiManager::handleGetScanStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
+    uint32_t now = hal::millis();
+    instance->scanCache.request(now);
+
+    JsonDocument doc;
+    instance->scanCache.toJson(doc.to<JsonObject>(), now);
+
+    String json;
+    serializeJson(doc, json);
+    instance->restServer->sendHeader("Access-Control-Allow-Origin", "*");
+    instance->restServer->send(200, "application/json", json);
+}
+
+// Recorded stats over ?from=&to=&res= (HistoryStore::Query), one
+// MAX_ROWS page at a time.
+void WiFiManager::handleGetHistoryStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
+    WebServer*          srv     = instance->restServer;
+    const HistoryStore& history = DeviceContext::getInstance().getHistory();
+    uint32_t            now     = hal::millis();
+
+    HistoryStore::Query q;
+    if (srv->hasArg("from")) q.from = (int32_t)srv->arg("from").toInt();
+    if (srv->hasArg("to"))   q.to   = (int32_t)srv->arg("to").toInt();
+    if (srv->hasArg("res"))  q.res  = (uint32_t)max(0L, srv->arg("res").toInt());
+
+    srv->sendHeader("Access-Control-Allow-Origin", "*");
+    HistoryStore::Range range;
+    if (!history.resolve(q, now, range)) {
+        srv->send(400, "application/json", "{\"error\":\"from is after to\"}");
+        return;
+    }
+
+    JsonDocument doc;
+    history.toJson(doc.to<JsonObject>(), range, now);
+
+    String json;
+    serializeJson(doc, json);
+    srv->send(200, "application/json", json);
+}
+
+// Rate limits and what each source got through or had dropped.
+void WiFiManager::handleGetLimitsStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
+    const RateLimiter& rl = RateLimiter::getInstance();
+
+    JsonDocument doc;
+    for (uint8_t s = 0; s < SOURCE_COUNT; ++s) {
+        JsonObject src = doc[CommandProcessor::sourceTag((CommandSource)s)].to<JsonObject>();
+        for (uint8_t c = 0; c < CLASS_COUNT; ++c) {
+            const RateLimiter::Limit&    l = rl.limit((CommandSource)s, (CommandClass)c);
+            const RateLimiter::Counters& n = rl.counters((CommandSource)s, (CommandClass)c);
+            JsonObject cls = src[RateLimiter::className((CommandClass)c)].to<JsonObject>();
+            cls["intervalMs"] = l.intervalMs;
+            cls["burst"]      = l.burst;
+            cls["admitted"]   = n.admitted;
+            cls["dropped"]    = n.dropped;
+        }
+    }
+
+    String json;
+    serializeJson(doc, json);
+    instance->restServer->sendHeader("Access-Control-Allow-Origin", "*");
+    instance->restServer->send(200, "application/json", json);
+}
+
+// Firmware update progress and the slot currently running.
+void WiFiManager::handleGetOtaStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
+    OtaManager& ota = OtaManager::getInstance();
+
+    JsonDocument doc;
+    doc["state"]       = OtaManager::stateName(ota.getState());
+    doc["running"]     = hal::otaRunningSlot();
+    doc["slotSize"]    = hal::otaSlotSize();
+    doc["size"]        = ota.getSize();
+    doc["offset"]      = ota.getOffset();
+    doc["bytesPerSec"] = ota.bytesPerSec();
+    doc["peakRam"]     = ota.peakRamBytes();
+    if (ota.lastError() != OTA_OK) doc["error"] = OtaManager::statusName(ota.lastError());
+
+    String json;
+    serializeJson(doc, json);
+    instance->restServer->send(200, "application/json", json);
+}
+
+// POST /ota?size=<bytes>&sha256=<hex>&sig=<hex>[&offset=<n>] with the
+// image from `offset` on as the raw body.  The body is streamed to flash
+// by handleOtaUploadStatic() as it arrives; a dropped upload is resumed
+// by posting the rest from the offset GET /ota (or a 409) reports.  The
+// update is finished as soon as the last byte is in.  A missing or bad
+// `sig` is a 403 (OtaManager.h).
+void WiFiManager::handleOtaUploadStatic() {
+    if (!instance || !instance->restServer) return;
+    WebServer*  srv = instance->restServer;
+    HTTPRaw&    raw = srv->raw();
+    OtaManager& ota = OtaManager::getInstance();
+
+    switch (raw.status) {
+        case RAW_START: {
+            uint8_t  sha[hal::Sha256::DIGEST_LEN];
+            uint8_t  sig[hal::Sha256::DIGEST_LEN];
+            uint32_t size = (uint32_t)srv->arg("size").toInt();
+            uint32_t resumeAt;
+            instance->httpOtaBase   = (uint32_t)srv->arg("offset").toInt();
+            instance->httpOtaStatus = OTA_ERR_STATE;
+            if (!size || !OtaManager::parseDigest(srv->arg("sha256").c_str(), sha)) break;
+            if (!OtaManager::parseDigest(srv->arg("sig").c_str(), sig)) {
+                instance->httpOtaStatus = OTA_ERR_AUTH;
+                break;
+            }
+
+            instance->httpOtaStatus = ota.begin(size, sha, sig, resumeAt);
+            if (instance->httpOtaStatus == OTA_OK && resumeAt != instance->httpOtaBase) {
+                instance->httpOtaStatus = OTA_ERR_OFFSET;
+            }
+            break;
+        }
+        case RAW_WRITE:
+            if (instance->httpOtaStatus != OTA_OK) break;   // drain the rest
+            instance->httpOtaStatus = ota.write(instance->httpOtaBase + raw.totalSize - raw.currentSize,
+                                                raw.buf, raw.currentSize);
+            break;
+        case RAW_END:
+            if (instance->httpOtaStatus == OTA_OK && ota.getOffset() == ota.getSize()) {
+                instance->httpOtaStatus = ota.finish();
+            }
+            break;
+        case RAW_ABORTED:
+            LOG_W(WIFI, "[REST] OTA upload dropped at %u\n", (unsigned)ota.getOffset());
+            break;
+    }
+}
+
+void WiFiManager::handlePostOtaStatic() {
     if (!instance || !instance->restServer) return;
+    WebServer*  srv = instance->restServer;
+    OtaManager& ota = OtaManager::getInstance();
+
+    uint8_t sha[hal::Sha256::DIGEST_LEN];
+    if (!srv->arg("size").toInt() || !OtaManager::parseDigest(srv->arg("sha256").c_str(), sha)) {
+        srv->send(400, "application/json", "{\"error\":\"size and sha256 required\"}");
+        return;
+    }
+
+    OtaStatus st = instance->httpOtaStatus;
+    JsonDocument doc;
+    doc["result"] = OtaManager::statusName(st);
+    doc["state"]  = OtaManager::stateName(ota.getState());
+    doc["offset"] = ota.getOffset();
+
+    int code;
+    switch (st) {
+        case OTA_OK:              code = 200; break;
+        case OTA_ERR_BUSY:
+        case OTA_ERR_STATE:
+        case OTA_ERR_OFFSET:      code = 409; break;
+        case OTA_ERR_UNSUPPORTED: code = 501; break;
+        case OTA_ERR_FLASH:       code = 500; break;
+        case OTA_ERR_AUTH:        code = 403; break;
+        default:                  code = 400; break;
+    }
+
+    String json;
+    serializeJson(doc, json);
+    srv->send(code, "application/json", json);
+}
+
+// Binary trace download (see TraceRecorder.h); ?source=flash for the
+// last flushed copy instead of the live RAM ring.
+void WiFiManager::handleGetTraceStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_QUERY)) return;
+    WebServer* srv       = instance->restServer;
+    bool       fromFlash = srv->arg("source") == "flash";
+
+    size_t   cap = fromFlash ? hal::fileSize(TraceRecorder::FLASH_PATH) : TraceRecorder::MAX_SNAPSHOT;
+    uint8_t* buf = new uint8_t[cap ? cap : 1];
+    size_t   n   = fromFlash ? hal::fileRead(TraceRecorder::FLASH_PATH, 0, buf, cap)
+                             : TraceRecorder::getInstance().snapshot(buf, cap);
+
+    srv->sendHeader("Access-Control-Allow-Origin", "*");
+    if (n == 0) {
+        delete[] buf;
+        srv->send(404, "application/json", "{\"error\":\"No trace\"}");
+        return;
+    }
+
+    TraceReader reader(buf, n);
+    if (reader.valid()) {
+        srv->sendHeader("X-Trace-Records", String(reader.header().records));
+        srv->sendHeader("X-Trace-Dropped", String(reader.header().dropped));
+    }
+    srv->sendHeader("Content-Disposition", "attachment; filename=\"trace.bin\"");
+    srv->setContentLength(n);
+    srv->send(200, "application/octet-stream", "");
+    srv->sendContent((const char*)buf, n);
+    delete[] buf;
+}
+
+void WiFiManager::handlePostIntensityStatic() {
+    if (!instance || !instance->restServer || !admitRest(CLASS_CONTROL)) return;
     instance->restServer->sendHeader("Access-Control-Allow-Origin", "*");
 
     if (!instance->restServer->hasArg("plain")) {
@@ -267,74 +803,96 @@ void WiFiManager::handlePostIntensityStatic() {
         instance->restServer->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
         return;
     }
-    if (!doc.containsKey("intensity")) {
+    // {"intensity":N} every channel, {"intensity":N,"channel":C} one,
+    // {"channels":[N, …]} from channel 0 up.
+    bool perChannel = !doc["channels"].isNull();
+    if (!perChannel && doc["intensity"].isNull()) {
         instance->restServer->send(400, "application/json", "{\"error\":\"Missing intensity field\"}");
         return;
     }
 
-    int val = doc["intensity"].as<int>();
-    DeviceContext::getInstance().getStats().intensity = constrain(val, 0, 100);
-    Serial.printf("[REST] Intensity -> %d\n", DeviceContext::getInstance().getStats().intensity);
-    
-    // Broadcast change to other clients
-    DeviceContext::getInstance().requestStatusBroadcast();
-
+    // Run as the INTENSITY command it is, so it is traced (and replays)
+    // like one from any other transport.
+    doc["requestType"] = "INTENSITY";
+    String frame;
+    serializeJson(doc, frame);
+    CommandResult result = CommandProcessor::getInstance().handleJson(frame.c_str(), frame.length(), SOURCE_REST);
+    if (result != CMD_OK) {
+        instance->restServer->send(400, "application/json", perChannel ? "{\"error\":\"Invalid channels\"}"
+                                                                        : "{\"error\":\"Invalid channel\"}");
+        return;
+    }
     instance->restServer->send(200, "application/json", "{\"status\":\"ok\"}");
 }
 
+#else
+
+void WiFiManager::startRestServer() {}
+void WiFiManager::stopRestServer()  {}
+
+#endif // OPENVIBE_WITH_REST
+
 // ── WebSocket client (remote) ────────────────────────────────────────
 
+#if OPENVIBE_WITH_REMOTE
+
 void WiFiManager::connectToRemote() {
     ConfigManager& cfg = ConfigManager::getInstance();
     String url = cfg.getRemoteServer();
 
     if (url.isEmpty()) {
-        Serial.println("[WS-Client] No remote URL configured");
+        LOG_W(WIFI, "[WS-Client] No remote URL configured\n");
         return;
     }
 
     disconnectRemote();
 
-    // ── Parse ws://host:port/path ────────────────────────────────────
-    String host;
-    int    port = 80;
-    String path = "/";
-
-    if (!url.startsWith("ws://")) {
-        Serial.println("[WS-Client] Invalid URL (expected ws://)");
+    RemoteEndpoint ep;
+    if (!parseRemoteUrl(url, hal::deviceId(), ep)) {
+        LOG_E(WIFI, "[WS-Client] Invalid URL (expected ws://)\n");
         return;
     }
 
+    wsClient = new WebSocketsClient();
+    wsClient->begin(ep.host, ep.port, ep.path);
+    wsClient->onEvent(wsClientEventWrapper);
+    lastRemoteRetry  = hal::millis();
+    remoteRetryCount = 0;
+
+    LOG_I(WIFI, "[WS-Client] Connecting to %s:%u%s\n",
+                ep.host.c_str(), (unsigned)ep.port, ep.path.c_str());
+}
+
+#endif // OPENVIBE_WITH_REMOTE
+
+bool WiFiManager::parseRemoteUrl(const String& url, const String& deviceId, RemoteEndpoint& out) {
+    if (!url.startsWith("ws://")) return false;
+
     String body = url.substring(5);
     int colon = body.indexOf(':');
     int slash = body.indexOf('/');
 
+    out.port = 80;
+    out.path = "/";
     if (colon > 0) {
-        host = body.substring(0, colon);
-        port = (slash > colon)
-             ? body.substring(colon + 1, slash).toInt()
-             : body.substring(colon + 1).toInt();
-        if (slash > 0) path = body.substring(slash);
+        out.host = body.substring(0, colon);
+        out.port = (slash > colon)
+                 ? body.substring(colon + 1, slash).toInt()
+                 : body.substring(colon + 1).toInt();
+        if (slash > 0) out.path = body.substring(slash);
     } else {
-        host = (slash > 0) ? body.substring(0, slash) : body;
-        if (slash > 0) path = body.substring(slash);
+        out.host = (slash > 0) ? body.substring(0, slash) : body;
+        if (slash > 0) out.path = body.substring(slash);
     }
 
     // Append device registration path
-    String deviceId = String((uint32_t)ESP.getEfuseMac(), HEX);
-    if (!path.endsWith("/")) path += "/";
-    path += "register?id=" + deviceId;
-
-    wsClient = new WebSocketsClient();
-    wsClient->begin(host, port, path);
-    wsClient->onEvent(wsClientEventWrapper);
-    lastRemoteRetry  = millis();
-    remoteRetryCount = 0;
-
-    Serial.printf("[WS-Client] Connecting to %s:%d%s\n",
-                  host.c_str(), port, path.c_str());
+    if (!out.path.endsWith("/")) out.path += "/";
+    out.path += "register?id=" + deviceId;
+    return true;
 }
 
+#if OPENVIBE_WITH_REMOTE
+
 void WiFiManager::disconnectRemote() {
     if (!wsClient) return;
     delete wsClient;
@@ -356,18 +914,43 @@ void WiFiManager::onWsClientEvent(WStype_t type, uint8_t* payload, size_t len) {
         case WStype_CONNECTED:
             wsClientConnected = true;
             remoteRetryCount  = 0;
-            Serial.println("[WS-Client] Connected to remote");
+            remoteEncoding    = WIRE_JSON;
+            remoteSession     = 0;
+            LOG_I(WIFI, "[WS-Client] Connected to remote\n");
             break;
 
         case WStype_DISCONNECTED:
             wsClientConnected = false;
-            lastRemoteRetry   = millis();
-            Serial.println("[WS-Client] Disconnected from remote");
+            lastRemoteRetry   = hal::millis();
+            LOG_I(WIFI, "[WS-Client] Disconnected from remote\n");
             break;
 
-        case WStype_TEXT:
-            processIncomingJson(payload);
+        case WStype_TEXT: {
+            if (!RateLimiter::getInstance().admitJson(SOURCE_WS_REMOTE, 0, (const char*)payload, len,
+                                                      hal::millis())) break;
+            String ack;
+            CommandProcessor::getInstance().handleJson((const char*)payload, len, SOURCE_WS_REMOTE,
+                                                       &ack, &remoteEncoding, &remoteSession);
+            if (!ack.isEmpty() && wsClient) wsClient->sendTXT(ack.c_str(), ack.length());
             break;
+        }
+
+        case WStype_BIN: {
+            // Not rate limited, as on the local server.
+            if (OtaManager::isChunkFrame(payload, len)) {
+                uint8_t reply[OtaManager::CHUNK_REPLY];
+                size_t  n = OtaManager::getInstance().handleChunkFrame(payload, len, reply);
+                if (wsClient) wsClient->sendBIN(reply, n);
+                break;
+            }
+            if (!RateLimiter::getInstance().admitMsgPack(SOURCE_WS_REMOTE, 0, payload, len,
+                                                         hal::millis())) break;
+            wire::AckBuffer ack;
+            CommandProcessor::getInstance().handleMsgPack(payload, len, SOURCE_WS_REMOTE,
+                                                          &ack, &remoteEncoding, &remoteSession);
+            if (ack.size() && wsClient) wsClient->sendBIN(ack.data(), ack.size());
+            break;
+        }
 
         default: break;
     }
@@ -376,76 +959,146 @@ void WiFiManager::onWsClientEvent(WStype_t type, uint8_t* payload, size_t len) {
 void WiFiManager::retryRemoteIfNeeded() {
     DeviceContext& ctx = DeviceContext::getInstance();
 
-    if (ctx.getTransport() != TRANSPORT_REMOTE) return;
+    TransportMode  mode = ctx.getTransport();
+
+    if (mode != TRANSPORT_REMOTE && mode != TRANSPORT_AUTO) return;
     if (wifiState != WIFI_CONNECTED)             return;
     if (wsClientConnected)                        return;
     if (remoteRetryCount >= MAX_REMOTE_RETRIES)   return;
-    if (millis() - lastRemoteRetry < REMOTE_RETRY_MS) return;
+    if (hal::millis() - lastRemoteRetry < REMOTE_RETRY_MS) return;
+    if (mode == TRANSPORT_AUTO && !wantsRemote(mode)) {   // no URL: nothing to retry
+        lastRemoteRetry = hal::millis();
+        return;
+    }
 
     remoteRetryCount++;
-    Serial.printf("[WS-Client] Retry %d/%d\n", remoteRetryCount, MAX_REMOTE_RETRIES);
+    lastRemoteRetry = hal::millis();   // also when there is no URL to try
+    LOG_I(WIFI, "[WS-Client] Retry %d/%d\n", remoteRetryCount, MAX_REMOTE_RETRIES);
     connectToRemote();
 }
 
-// ── Send ─────────────────────────────────────────────────────────────
+#else
 
-void WiFiManager::sendStats(String& json) {
-    if (wsServer && wsServerHasClient) {
-        wsServer->broadcastTXT(json);
-    }
-    if (wsClient && wsClientConnected) {
-        wsClient->sendTXT(json);
+void WiFiManager::connectToRemote()         {}
+void WiFiManager::disconnectRemote()        {}
+bool WiFiManager::isRemoteConnected() const { return false; }
+
+#endif // OPENVIBE_WITH_REMOTE
+
+// ── Idle scheduling ──────────────────────────────────────────────────
+
+uint32_t WiFiManager::msUntilNextWork(uint32_t now) const {
+    uint32_t wait = UINT32_MAX;
+
+    // Link up/down wake the loop; only the give-up needs a timer.
+    if (wifiState == WIFI_CONNECTING) {
+        uint32_t elapsed = now - wifiStateStart;
+        wait = elapsed > CONNECT_TIMEOUT_MS ? 0 : CONNECT_TIMEOUT_MS - elapsed + 1;
     }
-}
 
-// ── Incoming JSON ────────────────────────────────────────────────────
+    uint32_t s = scanCache.msUntilNextWork(now);
+    if (s < wait) wait = s;
 
-void WiFiManager::processIncomingJson(uint8_t* payload) {
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, (char*)payload);
-    if (err) {
-        Serial.printf("[WS] JSON parse error: %s\n", err.c_str());
-        return;
+#if OPENVIBE_WITH_REMOTE
+    if (wsClient && !wsClientConnected) {
+        if (CLIENT_RECONNECT_MS < wait) wait = CLIENT_RECONNECT_MS;
     }
 
-    DeviceContext& ctx    = DeviceContext::getInstance();
-    ConfigManager& cfg    = ConfigManager::getInstance();
-    const char* reqType   = doc["requestType"];
+    TransportMode mode = DeviceContext::getInstance().getTransport();
+    if ((mode == TRANSPORT_REMOTE || mode == TRANSPORT_AUTO) &&
+        wifiState == WIFI_CONNECTED && !wsClientConnected &&
+        remoteRetryCount < MAX_REMOTE_RETRIES) {
+        uint32_t elapsed = now - lastRemoteRetry;
+        uint32_t left    = elapsed >= REMOTE_RETRY_MS ? 0 : REMOTE_RETRY_MS - elapsed;
+        if (left < wait) wait = left;
+    }
+#endif
+    return wait;
+}
 
-    if (!reqType) return;
+bool WiFiManager::hasOpenSockets() const {
+    bool open = false;
+#if OPENVIBE_WITH_WS
+    open = open || wsServer;
+#endif
+#if OPENVIBE_WITH_REST
+    open = open || restServer;
+#endif
+#if OPENVIBE_WITH_REMOTE
+    open = open || wsClient;
+#endif
+    return open;
+}
 
-    if (strcmp(reqType, "STATUS") == 0) {
-        ctx.requestStatusBroadcast();
+// ── Send ─────────────────────────────────────────────────────────────
 
-    } else if (strcmp(reqType, "INTENSITY") == 0) {
-        int val = doc["intensity"].as<int>();
-        ctx.getStats().intensity = constrain(val, 0, 100);
-        Serial.printf("[WS] Intensity → %d\n", ctx.getStats().intensity);
+bool WiFiManager::hasLocalClients() const {
+#if OPENVIBE_WITH_WS
+    return wsServer && wsServer->connectedClients() > 0;
+#else
+    return false;
+#endif
+}
 
-    } else if (strcmp(reqType, "SWITCH_TRANSPORT") == 0) {
-        const char* t = doc["transport"];
-        if (!t) return;
+bool WiFiManager::wantsBinaryStatus() const {
+    bool binary = false;
+#if OPENVIBE_WITH_WS
+    binary = binary || (binaryClients && hasLocalClients());
+#endif
+#if OPENVIBE_WITH_REMOTE
+    binary = binary || (remoteEncoding == WIRE_MSGPACK && wsClientConnected);
+#endif
+    return binary;
+}
 
-        TransportMode mode = ctx.getTransport();
-        if      (strcmp(t, "BLE")    == 0) mode = TRANSPORT_BLE;
-        else if (strcmp(t, "WIFI")   == 0) mode = TRANSPORT_WIFI;
-        else if (strcmp(t, "REMOTE") == 0) {
-            mode = TRANSPORT_REMOTE;
-            const char* addr = doc["serverAddress"];
-            if (addr) {
-                cfg.setRemoteServer(addr);
-                ctx.getStats().serverAddress = String(addr);
-            }
-        }
-        ctx.setTransport(mode);
-        Serial.printf("[WS] Transport → %s\n", t);
-
-    } else if (strcmp(reqType, "WIFI_CREDENTIALS") == 0) {
-        const char* ssid = doc["ssid"];
-        const char* pass = doc["password"];
-        if (ssid) {
-            cfg.setWiFiCredentials(ssid, pass ? pass : "");
-            connect();
-        }
+void WiFiManager::sendStatsLocal(const String& json, const MsgPackWriter* binary) {
+#if OPENVIBE_WITH_WS
+    if (!hasLocalClients()) return;
+
+    // Common case: every client is on JSON
+    if (!binaryClients || !binary) {
+        wsServer->broadcastTXT(json.c_str(), json.length());
+        return;
     }
-}
\ No newline at end of file
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) {
+        if (binaryClients & (1u << i)) wsServer->sendBIN(i, binary->data(), binary->size());
+        else                           wsServer->sendTXT(i, json.c_str(), json.length());
+    }
+#else
+    (void)json;
+    (void)binary;
+#endif
+}
+
+void WiFiManager::sendStatsRemote(const String& json, const MsgPackWriter* binary) {
+#if OPENVIBE_WITH_REMOTE
+    if (!wsClient || !wsClientConnected) return;
+    if (remoteEncoding == WIRE_MSGPACK && binary) wsClient->sendBIN(binary->data(), binary->size());
+    else                                          wsClient->sendTXT(json.c_str(), json.length());
+#else
+    (void)json;
+    (void)binary;
+#endif
+}
+
+bool WiFiManager::remoteWantsBinary() const {
+#if OPENVIBE_WITH_REMOTE
+    return remoteEncoding == WIRE_MSGPACK;
+#else
+    return false;
+#endif
+}
+
+bool WiFiManager::sendEventsRemote(const String& json, const MsgPackWriter* binary) {
+#if OPENVIBE_WITH_REMOTE
+    if (!wsClient || !wsClientConnected) return false;
+    if (remoteEncoding == WIRE_MSGPACK && binary) return wsClient->sendBIN(binary->data(), binary->size());
+    return wsClient->sendTXT(json.c_str(), json.length());
+#else
+    (void)json;
+    (void)binary;
+    return false;
+#endif
+}
+
+#endif // OPENVIBE_WITH_WIFI
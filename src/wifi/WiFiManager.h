@@ -1,20 +1,62 @@
 #ifndef WIFI_MANAGER_H
 #define WIFI_MANAGER_H
 
+#include "../Features.h"
+#if OPENVIBE_WITH_WS
 #include <WebSocketsServer.h>
+#endif
+#if OPENVIBE_WITH_REMOTE
 #include <WebSocketsClient.h>
+#endif
+#if OPENVIBE_WITH_REST
 #include <WebServer.h>
+#endif
 #include <ArduinoJson.h>
 #include "../../include/types/device_stats.h"   // TransportMode only
+#include "../commands/Command.h"                // WireEncoding
+#include "../commands/RateLimiter.h"            // CommandClass
+#include "../ota/OtaManager.h"                  // OtaStatus
+#include "WiFiScanCache.h"
+
+class MsgPackWriter;
+
+// Local listener ports (the host build remaps REST to avoid needing root).
+#ifndef OPENVIBE_WS_PORT
+#define OPENVIBE_WS_PORT   6969
+#endif
+#ifndef OPENVIBE_REST_PORT
+#define OPENVIBE_REST_PORT 80
+#endif
+
+/** Target of the REMOTE transport, parsed from the stored ws:// URL. */
+struct RemoteEndpoint {
+    String   host;
+    uint16_t port = 80;
+    String   path = "/";   // includes the register?id=<deviceId> suffix
+};
 
 /**
  * Manages WiFi connectivity and WebSocket communication.
  *
  * Key design decisions:
  *  - Non-blocking: connect() returns immediately; handleWiFiState()
- *    polls WiFi.status() on each loop() tick.
+ *    polls hal::wifiIsConnected() on each loop() tick.
  *  - No globals: reads/writes go through DeviceContext singleton.
  *  - Static wrapper pattern for C-style WebSocket callbacks.
+ *  - The servers that are listening are advertised over DNS-SD
+ *    (OPENVIBE_WITH_MDNS) from the moment the link comes up, so
+ *    clients need no BLE round trip to learn the IP:
+ *      _openvibe-ws._tcp  local WebSocket server (TRANSPORT_WIFI only)
+ *      _http._tcp         REST API
+ *    TXT: deviceId, version, transport — republished on change.
+ *  - Scans run in the background into WiFiScanCache (never while the
+ *    station associates); SCAN and GET /scan answer from the cache.
+ *  - TRANSPORT_AUTO keeps the WS server and the remote client up
+ *    together (SessionManager routes between them and BLE).
+ *  - Each server / client is compiled out with its OPENVIBE_WITH_*
+ *    flag (Features.h).  The public interface stays: start / connect
+ *    calls become no-ops and the queries report "nothing there".  The
+ *    whole class is absent without OPENVIBE_WITH_WIFI.
  */
 class WiFiManager {
 public:
@@ -25,9 +67,11 @@ public:
     // WiFi connection (non-blocking)
     void connect();
     void disconnect();
-    void scanNetworks();
     bool isWiFiConnected() const;
 
+    // Networks in range (SCAN / GET /scan); refreshed in the background
+    WiFiScanCache& getScanCache() { return scanCache; }
+
     // Transport change hook
     void handleTransportChange(TransportMode oldMode, TransportMode newMode);
 
@@ -43,9 +87,30 @@ public:
     void connectToRemote();
     void disconnectRemote();
     bool isRemoteConnected() const;
-
-    // Send data on whichever transport is active
-    void sendStats(String& json);
+    static bool wantsRemote(TransportMode mode);   // REMOTE, or AUTO with a URL stored
+
+    // Pure ws://host[:port][/path] parser (no I/O; benchmarked)
+    static bool parseRemoteUrl(const String& url, const String& deviceId, RemoteEndpoint& out);
+
+    // Per-channel status delivery (scheduled by DeviceContext).
+    // `binary` is the MessagePack status for peers that switched with
+    // HELLO; callers only build it when wantsBinaryStatus().
+    bool hasLocalClients() const;
+    bool wantsBinaryStatus() const;
+    void sendStatsLocal(const String& json, const MsgPackWriter* binary = nullptr);
+    void sendStatsRemote(const String& json, const MsgPackWriter* binary = nullptr);
+
+    // Replay of the events buffered while the remote was away
+    // (EventBuffer); false if the batch did not go out.
+    bool remoteWantsBinary() const;
+    bool sendEventsRemote(const String& json, const MsgPackWriter* binary);
+
+    // ── Idle scheduling (DeviceContext sleeps between deadlines) ─────
+    // Milliseconds until loop() has timed work: the connect timeout,
+    // a scan's give-up, the remote retry, or the client library's own
+    // reconnect attempt.
+    uint32_t msUntilNextWork(uint32_t now) const;
+    bool     hasOpenSockets() const;   // any server / client to poll
 
 private:
     // ── WiFi state machine ───────────────────────────────────────────
@@ -60,38 +125,84 @@ private:
     unsigned long wifiStateStart;
     static constexpr unsigned long CONNECT_TIMEOUT_MS = 15000;
 
+    WiFiScanCache scanCache;
+
     void updateWiFiState(WiFiState s);
     void handleWiFiState();
 
+    static bool wantsLocalServer(TransportMode mode);
+
+#if OPENVIBE_WITH_WS
     // ── WebSocket server ─────────────────────────────────────────────
     WebSocketsServer* wsServer;
-    bool wsServerHasClient;
+
+    WireEncoding clientEncoding[WEBSOCKETS_SERVER_CLIENT_MAX];
+    uint32_t     clientSession[WEBSOCKETS_SERVER_CLIENT_MAX];   // seq session (CommandProcessor)
+    uint8_t      binaryClients;   // bit n: client n receives MessagePack
 
     static void wsServerEventWrapper(uint8_t num, WStype_t type, uint8_t* payload, size_t len);
     void onWsServerEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t len);
+#endif
 
+#if OPENVIBE_WITH_REST
     // ── REST API server ──────────────────────────────────────────────
     WebServer* restServer;
 
     static void handleGetStatusStatic();
     static void handlePostIntensityStatic();
+    static void handleGetTraceStatic();
+    static void handleGetPowerStatic();
+    static void handleGetEventsStatic();
+    static void handleGetSessionStatic();
+    static void handleGetScanStatic();
+    static void handleGetHistoryStatic();
+    static void handleGetLimitsStatic();
+    static void handleGetOtaStatic();
+    static void handlePostOtaStatic();
+    static void handleOtaUploadStatic();
     static void handleNotFoundStatic();
     static void handleOptionsStatic();
+#if OPENVIBE_WITH_WEBUI
+    static void handleAssetStatic();           // control page
+#endif
+    static bool admitRest(CommandClass cls);   // false: 429 already sent
 
+    // POST /ota in progress: outcome so far and the offset of the body
+    OtaStatus httpOtaStatus;
+    uint32_t  httpOtaBase;
+#endif
+
+#if OPENVIBE_WITH_REMOTE
     // ── WebSocket client (remote) ────────────────────────────────────
     WebSocketsClient* wsClient;
     bool wsClientConnected;
+    WireEncoding  remoteEncoding;
+    uint32_t      remoteSession;
     unsigned long lastRemoteRetry;
     int           remoteRetryCount;
     static constexpr int           MAX_REMOTE_RETRIES  = 100;
     static constexpr unsigned long REMOTE_RETRY_MS     = 15000;
+    static constexpr unsigned long CLIENT_RECONNECT_MS = 500;   // WebSocketsClient default
 
     static void wsClientEventWrapper(WStype_t type, uint8_t* payload, size_t len);
     void onWsClientEvent(WStype_t type, uint8_t* payload, size_t len);
     void retryRemoteIfNeeded();
-
-    // ── Message handling ─────────────────────────────────────────────
-    void processIncomingJson(uint8_t* payload);
+#endif
+
+#if OPENVIBE_WITH_MDNS
+    // ── DNS-SD ───────────────────────────────────────────────────────
+    static constexpr uint8_t MDNS_WS   = 1 << 0;
+    static constexpr uint8_t MDNS_HTTP = 1 << 1;
+
+    bool          mdnsUp;
+    uint8_t       mdnsServices;    // MDNS_* bits currently advertised
+    TransportMode mdnsTransport;   // TXT "transport" last published
+
+    void startDiscovery();
+    void stopDiscovery();
+    void publishServices();   // match the advertisement to what is listening
+    void publishService(uint8_t bit, const char* service, uint16_t port, bool listening, bool txtStale);
+#endif
 
     // Singleton pointer for C-callback routing
     static WiFiManager* instance;
@@ -0,0 +1,140 @@
+#include "WiFiScanCache.h"
+#include "../Features.h"
+#include "../log/Logger.h"
+
+#if OPENVIBE_WITH_WIFI
+
+WiFiScanCache::WiFiScanCache()
+    : n(0)
+    , scanned(false)
+    , scannedMs(0)
+    , wanted(false)
+    , running(false)
+    , startedMs(0)
+    , retryMs(0)
+    , retryAtMs(0)
+{
+    memset(list, 0, sizeof(list));
+}
+
+void WiFiScanCache::request(uint32_t now) {
+    if (running || wanted) return;
+    if (scanned && ageMs(now) < MAX_AGE_MS) return;
+    wanted = true;
+    hal::wake();   // the loop starts it once the radio is free
+}
+
+void WiFiScanCache::loop(bool radioFree, uint32_t now) {
+    if (running) {
+        int found = hal::wifiScanComplete();
+        if (found >= 0) {
+            collect(found, now);
+        } else if (found != -1 || now - startedMs > TIMEOUT_MS) {
+            LOG_W(WIFI, "[WiFi] Scan %s\n", found == -1 ? "timed out" : "failed");
+            hal::wifiScanDelete();
+            running = false;
+        }
+        return;
+    }
+
+    if (!wanted || !radioFree) return;
+    if (retryMs && (int32_t)(now - retryAtMs) < 0) return;
+    if (!hal::wifiScanStart()) {
+        retryMs   = retryMs ? min(retryMs * 2, MAX_AGE_MS) : RETRY_MS;
+        retryAtMs = now + retryMs;
+        LOG_W(WIFI, "[WiFi] Scan refused, retrying in %u ms\n", (unsigned)retryMs);
+        return;
+    }
+    wanted    = false;
+    retryMs   = 0;
+    running   = true;
+    startedMs = now;
+    LOG_D(WIFI, "[WiFi] Scanning...\n");
+}
+
+void WiFiScanCache::cancel() {
+    if (!running) return;
+    hal::wifiScanDelete();
+    running = false;
+    wanted  = true;
+}
+
+// Builds the new list aside so a reader never sees half a scan.
+void WiFiScanCache::collect(int found, uint32_t now) {
+    Network fresh[MAX_NETWORKS];
+    uint8_t count = 0;
+
+    hal::WiFiScanEntry e;
+    for (int i = 0; i < found; ++i) {
+        if (hal::wifiScanResult(i, e) && !e.ssid.isEmpty()) insert(e, fresh, count);
+    }
+    hal::wifiScanDelete();
+
+    memcpy(list, fresh, count * sizeof(Network));
+    n         = count;
+    scanned   = true;
+    scannedMs = now;
+    running   = false;
+    LOG_I(WIFI, "[WiFi] Scan: %d AP(s), %u network(s) in %u ms\n",
+                found, (unsigned)n, (unsigned)(now - startedMs));
+}
+
+// Keeps `out` sorted by RSSI, one entry per SSID, the weakest dropped
+// when full.
+void WiFiScanCache::insert(const hal::WiFiScanEntry& e, Network* out, uint8_t& count) {
+    int8_t rssi = (int8_t)constrain(e.rssi, -128, 127);
+
+    for (uint8_t i = 0; i < count; ++i) {
+        if (strncmp(out[i].ssid, e.ssid.c_str(), sizeof(out[i].ssid)) != 0) continue;
+        if (rssi <= out[i].rssi) return;   // a weaker AP of a known network
+        memmove(&out[i], &out[i + 1], (count - i - 1) * sizeof(Network));
+        --count;
+        break;
+    }
+
+    uint8_t at = 0;
+    while (at < count && out[at].rssi >= rssi) ++at;
+    if (at == MAX_NETWORKS) return;
+    if (count == MAX_NETWORKS) --count;
+    memmove(&out[at + 1], &out[at], (count - at) * sizeof(Network));
+
+    Network& net = out[at];
+    strncpy(net.ssid, e.ssid.c_str(), sizeof(net.ssid) - 1);
+    net.ssid[sizeof(net.ssid) - 1] = '\0';
+    net.rssi    = rssi;
+    net.channel = e.channel;
+    net.auth    = e.authMode;
+    ++count;
+}
+
+void WiFiScanCache::toJson(JsonObject out, uint32_t now, size_t maxBytes) const {
+    if (scanned) out["ageMs"] = ageMs(now);
+    out["scanning"] = isScanning();
+    out["total"]    = n;
+
+    JsonArray nets = out["networks"].to<JsonArray>();
+    for (uint8_t i = 0; i < n; ++i) {
+        JsonArray net = nets.add<JsonArray>();
+        net.add(list[i].ssid);
+        net.add(list[i].rssi);
+        net.add(list[i].channel);
+        net.add(list[i].auth);
+        if (maxBytes != SIZE_MAX && measureJson(out) > maxBytes) {
+            nets.remove(nets.size() - 1);
+            break;
+        }
+    }
+}
+
+// Completion wakes the loop; only the give-up and a retry need a timer.
+uint32_t WiFiScanCache::msUntilNextWork(uint32_t now) const {
+    if (!running && wanted && retryMs) {
+        int32_t left = (int32_t)(retryAtMs - now);
+        return left > 0 ? (uint32_t)left : 0;
+    }
+    if (!running) return UINT32_MAX;
+    uint32_t elapsed = now - startedMs;
+    return elapsed > TIMEOUT_MS ? 0 : TIMEOUT_MS - elapsed + 1;
+}
+
+#endif // OPENVIBE_WITH_WIFI
@@ -0,0 +1,79 @@
+#ifndef WIFI_SCAN_CACHE_H
+#define WIFI_SCAN_CACHE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../hal/Hal.h"
+
+// Networks kept (strongest first) and how old a list may get before a
+// SCAN asks for a fresh one.
+#ifndef OPENVIBE_SCAN_MAX_NETWORKS
+#define OPENVIBE_SCAN_MAX_NETWORKS 16
+#endif
+#ifndef OPENVIBE_SCAN_MAX_AGE_MS
+#define OPENVIBE_SCAN_MAX_AGE_MS   30000
+#endif
+
+/**
+ * Last Wi-Fi scan, for provisioning clients to pick an SSID from.
+ *
+ * Scans run in the background (hal::wifiScanStart) and never while the
+ * station is associating; WiFiManager::loop() drives them.  A finished
+ * scan replaces the list in one go: one entry per SSID (the strongest
+ * AP's RSSI, channel and auth), hidden networks left out, strongest
+ * first, at most MAX_NETWORKS.
+ *
+ * request() is what SCAN and GET /scan call: it only asks for a new
+ * scan when the list is older than MAX_AGE_MS (or there is none yet),
+ * so the caller always answers at once with what is cached.  A scan
+ * the driver refuses to start stays asked for and is tried again after
+ * RETRY_MS, doubling up to MAX_AGE_MS.
+ */
+class WiFiScanCache {
+public:
+    static constexpr uint8_t  MAX_NETWORKS = OPENVIBE_SCAN_MAX_NETWORKS;
+    static constexpr uint32_t MAX_AGE_MS   = OPENVIBE_SCAN_MAX_AGE_MS;
+    static constexpr uint32_t TIMEOUT_MS   = 10000;   // a scan that never reports back
+    static constexpr uint32_t RETRY_MS     = 1000;    // first wait after a refused start
+
+    struct Network {
+        char    ssid[33];
+        int8_t  rssi;
+        uint8_t channel;
+        uint8_t auth;   // hal::WiFiScanEntry::authMode, 0 = open
+    };
+
+    WiFiScanCache();
+
+    void request(uint32_t now);               // refresh if stale
+    void loop(bool radioFree, uint32_t now);  // start / collect a scan
+    void cancel();                            // stop a running scan; it runs again later
+
+    bool     isScanning() const   { return running || wanted; }
+    bool     hasResults() const   { return scanned; }
+    uint32_t ageMs(uint32_t now) const { return now - scannedMs; }
+    uint8_t  count() const        { return n; }
+    const Network& at(uint8_t i) const { return list[i]; }
+
+    // {"ageMs":…,"scanning":…,"total":…,"networks":[[ssid,rssi,channel,auth],…]}
+    // added to `out`; networks stop where `out` would pass maxBytes.
+    void toJson(JsonObject out, uint32_t now, size_t maxBytes = SIZE_MAX) const;
+
+    uint32_t msUntilNextWork(uint32_t now) const;
+
+private:
+    Network  list[MAX_NETWORKS];
+    uint8_t  n;
+    bool     scanned;     // list holds a finished scan
+    uint32_t scannedMs;
+    bool     wanted;      // refresh asked for, not started yet
+    bool     running;
+    uint32_t startedMs;
+    uint32_t retryMs;     // backoff after a refused start, 0 = none
+    uint32_t retryAtMs;
+
+    void collect(int found, uint32_t now);
+    void insert(const hal::WiFiScanEntry& e, Network* out, uint8_t& count);
+};
+
+#endif // WIFI_SCAN_CACHE_H
@@ -0,0 +1,128 @@
+#include <unity.h>
+#include "../../src/power/BatteryMonitor.h"
+
+/**
+ * BatteryMonitor's filter, stepped by hand with a synthetic ADC
+ * (pio test -e native_test).  One sample() is one timer tick, so
+ * sample counts × SAMPLE_PERIOD_MS are the settling times a status
+ * reader sees.
+ */
+namespace {
+
+// Pin millivolts; the default 2:1 divider doubles them.
+class FakeAdc : public AdcSource {
+public:
+    uint32_t mv    = 1850;
+    uint32_t noise = 0;      // ± peak, per conversion
+    uint32_t lcg   = 12345;
+
+    bool begin() override { return true; }
+
+    uint32_t readMilliVolts() override {
+        if (!noise) return mv;
+        lcg = lcg * 1103515245u + 12345u;
+        return mv - noise + (lcg >> 16) % (2 * noise + 1);
+    }
+};
+
+BatteryMonitor::Config config() {
+    BatteryMonitor::Config cfg;
+    cfg.adcPin    = 35;
+    cfg.chargePin = -1;
+    return cfg;
+}
+
+// Samples until the reading is within 5 % of the step from `target`.
+uint32_t samplesToSettle(BatteryMonitor& mon, uint16_t from, uint16_t target) {
+    uint32_t band = (from > target ? from - target : target - from) / 20;
+    for (uint32_t n = 1; n <= 1000; ++n) {
+        mon.sample();
+        uint16_t mv  = mon.getMilliVolts();
+        uint32_t off = mv > target ? mv - target : target - mv;
+        if (off <= band) return n;
+    }
+    return UINT32_MAX;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+// ── Filter ───────────────────────────────────────────────────────────
+
+void test_first_sample_primes_the_filter() {
+    FakeAdc*       adc = new FakeAdc();
+    BatteryMonitor mon;
+    TEST_ASSERT_TRUE(mon.begin(adc, config()));
+    TEST_ASSERT_EQUAL_UINT16(3700, mon.getMilliVolts());
+}
+
+// alpha = 1/8: 1 - (7/8)^n >= 0.95 first at n = 23, i.e. 2.3 s at 10 Hz.
+void test_step_up_settles_in_23_samples() {
+    FakeAdc*       adc = new FakeAdc();
+    BatteryMonitor mon;
+    mon.begin(adc, config());
+
+    adc->mv = 2050;   // 3700 → 4100 mV
+    uint32_t n = samplesToSettle(mon, 3700, 4100);
+    TEST_ASSERT_EQUAL_UINT32(23, n);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2300, n * BatteryMonitor::SAMPLE_PERIOD_MS);
+
+    for (int i = 0; i < 200; ++i) mon.sample();
+    TEST_ASSERT_EQUAL_UINT16(4100, mon.getMilliVolts());
+    TEST_ASSERT_EQUAL_UINT8(88, mon.getPercent());
+}
+
+void test_step_down_never_overshoots() {
+    FakeAdc*       adc = new FakeAdc();
+    BatteryMonitor mon;
+    adc->mv = 2050;
+    mon.begin(adc, config());
+
+    adc->mv = 1850;   // 4100 → 3700 mV
+    uint16_t last = mon.getMilliVolts();
+    for (int i = 0; i < 200; ++i) {
+        mon.sample();
+        TEST_ASSERT_LESS_OR_EQUAL_UINT16(last, mon.getMilliVolts());
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT16(3700, mon.getMilliVolts());
+        last = mon.getMilliVolts();
+    }
+    TEST_ASSERT_EQUAL_UINT16(3700, last);
+}
+
+// ±40 mV per conversion at the pin is ±80 mV at the battery; the
+// oversampling and the IIR together hold the reading within 10 mV.
+void test_noise_is_filtered() {
+    FakeAdc*       adc = new FakeAdc();
+    BatteryMonitor mon;
+    adc->noise = 40;
+    mon.begin(adc, config());
+
+    for (int i = 0; i < 50; ++i) mon.sample();
+    for (int i = 0; i < 500; ++i) {
+        mon.sample();
+        TEST_ASSERT_UINT16_WITHIN(10, 3700, mon.getMilliVolts());
+    }
+}
+
+// ── Discharge curve ──────────────────────────────────────────────────
+
+void test_percent_from_curve() {
+    TEST_ASSERT_EQUAL_UINT8(100, BatteryMonitor::percentFromMilliVolts(4250));
+    TEST_ASSERT_EQUAL_UINT8(100, BatteryMonitor::percentFromMilliVolts(4200));
+    TEST_ASSERT_EQUAL_UINT8(50,  BatteryMonitor::percentFromMilliVolts(3840));
+    TEST_ASSERT_EQUAL_UINT8(3,   BatteryMonitor::percentFromMilliVolts(3440));
+    TEST_ASSERT_EQUAL_UINT8(0,   BatteryMonitor::percentFromMilliVolts(3270));
+    TEST_ASSERT_EQUAL_UINT8(0,   BatteryMonitor::percentFromMilliVolts(3000));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sample_primes_the_filter);
+    RUN_TEST(test_step_up_settles_in_23_samples);
+    RUN_TEST(test_step_down_never_overshoots);
+    RUN_TEST(test_noise_is_filtered);
+    RUN_TEST(test_percent_from_curve);
+    return UNITY_END();
+}
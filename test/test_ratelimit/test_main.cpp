@@ -0,0 +1,88 @@
+#include <unity.h>
+#include "../../src/commands/RateLimiter.h"
+#include "../../src/hal/Hal.h"
+
+/**
+ * RateLimiter against frames whose type the byte scan cannot read
+ * (pio test -e native_test).  BLE gets three config tokens and no
+ * refill, so the fourth config command must be dropped however it is
+ * spelled.  TELEMETRY_RATE for AUTO is the config command: it is
+ * refused in execute(), after the limiter, and changes nothing.
+ */
+namespace {
+
+constexpr uint16_t BURST = 3;
+
+// Admitted and handled as a transport does: the ack, or "" if dropped.
+String send(const char* json) {
+    RateLimiter& rl = RateLimiter::getInstance();
+    String       ack;
+    if (!rl.admitJson(SOURCE_BLE, 0, json, strlen(json), hal::millis())) return ack;
+    CommandProcessor::getInstance().handleJson(json, strlen(json), SOURCE_BLE, &ack);
+    return ack;
+}
+
+uint32_t configDropped() {
+    return RateLimiter::getInstance().counters(SOURCE_BLE, CLASS_CONFIG).dropped;
+}
+
+void sendConfig(const char* json) {
+    uint32_t before = configDropped();
+    for (uint16_t i = 0; i < BURST; ++i) TEST_ASSERT_FALSE(send(json).isEmpty());
+    TEST_ASSERT_TRUE(send(json).isEmpty());
+    TEST_ASSERT_EQUAL_UINT32(before + 1, configDropped());
+}
+
+} // namespace
+
+void setUp() {
+    RateLimiter& rl = RateLimiter::getInstance();
+    rl.setLimit(SOURCE_BLE, CLASS_CONFIG,  { 3600000, BURST });
+    rl.setLimit(SOURCE_BLE, CLASS_CONTROL, { 3600000, 100 });
+}
+void tearDown() {}
+
+// ── Plain ────────────────────────────────────────────────────────────
+
+void test_plain_config_is_limited() {
+    sendConfig("{\"requestType\":\"TELEMETRY_RATE\",\"transport\":\"AUTO\",\"id\":1}");
+}
+
+// ── Escaped ──────────────────────────────────────────────────────────
+
+void test_escaped_key_is_limited() {
+    sendConfig("{\"request\\u0054ype\":\"TELEMETRY_RATE\",\"transport\":\"AUTO\",\"id\":1}");
+}
+
+void test_escaped_name_is_limited() {
+    sendConfig("{\"requestType\":\"TELEMETRY\\u005fRATE\",\"transport\":\"AUTO\",\"id\":1}");
+}
+
+// Four hidden config items cost four tokens: the frame is dropped whole.
+void test_escaped_batch_items_are_limited() {
+    uint32_t before = configDropped();
+    TEST_ASSERT_TRUE(send("{\"requestType\":\"BATCH\",\"commands\":["
+                          "{\"requestType\":\"TELEMETRY\\u005fRATE\",\"transport\":\"AUTO\"},"
+                          "{\"request\\u0054ype\":\"TELEMETRY_RATE\",\"transport\":\"AUTO\"},"
+                          "{\"requestType\":\"TELEMETRY\\u005fRATE\",\"transport\":\"AUTO\"},"
+                          "{\"request\\u0054ype\":\"TELEMETRY_RATE\",\"transport\":\"AUTO\"}]}").isEmpty());
+    TEST_ASSERT_EQUAL_UINT32(before + 4, configDropped());
+    TEST_ASSERT_FALSE(send("{\"requestType\":\"TELEMETRY_RATE\",\"transport\":\"AUTO\",\"id\":1}").isEmpty());
+}
+
+// An escape that only hides a control command still costs control.
+void test_escaped_control_runs() {
+    uint32_t before = configDropped();
+    TEST_ASSERT_FALSE(send("{\"requestType\":\"INTENS\\u0049TY\",\"intensity\":0,\"id\":1}").isEmpty());
+    TEST_ASSERT_EQUAL_UINT32(before, configDropped());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_plain_config_is_limited);
+    RUN_TEST(test_escaped_key_is_limited);
+    RUN_TEST(test_escaped_name_is_limited);
+    RUN_TEST(test_escaped_batch_items_are_limited);
+    RUN_TEST(test_escaped_control_runs);
+    return UNITY_END();
+}
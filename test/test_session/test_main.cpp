@@ -0,0 +1,125 @@
+#include <unity.h>
+#include "../../src/commands/CommandProcessor.h"
+#include "../../src/session/SessionManager.h"
+
+/**
+ * Seq dedupe through CommandProcessor, with connections held the way
+ * the transports hold them (pio test -e native_test).  STATUS is the
+ * command: it runs anywhere and only flags a broadcast.
+ */
+namespace {
+
+// One client connection: what a transport keeps for it.
+struct Conn {
+    CommandSource src;
+    WireEncoding  encoding = WIRE_JSON;
+    uint32_t      session  = 0;
+
+    explicit Conn(CommandSource s) : src(s) {}
+
+    String send(const char* json) {
+        String ack;
+        CommandProcessor::getInstance().handleJson(json, strlen(json), src, &ack, &encoding, &session);
+        return ack;
+    }
+
+    String status(uint32_t seq) {
+        char json[80];
+        snprintf(json, sizeof(json), "{\"requestType\":\"STATUS\",\"id\":%u,\"seq\":%u}",
+                 (unsigned)seq, (unsigned)seq);
+        return send(json);
+    }
+
+    void hello(uint32_t id) {
+        char json[64];
+        snprintf(json, sizeof(json), "{\"requestType\":\"HELLO\",\"session\":%u}", (unsigned)id);
+        send(json);
+    }
+};
+
+bool ran(const String& ack) {
+    return ack.indexOf("\"result\":\"OK\"") >= 0 && ack.indexOf("duplicate") < 0;
+}
+
+bool duplicate(const String& ack) {
+    return ack.indexOf("\"duplicate\":true") >= 0;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+// ── Interleaved clients ──────────────────────────────────────────────
+
+// B's seqs stay B's however far A has counted.
+void test_two_clients_interleave() {
+    Conn a(SOURCE_WS_LOCAL), b(SOURCE_WS_LOCAL);
+    a.hello(100);
+    for (uint32_t s = 400; s <= 500; ++s) TEST_ASSERT_TRUE(ran(a.status(s)));
+
+    b.hello(200);
+    TEST_ASSERT_TRUE(ran(b.status(1)));
+    TEST_ASSERT_TRUE(ran(a.status(501)));
+    TEST_ASSERT_TRUE(ran(b.status(2)));
+    TEST_ASSERT_TRUE(duplicate(a.status(500)));
+    TEST_ASSERT_TRUE(duplicate(b.status(1)));
+}
+
+// Without HELLO each connection counts on its own.
+void test_unnamed_connections_are_private() {
+    Conn a(SOURCE_WS_LOCAL), b(SOURCE_WS_REMOTE);
+    TEST_ASSERT_TRUE(ran(a.status(300)));
+    TEST_ASSERT_TRUE(ran(b.status(5)));
+    TEST_ASSERT_TRUE(ran(a.status(301)));
+    TEST_ASSERT_TRUE(ran(b.status(6)));
+    TEST_ASSERT_TRUE(duplicate(a.status(300)));
+}
+
+// ── Failover ─────────────────────────────────────────────────────────
+
+// The command went out on WS and ran; the link dropped before the ack.
+// The client opens BLE, names its session and resends: not run again.
+// A new connection on the way does not clear the window.
+void test_resend_after_failover_is_not_rerun() {
+    Conn ws(SOURCE_WS_LOCAL);
+    ws.hello(300);
+    TEST_ASSERT_TRUE(ran(ws.status(41)));
+
+    Conn other(SOURCE_WS_LOCAL);   // someone else connects meanwhile
+    TEST_ASSERT_TRUE(ran(other.status(1)));
+
+    Conn ble(SOURCE_BLE);
+    ble.hello(300);
+    String ack = ble.status(41);
+    TEST_ASSERT_TRUE(duplicate(ack));
+    TEST_ASSERT_TRUE(ack.indexOf("\"result\":\"OK\"") >= 0);
+    TEST_ASSERT_TRUE(ran(ble.status(42)));
+}
+
+// ── HELLO ────────────────────────────────────────────────────────────
+
+void test_hello_session_bounds() {
+    Conn ws(SOURCE_WS_LOCAL);
+    ws.send("{\"requestType\":\"HELLO\",\"session\":0}");
+    TEST_ASSERT_EQUAL_UINT32(0, ws.session);
+    ws.send("{\"requestType\":\"HELLO\",\"session\":2147483648}");
+    TEST_ASSERT_EQUAL_UINT32(0, ws.session);
+    ws.hello(SessionManager::MAX_CLIENT_SESSION);
+    TEST_ASSERT_EQUAL_UINT32(SessionManager::MAX_CLIENT_SESSION, ws.session);
+
+    // No connection to hold it
+    String ack;
+    const char* json = "{\"requestType\":\"HELLO\",\"session\":7}";
+    CommandProcessor::getInstance().handleJson(json, strlen(json), SOURCE_REST, &ack);
+    TEST_ASSERT_TRUE(ack.indexOf("INVALID") >= 0);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_two_clients_interleave);
+    RUN_TEST(test_unnamed_connections_are_private);
+    RUN_TEST(test_resend_after_failover_is_not_rerun);
+    RUN_TEST(test_hello_session_bounds);
+    return UNITY_END();
+}
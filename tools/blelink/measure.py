@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Command latency over BLE in each link state (README "BLE connection
+parameters").
+
+A run connects once and goes through the states the device picks the
+connection parameters for:
+
+  active  a stream of INTENSITY writes at --rate (a slider being
+          dragged); the device asks for 15 ms within a second or so
+  idle    after OPENVIBE_BLE_IDLE_AFTER_MS of quiet, single writes
+          --gap seconds apart (a client that only polls); the device
+          has backed off to 90-120 ms with slave latency 4
+
+Latency is the write-with-response round trip: the ATT write and its
+response are exchanged in connection events, so it shows what the
+granted interval and slave latency cost a command.  The first writes
+of the stream go before the switch to 15 ms and are not timed
+(--warmup).
+
+--http also reads GET /power before and after: the "ble" object gives
+the parameters granted and the connection events the device woke for
+per state, i.e. the part of the radio duty cycle they decide.  The
+device must have Wi-Fi up (AUTO transport) for that.
+
+    python tools/blelink/measure.py --ble AA:BB:CC:DD:EE:FF --http 192.168.1.57
+    python tools/blelink/measure.py --ble-sim 127.0.0.1:7070 --http 127.0.0.1:8080
+
+--ble needs bleak (pip install bleak).  --ble-sim is the host build's
+simulated link: its central grants every request at once and nothing
+goes over the air, so it only checks the path and the state changes,
+it does not time BLE.
+
+Exit status is 1 if any command fails.
+"""
+
+import argparse
+import json
+import socket
+import statistics
+import sys
+import time
+
+WIFI_CHAR_UUID = "c2433dd7-137e-4e82-845e-a40f70dc4a8d"   # src/ble/BLEManager.h
+
+IDLE_AFTER_S = 5.0   # OPENVIBE_BLE_IDLE_AFTER_MS
+
+
+# ── Links ────────────────────────────────────────────────────────────
+
+class SimLink:
+    """Newline-delimited JSON over TCP; the round trip ends at the ack."""
+
+    def __init__(self, endpoint, timeout):
+        host, port = endpoint.rsplit(":", 1)
+        self.s   = socket.create_connection((host, int(port)), timeout=timeout)
+        self.buf = b""
+
+    def command(self, obj):
+        self.s.sendall(json.dumps(obj).encode() + b"\n")
+        while True:
+            while b"\n" not in self.buf:
+                chunk = self.s.recv(4096)
+                if not chunk:
+                    raise ConnectionError("BLE sim closed")
+                self.buf += chunk
+            line, self.buf = self.buf.split(b"\n", 1)
+            try:
+                msg = json.loads(line)
+            except ValueError:
+                continue
+            if msg.get("ack") == obj["id"]:
+                return msg.get("result") == "OK"
+
+    def close(self):
+        self.s.close()
+
+
+class BleLink:
+    """One bleak connection driven from a private event loop."""
+
+    def __init__(self, address, timeout):
+        import asyncio
+        from bleak import BleakClient
+        self.loop   = asyncio.new_event_loop()
+        self.client = BleakClient(address, timeout=timeout)
+        self.loop.run_until_complete(self.client.connect())
+
+    def command(self, obj):
+        self.loop.run_until_complete(
+            self.client.write_gatt_char(WIFI_CHAR_UUID, json.dumps(obj).encode(), response=True))
+        return True
+
+    def close(self):
+        self.loop.run_until_complete(self.client.disconnect())
+        self.loop.close()
+
+
+# ── GET /power ───────────────────────────────────────────────────────
+
+def ble_power(endpoint, timeout):
+    host, _, port = endpoint.partition(":")
+    s = socket.create_connection((host, int(port or 80)), timeout=timeout)
+    try:
+        s.sendall(("GET /power HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n" % host).encode())
+        buf = b""
+        while True:
+            chunk = s.recv(4096)
+            if not chunk:
+                break
+            buf += chunk
+    finally:
+        s.close()
+    return json.loads(buf.partition(b"\r\n\r\n")[2]).get("ble")
+
+
+def delta(before, after, state):
+    """Per-state counters over the run."""
+    a, b = after[state], (before or {}).get(state, {})
+    out = {k: a[k] - b.get(k, 0) for k in ("ms", "commands", "wakeups")}
+    out["wakeupsPerS"] = round(out["wakeups"] * 1000.0 / out["ms"], 1) if out["ms"] else 0.0
+    return out
+
+
+# ── Phases ───────────────────────────────────────────────────────────
+
+def phase(link, name, count, spacing, warmup, seq):
+    samples = []
+    for i in range(warmup + count):
+        sys.stderr.write("[blelink] %s %d/%d\n" % (name, i + 1, warmup + count))
+        seq[0] += 1
+        t0 = time.monotonic()
+        try:
+            ok = link.command({"requestType": "INTENSITY", "intensity": seq[0] % 50, "id": seq[0]})
+        except Exception as e:   # noqa: BLE001 — any failure is a failed command
+            sys.stderr.write("  %s\n" % e)
+            ok = False
+        ms = (time.monotonic() - t0) * 1000.0
+        if i >= warmup:
+            samples.append(ms if ok else None)
+        time.sleep(max(0.0, spacing - ms / 1000.0))
+    return samples
+
+
+def summary(name, samples, runs):
+    good = sorted(s for s in samples if s is not None)
+    row = {"state": name, "runs": runs, "ok": len(good)}
+    if good:
+        row["median_ms"] = round(statistics.median(good), 1)
+        row["p90_ms"]    = round(good[min(len(good) - 1, int(len(good) * 0.9))], 1)
+        row["max_ms"]    = round(good[-1], 1)
+    return row
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--ble", help="BLE address of the device (needs bleak)")
+    ap.add_argument("--ble-sim", help="host build BLE link, HOST:PORT")
+    ap.add_argument("--http", help="REST server, HOST[:PORT], to read GET /power")
+    ap.add_argument("--count", type=int, default=40, help="commands timed per state")
+    ap.add_argument("--rate", type=float, default=25.0, help="commands / s while streaming")
+    ap.add_argument("--gap", type=float, default=2.5, help="seconds between idle commands")
+    ap.add_argument("--warmup", type=int, default=3, help="commands not timed at the start of a state")
+    ap.add_argument("--timeout", type=float, default=10.0, help="seconds per step")
+    ap.add_argument("--json", action="store_true", help="one JSON object per state")
+    args = ap.parse_args()
+    if bool(args.ble) == bool(args.ble_sim):
+        ap.error("give one of --ble, --ble-sim")
+
+    link   = BleLink(args.ble, args.timeout) if args.ble else SimLink(args.ble_sim, args.timeout)
+    before = ble_power(args.http, args.timeout) if args.http else None
+    seq, rows = [0], []
+    try:
+        samples = phase(link, "active", args.count, 1.0 / args.rate, args.warmup, seq)
+        rows.append(summary("active", samples, args.count))
+
+        sys.stderr.write("[blelink] quiet %.0f s\n" % (IDLE_AFTER_S + 2))
+        time.sleep(IDLE_AFTER_S + 2)
+        # --gap keeps the idle writes from ever being a stream.
+        samples = phase(link, "idle", max(1, args.count // 4), args.gap, 0, seq)
+        rows.append(summary("idle", samples, max(1, args.count // 4)))
+
+        after = ble_power(args.http, args.timeout) if args.http else None
+    finally:
+        link.close()
+
+    if after:
+        for row in rows:
+            row.update(delta(before, after, row["state"]))
+        rows[-1]["grant"] = {k: after.get(k) for k in ("intervalMs", "latency", "timeoutMs")}
+
+    ok = all(row["ok"] == row["runs"] for row in rows)
+    if args.json:
+        for row in rows:
+            print(json.dumps(row))
+        return 0 if ok else 1
+
+    print("%-6s %5s %10s %10s %10s %10s" % ("state", "ok", "median ms", "p90 ms", "max ms", "wakeups/s"))
+    for row in rows:
+        print("%-6s %2d/%-2d %10s %10s %10s %10s" % (row["state"], row["ok"], row["runs"],
+                                                    row.get("median_ms", "-"), row.get("p90_ms", "-"),
+                                                    row.get("max_ms", "-"), row.get("wakeupsPerS", "-")))
+    if after:
+        print("\nnow %s: %s ms, latency %s, timeout %s ms; %d requests, %d updates" % (
+              after["state"], after.get("intervalMs", "-"), after.get("latency", "-"), after.get("timeoutMs", "-"),
+              after["requests"], after["updates"]))
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
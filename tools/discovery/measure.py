@@ -0,0 +1,332 @@
+#!/usr/bin/env python3
+"""Time to first command: DNS-SD discovery against the BLE bootstrap.
+
+Each run ends when the device acks an INTENSITY sent over its local
+WebSocket; what differs is how the client learns where that is:
+
+  dnssd  query _openvibe-ws._tcp.local (PTR, then SRV / TXT / A as
+         needed), connect to the address and port advertised
+  ble    connect over BLE, write STATUS, read "ipAddress" from the
+         status notification, connect to --ws-port
+
+The device must be on TRANSPORT_WIFI (the WS server only listens
+then).  Queries are sent from an ephemeral port, so the responder
+answers by unicast and nothing has to bind 5353.
+
+    python tools/discovery/measure.py --ble AA:BB:CC:DD:EE:FF
+    python tools/discovery/measure.py --mdns 127.0.0.1 --ble-sim 127.0.0.1:7070
+
+--ble needs bleak (pip install bleak).  --ble-sim is the host build's
+simulated link, which has no connection setup: it only checks the
+path, it does not time BLE.
+
+Exit status is 1 if any run fails.
+"""
+
+import argparse
+import base64
+import json
+import os
+import socket
+import statistics
+import struct
+import sys
+import time
+
+MDNS_GROUP = "224.0.0.251"
+SERVICE    = "_openvibe-ws._tcp.local"
+
+SERVICE_UUID    = "ec2e0883-782d-433b-9a0c-6d5df5565410"   # src/ble/BLEManager.h
+WIFI_CHAR_UUID  = "c2433dd7-137e-4e82-845e-a40f70dc4a8d"
+STATS_CHAR_UUID = "c2433dd7-137e-4e82-845e-a40f70dc4a8e"
+
+TYPE_A, TYPE_PTR, TYPE_TXT, TYPE_SRV = 1, 12, 16, 33
+
+
+# ── DNS ──────────────────────────────────────────────────────────────
+
+def encode_name(name):
+    out = b""
+    for label in name.rstrip(".").split("."):
+        out += bytes([len(label)]) + label.encode()
+    return out + b"\0"
+
+
+def read_name(msg, pos):
+    labels, jumped, end = [], False, pos
+    for _ in range(64):
+        n = msg[pos]
+        if n == 0:
+            return ".".join(labels), (end if jumped else pos + 1)
+        if n & 0xC0 == 0xC0:
+            if not jumped:
+                end = pos + 2
+            pos, jumped = ((n & 0x3F) << 8) | msg[pos + 1], True
+            continue
+        labels.append(msg[pos + 1:pos + 1 + n].decode("utf-8", "replace"))
+        pos += 1 + n
+    raise ValueError("name loop")
+
+
+def parse_records(msg):
+    """All answer / additional records as (name, type, data)."""
+    qd, an, ns, ar = struct.unpack(">4H", msg[4:12])
+    pos = 12
+    for _ in range(qd):
+        _, pos = read_name(msg, pos)
+        pos += 4
+    records = []
+    for _ in range(an + ns + ar):
+        name, pos = read_name(msg, pos)
+        rtype, _, _, rdlen = struct.unpack(">HHIH", msg[pos:pos + 10])
+        pos += 10
+        rdata = msg[pos:pos + rdlen]
+        if rtype == TYPE_PTR:
+            data = read_name(msg, pos)[0]
+        elif rtype == TYPE_SRV:
+            data = (struct.unpack(">H", rdata[4:6])[0], read_name(msg, pos + 6)[0])
+        elif rtype == TYPE_TXT:
+            data, i = {}, 0
+            while i < len(rdata):
+                item = rdata[i + 1:i + 1 + rdata[i]].decode("utf-8", "replace")
+                i += 1 + rdata[i]
+                if "=" in item:
+                    k, v = item.split("=", 1)
+                    data[k] = v
+        elif rtype == TYPE_A:
+            data = socket.inet_ntoa(rdata)
+        else:
+            data = rdata
+        records.append((name.lower(), rtype, data))
+        pos += rdlen
+    return records
+
+
+def query(sock, target, names, timeout):
+    """Ask for (name, type) pairs; returns the records of the first reply."""
+    qid = struct.unpack(">H", os.urandom(2))[0]
+    msg = struct.pack(">6H", qid, 0, len(names), 0, 0, 0)
+    for name, qtype in names:
+        msg += encode_name(name) + struct.pack(">HH", qtype, 1)
+    sock.sendto(msg, target)
+    deadline = time.monotonic() + timeout
+    while True:
+        left = deadline - time.monotonic()
+        if left <= 0:
+            return None
+        sock.settimeout(left)
+        try:
+            reply, _ = sock.recvfrom(9000)
+        except socket.timeout:
+            return None
+        if len(reply) >= 12 and struct.unpack(">H", reply[:2])[0] == qid:
+            return parse_records(reply)
+
+
+def discover(target, device_id, timeout):
+    """(host, port, txt) of the first matching _openvibe-ws instance."""
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    try:
+        records = query(sock, target, [(SERVICE, TYPE_PTR)], timeout) or []
+        for _, _, instance in [r for r in records if r[1] == TYPE_PTR and r[0] == SERVICE.lower()]:
+            instance = instance.lower()
+            found = {rtype: data for name, rtype, data in records if name == instance}
+            if TYPE_SRV not in found or TYPE_TXT not in found:
+                more = query(sock, target, [(instance, TYPE_SRV), (instance, TYPE_TXT)], timeout) or []
+                found.update({rtype: data for name, rtype, data in more if name == instance})
+            if TYPE_SRV not in found:
+                continue
+            txt = found.get(TYPE_TXT, {})
+            if device_id and txt.get("deviceId") != device_id:
+                continue
+            port, target_host = found[TYPE_SRV]
+            addrs = [d for n, t, d in records if t == TYPE_A and n == target_host.lower()]
+            if not addrs:
+                more = query(sock, target, [(target_host, TYPE_A)], timeout) or []
+                addrs = [d for n, t, d in more if t == TYPE_A]
+            if addrs:
+                return addrs[0], port, txt
+        return None
+    finally:
+        sock.close()
+
+
+# ── WebSocket (just enough for one command) ──────────────────────────
+
+def ws_first_command(host, port, timeout):
+    s = socket.create_connection((host, port), timeout=timeout)
+    try:
+        key = base64.b64encode(os.urandom(16)).decode()
+        s.sendall(("GET / HTTP/1.1\r\nHost: %s:%d\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                   "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n" % (host, port, key)).encode())
+        buf = b""
+        while b"\r\n\r\n" not in buf:
+            chunk = s.recv(4096)
+            if not chunk:
+                raise ConnectionError("closed during handshake")
+            buf += chunk
+        buf = buf.split(b"\r\n\r\n", 1)[1]
+
+        payload = json.dumps({"requestType": "INTENSITY", "intensity": 0, "id": 1}).encode()
+        mask = os.urandom(4)
+        s.sendall(bytes([0x81, 0x80 | len(payload)]) + mask
+                  + bytes(b ^ mask[i % 4] for i, b in enumerate(payload)))
+
+        while True:   # skip status pushes until the ack
+            while len(buf) < 2:
+                buf += s.recv(4096)
+            n, h = buf[1] & 0x7F, 2
+            if n == 126:
+                while len(buf) < 4:
+                    buf += s.recv(4096)
+                n, h = struct.unpack(">H", buf[2:4])[0], 4
+            while len(buf) < h + n:
+                buf += s.recv(4096)
+            frame, buf = buf[h:h + n], buf[h + n:]
+            try:
+                msg = json.loads(frame)
+            except ValueError:
+                continue
+            if msg.get("ack") == 1:
+                return msg.get("result") == "OK"
+    finally:
+        s.close()
+
+
+# ── BLE bootstrap ────────────────────────────────────────────────────
+
+def ble_sim_address(endpoint, timeout):
+    host, port = endpoint.rsplit(":", 1)
+    s = socket.create_connection((host, int(port)), timeout=timeout)
+    try:
+        s.sendall(b'{"requestType":"STATUS"}\n')
+        buf = b""
+        while True:
+            chunk = s.recv(4096)
+            if not chunk:
+                return None
+            buf += chunk
+            while b"\n" in buf:
+                line, buf = buf.split(b"\n", 1)
+                try:
+                    status = json.loads(line)
+                except ValueError:
+                    continue
+                if status.get("ipAddress"):
+                    return status["ipAddress"]
+    finally:
+        s.close()
+
+
+def ble_address(address, timeout):
+    import asyncio
+    from bleak import BleakClient
+
+    async def run():
+        got = asyncio.get_running_loop().create_future()
+        buf = bytearray()
+
+        def on_notify(_, data):
+            buf.extend(data)
+            try:
+                status = json.loads(buf)
+            except ValueError:
+                return
+            del buf[:]
+            if status.get("ipAddress") and not got.done():
+                got.set_result(status["ipAddress"])
+
+        async with BleakClient(address, timeout=timeout) as client:
+            await client.start_notify(STATS_CHAR_UUID, on_notify)
+            await client.write_gatt_char(WIFI_CHAR_UUID, b'{"requestType":"STATUS"}', response=True)
+            return await asyncio.wait_for(got, timeout)
+
+    return asyncio.run(run())
+
+
+# ── Runs ─────────────────────────────────────────────────────────────
+
+def timed(fn):
+    t0 = time.monotonic()
+    try:
+        ok = fn()
+    except Exception as e:   # noqa: BLE001 — any failure is a failed run
+        sys.stderr.write("  %s\n" % e)
+        ok = False
+    return (time.monotonic() - t0) * 1000.0 if ok else None
+
+
+def summary(name, samples, runs):
+    good = sorted(s for s in samples if s is not None)
+    row = {"path": name, "runs": runs, "ok": len(good)}
+    if good:
+        row["median_ms"] = round(statistics.median(good), 1)
+        row["p90_ms"]    = round(good[min(len(good) - 1, int(len(good) * 0.9))], 1)
+        row["max_ms"]    = round(good[-1], 1)
+    return row
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--mdns", help="responder to query by unicast, HOST[:PORT] (default: the mDNS group)")
+    ap.add_argument("--device-id", help="only this deviceId (TXT), when several devices answer")
+    ap.add_argument("--ble", help="BLE address of the device (needs bleak)")
+    ap.add_argument("--ble-sim", help="host build BLE link, HOST:PORT")
+    ap.add_argument("--ws-port", type=int, default=6969, help="WS port for the BLE path")
+    ap.add_argument("--runs", type=int, default=10)
+    ap.add_argument("--timeout", type=float, default=5.0, help="seconds per step")
+    ap.add_argument("--pause", type=float, default=0.5, help="seconds between runs")
+    ap.add_argument("--json", action="store_true", help="one JSON object per path")
+    args = ap.parse_args()
+
+    if args.mdns:
+        host, _, port = args.mdns.partition(":")
+        target = (host, int(port or 5353))
+    else:
+        target = (MDNS_GROUP, 5353)
+
+    def via_dnssd():
+        found = discover(target, args.device_id, args.timeout)
+        if not found:
+            raise LookupError("no %s answer" % SERVICE)
+        return ws_first_command(found[0], found[1], args.timeout)
+
+    def via_ble():
+        if args.ble:
+            ip = ble_address(args.ble, args.timeout)
+        else:
+            ip = ble_sim_address(args.ble_sim, args.timeout)
+        if not ip:
+            raise LookupError("no ipAddress in the status")
+        return ws_first_command(ip, args.ws_port, args.timeout)
+
+    paths = [("dnssd", via_dnssd)]
+    if args.ble or args.ble_sim:
+        paths.append(("ble", via_ble))
+
+    rows, ok = [], True
+    for name, fn in paths:
+        samples = []
+        for i in range(args.runs):
+            sys.stderr.write("[discovery] %s %d/%d\n" % (name, i + 1, args.runs))
+            samples.append(timed(fn))
+            time.sleep(args.pause)
+        row = summary(name, samples, args.runs)
+        ok = ok and row["ok"] == args.runs
+        rows.append(row)
+
+    if args.json:
+        for row in rows:
+            print(json.dumps(row))
+        return 0 if ok else 1
+
+    print("%-6s %5s %10s %10s %10s" % ("path", "ok", "median ms", "p90 ms", "max ms"))
+    for row in rows:
+        print("%-6s %2d/%-2d %10s %10s %10s" % (row["path"], row["ok"], row["runs"],
+                                             row.get("median_ms", "-"), row.get("p90_ms", "-"),
+                                             row.get("max_ms", "-")))
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,94 @@
+#include "HttpPoller.h"
+#include "../../src/hal/native/NativeNet.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+
+HttpPoller::HttpPoller(const std::string& h, uint16_t p, const std::string& path, uint32_t timeoutMs)
+    : host(h)
+    , port(p)
+    , timeoutUs((uint64_t)timeoutMs * 1000)
+    , state(IDLE)
+    , sock(-1)
+    , scheduledUs(0)
+    , startedUs(0) {
+    request = "GET " + path + " HTTP/1.1\r\nHost: " + host +
+              "\r\nAccept: application/json\r\nConnection: close\r\n\r\n";
+}
+
+HttpPoller::~HttpPoller() {
+    native::closeFd(sock);
+}
+
+bool HttpPoller::wantsWrite() const {
+    return state == CONNECTING || (state == SENDING && !tx.empty());
+}
+
+void HttpPoller::start(uint64_t due, uint64_t nowUs) {
+    scheduledUs = due;
+    startedUs   = nowUs;
+    rx.clear();
+    tx.clear();
+    sock  = native::connectTcp(host.c_str(), port);
+    state = CONNECTING;
+}
+
+HttpPoller::Outcome HttpPoller::finish(Outcome o, uint64_t nowUs, uint32_t& latencyUs) {
+    native::closeFd(sock);
+    state     = IDLE;
+    latencyUs = (uint32_t)(nowUs - scheduledUs);
+    return o;
+}
+
+HttpPoller::Outcome HttpPoller::poll(uint64_t nowUs, uint32_t& latencyUs) {
+    if (state == IDLE) return PENDING;
+    if (sock < 0) return finish(CONNECT_ERROR, nowUs, latencyUs);
+    if (nowUs - startedUs > timeoutUs) return finish(TIMEOUT, nowUs, latencyUs);
+
+    if (state == CONNECTING) {
+        bool ok = false;
+        if (!native::connectFinished(sock, ok)) return PENDING;
+        if (!ok) return finish(CONNECT_ERROR, nowUs, latencyUs);
+        state = SENDING;
+        if (!native::writeQueued(sock, tx, (const uint8_t*)request.data(), request.size())) {
+            return finish(HTTP_ERROR, nowUs, latencyUs);
+        }
+    }
+
+    if (state == SENDING) {
+        if (!native::flushQueued(sock, tx)) return finish(HTTP_ERROR, nowUs, latencyUs);
+        if (!tx.empty()) return PENDING;
+        state = READING;
+    }
+
+    bool    open = native::readAvailable(sock, rx);
+    Outcome o    = parseResponse(!open);
+    return o == PENDING ? PENDING : finish(o, nowUs, latencyUs);
+}
+
+HttpPoller::Outcome HttpPoller::parseResponse(bool peerClosed) const {
+    static const char SEP[] = "\r\n\r\n";
+    const char* begin = (const char*)rx.data();
+    const char* end   = begin + rx.size();
+    const char* head  = std::search(begin, end, SEP, SEP + 4);
+
+    if (head == end) return peerClosed ? HTTP_ERROR : PENDING;
+
+    std::string headers(begin, head);
+    size_t      bodyLen = end - (head + 4);
+    int         status  = 0;
+    if (headers.compare(0, 5, "HTTP/") == 0) {
+        size_t sp = headers.find(' ');
+        if (sp != std::string::npos) status = atoi(headers.c_str() + sp + 1);
+    }
+
+    // Complete once Content-Length bytes arrived, or at close without one.
+    long        contentLength = -1;
+    const char* cl            = strcasestr(headers.c_str(), "\r\nContent-Length:");
+    if (cl) contentLength = strtol(cl + 17, nullptr, 10);
+
+    bool complete = contentLength >= 0 ? bodyLen >= (size_t)contentLength : peerClosed;
+    if (!complete) return peerClosed ? HTTP_ERROR : PENDING;
+    return status == 200 ? OK : HTTP_ERROR;
+}
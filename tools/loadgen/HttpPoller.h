@@ -0,0 +1,56 @@
+#ifndef LOADGEN_HTTP_POLLER_H
+#define LOADGEN_HTTP_POLLER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * One REST client doing what the apps do: a fresh connection per
+ * GET (the device answers with Connection: close), fully non-blocking
+ * so hundreds of pollers share the load generator's single thread.
+ */
+class HttpPoller {
+public:
+    enum Outcome {
+        PENDING,
+        OK,              // 200 with a complete body
+        HTTP_ERROR,      // other status, or truncated response
+        CONNECT_ERROR,   // refused / unreachable
+        TIMEOUT
+    };
+
+    HttpPoller(const std::string& host, uint16_t port, const std::string& path, uint32_t timeoutMs);
+    ~HttpPoller();
+
+    bool busy() const { return state != IDLE; }
+    int  fd() const   { return sock; }
+    bool wantsWrite() const;
+
+    // Begin a request that was due at scheduledUs (latency counts from there).
+    void start(uint64_t scheduledUs, uint64_t nowUs);
+
+    // Advance I/O; once it returns something other than PENDING the
+    // poller is idle again and latencyUs holds the round trip.
+    Outcome poll(uint64_t nowUs, uint32_t& latencyUs);
+
+private:
+    enum State { IDLE, CONNECTING, SENDING, READING };
+
+    std::string          host;
+    uint16_t             port;
+    std::string          request;
+    uint64_t             timeoutUs;
+
+    State                state;
+    int                  sock;
+    uint64_t             scheduledUs;
+    uint64_t             startedUs;
+    std::vector<uint8_t> tx;
+    std::vector<uint8_t> rx;
+
+    Outcome finish(Outcome o, uint64_t nowUs, uint32_t& latencyUs);
+    Outcome parseResponse(bool peerClosed) const;
+};
+
+#endif // LOADGEN_HTTP_POLLER_H
@@ -0,0 +1,506 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WebSocketsClient.h>
+#include "HttpPoller.h"
+#include "LatencyRecorder.h"
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <poll.h>
+#include <signal.h>
+
+/**
+ * Load generator for the local WebSocket server and REST API, aimed at
+ * a real device or the host build (`pio run -e native`).
+ *
+ *   .pio/build/loadgen/program [--host ADDR] [--ws-port N] [--http-port N]
+ *        [--ws-clients N] [--rate MSG_PER_S] [--mix intensity=80,status=15,switch=5]
+ *        [--http-pollers N] [--poll-rate REQ_PER_S] [--duration S]
+ *        [--ramp STEP] [--step S] [--max-p99-ms N] [--max-loss-pct X]
+ *        [--ack-timeout-ms N] [--json]
+ *
+ * Sends are open-loop: every message has a scheduled time and latency is
+ * measured from that time to its {"ack":id} (see CommandProcessor), so a
+ * stalled device loop shows up in the tail instead of silently lowering
+ * the offered rate.  A send that falls due while its client is
+ * disconnected is counted as skipped.  SWITCH_TRANSPORT always asks for
+ * WIFI so the server under test stays up.
+ *
+ * --ramp raises the WS rate by STEP every --step seconds until p99 or
+ * loss crosses its limit, then reports the last rate that held — where
+ * the single-loop WiFiManager saturates.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t nowUs() {
+    static const Clock::time_point t0 = Clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count();
+}
+
+volatile sig_atomic_t interrupted = 0;
+void onSignal(int) { interrupted = 1; }
+
+// ── Options ──────────────────────────────────────────────────────────
+
+enum CommandKind : uint8_t { KIND_INTENSITY, KIND_STATUS, KIND_SWITCH, KIND_COUNT };
+const char* const KIND_NAMES[KIND_COUNT] = { "intensity", "status", "switch" };
+
+struct Options {
+    std::string host          = "127.0.0.1";
+    uint16_t    wsPort        = 6969;
+    uint16_t    httpPort      = 80;
+    uint16_t    wsClients     = 4;
+    uint16_t    httpPollers   = 1;
+    double      rate          = 50;    // WS messages/s across all clients
+    double      pollRate      = 2;     // GET /status per second across all pollers
+    uint32_t    durationS     = 10;
+    uint32_t    weights[KIND_COUNT] = { 80, 20, 0 };
+    uint32_t    ackTimeoutMs  = 2000;
+    uint32_t    httpTimeoutMs = 2000;
+    double      rampStep      = 0;
+    uint32_t    stepS         = 5;
+    uint32_t    maxP99Ms      = 250;
+    double      maxLossPct    = 1.0;
+    bool        json          = false;
+};
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [--host ADDR] [--ws-port N] [--http-port N]\n"
+            "          [--ws-clients N] [--rate MSG_PER_S] [--mix intensity=80,status=15,switch=5]\n"
+            "          [--http-pollers N] [--poll-rate REQ_PER_S] [--duration S]\n"
+            "          [--ramp STEP] [--step S] [--max-p99-ms N] [--max-loss-pct X]\n"
+            "          [--ack-timeout-ms N] [--json]\n",
+            prog);
+}
+
+bool parseMix(const char* spec, uint32_t weights[KIND_COUNT]) {
+    uint32_t w[KIND_COUNT] = {};
+    std::string s(spec);
+    size_t pos = 0;
+    while (pos < s.size()) {
+        size_t comma = s.find(',', pos);
+        std::string item = s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        pos = comma == std::string::npos ? s.size() : comma + 1;
+
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) return false;
+        std::string name = item.substr(0, eq);
+        int k = 0;
+        while (k < KIND_COUNT && name != KIND_NAMES[k]) ++k;
+        if (k == KIND_COUNT) return false;
+        w[k] = (uint32_t)atoi(item.c_str() + eq + 1);
+    }
+    if (w[KIND_INTENSITY] + w[KIND_STATUS] + w[KIND_SWITCH] == 0) return false;
+    memcpy(weights, w, sizeof(w));
+    return true;
+}
+
+// ── Counters for one reporting window ────────────────────────────────
+
+struct Window {
+    uint32_t sent          = 0;
+    uint32_t acked         = 0;
+    uint32_t rejected      = 0;   // ack with result != OK
+    uint32_t timedOut      = 0;
+    uint32_t skipped       = 0;   // due while the client was down
+    uint32_t clientsOpen   = 0;
+    uint32_t statusFrames  = 0;
+    uint32_t connects      = 0;
+    uint32_t disconnects   = 0;
+    uint32_t sentByKind[KIND_COUNT] = {};
+
+    uint32_t httpOk        = 0;
+    uint32_t httpErrors    = 0;
+    uint32_t httpConnErr   = 0;
+    uint32_t httpTimeouts  = 0;
+    uint32_t httpSkipped   = 0;   // poller still busy with the previous GET
+
+    LatencyRecorder wsLatency;
+    LatencyRecorder httpLatency;
+
+    double lossPct() const {
+        uint32_t offered = sent + skipped;
+        return offered ? 100.0 * (timedOut + rejected + skipped) / offered : 0.0;
+    }
+};
+
+// ── Load generator ───────────────────────────────────────────────────
+
+class LoadGen {
+public:
+    explicit LoadGen(const Options& o) : opt(o) {}
+
+    void connect();
+    void runWindow(double wsRate, uint32_t seconds, Window& w, Window& total);
+    void report(const char* label, double wsRate, uint32_t seconds, Window& w) const;
+
+private:
+    struct Pending {
+        uint64_t scheduledUs;
+        uint8_t  kind;
+    };
+    struct Slot {
+        WebSocketsClient client;
+        bool             open       = false;
+        bool             sending    = false;   // part of this window's schedule
+        uint64_t         nextSendUs = 0;
+    };
+    struct Poller {
+        std::unique_ptr<HttpPoller> http;
+        uint64_t                    nextPollUs = 0;
+    };
+
+    const Options&                          opt;
+    std::vector<std::unique_ptr<Slot>>      slots;
+    std::vector<Poller>                     pollers;
+    std::unordered_map<uint32_t, Pending>   pending;
+    uint32_t                                nextId = 1;
+    uint32_t                                rng    = 0x2545F491;
+    Window*                                 win    = nullptr;
+    Window*                                 tot    = nullptr;
+
+    uint8_t pickKind();
+    void    send(Slot& s, uint64_t scheduledUs);
+    void    onEvent(Slot& s, WStype_t type, uint8_t* payload, size_t len);
+    void    expireAcks(uint64_t now);
+    void    waitForIo(uint64_t untilUs);
+};
+
+void LoadGen::connect() {
+    for (uint16_t i = 0; i < opt.wsClients; ++i) {
+        slots.emplace_back(new Slot());
+        Slot* s = slots.back().get();
+        s->client.setReconnectInterval(500);
+        s->client.onEvent([this, s](WStype_t t, uint8_t* p, size_t l) { onEvent(*s, t, p, l); });
+        s->client.begin(opt.host.c_str(), opt.wsPort, "/");
+    }
+    for (uint16_t i = 0; i < opt.httpPollers; ++i) {
+        Poller p;
+        p.http.reset(new HttpPoller(opt.host, opt.httpPort, "/status", opt.httpTimeoutMs));
+        pollers.push_back(std::move(p));
+    }
+
+    // Give every client a chance to open before the clock starts.
+    uint64_t deadline = nowUs() + 3000000;
+    while (!interrupted && nowUs() < deadline) {
+        bool allOpen = true;
+        for (auto& s : slots) {
+            s->client.loop();
+            allOpen &= s->open;
+        }
+        if (allOpen) break;
+        waitForIo(nowUs() + 2000);
+    }
+
+    size_t open = 0;
+    for (auto& s : slots) open += s->open;
+    fprintf(stderr, "[loadgen] %u/%u WebSocket clients open on %s:%u\n",
+            (unsigned)open, (unsigned)slots.size(), opt.host.c_str(), (unsigned)opt.wsPort);
+}
+
+uint8_t LoadGen::pickKind() {
+    rng = rng * 1664525u + 1013904223u;
+    uint32_t sum  = opt.weights[0] + opt.weights[1] + opt.weights[2];
+    uint32_t roll = (rng >> 8) % sum;
+    for (uint8_t k = 0; k < KIND_COUNT; ++k) {
+        if (roll < opt.weights[k]) return k;
+        roll -= opt.weights[k];
+    }
+    return KIND_STATUS;
+}
+
+void LoadGen::send(Slot& s, uint64_t scheduledUs) {
+    uint8_t  kind = pickKind();
+    uint32_t id   = nextId++;
+    char     msg[128];
+
+    switch (kind) {
+        case KIND_INTENSITY:
+            snprintf(msg, sizeof(msg), "{\"requestType\":\"INTENSITY\",\"intensity\":%u,\"id\":%u}",
+                     (unsigned)(id % 101), (unsigned)id);
+            break;
+        case KIND_SWITCH:
+            snprintf(msg, sizeof(msg), "{\"requestType\":\"SWITCH_TRANSPORT\",\"transport\":\"WIFI\",\"id\":%u}",
+                     (unsigned)id);
+            break;
+        default:
+            snprintf(msg, sizeof(msg), "{\"requestType\":\"STATUS\",\"id\":%u}", (unsigned)id);
+            break;
+    }
+
+    if (!s.client.sendTXT(msg, strlen(msg))) {
+        win->skipped++;
+        tot->skipped++;
+        return;
+    }
+    pending[id] = { scheduledUs, kind };
+    win->sent++;
+    tot->sent++;
+    win->sentByKind[kind]++;
+    tot->sentByKind[kind]++;
+}
+
+void LoadGen::onEvent(Slot& s, WStype_t type, uint8_t* payload, size_t len) {
+    switch (type) {
+        case WStype_CONNECTED:
+            s.open = true;
+            if (win) { win->connects++; tot->connects++; }
+            break;
+
+        case WStype_DISCONNECTED:
+            if (s.open && win) { win->disconnects++; tot->disconnects++; }
+            s.open = false;
+            break;
+
+        case WStype_TEXT: {
+            if (!win) break;
+            if (len < 7 || memcmp(payload, "{\"ack\":", 7) != 0) {
+                win->statusFrames++;
+                tot->statusFrames++;
+                break;
+            }
+            JsonDocument doc;
+            if (deserializeJson(doc, (const char*)payload, len)) break;
+            auto it = pending.find(doc["ack"].as<uint32_t>());
+            if (it == pending.end()) break;   // already timed out
+
+            const char* result = doc["result"] | "";
+            if (strcmp(result, "OK") == 0) {
+                uint32_t us = (uint32_t)(nowUs() - it->second.scheduledUs);
+                win->acked++;
+                tot->acked++;
+                win->wsLatency.add(us);
+                tot->wsLatency.add(us);
+            } else {
+                win->rejected++;
+                tot->rejected++;
+            }
+            pending.erase(it);
+            break;
+        }
+
+        default: break;
+    }
+}
+
+void LoadGen::expireAcks(uint64_t now) {
+    uint64_t limit = (uint64_t)opt.ackTimeoutMs * 1000;
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (now - it->second.scheduledUs > limit) {
+            win->timedOut++;
+            tot->timedOut++;
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void LoadGen::waitForIo(uint64_t untilUs) {
+    std::vector<pollfd> fds;
+    for (auto& s : slots) {
+        int fd = s->client.socketFd();
+        if (fd >= 0) fds.push_back({ fd, POLLIN, 0 });
+    }
+    for (auto& p : pollers) {
+        int fd = p.http->fd();
+        if (fd >= 0) fds.push_back({ fd, (short)(p.http->wantsWrite() ? POLLOUT : POLLIN), 0 });
+    }
+    uint64_t now     = nowUs();
+    int      timeout = untilUs > now ? (int)std::min<uint64_t>((untilUs - now + 999) / 1000, 2) : 0;
+    ::poll(fds.data(), fds.size(), timeout);
+}
+
+void LoadGen::runWindow(double wsRate, uint32_t seconds, Window& w, Window& total) {
+    win = &w;
+    tot = &total;
+
+    // The rate is spread over clients that are open now; ones the server
+    // refused (it caps concurrent clients) keep retrying but never send.
+    std::vector<Slot*> active;
+    for (auto& sp : slots) {
+        sp->sending = sp->open;
+        if (sp->open) active.push_back(sp.get());
+    }
+    w.clientsOpen = total.clientsOpen = (uint32_t)active.size();
+
+    uint64_t start      = nowUs();
+    uint64_t end        = start + (uint64_t)seconds * 1000000;
+    uint64_t wsInterval = wsRate > 0 && !active.empty() ? (uint64_t)(1e6 * active.size() / wsRate) : 0;
+    uint64_t pollEvery  = opt.pollRate > 0 ? (uint64_t)(1e6 * pollers.size() / opt.pollRate) : 0;
+
+    // Stagger clients/pollers evenly across one interval.
+    for (size_t i = 0; i < active.size(); ++i) {
+        active[i]->nextSendUs = start + wsInterval * i / active.size();
+    }
+    for (size_t i = 0; i < pollers.size(); ++i) {
+        pollers[i].nextPollUs = start + (pollEvery ? pollEvery * i / pollers.size() : 0);
+    }
+
+    while (!interrupted) {
+        uint64_t now = nowUs();
+        if (now >= end) break;
+        uint64_t nextDue = end;
+
+        for (auto& sp : slots) {
+            Slot& s = *sp;
+            s.client.loop();
+            if (!wsInterval || !s.sending) continue;
+            while (s.nextSendUs <= now) {
+                if (s.open) send(s, s.nextSendUs);
+                else { w.skipped++; total.skipped++; }
+                s.nextSendUs += wsInterval;
+            }
+            nextDue = std::min(nextDue, s.nextSendUs);
+        }
+
+        for (auto& p : pollers) {
+            uint32_t            us = 0;
+            HttpPoller::Outcome o  = p.http->poll(now, us);
+            switch (o) {
+                case HttpPoller::OK:
+                    w.httpOk++; total.httpOk++;
+                    w.httpLatency.add(us); total.httpLatency.add(us);
+                    break;
+                case HttpPoller::HTTP_ERROR:    w.httpErrors++;   total.httpErrors++;   break;
+                case HttpPoller::CONNECT_ERROR: w.httpConnErr++;  total.httpConnErr++;  break;
+                case HttpPoller::TIMEOUT:       w.httpTimeouts++; total.httpTimeouts++; break;
+                default: break;
+            }
+            if (!pollEvery) continue;
+            while (p.nextPollUs <= now) {
+                if (p.http->busy()) { w.httpSkipped++; total.httpSkipped++; }
+                else p.http->start(p.nextPollUs, now);
+                p.nextPollUs += pollEvery;
+            }
+            nextDue = std::min(nextDue, p.nextPollUs);
+        }
+
+        expireAcks(now);
+        waitForIo(nextDue);
+    }
+}
+
+void LoadGen::report(const char* label, double wsRate, uint32_t seconds, Window& w) const {
+    double secs = seconds ? (double)seconds : 1.0;
+    if (opt.json) {
+        printf("{\"window\":\"%s\",\"target_rate\":%.1f,\"seconds\":%u,"
+               "\"ws\":{\"clients_open\":%u,\"sent\":%u,\"acked\":%u,\"rejected\":%u,\"timeouts\":%u,\"skipped\":%u,"
+               "\"ack_per_s\":%.1f,\"status_frames\":%u,\"connects\":%u,\"disconnects\":%u,"
+               "\"p50_us\":%u,\"p99_us\":%u,\"p999_us\":%u,\"max_us\":%u,\"loss_pct\":%.3f},"
+               "\"http\":{\"ok\":%u,\"errors\":%u,\"connect_errors\":%u,\"timeouts\":%u,\"skipped\":%u,"
+               "\"p50_us\":%u,\"p99_us\":%u,\"p999_us\":%u}}\n",
+               label, wsRate, (unsigned)seconds,
+               w.clientsOpen, w.sent, w.acked, w.rejected, w.timedOut, w.skipped,
+               w.acked / secs, w.statusFrames, w.connects, w.disconnects,
+               w.wsLatency.percentile(0.5), w.wsLatency.percentile(0.99),
+               w.wsLatency.percentile(0.999), w.wsLatency.percentile(1.0), w.lossPct(),
+               w.httpOk, w.httpErrors, w.httpConnErr, w.httpTimeouts, w.httpSkipped,
+               w.httpLatency.percentile(0.5), w.httpLatency.percentile(0.99),
+               w.httpLatency.percentile(0.999));
+        fflush(stdout);
+        return;
+    }
+
+    fprintf(stderr,
+            "[%s] target %.0f msg/s over %us\n"
+            "  WS   clients %u/%u  sent %u (intensity %u / status %u / switch %u)  acked %u (%.1f/s)  rejected %u  "
+            "timeouts %u  skipped %u  loss %.2f %%\n"
+            "       latency p50 %.2f ms  p99 %.2f ms  p999 %.2f ms  max %.2f ms\n"
+            "       status frames %u (%.1f/s)  connects %u  disconnects %u\n"
+            "  HTTP ok %u  errors %u  connect errors %u  timeouts %u  skipped %u\n"
+            "       latency p50 %.2f ms  p99 %.2f ms  p999 %.2f ms\n",
+            label, wsRate, (unsigned)seconds,
+            w.clientsOpen, (unsigned)slots.size(), w.sent,
+            w.sentByKind[KIND_INTENSITY], w.sentByKind[KIND_STATUS], w.sentByKind[KIND_SWITCH],
+            w.acked, w.acked / secs, w.rejected, w.timedOut, w.skipped, w.lossPct(),
+            w.wsLatency.percentile(0.5) / 1000.0, w.wsLatency.percentile(0.99) / 1000.0,
+            w.wsLatency.percentile(0.999) / 1000.0, w.wsLatency.percentile(1.0) / 1000.0,
+            w.statusFrames, w.statusFrames / secs, w.connects, w.disconnects,
+            w.httpOk, w.httpErrors, w.httpConnErr, w.httpTimeouts, w.httpSkipped,
+            w.httpLatency.percentile(0.5) / 1000.0, w.httpLatency.percentile(0.99) / 1000.0,
+            w.httpLatency.percentile(0.999) / 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const char* a    = argv[i];
+        const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool        ok   = true;
+
+        if      (!strcmp(a, "--host")           && next) { opt.host = next; ++i; }
+        else if (!strcmp(a, "--ws-port")        && next) { opt.wsPort = (uint16_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--http-port")      && next) { opt.httpPort = (uint16_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--ws-clients")     && next) { opt.wsClients = (uint16_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--http-pollers")   && next) { opt.httpPollers = (uint16_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--rate")           && next) { opt.rate = atof(next); ++i; }
+        else if (!strcmp(a, "--poll-rate")      && next) { opt.pollRate = atof(next); ++i; }
+        else if (!strcmp(a, "--duration")       && next) { opt.durationS = (uint32_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--mix")            && next) { ok = parseMix(next, opt.weights); ++i; }
+        else if (!strcmp(a, "--ack-timeout-ms") && next) { opt.ackTimeoutMs = (uint32_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--ramp")           && next) { opt.rampStep = atof(next); ++i; }
+        else if (!strcmp(a, "--step")           && next) { opt.stepS = (uint32_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--max-p99-ms")     && next) { opt.maxP99Ms = (uint32_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--max-loss-pct")   && next) { opt.maxLossPct = atof(next); ++i; }
+        else if (!strcmp(a, "--json"))                   { opt.json = true; }
+        else if (!strcmp(a, "--help"))                   { usage(argv[0]); return 0; }
+        else ok = false;
+
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    signal(SIGINT,  onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    LoadGen gen(opt);
+    gen.connect();
+
+    Window total;
+    if (opt.rampStep <= 0) {
+        Window w;
+        gen.runWindow(opt.rate, opt.durationS, w, total);
+        gen.report("run", opt.rate, opt.durationS, total);
+        return total.timedOut || total.rejected ? 1 : 0;
+    }
+
+    // ── Ramp until the device stops keeping up ───────────────────────
+    double   rate      = opt.rate;
+    double   lastGood  = 0;
+    double   lastRun   = rate;
+    uint32_t elapsed   = 0;
+    uint32_t step      = 0;
+    char     label[32];
+    while (!interrupted && elapsed + opt.stepS <= opt.durationS) {
+        Window w;
+        gen.runWindow(rate, opt.stepS, w, total);
+        snprintf(label, sizeof(label), "step %u", (unsigned)++step);
+        gen.report(label, rate, opt.stepS, w);
+        elapsed += opt.stepS;
+        lastRun  = rate;
+
+        bool held = w.wsLatency.percentile(0.99) <= opt.maxP99Ms * 1000u && w.lossPct() <= opt.maxLossPct;
+        if (!held) break;
+        lastGood = rate;
+        rate += opt.rampStep;
+    }
+
+    gen.report("total", lastRun, elapsed, total);
+    if (opt.json) {
+        printf("{\"saturation_rate\":%.1f,\"limit_p99_ms\":%u,\"limit_loss_pct\":%.2f}\n",
+               lastGood, (unsigned)opt.maxP99Ms, opt.maxLossPct);
+    } else {
+        fprintf(stderr, "Sustained up to %.0f msg/s (p99 <= %u ms, loss <= %.2f %%)\n",
+                lastGood, (unsigned)opt.maxP99Ms, opt.maxLossPct);
+    }
+    return 0;
+}
@@ -0,0 +1,422 @@
+#include <Arduino.h>
+#include "../../src/DeviceContext.h"
+#include "../../src/ConfigManager.h"
+#include "../../src/commands/CommandProcessor.h"
+#include "../../src/trace/TraceRecorder.h"
+#include "../../src/log/Logger.h"
+#include "../../src/protocol/WireProtocol.h"
+#include "../../src/hal/Hal.h"
+#include "../../src/hal/native/NativeSim.h"
+#include "../loadgen/LatencyRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <signal.h>
+#include <unistd.h>
+
+/**
+ * Deterministic replay of a command trace (see src/trace/TraceRecorder.h)
+ * through the host build of the firmware.
+ *
+ *   .pio/build/replay/program TRACE [--speed X] [--transport BLE|WIFI|REMOTE]
+ *                             [--settle-ms N] [--print] [--verbose] [--json]
+ *
+ * TRACE is either the binary from GET /trace (or <nvs-dir>/fs/trace.bin)
+ * or a serial log containing a TRACE-BEGIN … TRACE-END dump; the last
+ * dump in the log is used.
+ *
+ * The firmware boots on a private NVS in the transport the trace
+ * started in, then every recorded frame is handed to CommandProcessor
+ * with its original source, spaced by the recorded gaps divided by
+ * --speed (0 = back to back, one service() pass still runs in between).
+ * Each result is compared with the recorded one and the active
+ * transport with the recorded transitions; any mismatch is a
+ * divergence and the exit status is 1.  TRACE and OTA commands and
+ * frames truncated at record time are skipped.  MessagePack frames go through
+ * handleMsgPack(); each WebSocket source keeps the encoding its HELLOs
+ * selected, and each connection source (BLE too) the seq session, as
+ * the connection did.
+ *
+ * Servers bind the ports set in [env:replay], so a simulator on the
+ * default ports can keep running.
+ */
+
+void setup();
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t nowUs() {
+    static const Clock::time_point t0 = Clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count();
+}
+
+volatile sig_atomic_t interrupted = 0;
+void onSignal(int) { interrupted = 1; }
+
+struct Options {
+    const char* path      = nullptr;
+    const char* transport = nullptr;
+    double      speed     = 1.0;
+    uint32_t    settleMs  = 500;
+    bool        print     = false;
+    bool        verbose   = false;
+    bool        json      = false;
+};
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s TRACE [--speed X] [--transport BLE|WIFI|REMOTE] [--settle-ms N]\n"
+            "          [--print] [--verbose] [--json]\n",
+            prog);
+}
+
+// ── Loading ──────────────────────────────────────────────────────────
+
+bool readFile(const char* path, std::string& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    char   buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+int base64Value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+void base64Decode(const std::string& text, std::vector<uint8_t>& out) {
+    uint32_t acc  = 0;
+    int      bits = 0;
+    for (char c : text) {
+        int v = base64Value(c);
+        if (v < 0) continue;   // padding, CR/LF, log prefixes
+        acc   = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back((uint8_t)(acc >> bits));
+        }
+    }
+}
+
+// Binary as-is, or the last TRACE-BEGIN … TRACE-END block of a log.
+bool loadTrace(const char* path, std::vector<uint8_t>& out) {
+    std::string text;
+    if (!readFile(path, text)) return false;
+
+    if (text.compare(0, 4, "OVTR") == 0) {
+        out.assign(text.begin(), text.end());
+        return true;
+    }
+
+    size_t begin = text.rfind("TRACE-BEGIN");
+    if (begin == std::string::npos) return false;
+    size_t end = text.find("TRACE-END", begin);
+    if (end == std::string::npos) return false;
+
+    size_t bodyStart = text.find('\n', begin);
+    if (bodyStart == std::string::npos || bodyStart > end) return false;
+    base64Decode(text.substr(bodyStart, end - bodyStart), out);
+    return true;
+}
+
+// ── Naming ───────────────────────────────────────────────────────────
+
+const char* transportName(uint8_t t) {
+    switch (t) {
+        case TRANSPORT_BLE:    return "BLE";
+        case TRANSPORT_WIFI:   return "WIFI";
+        case TRANSPORT_REMOTE: return "REMOTE";
+        case TRANSPORT_AUTO:   return "AUTO";
+        default:               return "?";
+    }
+}
+
+// Mirrors WiFiManager::WiFiState.
+const char* wifiStateName(uint8_t s) {
+    static const char* const NAMES[] = { "IDLE", "CONNECTING", "CONNECTED", "FAILED", "DISCONNECTED" };
+    return s < 5 ? NAMES[s] : "?";
+}
+
+void printRecord(FILE* out, const TraceRecord& rec, const uint8_t* payload, uint32_t sinceStartUs) {
+    fprintf(out, "%10.3f ms  ", sinceStartUs / 1000.0);
+    switch (rec.type) {
+        case TRACE_BOOT:
+            fprintf(out, "BOOT       transport=%s version=%.*s\n",
+                    transportName(rec.a), (int)rec.stored, (const char*)payload);
+            break;
+        case TRACE_COMMAND:
+            fprintf(out, "COMMAND    %-9s %-11s %5uB%s ",
+                    CommandProcessor::sourceTag((CommandSource)rec.a),
+                    CommandProcessor::resultName((CommandResult)rec.b),
+                    (unsigned)rec.size, (rec.flags & TRACE_FLAG_TRUNCATED) ? "+" : " ");
+            if (rec.flags & TRACE_FLAG_BINARY) {
+                fprintf(out, "msgpack");
+                for (uint16_t i = 0; i < rec.stored && i < 32; ++i) fprintf(out, " %02x", payload[i]);
+                fprintf(out, "%s\n", rec.stored > 32 ? " …" : "");
+            } else {
+                fprintf(out, "%.*s\n", (int)rec.stored, (const char*)payload);
+            }
+            break;
+        case TRACE_WIFI_STATE:
+            fprintf(out, "WIFI       %s -> %s\n", wifiStateName(rec.a), wifiStateName(rec.b));
+            break;
+        case TRACE_TRANSPORT:
+            fprintf(out, "TRANSPORT  %s -> %s\n", transportName(rec.a), transportName(rec.b));
+            break;
+        default:
+            fprintf(out, "type %u\n", (unsigned)rec.type);
+            break;
+    }
+}
+
+// TRACE would act on the recorder being replayed from; OTA on the
+// firmware slots (and restart the process).
+bool isSkippedCommand(const TraceRecord& rec, const uint8_t* payload) {
+    if (rec.flags & TRACE_FLAG_BINARY) {
+        MsgPackReader r(payload, rec.stored);
+        uint32_t      entries;
+        int64_t       key, type;
+        return r.map(entries) && entries && r.sint(key) && key == wire::KEY_TYPE
+            && r.sint(type) && (type == REQ_TRACE || type == REQ_OTA);
+    }
+    static const char* const KEYS[] = { "\"TRACE\"", "\"OTA\"" };
+    for (const char* key : KEYS) {
+        const char* end = key + strlen(key);
+        if (std::search(payload, payload + rec.stored, key, end) != payload + rec.stored) return true;
+    }
+    return false;
+}
+
+// Transport the device was in when the trace starts.
+uint8_t initialTransport(const std::vector<uint8_t>& data) {
+    TraceReader    r(data.data(), data.size());
+    TraceRecord    rec;
+    const uint8_t* payload;
+    while (r.next(rec, payload)) {
+        if (rec.type == TRACE_BOOT || rec.type == TRACE_TRANSPORT) return rec.a;
+    }
+    return TRANSPORT_WIFI;
+}
+
+// Run the device until `untilUs`.  service() instead of loop(): the
+// idle wait would sleep to the device's next deadline, past ours.
+void pumpUntil(uint64_t untilUs) {
+    DeviceContext& ctx = DeviceContext::getInstance();
+    do {
+        ctx.service();
+        if (nowUs() < untilUs) hal::waitForEvent(1);
+    } while (nowUs() < untilUs && !interrupted);
+}
+
+// ── Replay ───────────────────────────────────────────────────────────
+
+struct Report {
+    uint32_t        records        = 0;
+    uint32_t        commands       = 0;
+    uint32_t        replayed       = 0;
+    uint32_t        skipped        = 0;
+    uint32_t        resultDiffs    = 0;
+    uint32_t        transportDiffs = 0;
+    uint64_t        traceSpanUs    = 0;
+    uint64_t        wallUs         = 0;
+    LatencyRecorder handleUs;
+};
+
+void replay(const std::vector<uint8_t>& data, const Options& opt, FILE* out, Report& rep) {
+    DeviceContext&    ctx  = DeviceContext::getInstance();
+    CommandProcessor& proc = CommandProcessor::getInstance();
+
+    TraceReader    r(data.data(), data.size());
+    TraceRecord    rec;
+    const uint8_t* payload;
+    bool           first    = true;
+    uint32_t       prevUs   = 0;
+    int64_t        traceUs  = 0;   // position in the original timeline
+    uint64_t       startUs  = nowUs();
+    uint8_t        expected = ctx.getTransport();
+    WireEncoding   encoding[SOURCE_COUNT] = {};   // per-source HELLO state
+    uint32_t       sessions[SOURCE_COUNT] = {};
+
+    while (!interrupted && r.next(rec, payload)) {
+        ++rep.records;
+        // Signed: a command is logged after the transitions it caused,
+        // with its earlier arrival time.
+        if (!first) traceUs += (int32_t)(rec.timeUs - prevUs);
+        first  = false;
+        prevUs = rec.timeUs;
+
+        if (rec.type == TRACE_TRANSPORT) {
+            expected = rec.b;
+            continue;
+        }
+        if (rec.type != TRACE_COMMAND) continue;
+
+        ++rep.commands;
+        if ((rec.flags & TRACE_FLAG_TRUNCATED) || rec.a >= SOURCE_COUNT || isSkippedCommand(rec, payload)) {
+            ++rep.skipped;
+            continue;
+        }
+
+        if (opt.speed > 0) pumpUntil(startUs + (uint64_t)(std::max<int64_t>(traceUs, 0) / opt.speed));
+        else               DeviceContext::getInstance().service();
+
+        CommandSource   src     = (CommandSource)rec.a;
+        bool            ws      = src == SOURCE_WS_LOCAL || src == SOURCE_WS_REMOTE;
+        WireEncoding*   enc     = ws ? &encoding[src] : nullptr;
+        uint32_t*       session = ws || src == SOURCE_BLE ? &sessions[src] : nullptr;
+        String          ack;
+        wire::AckBuffer binAck;
+        uint64_t        t0      = nowUs();
+        CommandResult   result  = (rec.flags & TRACE_FLAG_BINARY)
+                                ? proc.handleMsgPack(payload, rec.stored, src, &binAck, enc, session)
+                                : proc.handleJson((const char*)payload, rec.stored, src, &ack, enc, session);
+        rep.handleUs.add((uint32_t)(nowUs() - t0));
+        ++rep.replayed;
+
+        if (result != rec.b) {
+            ++rep.resultDiffs;
+            bool binary = rec.flags & TRACE_FLAG_BINARY;
+            fprintf(out, "divergence @%.3f ms: result %s, recorded %s: %.*s\n",
+                    traceUs / 1000.0, CommandProcessor::resultName(result),
+                    CommandProcessor::resultName((CommandResult)rec.b),
+                    binary ? 9 : (int)rec.stored, binary ? "<msgpack>" : (const char*)payload);
+        }
+        if (ctx.getTransport() != expected) {
+            ++rep.transportDiffs;
+            fprintf(out, "divergence @%.3f ms: transport %s, recorded %s\n",
+                    traceUs / 1000.0, transportName(ctx.getTransport()), transportName(expected));
+            expected = ctx.getTransport();   // report each split once
+        }
+    }
+
+    rep.traceSpanUs = (uint64_t)std::max<int64_t>(traceUs, 0);
+    rep.wallUs      = nowUs() - startUs;
+}
+
+void printReport(FILE* out, const TraceFileHeader& hdr, Report& rep, const Options& opt) {
+    uint32_t divergences = rep.resultDiffs + rep.transportDiffs;
+    if (opt.json) {
+        fprintf(out,
+                "{\"records\":%u,\"dropped_at_capture\":%u,\"commands\":%u,\"replayed\":%u,\"skipped\":%u,"
+                "\"result_divergences\":%u,\"transport_divergences\":%u,\"speed\":%.2f,"
+                "\"trace_ms\":%.1f,\"wall_ms\":%.1f,"
+                "\"handle_us\":{\"p50\":%u,\"p99\":%u,\"max\":%u}}\n",
+                (unsigned)rep.records, (unsigned)hdr.dropped, (unsigned)rep.commands,
+                (unsigned)rep.replayed, (unsigned)rep.skipped,
+                (unsigned)rep.resultDiffs, (unsigned)rep.transportDiffs, opt.speed,
+                rep.traceSpanUs / 1000.0, rep.wallUs / 1000.0,
+                (unsigned)rep.handleUs.percentile(0.50), (unsigned)rep.handleUs.percentile(0.99),
+                (unsigned)rep.handleUs.percentile(1.0));
+        return;
+    }
+
+    fprintf(out, "records    %u (%u dropped at capture)\n", (unsigned)rep.records, (unsigned)hdr.dropped);
+    fprintf(out, "commands   %u replayed, %u skipped\n", (unsigned)rep.replayed, (unsigned)rep.skipped);
+    fprintf(out, "timeline   %.1f ms recorded, %.1f ms replayed (speed %.2f)\n",
+            rep.traceSpanUs / 1000.0, rep.wallUs / 1000.0, opt.speed);
+    fprintf(out, "handle     p50 %u us  p99 %u us  max %u us\n",
+            (unsigned)rep.handleUs.percentile(0.50), (unsigned)rep.handleUs.percentile(0.99),
+            (unsigned)rep.handleUs.percentile(1.0));
+    fprintf(out, "%s (%u result, %u transport)\n", divergences ? "DIVERGED" : "identical",
+            (unsigned)rep.resultDiffs, (unsigned)rep.transportDiffs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const char* a    = argv[i];
+        const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool        ok   = true;
+
+        if      (!strcmp(a, "--speed")     && next) { opt.speed = atof(next); ++i; }
+        else if (!strcmp(a, "--transport") && next) { opt.transport = next; ++i; }
+        else if (!strcmp(a, "--settle-ms") && next) { opt.settleMs = (uint32_t)atoi(next); ++i; }
+        else if (!strcmp(a, "--print"))             { opt.print = true; }
+        else if (!strcmp(a, "--verbose"))           { opt.verbose = true; }
+        else if (!strcmp(a, "--json"))              { opt.json = true; }
+        else if (!strcmp(a, "--help"))              { usage(argv[0]); return 0; }
+        else if (a[0] != '-' && !opt.path)          { opt.path = a; }
+        else ok = false;
+
+        if (!ok || opt.speed < 0) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!opt.path) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    if (!loadTrace(opt.path, data)) {
+        fprintf(stderr, "cannot read a trace from %s\n", opt.path);
+        return 2;
+    }
+    TraceReader reader(data.data(), data.size());
+    if (!reader.valid()) {
+        fprintf(stderr, "%s: not an OVTR v%u trace\n", opt.path, (unsigned)TraceRecorder::VERSION);
+        return 2;
+    }
+
+    if (opt.print) {
+        TraceRecord    rec;
+        const uint8_t* payload;
+        bool           first   = true;
+        uint32_t       startUs = 0;
+        while (reader.next(rec, payload)) {
+            if (first) startUs = rec.timeUs;
+            first = false;
+            printRecord(stdout, rec, payload, rec.timeUs - startUs);
+        }
+        return 0;
+    }
+
+    // Firmware logs go to stdout; keep the report on its own stream.
+    fflush(stdout);
+    FILE* out = fdopen(dup(STDOUT_FILENO), "w");
+    if (!opt.verbose && !freopen("/dev/null", "w", stdout)) out = stderr;
+    // The console must not read the replayer's own stdin.
+    if (!freopen("/dev/null", "r", stdin)) return 2;
+
+    // ── Boot a fresh simulated device in the trace's transport ───────
+    native::SimOptions& o = native::simOptions();
+    char dir[] = "/tmp/openvibe-replay-XXXXXX";
+    if (mkdtemp(dir)) o.nvsDir = dir;
+    o.blePort = 0;   // ephemeral; nothing connects to it
+
+    TransportMode transport = (TransportMode)initialTransport(data);
+    if (opt.transport && !CommandProcessor::parseTransport(opt.transport, transport)) {
+        usage(argv[0]);
+        return 2;
+    }
+    ConfigManager& cfg = ConfigManager::getInstance();
+    cfg.setWiFiCredentials("OpenVibe-Lab", "");
+    cfg.setLastTransport(transport);
+
+    signal(SIGINT,  onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    setup();
+    pumpUntil(nowUs() + (uint64_t)opt.settleMs * 1000);   // let the station associate
+
+    Report rep;
+    replay(data, opt, out, rep);
+    Logger::getInstance().flush();   // device log first, then the report
+    printReport(out, reader.header(), rep, opt);
+    fflush(out);
+    return rep.resultDiffs + rep.transportDiffs ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""Flash, static RAM and boot time of each product variant (src/Features.h).
+
+Builds every env with PlatformIO and reads the size summary it prints
+("RAM: ... used N bytes", "Flash: ... used N bytes"; RAM is .data +
+.bss).  With --port, each variant is also flashed and reset, and the
+"[Boot] Ready in N ms (BLE N ms, Wi-Fi N ms)" line is read from the
+serial port.  Deltas are against the first env.
+
+    python tools/variants/report.py
+    python tools/variants/report.py --port /dev/ttyUSB0 esp32dev esp32dev_ble
+
+--port needs pyserial; PlatformIO's own interpreter has it:
+
+    ~/.platformio/penv/bin/python tools/variants/report.py --port /dev/ttyUSB0
+
+Exit status is 1 if any build (or boot read) fails.
+"""
+
+import argparse
+import json
+import re
+import subprocess
+import sys
+import time
+
+DEFAULT_ENVS = ["esp32dev", "esp32dev_ble", "esp32dev_wifi", "esp32dev_ws"]
+
+SIZE_RE = re.compile(r"^(RAM|Flash):.*\(used (\d+) bytes from (\d+) bytes\)", re.M)
+BOOT_RE = re.compile(r"\[Boot\] Ready in (\d+) ms \(BLE (\d+) ms, Wi-Fi (\d+) ms\)")
+
+
+def build(env, pio):
+    proc = subprocess.run([pio, "run", "-e", env], stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT, universal_newlines=True)
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout[-4000:])
+        return None
+    sizes = {kind.lower(): int(used) for kind, used, _ in SIZE_RE.findall(proc.stdout)}
+    if "ram" not in sizes or "flash" not in sizes:
+        sys.stderr.write("%s: no size summary in the build output\n" % env)
+        return None
+    return sizes
+
+
+def boot(env, pio, port, baud, timeout):
+    import serial   # pyserial, only needed here
+
+    proc = subprocess.run([pio, "run", "-e", env, "-t", "upload", "--upload-port", port],
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True)
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout[-4000:])
+        return None
+
+    with serial.Serial(port, baud, timeout=0.2) as ser:
+        # EN low through RTS (DTR high keeps GPIO0 up: normal boot).
+        ser.dtr = False
+        ser.rts = True
+        time.sleep(0.1)
+        ser.reset_input_buffer()
+        ser.rts = False
+
+        deadline = time.time() + timeout
+        line = b""
+        while time.time() < deadline:
+            line += ser.readline()
+            if not line.endswith(b"\n"):
+                continue
+            m = BOOT_RE.search(line.decode("utf-8", "replace"))
+            if m:
+                return {"boot_ms": int(m.group(1)), "ble_ms": int(m.group(2)),
+                        "wifi_ms": int(m.group(3))}
+            line = b""
+    sys.stderr.write("%s: no boot line within %d s\n" % (env, timeout))
+    return None
+
+
+def delta(value, base):
+    if value is None or base is None:
+        return ""
+    return "%+d" % (value - base)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("envs", nargs="*", default=DEFAULT_ENVS,
+                    help="PlatformIO envs; the first is the reference (default: %(default)s)")
+    ap.add_argument("--port", help="serial port: also flash each variant and time its boot")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--timeout", type=int, default=20, help="seconds to wait for the boot line")
+    ap.add_argument("--pio", default="pio", help="PlatformIO executable")
+    ap.add_argument("--json", action="store_true", help="one JSON object per variant")
+    args = ap.parse_args()
+
+    if args.port:
+        try:
+            import serial  # noqa: F401
+        except ImportError:
+            sys.exit("--port needs pyserial (use ~/.platformio/penv/bin/python)")
+
+    rows = []
+    ok   = True
+    for env in args.envs:
+        sys.stderr.write("[variants] %s\n" % env)
+        row = {"env": env}
+        sizes = build(env, args.pio)
+        if sizes is None:
+            ok = False
+        else:
+            row.update(sizes)
+            if args.port:
+                b = boot(env, args.pio, args.port, args.baud, args.timeout)
+                if b is None:
+                    ok = False
+                else:
+                    row.update(b)
+        rows.append(row)
+
+    base = rows[0]
+    if args.json:
+        for row in rows:
+            out = dict(row)
+            for key in ("flash", "ram", "boot_ms"):
+                if key in row and key in base:
+                    out[key + "_delta"] = row[key] - base[key]
+            print(json.dumps(out))
+        return 0 if ok else 1
+
+    header = "%-16s %10s %9s %8s %8s" % ("env", "flash", "Δ", "ram", "Δ")
+    if args.port:
+        header += " %8s %7s %7s %7s" % ("boot ms", "Δ", "BLE", "Wi-Fi")
+    print(header)
+    for row in rows:
+        line = "%-16s %10s %9s %8s %8s" % (
+            row["env"], row.get("flash", "failed"), delta(row.get("flash"), base.get("flash")),
+            row.get("ram", ""), delta(row.get("ram"), base.get("ram")))
+        if args.port:
+            line += " %8s %7s %7s %7s" % (
+                row.get("boot_ms", "-"), delta(row.get("boot_ms"), base.get("boot_ms")),
+                row.get("ble_ms", ""), row.get("wifi_ms", ""))
+        print(line)
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""Compress the control page (web/) into src/webui/WebAssets.cpp.
+
+Every file in web/ becomes a gzip byte array the firmware serves
+straight from flash.  Files other than index.html get the first 8 hex
+digits of their SHA-256 in the name (app.js -> app.1a2b3c4d.js), and
+index.html's references are rewritten to match, so those can be
+cached for a year; index.html itself is served at / and revalidated.
+Each asset's ETag is a hash of its gzip bytes.
+
+Runs as a PlatformIO pre: script (extra_scripts in platformio.ini) and
+by hand:
+
+    python tools/webui/embed.py            # regenerate if web/ changed
+    python tools/webui/embed.py --check    # exit 1 if out of date
+
+The output is only rewritten when it would change, so an unchanged
+web/ rebuilds nothing.  Compression is deterministic (no timestamp),
+so the same web/ always gives the same file.
+
+An asset must fit MAX_ASSET_BYTES compressed: the device then hands it
+to lwIP in one write that never waits for an ACK, and the loop (motor
+updates included) is held up for a copy, not for the network.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+MAX_ASSET_BYTES = 5744   # CONFIG_LWIP_TCP_SND_BUF_DEFAULT on Arduino-ESP32
+
+TYPES = {
+    ".html": "text/html",
+    ".js":   "application/javascript",
+    ".css":  "text/css",
+    ".svg":  "image/svg+xml",
+    ".png":  "image/png",
+    ".ico":  "image/x-icon",
+    ".json": "application/json",
+}
+
+OUTPUT = os.path.join("src", "webui", "WebAssets.cpp")
+
+
+def symbol(name):
+    return re.sub(r"[^A-Z0-9]", "_", name.upper())
+
+
+def compress(data):
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def collect(root):
+    """[(path, type, immutable, source bytes)] with index.html first."""
+    web = os.path.join(root, "web")
+    files = sorted(f for f in os.listdir(web) if os.path.isfile(os.path.join(web, f)))
+    if "index.html" not in files:
+        sys.exit("embed.py: web/index.html is missing")
+
+    assets, renames = [], {}
+    for name in files:
+        stem, ext = os.path.splitext(name)
+        if ext not in TYPES:
+            sys.exit(f"embed.py: no content type for web/{name}")
+        if name == "index.html":
+            continue
+        with open(os.path.join(web, name), "rb") as f:
+            data = f.read()
+        hashed = f"{stem}.{hashlib.sha256(data).hexdigest()[:8]}{ext}"
+        renames[name] = hashed
+        assets.append(("/" + hashed, TYPES[ext], True, data))
+
+    with open(os.path.join(web, "index.html"), encoding="utf-8") as f:
+        html = f.read()
+    for name, hashed in renames.items():
+        html, n = re.subn(r'((?:href|src)=")/?' + re.escape(name) + '"', r"\g<1>/" + hashed + '"', html)
+        if n == 0:
+            print(f"embed.py: web/{name} is not referenced from index.html", file=sys.stderr)
+    assets.insert(0, ("/", TYPES[".html"], False, html.encode("utf-8")))
+    return assets
+
+
+def render(assets):
+    out = [
+        "// Generated by tools/webui/embed.py from web/ — do not edit.",
+        '#include "WebAssets.h"',
+        "",
+        "#if OPENVIBE_WITH_WEBUI",
+        "",
+        "namespace webui {",
+        "",
+        "namespace {",
+        "",
+    ]
+    rows, raw_total, gz_total = [], 0, 0
+    for path, ctype, immutable, data in assets:
+        gz  = compress(data)
+        if len(gz) > MAX_ASSET_BYTES:
+            sys.exit(f"embed.py: {path} is {len(gz)} bytes compressed, over {MAX_ASSET_BYTES}")
+        sym  = symbol(path.strip("/") or "index.html")
+        etag = '\\"' + hashlib.sha256(gz).hexdigest()[:16] + '\\"'
+        raw_total += len(data)
+        gz_total  += len(gz)
+
+        out.append(f"// {path}: {len(data)} -> {len(gz)} bytes")
+        out.append(f"const uint8_t {sym}[] = {{")
+        for i in range(0, len(gz), 16):
+            out.append("    " + ", ".join(f"0x{b:02x}" for b in gz[i:i + 16]) + ",")
+        out.append("};")
+        out.append("")
+        rows.append(f'    {{ "{path}", "{ctype}", "{etag}", {sym}, sizeof({sym}), '
+                    f'{"true" if immutable else "false"} }},')
+
+    out += ["} // namespace", "", "const Asset ASSETS[] = {"] + rows + [
+        "};",
+        "",
+        "const uint8_t  ASSET_COUNT  = sizeof(ASSETS) / sizeof(ASSETS[0]);",
+        f"const uint32_t SOURCE_BYTES = {raw_total};",
+        f"const uint32_t GZIP_BYTES   = {gz_total};",
+        "",
+        "} // namespace webui",
+        "",
+        "#endif // OPENVIBE_WITH_WEBUI",
+        "",
+    ]
+    return "\n".join(out), raw_total, gz_total
+
+
+def run(root, check=False, quiet=False):
+    text, raw_total, gz_total = render(collect(root))
+    path = os.path.join(root, OUTPUT)
+    try:
+        with open(path, encoding="utf-8") as f:
+            current = f.read()
+    except FileNotFoundError:
+        current = None
+
+    if current == text:
+        return 0
+    if check:
+        print(f"embed.py: {OUTPUT} is out of date; run tools/webui/embed.py", file=sys.stderr)
+        return 1
+    with open(path, "w", encoding="utf-8", newline="\n") as f:
+        f.write(text)
+    if not quiet:
+        print(f"embed.py: {OUTPUT} written, {raw_total} -> {gz_total} bytes")
+    return 0
+
+
+try:
+    Import("env")   # noqa: F821 — PlatformIO pre: script
+    run(env.subst("$PROJECT_DIR"))   # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+        ap.add_argument("--check", action="store_true", help="exit 1 if the output is out of date")
+        args = ap.parse_args()
+        sys.exit(run(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))),
+                     args.check))
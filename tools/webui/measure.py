@@ -0,0 +1,283 @@
+#!/usr/bin/env python3
+"""First load of the control page: bytes on the wire and time to interactive.
+
+A run does what a browser does with the page:
+
+  cold   GET /, then its stylesheet and script in parallel, then the
+         WebSocket app.js opens; interactive once the first status
+         arrives (app.js draws the sliders from it)
+  warm   GET / with If-None-Match (304), the hashed assets from the
+         browser cache, then the same WebSocket
+
+Bytes are everything the device sent over HTTP, headers included.
+
+--stall also times command acks over a second WebSocket, first with
+the page idle and then while it is loaded over and over, so serving it
+can be seen (or not) to hold up the loop that runs the motors.
+
+    python tools/webui/measure.py --host 192.168.1.57
+    python tools/webui/measure.py --host 127.0.0.1 --http-port 8080 --stall
+
+Runs are paced by --pause: a cold load takes 3 of the REST query
+tokens (10 / s, see README "Rate limits").
+
+Exit status is 1 if any run fails.
+"""
+
+import argparse
+import base64
+import gzip
+import json
+import os
+import re
+import socket
+import statistics
+import struct
+import sys
+import threading
+import time
+
+
+# ── HTTP ─────────────────────────────────────────────────────────────
+
+def http_get(host, port, path, timeout, etag=None):
+    """(status, headers, body, bytes received)"""
+    s = socket.create_connection((host, port), timeout=timeout)
+    try:
+        req = "GET %s HTTP/1.1\r\nHost: %s\r\nAccept-Encoding: gzip\r\n" % (path, host)
+        if etag:
+            req += "If-None-Match: %s\r\n" % etag
+        s.sendall((req + "Connection: close\r\n\r\n").encode())
+        buf = b""
+        while True:   # the device closes after each response
+            chunk = s.recv(65536)
+            if not chunk:
+                break
+            buf += chunk
+    finally:
+        s.close()
+
+    head, _, body = buf.partition(b"\r\n\r\n")
+    lines   = head.decode("latin-1").split("\r\n")
+    status  = int(lines[0].split()[1])
+    headers = {}
+    for line in lines[1:]:
+        k, _, v = line.partition(":")
+        headers[k.strip().lower()] = v.strip()
+    return status, headers, body, len(buf)
+
+
+def asset_paths(html):
+    return re.findall(r'(?:href|src)="(/[^"]+)"', html)
+
+
+# ── WebSocket ────────────────────────────────────────────────────────
+
+class Ws:
+    def __init__(self, host, port, timeout):
+        self.s = socket.create_connection((host, port), timeout=timeout)
+        key = base64.b64encode(os.urandom(16)).decode()
+        self.s.sendall(("GET / HTTP/1.1\r\nHost: %s\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                        "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n" % (host, key)).encode())
+        self.buf = b""
+        while b"\r\n\r\n" not in self.buf:
+            chunk = self.s.recv(4096)
+            if not chunk:
+                raise ConnectionError("WebSocket upgrade refused")
+            self.buf += chunk
+        self.buf = self.buf.split(b"\r\n\r\n", 1)[1]
+
+    def send(self, obj):
+        payload = json.dumps(obj).encode()
+        mask = os.urandom(4)
+        self.s.sendall(bytes([0x81, 0x80 | len(payload)]) + mask
+                       + bytes(b ^ mask[i % 4] for i, b in enumerate(payload)))
+
+    def recv(self):
+        while True:
+            while len(self.buf) < 2:
+                self.fill()
+            n, h = self.buf[1] & 0x7F, 2
+            if n == 126:
+                while len(self.buf) < 4:
+                    self.fill()
+                n, h = struct.unpack(">H", self.buf[2:4])[0], 4
+            while len(self.buf) < h + n:
+                self.fill()
+            frame, self.buf = self.buf[h:h + n], self.buf[h + n:]
+            try:
+                return json.loads(frame)
+            except ValueError:
+                continue
+
+    def fill(self):
+        chunk = self.s.recv(4096)
+        if not chunk:
+            raise ConnectionError("WebSocket closed")
+        self.buf += chunk
+
+    def close(self):
+        self.s.close()
+
+
+def first_status(host, ws_port, timeout):
+    ws = Ws(host, ws_port, timeout)
+    try:
+        ws.send({"requestType": "STATUS"})
+        while "intensity" not in ws.recv():
+            pass
+    finally:
+        ws.close()
+
+
+# ── Page loads ───────────────────────────────────────────────────────
+
+def load(args, cache):
+    """One page load; `cache` maps path -> ETag from the cold load."""
+    etag = cache.get("/") if args.warm else None
+    status, headers, body, wire = http_get(args.host, args.http_port, "/", args.timeout, etag)
+    if status == 304:
+        html = cache["html"]
+    elif status == 200 and headers.get("content-encoding") == "gzip":
+        html = gzip.decompress(body).decode()
+        cache["/"], cache["html"] = headers.get("etag"), html
+    else:
+        raise RuntimeError("GET / answered %d" % status)
+
+    results, threads = [], []
+    for path in asset_paths(html):
+        if args.warm and path in cache:
+            continue   # hashed name: the browser keeps it for a year
+
+        def get(p=path):
+            try:
+                results.append((p,) + http_get(args.host, args.http_port, p, args.timeout))
+            except OSError as e:
+                results.append((p, 0, {}, b"", 0, e))
+        threads.append(threading.Thread(target=get))
+        threads[-1].start()
+    for t in threads:
+        t.join()
+    for p, st, hdr, _, n, *err in results:
+        if st != 200:
+            raise RuntimeError("GET %s answered %s" % (p, err[0] if err else st))
+        if "immutable" in hdr.get("cache-control", ""):
+            cache[p] = hdr.get("etag")
+        wire += n
+
+    first_status(args.host, args.ws_port, args.timeout)
+    return wire
+
+
+def summary(name, samples, runs, key):
+    good = sorted(s for s in samples if s is not None)
+    row = {"path": name, "runs": runs, "ok": len(good)}
+    if good:
+        row["median_" + key] = round(statistics.median(good), 1)
+        row["p90_" + key]    = round(good[min(len(good) - 1, int(len(good) * 0.9))], 1)
+        row["max_" + key]    = round(good[-1], 1)
+    return row
+
+
+# ── Stall: command acks while the page is served ─────────────────────
+
+def ack_latencies(args, seconds):
+    ws = Ws(args.host, args.ws_port, args.timeout)
+    out, seq, end = [], 0, time.monotonic() + seconds
+    try:
+        while time.monotonic() < end:
+            seq += 1
+            t0 = time.monotonic()
+            ws.send({"requestType": "INTENSITY", "intensity": seq % 50, "id": seq})
+            while ws.recv().get("ack") != seq:
+                pass
+            out.append((time.monotonic() - t0) * 1000.0)
+            time.sleep(0.04)   # 25 / s, under the control limit
+    finally:
+        ws.close()
+    return out
+
+
+def stall(args):
+    rows, args.warm = [], False   # every load cold: the most the device sends
+    for name, busy in (("idle", False), ("loading", True)):
+        stop, loads = threading.Event(), [0]
+
+        def hammer():
+            cache = {}
+            while not stop.is_set():
+                try:
+                    load(args, cache)
+                    loads[0] += 1
+                except (OSError, RuntimeError):
+                    pass
+                time.sleep(args.pause)
+        if busy:
+            t = threading.Thread(target=hammer)
+            t.start()
+        lat = ack_latencies(args, args.stall)
+        stop.set()
+        if busy:
+            t.join()
+        row = summary(name, lat, len(lat), "ack_ms")
+        row["page_loads"] = loads[0]
+        rows.append(row)
+    return rows
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--http-port", type=int, default=80)
+    ap.add_argument("--ws-port", type=int, default=6969)
+    ap.add_argument("--runs", type=int, default=10)
+    ap.add_argument("--timeout", type=float, default=5.0, help="seconds per request")
+    ap.add_argument("--pause", type=float, default=0.5, help="seconds between runs")
+    ap.add_argument("--stall", type=float, metavar="SECONDS", nargs="?", const=10.0,
+                    help="also time command acks idle and while loading (default 10 s each)")
+    ap.add_argument("--json", action="store_true", help="one JSON object per row")
+    args = ap.parse_args()
+
+    rows, ok, cache = [], True, {}
+    for name, warm in (("cold", False), ("warm", True)):
+        args.warm = warm
+        times, sizes = [], []
+        for i in range(args.runs):
+            sys.stderr.write("[webui] %s %d/%d\n" % (name, i + 1, args.runs))
+            t0 = time.monotonic()
+            try:
+                sizes.append(load(args, cache))
+                times.append((time.monotonic() - t0) * 1000.0)
+            except (OSError, RuntimeError) as e:
+                sys.stderr.write("  %s\n" % e)
+                times.append(None)
+            time.sleep(args.pause)
+        row = summary(name, times, args.runs, "ms")
+        row["bytes"] = max(sizes) if sizes else None
+        ok = ok and row["ok"] == args.runs
+        rows.append(row)
+
+    stall_rows = stall(args) if args.stall else []
+
+    if args.json:
+        for row in rows + stall_rows:
+            print(json.dumps(row))
+        return 0 if ok else 1
+
+    print("%-5s %5s %7s %10s %10s %10s" % ("load", "ok", "bytes", "median ms", "p90 ms", "max ms"))
+    for row in rows:
+        print("%-5s %2d/%-2d %7s %10s %10s %10s" % (row["path"], row["ok"], row["runs"], row["bytes"],
+                                                   row.get("median_ms", "-"), row.get("p90_ms", "-"),
+                                                   row.get("max_ms", "-")))
+    if stall_rows:
+        print()
+        print("%-8s %6s %6s %10s %10s %10s" % ("acks", "acks", "loads", "median ms", "p90 ms", "max ms"))
+        for row in stall_rows:
+            print("%-8s %6d %6d %10s %10s %10s" % (row["path"], row["ok"], row["page_loads"],
+                                                   row.get("median_ack_ms", "-"),
+                                                   row.get("p90_ack_ms", "-"), row.get("max_ack_ms", "-")))
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
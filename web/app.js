@@ -0,0 +1,117 @@
+'use strict';
+// Control page served by the device (tools/webui/embed.py puts it in
+// flash).  Commands go as JSON over the local WebSocket; when that is
+// not up (transport BLE or REMOTE) intensity goes to POST /intensity and
+// status is polled from GET /status.  ?ws=PORT if the WS port is not 6969.
+(() => {
+  const $ = id => document.getElementById(id);
+  const WS_PORT = new URLSearchParams(location.search).get('ws') || 6969;
+  const SEND_MS = 40;     // one command per 40 ms: under the 50 / s control limit
+  const POLL_MS = 2000;   // REST fallback
+  const FIELDS  = { battery: '%', transport: '', ipAddress: '', deviceId: '', version: '' };
+
+  let ws = null, sliders = [], levels = [], dirty = false, interactive = false;
+
+  function post(path, body) {
+    return fetch(path, { method: 'POST', headers: { 'Content-Type': 'application/json' },
+                         body: JSON.stringify(body) });
+  }
+
+  const live = () => ws && ws.readyState === WebSocket.OPEN;
+
+  function send(cmd) {
+    if (live()) ws.send(JSON.stringify(cmd));
+    else if (cmd.requestType === 'INTENSITY') post('/intensity', cmd).catch(() => {});
+  }
+
+  // ── Channels ──────────────────────────────────────────────────────
+  function build(count) {
+    const box = $('channels');
+    box.textContent = '';
+    sliders = [];
+    for (let c = 0; c < count; ++c) {
+      const row = document.createElement('div'), out = document.createElement('output');
+      const s   = Object.assign(document.createElement('input'), { type: 'range', min: 0, max: 100, value: 0 });
+      row.className = 'channel';
+      row.append(count > 1 ? `Ch ${c}` : 'Level', s, out);
+      s.oninput = () => { levels[c] = +s.value; out.value = s.value; dirty = true; };
+      box.append(row);
+      sliders.push([s, out]);
+    }
+    levels = new Array(count).fill(0);
+  }
+
+  setInterval(() => {
+    if (!dirty) return;
+    dirty = false;
+    send(levels.length > 1 ? { requestType: 'INTENSITY', channels: levels }
+                           : { requestType: 'INTENSITY', intensity: levels[0] });
+  }, SEND_MS);
+
+  // ── Status ────────────────────────────────────────────────────────
+  function show(st) {
+    if (st.intensity === undefined) return;   // an ack, not a status
+    const now = st.channels || [st.intensity];
+    if (now.length !== sliders.length) build(now.length);
+    now.forEach((v, c) => {
+      const [s, out] = sliders[c];
+      if (document.activeElement !== s) { s.value = v; out.value = v; levels[c] = v; }
+    });
+    const dl = $('status');
+    dl.textContent = '';
+    for (const k in FIELDS) {
+      if (st[k] === undefined || st[k] === '') continue;
+      dl.append(Object.assign(document.createElement('dt'), { textContent: k }),
+                Object.assign(document.createElement('dd'), { textContent: st[k] + FIELDS[k] }));
+    }
+    if (!interactive) {
+      interactive = true;
+      performance.mark('interactive');
+      console.info(`[OpenVibe] interactive after ${Math.round(performance.now())} ms`);
+    }
+  }
+
+  function linkState(text, up) {
+    $('link').textContent = text;
+    $('link').className = up ? '' : 'off';
+    $('patterns').hidden = text === 'REST';   // PATTERN has no REST route
+  }
+
+  // ── Connection ────────────────────────────────────────────────────
+  let poller = 0;
+  function poll() {
+    fetch('/status').then(r => r.ok ? r.json() : null)
+      .then(st => { if (st && !live()) { linkState('REST', true); show(st); } })
+      .catch(() => linkState('offline', false));
+  }
+
+  function connect() {
+    ws = new WebSocket(`ws://${location.hostname}:${WS_PORT}/`);
+    ws.onopen = () => {
+      clearInterval(poller);
+      poller = 0;
+      linkState('live', true);
+      send({ requestType: 'STATUS' });
+    };
+    ws.onmessage = e => { try { show(JSON.parse(e.data)); } catch (_) {} };
+    ws.onclose = () => {
+      ws = null;
+      if (!poller) {
+        poll();
+        poller = setInterval(poll, POLL_MS);
+      }
+      setTimeout(connect, 5000);
+    };
+  }
+
+  $('pattern').onchange = $('period').onchange = () => send({
+    requestType: 'PATTERN', pattern: $('pattern').value, periodMs: +$('period').value });
+  $('stop').onclick = () => {
+    levels.fill(0);
+    sliders.forEach(([s, out]) => { s.value = 0; out.value = 0; });
+    dirty = true;
+  };
+
+  build(1);
+  connect();
+})();